@@ -45,13 +45,6 @@ typedef enum poiAttributes
 } t_poiAttributes;
 }
 
-/**
- * Function returns the type of POI based on the input string
- * @param const string& type : IN type of POI in string
- * @returnvalue t_poi type of POI
- */
-CPOI::t_poi stringToPoiType(const string& type);
-
 /**
  * Function sets the name of Media
  * @paramconst string& name : name of the Media
@@ -158,7 +151,7 @@ bool CCSV::readData(CWpDatabase& waypointDb, CPoiDatabase& poiDb,
 		{
 			validateEachWpLine(name, latitude, longitude, // validate each lines read from the Wp file, in case of error, exception is thrown
 					lineVector[lineNumber]);
-			CWaypoint wp(name, latitude, longitude); // if it is a valid line, add wp to the WpDatabase
+			CWaypoint wp(name, latitude, longitude, waypointDb.getStringPool()); // if it is a valid line, add wp to the WpDatabase
 			waypointDb.addWaypoint(wp);
 		} catch (int error)                           // catch exceptions thrown
 		{
@@ -179,8 +172,10 @@ bool CCSV::readData(CWpDatabase& waypointDb, CPoiDatabase& poiDb,
 		{
 			validateEachPoiLine(name, latitude, longitude, type, description, // validate each lines read from the poi file, in case of error, exception is thrown
 					lineVector[lineNumber]);
-			CPOI poi(stringToPoiType(type), name, description, latitude,
-					longitude);
+			t_poiCategory category;
+			CPoiCategoryRegistry::getId(type, category);   // registered by validatePoiType()
+			CPOI poi(category, name, description, latitude, longitude,
+					poiDb.getStringPool());
 			poiDb.addPoi(poi); // if it is a valid line, add poi to the poiDatabase
 		} catch (int error)                       // catch exceptions thrown
 		{
@@ -363,15 +358,14 @@ bool CCSV::validateRange(const double& latitude, const double& longitude)
 
 /**
  * Function validates the type of POI in string form as read from persistent storage.
- * POI type should be one among the known types such as Restaurant, Touristic,
- * Gasstation and University
+ * POI type is one among the categories of CPoiCategoryRegistry, e.g. the built-in
+ * Restaurant, Touristic, Gasstation and University; an unknown type is registered as new category
  * @param const string& poiType : IN type of POI in string form
  * @returnvalue true in case type of POI is valid, otherwise false
  */
 bool CCSV::validatePoiType(const string& poiType)
 {
-	return (!poiType.compare("RESTAURANT") || !poiType.compare("TOURISTIC") // checks if type of POI is one among the known types of POI
-			|| !poiType.compare("GASSTATION") || !poiType.compare("UNIVERSITY"));
+	return CPoiCategoryRegistry::registerCategory(poiType) != POI_CATEGORY_INVALID; // invalid name or no free ID
 }
 
 /**
@@ -484,21 +478,3 @@ void CCSV::getAttributesFromLine( const string& line,
 	attributeVector.push_back(attribute);
 }
 
-/**
- * Function returns the type of POI based on the input string
- * @param const string& type : IN type of POI in string
- * @returnvalue t_poi type of POI
- */
-CPOI::t_poi stringToPoiType(const string& type)
-{
-
-	if (type.compare("RESTAURANT")== 0)
-		return CPOI::RESTAURANT;
-	else if (type.compare("TOURISTIC") == 0)
-		return CPOI::TOURISTIC;
-	else if (type.compare("GASSTATION") == 0)
-		return CPOI::GASSTATION;
-	else
-		return CPOI::UNIVERSITY;
-}
-
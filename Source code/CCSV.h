@@ -25,8 +25,8 @@ private:
 
 	/**
 	 * Function validates the type of POI in string form as read from persistent storage.
-	 * POI type should be one among the known types such as Restaurant, Touristic,
-	 * Gasstation and University
+	 * POI type is one among the categories of CPoiCategoryRegistry, e.g. the built-in
+	 * Restaurant, Touristic, Gasstation and University; an unknown type is registered as new category
 	 * @param const string& poiType : IN type of POI in string form
 	 * @returnvalue true in case type of POI is valid, otherwise false
 	 */
@@ -0,0 +1,826 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CCONTRACTIONHIERARCHY.CPP
+ * Author          : George Sebastian
+ * Description     : CContractionHierarchy preprocesses a CRoadGraph for very fast shortest
+ *                   path queries. During the contraction the graph is kept as adjacency
+ *                   lists (edges are removed and shortcuts added); when a node is contracted
+ *                   its remaining edges all lead to higher ranked nodes and are frozen as its
+ *                   upward (outgoing) and downward (incoming) edges.
+ *                   The nodes of a round are contracted one after the other in the order of
+ *                   their selection. The witness search of a node ignores the nodes selected
+ *                   before it in the round (they are removed when it is contracted) and uses
+ *                   the ones selected after it (they still exist then), so its witnesses are
+ *                   valid although all searches of the round run in parallel on the graph of
+ *                   the start of the round. A witness search only follows paths of a few
+ *                   edges (hops); a shortcut is added when no witness was found with them
+ *                   (correct, only some shortcuts too many). The hop limits grow in stages
+ *                   with the mean degree of the remaining graph : the graph is sparse at the
+ *                   beginning, where short searches find most witnesses, and dense at the
+ *                   end, where a missed witness costs many shortcuts.
+ *                   The positions of the edges in the adjacency lists are kept in a hash
+ *                   table, so parallel edges are found and edges removed in constant time
+ *                   also for the high degrees of the last rounds.
+ *                   File format : "NVCH", version, number of nodes, fingerprint of the graph,
+ *                   then the arrays of the hierarchy, each with its number of elements.
+ ****************************************************************************/
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <math.h>
+using namespace std;
+
+#include "CContractionHierarchy.h"
+#include "CWorkStealingPool.h"
+
+#define SPARSE_MEAN_DEGREE 3.3        // mean edges per remaining node up to which the hop limits are smallest
+#define DENSE_MEAN_DEGREE 10.0        // mean edges per remaining node from which the hop limits are largest
+#define PRIORITY_EDGE_QUOTIENT 3.0    // weights of the terms of the priority of a node
+#define PRIORITY_HOP_QUOTIENT 1.0
+#define PRIORITY_CONTRACTED_NEIGHBOURS 0.05
+#define PRIORITY_LEVEL 1.0
+#define CONTRACTION_CHUNK 64          // nodes per task of the thread pool
+#define CH_FILE_VERSION 2             // 2 : fingerprint of the graph includes the edges
+
+/**
+ * Function writes an array with its number of elements to a binary file
+ * @param std::ofstream& file               : IN/OUT file
+ * @param const std::vector<elementType>& v : IN array
+ * @returnvalue void
+ */
+template<class elementType>
+static void writeArray(ofstream& file, const vector<elementType>& v)
+{
+	unsigned long long size = v.size();
+
+	file.write((const char*) &size, sizeof(size));
+	if (size > 0)
+		file.write((const char*) &v[0], size * sizeof(elementType));
+}
+
+/**
+ * Function reads an array written by writeArray()
+ * @param std::ifstream& file         : IN/OUT file
+ * @param std::vector<elementType>& v : OUT array
+ * @returnvalue true if the array could be read
+ */
+template<class elementType>
+static bool readArray(ifstream& file, vector<elementType>& v)
+{
+	unsigned long long size = 0;
+
+	if (!file.read((char*) &size, sizeof(size)) || size > (1ULL << 34))
+		// file is truncated or corrupted
+		return false;
+
+	v.resize(size);
+	if (size > 0)
+		file.read((char*) &v[0], size * sizeof(elementType));
+
+	return (bool) file;
+}
+
+/**
+ * Function returns the key of an edge in the table of the edge positions
+ * @param unsigned int from : IN start node
+ * @param unsigned int to   : IN end node
+ * @returnvalue unsigned long long : key
+ */
+static inline unsigned long long edgeKey(unsigned int from, unsigned int to)
+{
+	return ((unsigned long long) from << 32) | to;
+}
+
+/**
+ * Function sets the hop limits of the witness searches for the mean degree of the remaining graph
+ * @param double meanDegree              : IN edges per remaining node
+ * @param unsigned int& priorityHopLimit : OUT hop limit of the estimates of the priorities
+ * @param unsigned int& hopLimit         : OUT hop limit of the contraction
+ * @returnvalue void
+ */
+static void stageHopLimits(double meanDegree, unsigned int& priorityHopLimit,
+		unsigned int& hopLimit)
+{
+	if (meanDegree < SPARSE_MEAN_DEGREE)
+	{
+		priorityHopLimit = 1;
+		hopLimit = 3;
+	}
+	else if (meanDegree < DENSE_MEAN_DEGREE)
+	{
+		priorityHopLimit = 2;
+		hopLimit = 4;
+	}
+	else
+	{
+		priorityHopLimit = 2;
+		hopLimit = 5;
+	}
+}
+
+/**
+ * Constructor of class CContractionHierarchy, the hierarchy is empty
+ * @param no parameters
+ * @return no value
+ */
+CContractionHierarchy::CContractionHierarchy()
+{
+	m_pGraph = NULL;
+	m_noShortcuts = 0;
+	m_noRounds = 0;
+	m_noDynamicEdges = 0;
+}
+
+/**
+ * Function contracts all nodes of a road graph and builds the upward and downward edges
+ * @param const CRoadGraph& graph : IN graph, buildAdjacency() has to be called before; must live as long as the hierarchy
+ * @param unsigned int noThreads  : IN threads for the witness searches, 0 for the number of cores
+ * @returnvalue void
+ */
+void CContractionHierarchy::build(const CRoadGraph& graph,
+		unsigned int noThreads)
+{
+	unsigned int noNodes = graph.getNoNodes();
+
+	m_pGraph = &graph;
+	m_noShortcuts = 0;
+	m_noRounds = 0;
+	m_out.assign(noNodes, vector<t_dynamicEdge>());
+	m_in.assign(noNodes, vector<t_dynamicEdge>());
+	m_edgePositions.clear();
+	m_edgePositions.reserve(3 * graph.getNoEdges());
+	m_noDynamicEdges = 0;
+	m_contracting.assign(noNodes, 0);
+	m_contractedNeighbours.assign(noNodes, 0);
+	m_level.assign(noNodes, 0);
+
+	for (unsigned int node = 0; node < noNodes; node++)
+	{
+		for (unsigned int e = graph.m_firstEdge[node]; e < graph.m_firstEdge[node + 1]; e++)
+		{
+			if (graph.m_edgeTarget[e] != node)
+				// loops are never part of a shortest path
+				addDynamicEdge(node, graph.m_edgeTarget[e], graph.m_edgeCost[e], 1,
+						CH_NO_MIDDLE);
+		}
+	}
+
+	CWorkStealingPool pool(noThreads);
+	vector<double> priority(noNodes);
+	vector<unsigned int> updateNodes(noNodes);
+	unsigned int priorityHopLimit, hopLimit;
+
+	stageHopLimits((double) m_noDynamicEdges / max(noNodes, 1u), priorityHopLimit,
+			hopLimit);
+
+	for (unsigned int node = 0; node < noNodes; node++)
+		updateNodes[node] = node;
+
+	// priorities of the nodes in updateNodes, in chunks of nodes on the thread pool
+	function<void(unsigned int)> updatePriorities = [&](unsigned int task)
+	{
+		t_witnessState* pState = acquireWitnessState();
+		unsigned int last = min((unsigned int) updateNodes.size(), (task + 1) * CONTRACTION_CHUNK);
+
+		for (unsigned int i = task * CONTRACTION_CHUNK; i < last; i++)
+			priority[updateNodes[i]] = calculatePriority(updateNodes[i],
+					priorityHopLimit, *pState);
+
+		releaseWitnessState(pState);
+	};
+	pool.parallelFor((updateNodes.size() + CONTRACTION_CHUNK - 1) / CONTRACTION_CHUNK,
+			updatePriorities);
+
+	vector<unsigned int> remaining(updateNodes);
+	vector<unsigned int> selected;
+	vector<vector<t_shortcut> > shortcuts;
+	vector<vector<t_dynamicEdge> > up(noNodes), down(noNodes);
+	vector<unsigned int> neighbours;
+	unsigned int nextRank = 0;
+
+	m_rank.assign(noNodes, 0);
+
+	while (!remaining.empty())
+	{
+		// independent set : nodes with a smaller priority than all their neighbours (ties by number)
+		selected.clear();
+		for (unsigned int i = 0; i < remaining.size(); i++)
+		{
+			unsigned int node = remaining[i];
+			bool smallest = true;
+
+			for (unsigned int list = 0; list < 2 && smallest; list++)
+			{
+				const vector<t_dynamicEdge>& edges = (list == 0) ? m_out[node] : m_in[node];
+
+				for (unsigned int e = 0; e < edges.size() && smallest; e++)
+				{
+					unsigned int neighbour = edges[e].node;
+					smallest = priority[node] < priority[neighbour]
+							|| (priority[node] == priority[neighbour] && node < neighbour);
+				}
+			}
+
+			if (smallest)
+			{
+				selected.push_back(node);
+				m_contracting[node] = selected.size();   // position in the round, from 1
+			}
+		}
+
+		// witness searches of the selected nodes on the thread pool
+		shortcuts.assign(selected.size(), vector<t_shortcut>());
+		pool.parallelFor((selected.size() + CONTRACTION_CHUNK - 1) / CONTRACTION_CHUNK,
+				[&](unsigned int task)
+				{
+					t_witnessState* pState = acquireWitnessState();
+					unsigned int last = min((unsigned int) selected.size(), (task + 1) * CONTRACTION_CHUNK);
+
+					unsigned int noHops;
+
+					for (unsigned int i = task * CONTRACTION_CHUNK; i < last; i++)
+						findShortcuts(selected[i], hopLimit, *pState, &shortcuts[i], noHops);
+
+					releaseWitnessState(pState);
+				});
+
+		// contraction : freeze the edges, remove the node, add the shortcuts
+		updateNodes.clear();
+		for (unsigned int i = 0; i < selected.size(); i++)
+		{
+			unsigned int node = selected[i];
+
+			m_rank[node] = nextRank++;
+			up[node] = m_out[node];
+			down[node] = m_in[node];
+
+			neighbours.clear();
+			for (unsigned int e = 0; e < up[node].size(); e++)
+			{
+				removeDynamicEdge(node, up[node][e].node);
+				neighbours.push_back(up[node][e].node);
+			}
+			for (unsigned int e = 0; e < down[node].size(); e++)
+			{
+				removeDynamicEdge(down[node][e].node, node);
+				neighbours.push_back(down[node][e].node);
+			}
+
+			// a neighbour over an outgoing and an incoming edge is counted once
+			sort(neighbours.begin(), neighbours.end());
+			neighbours.erase(unique(neighbours.begin(), neighbours.end()),
+					neighbours.end());
+			for (unsigned int n = 0; n < neighbours.size(); n++)
+			{
+				m_contractedNeighbours[neighbours[n]]++;
+				m_level[neighbours[n]] = max(m_level[neighbours[n]], m_level[node] + 1);
+				updateNodes.push_back(neighbours[n]);
+			}
+
+			vector<t_dynamicEdge>().swap(m_out[node]);
+			vector<t_dynamicEdge>().swap(m_in[node]);
+
+			for (unsigned int s = 0; s < shortcuts[i].size(); s++)
+				addDynamicEdge(shortcuts[i][s].from, shortcuts[i][s].to,
+						shortcuts[i][s].cost, shortcuts[i][s].hops, node);
+			m_noShortcuts += shortcuts[i].size();
+		}
+
+		unsigned int kept = 0;
+		for (unsigned int i = 0; i < remaining.size(); i++)
+		{
+			if (!m_contracting[remaining[i]])
+				remaining[kept++] = remaining[i];
+		}
+		remaining.resize(kept);
+
+		for (unsigned int i = 0; i < selected.size(); i++)
+			m_contracting[selected[i]] = 0;
+
+		// new priorities of the neighbours of the contracted nodes
+		stageHopLimits((double) m_noDynamicEdges / max((unsigned int) remaining.size(), 1u),
+				priorityHopLimit, hopLimit);
+		sort(updateNodes.begin(), updateNodes.end());
+		updateNodes.erase(unique(updateNodes.begin(), updateNodes.end()),
+				updateNodes.end());
+		pool.parallelFor((updateNodes.size() + CONTRACTION_CHUNK - 1) / CONTRACTION_CHUNK,
+				updatePriorities);
+
+		m_noRounds++;
+	}
+
+	// frozen edges to compressed sparse row arrays
+	m_firstUp.assign(noNodes + 1, 0);
+	m_firstDown.assign(noNodes + 1, 0);
+	m_upNode.clear();
+	m_upCost.clear();
+	m_upMiddle.clear();
+	m_downNode.clear();
+	m_downCost.clear();
+	m_downMiddle.clear();
+
+	for (unsigned int node = 0; node < noNodes; node++)
+	{
+		for (unsigned int e = 0; e < up[node].size(); e++)
+		{
+			m_upNode.push_back(up[node][e].node);
+			m_upCost.push_back(up[node][e].cost);
+			m_upMiddle.push_back(up[node][e].middle);
+		}
+		for (unsigned int e = 0; e < down[node].size(); e++)
+		{
+			m_downNode.push_back(down[node][e].node);
+			m_downCost.push_back(down[node][e].cost);
+			m_downMiddle.push_back(down[node][e].middle);
+		}
+		m_firstUp[node + 1] = m_upNode.size();
+		m_firstDown[node + 1] = m_downNode.size();
+	}
+
+	m_out.clear();
+	m_in.clear();
+	m_edgePositions.clear();
+	for (unsigned int i = 0; i < m_freeStates.size(); i++)
+		delete m_freeStates[i];
+	m_freeStates.clear();
+}
+
+/**
+ * Function writes the hierarchy to a binary file
+ * @param const std::string& fileName : IN name of the file
+ * @returnvalue true if the file could be written
+ */
+bool CContractionHierarchy::save(const string& fileName) const
+{
+	if (m_pGraph == NULL)
+		return false;
+
+	ofstream file(fileName.c_str(), ios::binary);
+	if (!file)
+	{
+		cout << "ERROR : " << fileName << " could not be opened" << endl;
+		return false;
+	}
+
+	unsigned int version = CH_FILE_VERSION;
+	unsigned int noNodes = m_rank.size();
+	unsigned long long graphFingerprint = m_pGraph->getFingerprint();
+
+	file.write("NVCH", 4);
+	file.write((const char*) &version, sizeof(version));
+	file.write((const char*) &noNodes, sizeof(noNodes));
+	file.write((const char*) &graphFingerprint, sizeof(graphFingerprint));
+	file.write((const char*) &m_noShortcuts, sizeof(m_noShortcuts));
+
+	writeArray(file, m_rank);
+	writeArray(file, m_firstUp);
+	writeArray(file, m_upNode);
+	writeArray(file, m_upCost);
+	writeArray(file, m_upMiddle);
+	writeArray(file, m_firstDown);
+	writeArray(file, m_downNode);
+	writeArray(file, m_downCost);
+	writeArray(file, m_downMiddle);
+
+	return (bool) file;
+}
+
+/**
+ * Function reads a hierarchy from a binary file written by save()
+ * @param const std::string& fileName : IN name of the file
+ * @param const CRoadGraph& graph     : IN graph from which the hierarchy was built (same nodes in the same order, same edges and costs)
+ * @returnvalue true if the file could be read and belongs to the graph
+ */
+bool CContractionHierarchy::load(const string& fileName,
+		const CRoadGraph& graph)
+{
+	ifstream file(fileName.c_str(), ios::binary);
+	if (!file)
+	{
+		cout << "ERROR : " << fileName << " could not be opened" << endl;
+		return false;
+	}
+
+	char magic[4];
+	unsigned int version = 0, noNodes = 0, noShortcuts = 0;
+	unsigned long long graphFingerprint = 0;
+
+	file.read(magic, 4);
+	file.read((char*) &version, sizeof(version));
+	file.read((char*) &noNodes, sizeof(noNodes));
+	file.read((char*) &graphFingerprint, sizeof(graphFingerprint));
+	file.read((char*) &noShortcuts, sizeof(noShortcuts));
+
+	if (!file || string(magic, 4) != "NVCH" || version != CH_FILE_VERSION)
+	{
+		cout << "ERROR : " << fileName << " is no contraction hierarchy" << endl;
+		return false;
+	}
+
+	if (noNodes != graph.getNoNodes() || graphFingerprint != graph.getFingerprint())
+	{
+		cout << "ERROR : " << fileName << " was built from another graph" << endl;
+		return false;
+	}
+
+	bool ok = readArray(file, m_rank) && readArray(file, m_firstUp)
+			&& readArray(file, m_upNode) && readArray(file, m_upCost)
+			&& readArray(file, m_upMiddle) && readArray(file, m_firstDown)
+			&& readArray(file, m_downNode) && readArray(file, m_downCost)
+			&& readArray(file, m_downMiddle);
+
+	if (!ok || !checkArrays(noNodes))
+	{
+		cout << "ERROR : " << fileName << " is corrupted" << endl;
+		m_pGraph = NULL;
+		return false;
+	}
+
+	m_pGraph = &graph;
+	m_noShortcuts = noShortcuts;
+	m_noRounds = 0;
+	return true;
+}
+
+/**
+ * Function checks the arrays of the hierarchy read by load() : sizes, offsets, node numbers, ranks and
+ * costs, so neither a query nor the unpacking of a shortcut reads outside of the arrays or loops
+ * @param unsigned int noNodes : IN number of nodes of the graph
+ * @returnvalue true if the arrays are consistent
+ */
+bool CContractionHierarchy::checkArrays(unsigned int noNodes) const
+{
+	if (m_rank.size() != noNodes || m_firstUp.size() != noNodes + 1
+			|| m_firstDown.size() != noNodes + 1 || m_firstUp[0] != 0
+			|| m_firstDown[0] != 0 || m_firstUp.back() != m_upNode.size()
+			|| m_firstDown.back() != m_downNode.size()
+			|| m_upCost.size() != m_upNode.size()
+			|| m_upMiddle.size() != m_upNode.size()
+			|| m_downCost.size() != m_downNode.size()
+			|| m_downMiddle.size() != m_downNode.size())
+		return false;
+
+	// the ranks are a permutation of the nodes
+	vector<bool> isRankUsed(noNodes, false);
+	for (unsigned int node = 0; node < noNodes; node++)
+	{
+		if (m_rank[node] >= noNodes || isRankUsed[m_rank[node]])
+			return false;
+		isRankUsed[m_rank[node]] = true;
+	}
+
+	for (unsigned int list = 0; list < 2; list++)
+	{
+		const vector<unsigned int>& first = (list == 0) ? m_firstUp : m_firstDown;
+		const vector<unsigned int>& nodes = (list == 0) ? m_upNode : m_downNode;
+		const vector<double>& costs = (list == 0) ? m_upCost : m_downCost;
+		const vector<unsigned int>& middles = (list == 0) ? m_upMiddle : m_downMiddle;
+
+		for (unsigned int node = 0; node < noNodes; node++)
+		{
+			if (first[node] > first[node + 1])
+				return false;
+
+			for (unsigned int e = first[node]; e < first[node + 1]; e++)
+			{
+				unsigned int other = nodes[e];
+				unsigned int middle = middles[e];
+
+				// edges lead to higher ranked nodes, the middle of a shortcut is ranked lower than both ends
+				if (other >= noNodes || m_rank[other] <= m_rank[node]
+						|| !(costs[e] >= 0.0) || isinf(costs[e]))
+					return false;
+				if (middle != CH_NO_MIDDLE
+						&& (middle >= noNodes || m_rank[middle] >= m_rank[node]))
+					return false;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Function returns the graph of the hierarchy
+ * @param no parameters
+ * @returnvalue const CRoadGraph* : graph, NULL if the hierarchy is empty
+ */
+const CRoadGraph* CContractionHierarchy::getGraph() const
+{
+	return m_pGraph;
+}
+
+/**
+ * Function returns the number of shortcuts added by the contraction
+ * @param no parameters
+ * @returnvalue unsigned int : number of shortcuts
+ */
+unsigned int CContractionHierarchy::getNoShortcuts() const
+{
+	return m_noShortcuts;
+}
+
+/**
+ * Function returns the number of contraction rounds of the last build
+ * @param no parameters
+ * @returnvalue unsigned int : number of rounds, 0 if the hierarchy was loaded
+ */
+unsigned int CContractionHierarchy::getNoRounds() const
+{
+	return m_noRounds;
+}
+
+/**
+ * Function finds the shortcuts needed when a node is contracted
+ * @param unsigned int node                   : IN node to be contracted
+ * @param unsigned int hopLimit               : IN maximum number of edges of a witness path
+ * @param t_witnessState& state               : IN/OUT arrays of the witness searches
+ * @param std::vector<t_shortcut>* pShortcuts : OUT shortcuts, NULL if only the number is needed
+ * @param unsigned int& noHops                : OUT edges of the road graph replaced by the shortcuts
+ * @returnvalue unsigned int : number of shortcuts
+ */
+unsigned int CContractionHierarchy::findShortcuts(unsigned int node,
+		unsigned int hopLimit, t_witnessState& state,
+		vector<t_shortcut>* pShortcuts, unsigned int& noHops) const
+{
+	const vector<t_dynamicEdge>& in = m_in[node];
+	const vector<t_dynamicEdge>& out = m_out[node];
+	unsigned int noShortcuts = 0;
+
+	noHops = 0;
+
+	if (in.empty() || out.empty())
+		// no path leads through the node
+		return 0;
+
+	if (state.isTarget.size() < m_out.size())
+		state.isTarget.resize(m_out.size(), 0);
+
+	double maxOut = 0.0;
+	for (unsigned int o = 0; o < out.size(); o++)
+	{
+		maxOut = max(maxOut, out[o].cost);
+		state.isTarget[out[o].node] = 1;
+	}
+
+	for (unsigned int i = 0; i < in.size(); i++)
+	{
+		unsigned int from = in[i].node;
+
+		witnessSearch(from, node, in[i].cost + maxOut, hopLimit, out.size(), state);
+
+		for (unsigned int o = 0; o < out.size(); o++)
+		{
+			unsigned int to = out[o].node;
+			double viaCost = in[i].cost + out[o].cost;
+
+			if (to == from
+					|| (state.reached[to].stamp == state.queryStamp
+							&& state.reached[to].distance <= viaCost))
+				// no loop needed, or a witness path is not longer
+				continue;
+
+			noShortcuts++;
+			noHops += in[i].hops + out[o].hops;
+			if (pShortcuts != NULL)
+			{
+				t_shortcut shortcut;
+				shortcut.from = from;
+				shortcut.to = to;
+				shortcut.cost = viaCost;
+				shortcut.hops = in[i].hops + out[o].hops;
+				pShortcuts->push_back(shortcut);
+			}
+		}
+	}
+
+	for (unsigned int o = 0; o < out.size(); o++)
+		state.isTarget[out[o].node] = 0;
+
+	return noShortcuts;
+}
+
+/**
+ * Function runs a witness search : Dijkstra from a node, without the node to be contracted and the nodes
+ * selected before it in the round (m_contracting smaller than the one of the node), which are removed
+ * before the node is contracted
+ * @param unsigned int from        : IN start node
+ * @param unsigned int excluded    : IN node to be contracted
+ * @param double maxCost           : IN search stops at this distance
+ * @param unsigned int hopLimit    : IN nodes reached with this number of edges are not expanded
+ * @param unsigned int noTargets   : IN search stops when this number of targets (marked in the state) is settled
+ * @param t_witnessState& state    : IN/OUT arrays of the search, distances of the reached nodes
+ * @returnvalue void
+ */
+void CContractionHierarchy::witnessSearch(unsigned int from,
+		unsigned int excluded, double maxCost, unsigned int hopLimit,
+		unsigned int noTargets, t_witnessState& state) const
+{
+	if (state.reached.size() < m_out.size())
+	{
+		t_reachedNode unreached;
+		unreached.distance = 0.0;
+		unreached.stamp = 0;
+		unreached.hops = 0;
+		state.reached.resize(m_out.size(), unreached);
+	}
+
+	state.queryStamp++;
+	if (state.queryStamp == 0)
+	{
+		for (unsigned int node = 0; node < state.reached.size(); node++)
+			state.reached[node].stamp = 0;
+		state.queryStamp = 1;
+	}
+
+	greater<pair<double, unsigned int> > smallestOnTop;
+	unsigned int excludedPosition = m_contracting[excluded];
+
+	state.heap.clear();
+	state.reached[from].stamp = state.queryStamp;
+	state.reached[from].distance = 0.0;
+	state.reached[from].hops = 0;
+	state.heap.push_back(make_pair(0.0, from));
+
+	while (!state.heap.empty())
+	{
+		pair<double, unsigned int> top = state.heap.front();
+		pop_heap(state.heap.begin(), state.heap.end(), smallestOnTop);
+		state.heap.pop_back();
+
+		if (top.first > state.reached[top.second].distance)
+			// outdated entry
+			continue;
+
+		if (state.isTarget[top.second] && --noTargets == 0)
+			// distances of all targets are known
+			break;
+
+		if (state.reached[top.second].hops >= hopLimit)
+			// target at the hop limit, longer witness paths are not searched
+			continue;
+
+		unsigned int hops = state.reached[top.second].hops + 1;
+		const vector<t_dynamicEdge>& edges = m_out[top.second];
+		for (unsigned int e = 0; e < edges.size(); e++)
+		{
+			unsigned int node = edges[e].node;
+			double distance = top.first + edges[e].cost;
+			t_reachedNode& reached = state.reached[node];
+
+			if (distance > maxCost || node == excluded
+					|| (m_contracting[node] != 0 && m_contracting[node] < excludedPosition)
+					|| (reached.stamp == state.queryStamp && reached.distance <= distance))
+				// longer than the paths through the node, or removed, or no improvement
+				continue;
+
+			reached.stamp = state.queryStamp;
+			reached.distance = distance;
+			reached.hops = hops;
+			if (hops < hopLimit || state.isTarget[node])
+			// a node at the hop limit is not expanded, only its distance is needed
+			{
+				state.heap.push_back(make_pair(distance, node));
+				push_heap(state.heap.begin(), state.heap.end(), smallestOnTop);
+			}
+		}
+	}
+}
+
+/**
+ * Function calculates the priority of a node from the shortcuts per removed edge, the edges of the road
+ * graph replaced by the shortcuts per edge of the road graph replaced by the removed edges, the contracted
+ * neighbours and the level
+ * @param unsigned int node     : IN node
+ * @param unsigned int hopLimit : IN maximum number of edges of a witness path
+ * @param t_witnessState& state : IN/OUT arrays of the witness searches
+ * @returnvalue double : priority, smaller is contracted earlier
+ */
+double CContractionHierarchy::calculatePriority(unsigned int node,
+		unsigned int hopLimit, t_witnessState& state) const
+{
+	unsigned int addedHops, removedHops = 0;
+	unsigned int noAdded = findShortcuts(node, hopLimit, state, NULL, addedHops);
+	unsigned int noRemoved = m_in[node].size() + m_out[node].size();
+
+	for (unsigned int e = 0; e < m_in[node].size(); e++)
+		removedHops += m_in[node][e].hops;
+	for (unsigned int e = 0; e < m_out[node].size(); e++)
+		removedHops += m_out[node][e].hops;
+
+	return PRIORITY_EDGE_QUOTIENT * noAdded / max(noRemoved, 1u)
+			+ PRIORITY_HOP_QUOTIENT * addedHops / max(removedHops, 1u)
+			+ PRIORITY_CONTRACTED_NEIGHBOURS * m_contractedNeighbours[node]
+			+ PRIORITY_LEVEL * m_level[node];
+}
+
+/**
+ * Function adds an edge to the graph of the contraction, a parallel edge keeps the smaller cost
+ * @param unsigned int from   : IN start node
+ * @param unsigned int to     : IN end node
+ * @param double cost         : IN cost
+ * @param unsigned int hops   : IN edges of the road graph replaced by the edge
+ * @param unsigned int middle : IN contracted node of a shortcut, CH_NO_MIDDLE for a road
+ * @returnvalue void
+ */
+void CContractionHierarchy::addDynamicEdge(unsigned int from, unsigned int to,
+		double cost, unsigned int hops, unsigned int middle)
+{
+	vector<t_dynamicEdge>& out = m_out[from];
+	vector<t_dynamicEdge>& in = m_in[to];
+	t_edgePosition position;
+
+	position.out = out.size();
+	position.in = in.size();
+	pair<unordered_map<unsigned long long, t_edgePosition>::iterator, bool> inserted =
+			m_edgePositions.insert(make_pair(edgeKey(from, to), position));
+
+	if (!inserted.second)
+	// parallel edge
+	{
+		position = inserted.first->second;
+		if (cost < out[position.out].cost)
+		{
+			out[position.out].cost = in[position.in].cost = cost;
+			out[position.out].hops = in[position.in].hops = hops;
+			out[position.out].middle = in[position.in].middle = middle;
+		}
+		return;
+	}
+
+	t_dynamicEdge edge;
+	edge.cost = cost;
+	edge.middle = middle;
+	edge.hops = hops;
+	edge.node = to;
+	out.push_back(edge);
+	edge.node = from;
+	in.push_back(edge);
+	m_noDynamicEdges++;
+}
+
+/**
+ * Function removes an edge from the graph of the contraction, the last edges of both lists take its places
+ * @param unsigned int from : IN start node
+ * @param unsigned int to   : IN end node
+ * @returnvalue void
+ */
+void CContractionHierarchy::removeDynamicEdge(unsigned int from, unsigned int to)
+{
+	vector<t_dynamicEdge>& out = m_out[from];
+	vector<t_dynamicEdge>& in = m_in[to];
+	unordered_map<unsigned long long, t_edgePosition>::iterator found =
+			m_edgePositions.find(edgeKey(from, to));
+	t_edgePosition position = found->second;
+
+	m_edgePositions.erase(found);
+
+	if (position.out + 1 < out.size())
+	{
+		out[position.out] = out.back();
+		m_edgePositions[edgeKey(from, out[position.out].node)].out = position.out;
+	}
+	out.pop_back();
+
+	if (position.in + 1 < in.size())
+	{
+		in[position.in] = in.back();
+		m_edgePositions[edgeKey(in[position.in].node, to)].in = position.in;
+	}
+	in.pop_back();
+
+	m_noDynamicEdges--;
+}
+
+/**
+ * Function takes a free witness state (or creates one) for a task of the thread pool
+ * @param no parameters
+ * @returnvalue t_witnessState* : state, to be returned with releaseWitnessState()
+ */
+CContractionHierarchy::t_witnessState* CContractionHierarchy::acquireWitnessState()
+{
+	lock_guard<mutex> lock(m_stateMutex);
+
+	if (m_freeStates.empty())
+	{
+		t_witnessState* pState = new t_witnessState;
+		pState->queryStamp = 0;
+		return pState;
+	}
+
+	t_witnessState* pState = m_freeStates.back();
+	m_freeStates.pop_back();
+	return pState;
+}
+
+/**
+ * Function returns a witness state taken with acquireWitnessState()
+ * @param t_witnessState* pState : IN state
+ * @returnvalue void
+ */
+void CContractionHierarchy::releaseWitnessState(t_witnessState* pState)
+{
+	lock_guard<mutex> lock(m_stateMutex);
+	m_freeStates.push_back(pState);
+}
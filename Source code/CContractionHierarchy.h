@@ -0,0 +1,260 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CCONTRACTIONHIERARCHY.H
+ * Author          : George Sebastian
+ * Description     : CContractionHierarchy preprocesses a CRoadGraph for very fast shortest
+ *                   path queries (CHierarchySearch). The nodes are contracted one after
+ *                   the other, least important first : a contracted node is removed from
+ *                   the graph and shortcuts between its neighbours replace the shortest
+ *                   paths through it. A shortcut is not needed if a witness search finds a
+ *                   path of the same cost around the node.
+ *                   The order of a node (rank) is the round in which it was contracted; a
+ *                   query only follows edges to higher ranked nodes, from the start and
+ *                   from the destination, and settles a few hundred nodes.
+ *                   Each round contracts a set of independent nodes (no two are neighbours)
+ *                   whose priority is smaller than the priority of all their neighbours.
+ *                   Their witness searches and the priority updates run on a thread pool.
+ *                   The priority combines the shortcuts per removed edge, the same for the
+ *                   edges of the road graph replaced by them, the contracted neighbours and
+ *                   the level of the node. The witness searches are limited by a number of
+ *                   hops that grows with the mean degree of the remaining graph.
+ *                   The hierarchy can be saved to a binary file and loaded for the same
+ *                   graph, so the preprocessing is done only once.
+ ****************************************************************************/
+#ifndef CCONTRACTIONHIERARCHY_H
+#define CCONTRACTIONHIERARCHY_H
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <unordered_map>
+
+#include "CRoadGraph.h"
+
+#define CH_NO_MIDDLE 0xFFFFFFFFu      // edge of the road graph, not a shortcut
+
+class CContractionHierarchy
+{
+public:
+
+	/**
+	 * Constructor of class CContractionHierarchy, the hierarchy is empty
+	 * @param no parameters
+	 * @return no value
+	 */
+	CContractionHierarchy();
+
+	/**
+	 * Function contracts all nodes of a road graph and builds the upward and downward edges
+	 * @param const CRoadGraph& graph : IN graph, buildAdjacency() has to be called before; must live as long as the hierarchy
+	 * @param unsigned int noThreads  : IN threads for the witness searches, 0 for the number of cores
+	 * @returnvalue void
+	 */
+	void build(const CRoadGraph& graph, unsigned int noThreads = 0);
+
+	/**
+	 * Function writes the hierarchy to a binary file
+	 * @param const std::string& fileName : IN name of the file
+	 * @returnvalue true if the file could be written
+	 */
+	bool save(const std::string& fileName) const;
+
+	/**
+	 * Function reads a hierarchy from a binary file written by save()
+	 * @param const std::string& fileName : IN name of the file
+	 * @param const CRoadGraph& graph     : IN graph from which the hierarchy was built (same nodes in the same order, same edges and costs)
+	 * @returnvalue true if the file could be read and belongs to the graph
+	 */
+	bool load(const std::string& fileName, const CRoadGraph& graph);
+
+	/**
+	 * Function returns the graph of the hierarchy
+	 * @param no parameters
+	 * @returnvalue const CRoadGraph* : graph, NULL if the hierarchy is empty
+	 */
+	const CRoadGraph* getGraph() const;
+
+	/**
+	 * Function returns the number of shortcuts added by the contraction
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of shortcuts
+	 */
+	unsigned int getNoShortcuts() const;
+
+	/**
+	 * Function returns the number of contraction rounds of the last build
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of rounds, 0 if the hierarchy was loaded
+	 */
+	unsigned int getNoRounds() const;
+
+private:
+
+	friend class CHierarchySearch;
+
+	/*
+	 * edge of the graph during the contraction
+	 */
+	struct t_dynamicEdge
+	{
+		unsigned int node;      // target of an outgoing edge, source of an incoming edge
+		double cost;
+		unsigned int middle;    // contracted node of a shortcut, CH_NO_MIDDLE for a road
+		unsigned int hops;      // edges of the road graph replaced by the edge
+	};
+
+	/*
+	 * positions of an edge from -> to in m_out[from] and m_in[to]
+	 */
+	struct t_edgePosition
+	{
+		unsigned int out;
+		unsigned int in;
+	};
+
+	/*
+	 * shortcut found for a contracted node
+	 */
+	struct t_shortcut
+	{
+		unsigned int from;
+		unsigned int to;
+		double cost;
+		unsigned int hops;
+	};
+
+	/*
+	 * node reached by a witness search, valid if the stamp is the one of the search
+	 */
+	struct t_reachedNode
+	{
+		double distance;
+		unsigned int stamp;
+		unsigned int hops;      // edges of the path
+	};
+
+	/*
+	 * arrays of a witness search, one per thread
+	 */
+	struct t_witnessState
+	{
+		std::vector<t_reachedNode> reached;
+		std::vector<std::pair<double, unsigned int> > heap;
+		std::vector<unsigned char> isTarget;    // out-neighbours of the node to be contracted
+		unsigned int queryStamp;
+	};
+
+	/**
+	 * Function finds the shortcuts needed when a node is contracted
+	 * @param unsigned int node                   : IN node to be contracted
+	 * @param unsigned int hopLimit               : IN maximum number of edges of a witness path
+	 * @param t_witnessState& state               : IN/OUT arrays of the witness searches
+	 * @param std::vector<t_shortcut>* pShortcuts : OUT shortcuts, NULL if only the number is needed
+	 * @param unsigned int& noHops                : OUT edges of the road graph replaced by the shortcuts
+	 * @returnvalue unsigned int : number of shortcuts
+	 */
+	unsigned int findShortcuts(unsigned int node, unsigned int hopLimit,
+			t_witnessState& state, std::vector<t_shortcut>* pShortcuts,
+			unsigned int& noHops) const;
+
+	/**
+	 * Function runs a witness search : Dijkstra from a node, without the node to be contracted and the nodes
+	 * selected before it in the round (m_contracting smaller than the one of the node), which are removed
+	 * before the node is contracted
+	 * @param unsigned int from        : IN start node
+	 * @param unsigned int excluded    : IN node to be contracted
+	 * @param double maxCost           : IN search stops at this distance
+	 * @param unsigned int hopLimit    : IN nodes reached with this number of edges are not expanded
+	 * @param unsigned int noTargets   : IN search stops when this number of targets (marked in the state) is settled
+	 * @param t_witnessState& state    : IN/OUT arrays of the search, distances of the reached nodes
+	 * @returnvalue void
+	 */
+	void witnessSearch(unsigned int from, unsigned int excluded, double maxCost,
+			unsigned int hopLimit, unsigned int noTargets,
+			t_witnessState& state) const;
+
+	/**
+	 * Function calculates the priority of a node from the shortcuts per removed edge, the edges of the road
+	 * graph replaced by the shortcuts per edge of the road graph replaced by the removed edges, the contracted
+	 * neighbours and the level
+	 * @param unsigned int node     : IN node
+	 * @param unsigned int hopLimit : IN maximum number of edges of a witness path
+	 * @param t_witnessState& state : IN/OUT arrays of the witness searches
+	 * @returnvalue double : priority, smaller is contracted earlier
+	 */
+	double calculatePriority(unsigned int node, unsigned int hopLimit,
+			t_witnessState& state) const;
+
+	/**
+	 * Function adds an edge to the graph of the contraction, a parallel edge keeps the smaller cost
+	 * @param unsigned int from   : IN start node
+	 * @param unsigned int to     : IN end node
+	 * @param double cost         : IN cost
+	 * @param unsigned int hops   : IN edges of the road graph replaced by the edge
+	 * @param unsigned int middle : IN contracted node of a shortcut, CH_NO_MIDDLE for a road
+	 * @returnvalue void
+	 */
+	void addDynamicEdge(unsigned int from, unsigned int to, double cost,
+			unsigned int hops, unsigned int middle);
+
+	/**
+	 * Function removes an edge from the graph of the contraction, the last edges of both lists take its places
+	 * @param unsigned int from : IN start node
+	 * @param unsigned int to   : IN end node
+	 * @returnvalue void
+	 */
+	void removeDynamicEdge(unsigned int from, unsigned int to);
+
+	/**
+	 * Function takes a free witness state (or creates one) for a task of the thread pool
+	 * @param no parameters
+	 * @returnvalue t_witnessState* : state, to be returned with releaseWitnessState()
+	 */
+	t_witnessState* acquireWitnessState();
+
+	/**
+	 * Function returns a witness state taken with acquireWitnessState()
+	 * @param t_witnessState* pState : IN state
+	 * @returnvalue void
+	 */
+	void releaseWitnessState(t_witnessState* pState);
+
+	/**
+	 * Function checks the arrays of the hierarchy read by load() : sizes, offsets, node numbers, ranks and
+	 * costs, so neither a query nor the unpacking of a shortcut reads outside of the arrays or loops
+	 * @param unsigned int noNodes : IN number of nodes of the graph
+	 * @returnvalue true if the arrays are consistent
+	 */
+	bool checkArrays(unsigned int noNodes) const;
+
+	const CRoadGraph* m_pGraph;
+	unsigned int m_noShortcuts;
+	unsigned int m_noRounds;
+
+	// graph during the contraction
+	std::vector<std::vector<t_dynamicEdge> > m_out;
+	std::vector<std::vector<t_dynamicEdge> > m_in;
+	std::unordered_map<unsigned long long, t_edgePosition> m_edgePositions;    // from << 32 | to -> positions of the edge
+	unsigned int m_noDynamicEdges;
+	std::vector<unsigned int> m_contracting;    // position of the node in the current round from 1, 0 : not contracted in this round
+	std::vector<unsigned int> m_contractedNeighbours;
+	std::vector<unsigned int> m_level;          // longest chain of contracted nodes below the node
+	std::vector<t_witnessState*> m_freeStates;
+	std::mutex m_stateMutex;
+
+	// hierarchy : edges of node n to higher ranked nodes in compressed sparse row format
+	std::vector<unsigned int> m_rank;
+	std::vector<unsigned int> m_firstUp;        // outgoing : n -> m_upNode[e]
+	std::vector<unsigned int> m_upNode;
+	std::vector<double> m_upCost;
+	std::vector<unsigned int> m_upMiddle;
+	std::vector<unsigned int> m_firstDown;      // incoming : m_downNode[e] -> n
+	std::vector<unsigned int> m_downNode;
+	std::vector<double> m_downCost;
+	std::vector<unsigned int> m_downMiddle;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CCONTRACTIONHIERARCHY_H */
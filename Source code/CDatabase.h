@@ -7,12 +7,39 @@
  *                   Waypoint Database and POI Database
  *                   T1 -> Keytype of Map
  *                   T2 -> Type of the object stored in Map
+ *                   With DATABASE_ARENA the Map, its nodes and the strings of the objects
+ *                   (in a CStringPool of the Database) are taken from the slabs of a
+ *                   CSlabArena owned by the Database : adding an object costs no call of
+ *                   new, objects added one after another lie next to each other, and
+ *                   clearDb() deletes the slabs without destroying the nodes one by one,
+ *                   its cost depends on the number of slabs only. The keys of the Map
+ *                   point to the names in the pool, so no key holds memory of its own; the
+ *                   first NAME_PREFIX_CHARS characters are kept in the key as integers, most
+ *                   comparisons need not read the name.
+ *                   The objects of the Database, their copies by getDbContainer() and
+ *                   objects created with getStringPool() use the strings of the Database :
+ *                   they are valid until clearDb() or the destruction of the Database.
+ *                   addObjectToDb() and clearDb() are virtual : a derived Database with data
+ *                   of its own about the objects (e.g. the type index of CPoiDatabase)
+ *                   overrides them and keeps its data consistent with the Map, also when
+ *                   they are called through the base class.
  ****************************************************************************/
 #ifndef CDATABASE_H_
 #define CDATABASE_H_
 
 #include <iostream>
 #include <map>
+#include <functional>
+#include <new>
+#include <string.h>
+#include <stdint.h>
+
+#include "CSlabArena.h"
+#include "CSlabAllocator.h"
+#include "CStringPool.h"
+
+#define DATABASE_ARENA 1                 // 1 : Map, nodes and strings in the slabs of the Database, 0 : std::allocator and shared CStringPool
+#define NAME_PREFIX_CHARS 16             // characters of a name in the key of the Map, a multiple of 8
 
 template<class keyType, class objectType> // T1 -> Type of the Key in Map , T2 -> Type of the object stored in Map
 class CDatabase
@@ -20,7 +47,69 @@ class CDatabase
 
 private:
 
-	std::map<keyType, objectType> m_dbContainer;
+#if DATABASE_ARENA
+	/*
+	 * key of the Map : name in the pool of the Database
+	 */
+	struct t_key
+	{
+		uint64_t prefix[NAME_PREFIX_CHARS / 8]; // first characters, 8 per element (first one in the upper byte), filled up with '\0'
+		const char* text;
+	};
+
+	/*
+	 * order of the keys : order of the names, like std::string
+	 */
+	struct t_lessName
+	{
+		bool operator()(const t_key& left, const t_key& right) const
+		{
+			for (unsigned int i = 0; i < NAME_PREFIX_CHARS / 8; i++)
+			{
+				if (left.prefix[i] != right.prefix[i])
+					return left.prefix[i] < right.prefix[i];
+			}
+			// equal prefixes : the names are equal if they end within the prefix
+			return (left.prefix[NAME_PREFIX_CHARS / 8 - 1] & 0xff) != 0
+					&& strcmp(left.text + NAME_PREFIX_CHARS,
+							right.text + NAME_PREFIX_CHARS) < 0;
+		}
+	};
+
+	typedef std::map<t_key, objectType, t_lessName,
+			CSlabAllocator<std::pair<const t_key, objectType> > > t_container;
+
+	CSlabArena m_arena;                 // constructed before and destroyed after m_stringPool
+	CStringPool m_stringPool;           // names and descriptions of the objects, in m_arena
+#else
+	typedef keyType t_key;
+	typedef std::map<keyType, objectType> t_container;
+#endif
+
+	t_container* m_pDbContainer;        // with DATABASE_ARENA in m_arena and never destroyed, see clearDb()
+
+	/**
+	 * Function creates the empty Map
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void createContainer();
+
+	/**
+	 * Function returns the key of a name
+	 * @param const char* name : IN name, has to be valid as long as the key is used
+	 * @returnvalue t_key : key
+	 */
+	static t_key makeKey(const char* name);
+
+	/**
+	 * Function inserts a copy of an object, its strings are copied into the pool of the Database
+	 * @param objectType const& object                 : IN object, not yet in the Database
+	 * @param typename t_container::iterator position : IN first element after the object
+	 * @returnvalue void
+	 */
+	void insertObject(objectType const& object,
+			typename t_container::iterator position);
 
 public:
 
@@ -31,7 +120,7 @@ public:
 	 * @param objectType const& object : IN object to be added to Database
 	 * @returnvalue void
 	 */
-	void addObjectToDb(objectType const& object);
+	virtual void addObjectToDb(objectType const& object);
 
 	/**
 	 * Function prints the contents of Database
@@ -45,7 +134,7 @@ public:
 	 * @param no parameters
 	 * @returnvalue void
 	 */
-	void clearDb();
+	virtual void clearDb();
 
 	/**
 	 * Function checks for the Object having the same name as passed by the user in the Database
@@ -55,13 +144,80 @@ public:
 	 */
 	objectType* getPointerToObject(const std::string& name);
 
+	/**
+	 * Function returns the pool for the strings of objects to be added : they are added without copying their
+	 * strings, and have to be added before clearDb()
+	 * @param no parameters
+	 * @returnvalue CStringPool* : pool of the Database, NULL (shared pool) without DATABASE_ARENA
+	 */
+	CStringPool* getStringPool();
+
 	/**
 	 * Constructor for the CDatabase class
 	 * @param no parameters
 	 * @return no values
 	 */
+#if DATABASE_ARENA
+	CDatabase() :
+			m_stringPool(m_arena)
+	{
+		createContainer();
+	}
+
+	/**
+	 * Copy constructor for the CDatabase class, the objects and their strings are copied into the slabs of the new Database
+	 * @param const CDatabase& other : IN Database to be copied
+	 * @return no values
+	 */
+	CDatabase(const CDatabase& other) :
+			m_stringPool(m_arena)
+#else
 	CDatabase()
 	{
+		createContainer();
+	}
+
+	/**
+	 * Copy constructor for the CDatabase class
+	 * @param const CDatabase& other : IN Database to be copied
+	 * @return no values
+	 */
+	CDatabase(const CDatabase& other)
+#endif
+	{
+		createContainer();
+		for (typename t_container::const_iterator itr =
+				other.m_pDbContainer->begin(); itr != other.m_pDbContainer->end(); ++itr)
+			insertObject(itr->second, m_pDbContainer->end());
+	}
+
+	/**
+	 * Assignment operator for the CDatabase class, the objects are copied into this Database
+	 * @param const CDatabase& other : IN Database to be copied
+	 * @returnvalue CDatabase&
+	 */
+	CDatabase& operator=(const CDatabase& other)
+	{
+		if (this != &other)
+		{
+			clearDb();
+			for (typename t_container::const_iterator itr =
+					other.m_pDbContainer->begin(); itr != other.m_pDbContainer->end(); ++itr)
+				insertObject(itr->second, m_pDbContainer->end());
+		}
+		return *this;
+	}
+
+	/**
+	 * Destructor for the CDatabase class
+	 * @param no parameters
+	 * @return no values
+	 */
+	virtual ~CDatabase()
+	{
+#if !DATABASE_ARENA
+		delete m_pDbContainer;
+#endif
 	}
 
 	/**
@@ -72,6 +228,82 @@ public:
 	const void getDbContainer(std::map<keyType, objectType>& dbContainer) const;
 };
 
+/**
+ * Function creates the empty Map
+ * @param no parameters
+ * @returnvalue void
+ */
+template<class keyType, class objectType>
+void CDatabase<keyType, objectType>::createContainer()
+{
+#if DATABASE_ARENA
+	void* pStorage = m_arena.allocate(sizeof(t_container), alignof(t_container));
+	m_pDbContainer = new (pStorage) t_container(t_lessName(),
+			CSlabAllocator<std::pair<const t_key, objectType> >(&m_arena));
+#else
+	m_pDbContainer = new t_container;
+#endif
+}
+
+/**
+ * Function returns the key of a name
+ * @param const char* name : IN name, has to be valid as long as the key is used
+ * @returnvalue t_key : key
+ */
+template<class keyType, class objectType>
+typename CDatabase<keyType, objectType>::t_key CDatabase<keyType, objectType>::makeKey(
+		const char* name)
+{
+#if DATABASE_ARENA
+	t_key key;
+
+	for (unsigned int i = 0; i < NAME_PREFIX_CHARS / 8; i++)
+		key.prefix[i] = 0;
+	for (unsigned int i = 0; i < NAME_PREFIX_CHARS && name[i] != '\0'; i++)
+		key.prefix[i / 8] |= (uint64_t) (unsigned char) name[i] << (56 - 8 * (i % 8));
+	key.text = name;
+
+	return key;
+#else
+	return keyType(name);
+#endif
+}
+
+/**
+ * Function inserts a copy of an object, its strings are copied into the pool of the Database
+ * @param objectType const& object                 : IN object, not yet in the Database
+ * @param typename t_container::iterator position : IN first element after the object
+ * @returnvalue void
+ */
+template<class keyType, class objectType>
+void CDatabase<keyType, objectType>::insertObject(objectType const& object,
+		typename t_container::iterator position)
+{
+	objectType copy(object);
+
+#if DATABASE_ARENA
+	copy.internStrings(m_stringPool);   // the key points to the name in the pool
+#endif
+	m_pDbContainer->insert(position,
+			typename t_container::value_type(makeKey(copy.getNameChars()), copy));
+}
+
+/**
+ * Function returns the pool for the strings of objects to be added : they are added without copying their
+ * strings, and have to be added before clearDb()
+ * @param no parameters
+ * @returnvalue CStringPool* : pool of the Database, NULL (shared pool) without DATABASE_ARENA
+ */
+template<class keyType, class objectType>
+CStringPool* CDatabase<keyType, objectType>::getStringPool()
+{
+#if DATABASE_ARENA
+	return &m_stringPool;
+#else
+	return NULL;
+#endif
+}
+
 /**
  * Function adds object of type 'ObjectType' provided by user to Database, if Object is valid
  * If Object is already existing in Database, it will be overwritten and Warning is
@@ -85,17 +317,19 @@ void CDatabase<keyType, objectType>::addObjectToDb(objectType const& object)
 	if (object.getName() != "default city")
 	//  Object contains valid data, then added to the Database
 	{
-		typename std::map<keyType, objectType>::iterator itr;
-		itr = m_dbContainer.find(object.getName()); // checks if Object is already existing in Database
+		t_key key = makeKey(object.getNameChars());
+		typename t_container::iterator itr;
+		itr = m_pDbContainer->lower_bound(key); // checks if Object is already existing in Database
 
-		if (itr != m_dbContainer.end())
-			//	Object already exists in Database
+		if (itr != m_pDbContainer->end()
+				&& !m_pDbContainer->key_comp()(key, itr->first))
+			//	Object already exists in Database, the Map keeps it
 			std::cout << "WARNING : " << object.getName()
 					<< " already exists in  Database and will be overwritten ! "
 					<< std::endl;
-
-		m_dbContainer.insert(
-				pair<keyType, objectType>(object.getName(), object));
+		else
+			// inserted before the next name, no second search
+			insertObject(object, itr);
 
 	}
 	else
@@ -118,10 +352,10 @@ objectType* CDatabase<keyType, objectType>::getPointerToObject(
 {
 	objectType* pObject;
 
-	typename std::map<keyType, objectType>::iterator itr;
-	itr = m_dbContainer.find(name); // searches in STL MAP for a KEY equal to 'name'
+	typename t_container::iterator itr;
+	itr = m_pDbContainer->find(makeKey(name.c_str())); // searches in STL MAP for a KEY equal to 'name'
 
-	if (itr != m_dbContainer.end())
+	if (itr != m_pDbContainer->end())
 		// found in the Database
 		pObject = &(itr->second);
 	else
@@ -141,11 +375,11 @@ template<class keyType, class objectType>
 void CDatabase<keyType, objectType>::printDb()
 {
 
-	std::cout << "Database contains " << m_dbContainer.size() << " elements"
+	std::cout << "Database contains " << m_pDbContainer->size() << " elements"
 			<< std::endl << std::endl;
 
-	for (typename std::map<keyType, objectType>::const_iterator itr =
-			m_dbContainer.begin(); itr != m_dbContainer.end(); ++itr)
+	for (typename t_container::const_iterator itr =
+			m_pDbContainer->begin(); itr != m_pDbContainer->end(); ++itr)
 	{
 		std::cout << itr->second << std::endl; // operator overloaded for printing the objects
 	}
@@ -159,7 +393,15 @@ void CDatabase<keyType, objectType>::printDb()
 template<class keyType, class objectType>
 void CDatabase<keyType, objectType>::clearDb()
 {
-	m_dbContainer.clear();
+#if DATABASE_ARENA
+	// the Map, its nodes and the strings are in the slabs : all slabs are deleted at once, the nodes are
+	// not destroyed (the objects hold IDs of strings and numbers only), a new Map is created in the new slabs
+	m_arena.release();
+	m_stringPool.reset();
+	createContainer();
+#else
+	m_pDbContainer->clear();
+#endif
 }
 
 /**
@@ -171,7 +413,14 @@ template<class keyType, class objectType>
 const void CDatabase<keyType, objectType>::getDbContainer(
 		std::map<keyType, objectType>& dbContainer) const
 {
-	dbContainer = m_dbContainer;
+	dbContainer.clear();
+
+	// the objects are inserted in order, each one next to the previous one
+	for (typename t_container::const_iterator itr =
+			m_pDbContainer->begin(); itr != m_pDbContainer->end(); ++itr)
+		dbContainer.insert(dbContainer.end(),
+				std::pair<const keyType, objectType>(itr->second.getNameChars(),
+						itr->second));
 }
 
 #endif /* CDATABASE_H_ */
@@ -0,0 +1,322 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CDEVIATIONDETECTOR.CPP
+ * Author          : George Sebastian
+ * Description     : CDeviationDetector detects that a vehicle left its Route and suggests
+ *                   where to re-join it. The state changes only after some fixes in a row
+ *                   contradict it, so GPS jitter near the threshold raises no alerts.
+ *                   The heading of the vehicle is taken from positions at least 20 m apart,
+ *                   the heading of a standing vehicle is not used.
+ ****************************************************************************/
+#include <math.h>
+#include <algorithm>
+using namespace std;
+
+#include "CDeviationDetector.h"
+#include "CUnitVector.h"
+
+#define DEG_TO_RAD 0.017453292519943295
+#define MIN_HEADING_KM 0.02               // vehicle has to move 20 m for a new heading
+#define REJOIN_BLOCK_SEGMENTS 32          // segments per block of the re-join search
+
+/**
+ * Constructor of class CDeviationDetector
+ * @param double maxCrossTrackKm       : IN largest distance from the Route for a vehicle on the Route
+ * @param double maxHeadingDegree      : IN largest difference between the heading of the vehicle and the direction of the Route
+ * @param unsigned int noConfirmFixes  : IN number of fixes in a row needed to leave or re-join the Route (filters GPS jitter)
+ * @return no value
+ */
+CDeviationDetector::CDeviationDetector(double maxCrossTrackKm,
+		double maxHeadingDegree, unsigned int noConfirmFixes)
+{
+	m_maxCrossTrackKm = maxCrossTrackKm;
+	m_maxHeadingDegree = maxHeadingDegree;
+	m_noConfirmFixes = (noConfirmFixes > 0) ? noConfirmFixes : 1;
+	m_routeLengthKm = 0.0;
+	m_noSegmentTests = 0;
+	reset();
+}
+
+/**
+ * Function prepares the segments, their bounding boxes and the distances along the Route.
+ * Has to be called again after the Route was changed.
+ * @param const CRoute& route : IN Route of the vehicle
+ * @returnvalue void
+ */
+void CDeviationDetector::setRoute(const CRoute& route)
+{
+	CRouteView view = route.getRouteView();
+
+	m_matcher.setRoute(route);
+	m_latitude.clear();
+	m_longitude.clear();
+	m_startKm.clear();
+	m_directionEast.clear();
+	m_directionNorth.clear();
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		m_segmentBounds[i].clear();
+		m_blockBounds[i].clear();
+	}
+
+	CUnitVector previous;
+	m_routeLengthKm = 0.0;
+
+	for (CRouteView::const_iterator itr = view.begin(); itr != view.end();
+			++itr)
+	{
+		double latitude = itr->pWaypoint->getLatitude();
+		double longitude = itr->pWaypoint->getLongitude();
+		CUnitVector point = CUnitVector::fromLatLon(latitude, longitude);
+
+		if (!m_latitude.empty())
+			// same length as in CRouteMatcher, so the along track distances agree
+			m_routeLengthKm += previous.distanceTo(point);
+
+		m_latitude.push_back(latitude);
+		m_longitude.push_back(longitude);
+		m_startKm.push_back(m_routeLengthKm);
+		previous = point;
+	}
+
+	unsigned int noSegments = (m_latitude.size() > 1) ? m_latitude.size() - 1 : 0;
+
+	for (unsigned int s = 0; s < noSegments; s++)
+	{
+		double north = (m_latitude[s + 1] - m_latitude[s]);
+		double east = (m_longitude[s + 1] - m_longitude[s])
+				* cos((m_latitude[s] + m_latitude[s + 1]) * 0.5 * DEG_TO_RAD);
+		double length = sqrt(north * north + east * east);
+
+		// direction of a segment with identical end points is unknown, the heading is not tested there
+		m_directionEast.push_back((length > 0.0) ? east / length : 0.0);
+		m_directionNorth.push_back((length > 0.0) ? north / length : 0.0);
+
+		m_segmentBounds[0].push_back(min(m_latitude[s], m_latitude[s + 1]));
+		m_segmentBounds[1].push_back(max(m_latitude[s], m_latitude[s + 1]));
+		m_segmentBounds[2].push_back(min(m_longitude[s], m_longitude[s + 1]));
+		m_segmentBounds[3].push_back(max(m_longitude[s], m_longitude[s + 1]));
+
+		if (s % REJOIN_BLOCK_SEGMENTS == 0)
+		// first segment of a new block
+		{
+			for (unsigned int i = 0; i < 4; i++)
+				m_blockBounds[i].push_back(m_segmentBounds[i][s]);
+		}
+		else
+		{
+			m_blockBounds[0].back() = min(m_blockBounds[0].back(), m_segmentBounds[0][s]);
+			m_blockBounds[1].back() = max(m_blockBounds[1].back(), m_segmentBounds[1][s]);
+			m_blockBounds[2].back() = min(m_blockBounds[2].back(), m_segmentBounds[2][s]);
+			m_blockBounds[3].back() = max(m_blockBounds[3].back(), m_segmentBounds[3][s]);
+		}
+	}
+
+	reset();
+}
+
+/**
+ * Function processes a fix of the vehicle
+ * @param const t_gpsFix& fix      : IN position of the vehicle
+ * @param t_deviation& deviation   : OUT state of the vehicle and the re-join point if it is off route
+ * @returnvalue true if the Route has at least one segment and the fix could be processed
+ */
+bool CDeviationDetector::update(const t_gpsFix& fix, t_deviation& deviation)
+{
+	if (!m_matcher.match(CUnitVector::fromLatLon(fix.latitude, fix.longitude),
+			deviation.match))
+		return false;
+
+	// heading of the vehicle from the positions of the last 20 m or more
+	double kmPerDegreeLongitude = CUnitVector::KM_PER_DEGREE * cos(fix.latitude * DEG_TO_RAD);
+
+	if (m_hasHeadingPoint)
+	{
+		double north = (fix.latitude - m_headingLatitude) * CUnitVector::KM_PER_DEGREE;
+		double east = (fix.longitude - m_headingLongitude) * kmPerDegreeLongitude;
+		double length = sqrt(north * north + east * east);
+
+		if (length >= MIN_HEADING_KM)
+		{
+			m_headingEast = east / length;
+			m_headingNorth = north / length;
+			m_hasHeading = true;
+			m_headingLatitude = fix.latitude;
+			m_headingLongitude = fix.longitude;
+		}
+	}
+	else
+	{
+		m_hasHeadingPoint = true;
+		m_headingLatitude = fix.latitude;
+		m_headingLongitude = fix.longitude;
+	}
+
+	unsigned int segment = deviation.match.segment;
+	bool headingDeviates = false;
+	deviation.headingDegree = -1.0;
+
+	if (m_hasHeading
+			&& (m_directionEast[segment] != 0.0 || m_directionNorth[segment] != 0.0))
+	{
+		double cosine = m_headingEast * m_directionEast[segment]
+				+ m_headingNorth * m_directionNorth[segment];
+		deviation.headingDegree = acos(max(-1.0, min(1.0, cosine))) / DEG_TO_RAD;
+		headingDeviates = deviation.headingDegree > m_maxHeadingDegree;
+	}
+
+	bool deviates = fabs(deviation.match.crossTrackKm) > m_maxCrossTrackKm
+			|| headingDeviates;
+
+	deviation.changed = false;
+
+	if (deviates != m_offRoute)
+	// fix contradicts the current state
+	{
+		m_noContraryFixes++;
+
+		if (m_noContraryFixes >= m_noConfirmFixes)
+		{
+			m_offRoute = deviates;
+			m_noContraryFixes = 0;
+			deviation.changed = true;
+		}
+	}
+	else
+		m_noContraryFixes = 0;
+
+	if (!m_offRoute && !deviates)
+		m_progressSegment = segment;
+
+	deviation.offRoute = m_offRoute;
+
+	if (m_offRoute)
+		findRejoin(fix.latitude, fix.longitude, m_progressSegment,
+				deviation.rejoin);
+
+	return true;
+}
+
+/**
+ * Function searches the nearest point of the Route at or after a segment
+ * @param double latitude          : IN latitude of the vehicle
+ * @param double longitude         : IN longitude of the vehicle
+ * @param unsigned int firstSegment : IN first segment which may be re-joined
+ * @param t_rejoinPoint& rejoin    : OUT nearest point
+ * @returnvalue true if the Route has a segment at or after firstSegment
+ */
+bool CDeviationDetector::findRejoin(double latitude, double longitude,
+		unsigned int firstSegment, t_rejoinPoint& rejoin)
+{
+	unsigned int noSegments = m_segmentBounds[0].size();
+
+	if (firstSegment >= noSegments)
+		return false;
+
+	double kmPerDegreeLongitude = CUnitVector::KM_PER_DEGREE * cos(latitude * DEG_TO_RAD);
+	double bestSquaredKm = -1.0;
+
+	for (unsigned int block = firstSegment / REJOIN_BLOCK_SEGMENTS;
+			block < m_blockBounds[0].size(); block++)
+	{
+		if (bestSquaredKm >= 0.0
+				&& squaredBoxDistance(block, m_blockBounds, latitude, longitude,
+						kmPerDegreeLongitude) >= bestSquaredKm)
+			// no segment of the block can be closer
+			continue;
+
+		unsigned int first = max(firstSegment, block * REJOIN_BLOCK_SEGMENTS);
+		unsigned int last = min(noSegments, (block + 1) * REJOIN_BLOCK_SEGMENTS);
+
+		for (unsigned int s = first; s < last; s++)
+		{
+			if (bestSquaredKm >= 0.0
+					&& squaredBoxDistance(s, m_segmentBounds, latitude, longitude,
+							kmPerDegreeLongitude) >= bestSquaredKm)
+				continue;
+
+			m_noSegmentTests++;
+
+			// projection onto the segment in the local plane around the vehicle
+			double ax = (m_longitude[s] - longitude) * kmPerDegreeLongitude;
+			double ay = (m_latitude[s] - latitude) * CUnitVector::KM_PER_DEGREE;
+			double dx = (m_longitude[s + 1] - longitude) * kmPerDegreeLongitude - ax;
+			double dy = (m_latitude[s + 1] - latitude) * CUnitVector::KM_PER_DEGREE - ay;
+			double lengthSquared = dx * dx + dy * dy;
+			double t = (lengthSquared > 0.0) ?
+					-(ax * dx + ay * dy) / lengthSquared : 0.0;
+			t = max(0.0, min(1.0, t));
+
+			double px = ax + t * dx, py = ay + t * dy;
+			double squaredKm = px * px + py * py;
+
+			if (bestSquaredKm < 0.0 || squaredKm < bestSquaredKm)
+			{
+				bestSquaredKm = squaredKm;
+				rejoin.segment = s;
+				rejoin.fraction = t;
+			}
+		}
+	}
+
+	unsigned int s = rejoin.segment;
+	double t = rejoin.fraction;
+
+	rejoin.latitude = m_latitude[s] + t * (m_latitude[s + 1] - m_latitude[s]);
+	rejoin.longitude = m_longitude[s] + t * (m_longitude[s + 1] - m_longitude[s]);
+	rejoin.alongTrackKm = m_startKm[s] + t * (m_startKm[s + 1] - m_startKm[s]);
+	rejoin.distanceKm = sqrt(bestSquaredKm);
+	rejoin.remainingKm = m_routeLengthKm - rejoin.alongTrackKm;
+	return true;
+}
+
+/**
+ * Function forgets the previous fixes, e.g. for a new trip on the same Route
+ * @param no parameters
+ * @returnvalue void
+ */
+void CDeviationDetector::reset()
+{
+	m_offRoute = false;
+	m_noContraryFixes = 0;
+	m_progressSegment = 0;
+	m_hasHeadingPoint = false;
+	m_hasHeading = false;
+	m_headingLatitude = 0.0;
+	m_headingLongitude = 0.0;
+	m_headingEast = 0.0;
+	m_headingNorth = 0.0;
+	m_matcher.resetHint();
+}
+
+/**
+ * Function returns the number of segments tested by the re-join searches so far (for benchmarks)
+ * @param no parameters
+ * @returnvalue unsigned long long : number of tested segments
+ */
+unsigned long long CDeviationDetector::getNoSegmentTests() const
+{
+	return m_noSegmentTests;
+}
+
+/**
+ * Function returns a lower bound of the squared distance in km^2 from the vehicle to a bounding box
+ * @param unsigned int box   : IN index of the box in the given arrays
+ * @param const std::vector<double>* bounds : IN min latitude, max latitude, min longitude, max longitude arrays
+ * @param double latitude    : IN latitude of the vehicle
+ * @param double longitude   : IN longitude of the vehicle
+ * @param double kmPerDegreeLongitude : IN scale of the local plane around the vehicle
+ * @returnvalue double : squared distance, 0 inside of the box
+ */
+double CDeviationDetector::squaredBoxDistance(unsigned int box,
+		const vector<double>* bounds, double latitude, double longitude,
+		double kmPerDegreeLongitude)
+{
+	double north = max(0.0, max(bounds[0][box] - latitude, latitude - bounds[1][box]))
+			* CUnitVector::KM_PER_DEGREE;
+	double east = max(0.0, max(bounds[2][box] - longitude, longitude - bounds[3][box]))
+			* kmPerDegreeLongitude;
+
+	return north * north + east * east;
+}
@@ -0,0 +1,156 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CDEVIATIONDETECTOR.H
+ * Author          : George Sebastian
+ * Description     : CDeviationDetector detects that a vehicle left its Route and suggests
+ *                   where to re-join it. Each fix is projected onto the Route with
+ *                   CRouteMatcher; the vehicle is off route when its cross track distance
+ *                   or the difference between its heading and the direction of the Route
+ *                   exceeds a threshold for some fixes in a row.
+ *                   The re-join point is the nearest point of the Route downstream of the
+ *                   last position on the Route. The segments are grouped in blocks with a
+ *                   bounding box, blocks and segments which cannot be closer than the best
+ *                   point found so far are skipped, so the search costs a few segment
+ *                   tests per fix and can run on every fix.
+ *                   Distances of the re-join search are calculated in a local plane around
+ *                   the vehicle, the Route must not cross the date line.
+ ****************************************************************************/
+#ifndef CDEVIATIONDETECTOR_H
+#define CDEVIATIONDETECTOR_H
+
+#include <vector>
+
+#include "CRoute.h"
+#include "CRouteMatcher.h"
+#include "CPositionSensor.h"
+
+/*
+ * suggested point to re-join the Route
+ */
+struct t_rejoinPoint
+{
+	unsigned int segment;   // segment from Route element 'segment' to element 'segment' + 1
+	double fraction;        // along track fraction on the segment
+	double latitude;
+	double longitude;
+	double alongTrackKm;    // distance in km from the start of the Route to the re-join point
+	double distanceKm;      // straight distance in km from the vehicle to the re-join point
+	double remainingKm;     // distance in km along the Route from the re-join point to the end
+};
+
+/*
+ * result of a fix
+ */
+struct t_deviation
+{
+	bool offRoute;            // vehicle is off its Route
+	bool changed;             // vehicle left or re-joined the Route with this fix
+	t_routeMatch match;       // projection of the fix onto the Route
+	double headingDegree;     // difference between the heading of the vehicle and the Route, -1 if unknown
+	t_rejoinPoint rejoin;     // only valid if offRoute
+};
+
+class CDeviationDetector
+{
+public:
+
+	/**
+	 * Constructor of class CDeviationDetector
+	 * @param double maxCrossTrackKm       : IN largest distance from the Route for a vehicle on the Route
+	 * @param double maxHeadingDegree      : IN largest difference between the heading of the vehicle and the direction of the Route
+	 * @param unsigned int noConfirmFixes  : IN number of fixes in a row needed to leave or re-join the Route (filters GPS jitter)
+	 * @return no value
+	 */
+	CDeviationDetector(double maxCrossTrackKm = 0.05,
+			double maxHeadingDegree = 60.0, unsigned int noConfirmFixes = 3);
+
+	/**
+	 * Function prepares the segments, their bounding boxes and the distances along the Route.
+	 * Has to be called again after the Route was changed.
+	 * @param const CRoute& route : IN Route of the vehicle
+	 * @returnvalue void
+	 */
+	void setRoute(const CRoute& route);
+
+	/**
+	 * Function processes a fix of the vehicle
+	 * @param const t_gpsFix& fix      : IN position of the vehicle
+	 * @param t_deviation& deviation   : OUT state of the vehicle and the re-join point if it is off route
+	 * @returnvalue true if the Route has at least one segment and the fix could be processed
+	 */
+	bool update(const t_gpsFix& fix, t_deviation& deviation);
+
+	/**
+	 * Function searches the nearest point of the Route at or after a segment
+	 * @param double latitude          : IN latitude of the vehicle
+	 * @param double longitude         : IN longitude of the vehicle
+	 * @param unsigned int firstSegment : IN first segment which may be re-joined
+	 * @param t_rejoinPoint& rejoin    : OUT nearest point
+	 * @returnvalue true if the Route has a segment at or after firstSegment
+	 */
+	bool findRejoin(double latitude, double longitude, unsigned int firstSegment,
+			t_rejoinPoint& rejoin);
+
+	/**
+	 * Function forgets the previous fixes, e.g. for a new trip on the same Route
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void reset();
+
+	/**
+	 * Function returns the number of segments tested by the re-join searches so far (for benchmarks)
+	 * @param no parameters
+	 * @returnvalue unsigned long long : number of tested segments
+	 */
+	unsigned long long getNoSegmentTests() const;
+
+private:
+
+	/**
+	 * Function returns a lower bound of the squared distance in km^2 from the vehicle to a bounding box
+	 * @param unsigned int box   : IN index of the box in the given arrays
+	 * @param const std::vector<double>* bounds : IN min latitude, max latitude, min longitude, max longitude arrays
+	 * @param double latitude    : IN latitude of the vehicle
+	 * @param double longitude   : IN longitude of the vehicle
+	 * @param double kmPerDegreeLongitude : IN scale of the local plane around the vehicle
+	 * @returnvalue double : squared distance, 0 inside of the box
+	 */
+	static double squaredBoxDistance(unsigned int box,
+			const std::vector<double>* bounds, double latitude,
+			double longitude, double kmPerDegreeLongitude);
+
+	CRouteMatcher m_matcher;
+	double m_maxCrossTrackKm;
+	double m_maxHeadingDegree;
+	unsigned int m_noConfirmFixes;
+
+	// points of the Route, segment s goes from point s to point s + 1
+	std::vector<double> m_latitude;
+	std::vector<double> m_longitude;
+	std::vector<double> m_startKm;           // distance from the start of the Route to the point
+
+	// segments, one array per attribute
+	std::vector<double> m_directionEast;     // unit direction of the segment in the local plane
+	std::vector<double> m_directionNorth;
+	std::vector<double> m_segmentBounds[4];  // bounding box of each segment : min/max latitude, min/max longitude
+	std::vector<double> m_blockBounds[4];    // bounding box of each block of segments
+	double m_routeLengthKm;
+
+	// state of the vehicle
+	bool m_offRoute;
+	unsigned int m_noContraryFixes;          // fixes in a row which contradict the current state
+	unsigned int m_progressSegment;          // segment of the last match on the Route
+	bool m_hasHeadingPoint;
+	double m_headingLatitude;                // previous position used for the heading
+	double m_headingLongitude;
+	double m_headingEast;                    // unit heading of the vehicle in the local plane
+	double m_headingNorth;
+	bool m_hasHeading;
+	unsigned long long m_noSegmentTests;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CDEVIATIONDETECTOR_H */
@@ -0,0 +1,135 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CDISTANCEMATRIX.H
+ * Author          : George Sebastian
+ * Description     : CDistanceMatrix computes the costs from every source to every target
+ *                   (many to many) and stores them row major : cost(source i, target j) is
+ *                   element i * noTargets + j. Sources and targets are Waypoints or POIs.
+ *                   Two modes :
+ *                   - great circle distance in km, computed from the unit vectors of the
+ *                     positions kept in separate x, y and z arrays (structure of arrays) so
+ *                     that the inner loop over the targets is vectorised by the compiler;
+ *                     the targets are processed in tiles which stay in the cache while
+ *                     all rows of a task use them
+ *                   - any cost given by a function, e.g. travel distances or times
+ *                   The rows are distributed in blocks over a thread pool.
+ ****************************************************************************/
+#ifndef CDISTANCEMATRIX_H
+#define CDISTANCEMATRIX_H
+
+#include <vector>
+#include <functional>
+
+#include "CWaypoint.h"
+#include "CWorkStealingPool.h"
+
+class CDistanceMatrix
+{
+public:
+
+	/*
+	 * cost between a source and a target, called from several threads at the same time
+	 */
+	typedef std::function<double(const CWaypoint& source, const CWaypoint& target)> t_costFunction;
+
+	/**
+	 * Constructor of class CDistanceMatrix, starts the thread pool
+	 * @param unsigned int noThreads : IN number of threads computing the rows, 0 for the number of cores
+	 * @return no value
+	 */
+	CDistanceMatrix(unsigned int noThreads = 0);
+
+	/**
+	 * Function computes the great circle distances from all sources to all targets
+	 * @param const std::vector<const CWaypoint*>& sources : IN sources (rows), Waypoints or POIs
+	 * @param const std::vector<const CWaypoint*>& targets : IN targets (columns), Waypoints or POIs
+	 * @returnvalue void
+	 */
+	void compute(const std::vector<const CWaypoint*>& sources,
+			const std::vector<const CWaypoint*>& targets);
+
+	/**
+	 * Function computes the costs from all sources to all targets with a cost function
+	 * @param const std::vector<const CWaypoint*>& sources : IN sources (rows), Waypoints or POIs
+	 * @param const std::vector<const CWaypoint*>& targets : IN targets (columns), Waypoints or POIs
+	 * @param const t_costFunction& cost                   : IN cost function, must be thread safe
+	 * @returnvalue void
+	 */
+	void compute(const std::vector<const CWaypoint*>& sources,
+			const std::vector<const CWaypoint*>& targets, const t_costFunction& cost);
+
+	/**
+	 * Function returns the cost from a source to a target
+	 * @param unsigned int source : IN row
+	 * @param unsigned int target : IN column
+	 * @returnvalue double : cost, great circle distance in km
+	 */
+	double get(unsigned int source, unsigned int target) const
+	{
+		return m_matrix[source * m_noTargets + target];
+	}
+
+	/**
+	 * Function returns the whole matrix
+	 * @param no parameters
+	 * @returnvalue const std::vector<double>& : costs, row major, getNoSources() x getNoTargets()
+	 */
+	const std::vector<double>& getMatrix() const;
+
+	/**
+	 * Function moves the matrix out of the object (no copy), the object is empty afterwards
+	 * @param std::vector<double>& matrix : OUT costs, row major
+	 * @returnvalue void
+	 */
+	void takeMatrix(std::vector<double>& matrix);
+
+	/**
+	 * Function returns the number of rows
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of sources
+	 */
+	unsigned int getNoSources() const;
+
+	/**
+	 * Function returns the number of columns
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of targets
+	 */
+	unsigned int getNoTargets() const;
+
+private:
+
+	/**
+	 * Function stores the unit vectors of Waypoints in x, y and z arrays
+	 * @param const std::vector<const CWaypoint*>& waypoints : IN Waypoints
+	 * @param std::vector<double>& x : OUT x components
+	 * @param std::vector<double>& y : OUT y components
+	 * @param std::vector<double>& z : OUT z components
+	 * @returnvalue void
+	 */
+	static void toUnitVectors(const std::vector<const CWaypoint*>& waypoints,
+			std::vector<double>& x, std::vector<double>& y, std::vector<double>& z);
+
+	/**
+	 * Function computes the great circle distances of a block of rows, tile by tile of the targets
+	 * @param unsigned int firstRow : IN first row of the block
+	 * @param unsigned int lastRow  : IN row after the block
+	 * @returnvalue void
+	 */
+	void computeBlock(unsigned int firstRow, unsigned int lastRow);
+
+	CWorkStealingPool m_pool;
+
+	unsigned int m_noSources;
+	unsigned int m_noTargets;
+	std::vector<double> m_matrix;
+
+	// unit vectors of sources and targets, great circle mode only
+	std::vector<double> m_sourceX, m_sourceY, m_sourceZ;
+	std::vector<double> m_targetX, m_targetY, m_targetZ;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CDISTANCEMATRIX_H */
@@ -6,6 +6,7 @@
  * Description     : CGPSSensor class is used to get the current position of user
  ****************************************************************************/
 #include <iostream>
+#include <chrono>
 using namespace std;
 
 #include "CGPSSensor.h"
@@ -30,6 +31,28 @@ CWaypoint CGPSSensor::getCurrentPosition()
 	return currentPosition;
 }
 
+/**
+ * Function reads the next position entered by the user, timestamped with the current UTC time of day
+ * @param t_gpsFix& fix : OUT next fix
+ * @returnvalue true if a valid position was entered, false at the end of the input or for an invalid position
+ */
+bool CGPSSensor::getNextFix(t_gpsFix& fix)
+{
+	CWaypoint currentPosition = getCurrentPosition();
+
+	if (!cin || currentPosition.getName() == "default city")
+		// end of the input or invalid latitude/longitude
+		return false;
+
+	double secondsSinceEpoch = chrono::duration<double>(
+			chrono::system_clock::now().time_since_epoch()).count();
+
+	fix.latitude = currentPosition.getLatitude();
+	fix.longitude = currentPosition.getLongitude();
+	fix.timestamp = secondsSinceEpoch - 86400.0 * (long long) (secondsSinceEpoch / 86400.0);
+	return true;
+}
+
 /**
  * Constructor of class CGPSSensor
  * @param no parameters
@@ -9,8 +9,9 @@
 #define CGPSSENSOR_H
 
 #include "CWaypoint.h"
+#include "CPositionSensor.h"
 
-class CGPSSensor
+class CGPSSensor: public CPositionSensor
 {
 private:
 public:
@@ -22,12 +23,19 @@ public:
 	 */
 	CGPSSensor();
 
+	/**
+	 * Function reads the next position entered by the user, timestamped with the current UTC time of day
+	 * @param t_gpsFix& fix : OUT next fix
+	 * @returnvalue true if a valid position was entered, false at the end of the input or for an invalid position
+	 */
+	virtual bool getNextFix(t_gpsFix& fix);
+
 	/**
 	 *Function to get the current position of the user
 	 *@param no parameters
 	 *@returnvalue CWaypoint : object of type CWaypoint
 	 */
-	CWaypoint getCurrentPosition();
+	virtual CWaypoint getCurrentPosition();
 };
 /********************
  **  CLASS END
@@ -0,0 +1,453 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CGEOFENCEINDEX.CPP
+ * Author          : George Sebastian
+ * Description     : CGeofenceIndex raises alerts when vehicles enter or leave zones
+ *                   (geofences) : circles, e.g. around the POIs of a type in the POI
+ *                   Database, or arbitrary polygons.
+ *                   The fences are registered in a grid of cells (about 1 km), each fix is
+ *                   only tested against the fences of the cell of the vehicle. The grid is
+ *                   stored in CSR format (one array of fences sorted by cell) and only
+ *                   looked up when a vehicle moves to another cell.
+ *                   Circles are tested with squared distances, polygons with a bounding
+ *                   box, ray casting and the distance to the nearest edge.
+ ****************************************************************************/
+#include <iostream>
+#include <math.h>
+#include <algorithm>
+using namespace std;
+
+#include "CGeofenceIndex.h"
+#include "CUnitVector.h"
+
+#define METRES_PER_DEGREE (1000.0 * CUnitVector::KM_PER_DEGREE)
+#define DEG_TO_RAD 0.017453292519943295
+
+/**
+ * Constructor of class CGeofenceIndex
+ * @param double hysteresisMetres : IN distance inside/outside of the border needed to enter/leave a fence
+ * @param double dwellSeconds     : IN time inside of a fence after which a dwell event is raised
+ * @param double cellMetres       : IN size of the grid cells
+ * @return no value
+ */
+CGeofenceIndex::CGeofenceIndex(double hysteresisMetres, double dwellSeconds,
+		double cellMetres)
+{
+	m_hysteresisMetres = (hysteresisMetres > 0.0) ? hysteresisMetres : 0.0;
+	m_dwellSeconds = dwellSeconds;
+	m_cellDegree = ((cellMetres > 10.0) ? cellMetres : 10.0) / METRES_PER_DEGREE;
+	m_gridValid = false;
+	m_noFenceTests = 0;
+	m_cornerBegin.push_back(0);
+}
+
+/**
+ * Function adds a circular fence
+ * @param const std::string& name : IN name of the fence
+ * @param double latitude         : IN latitude of the centre
+ * @param double longitude        : IN longitude of the centre
+ * @param double radiusMetres     : IN radius
+ * @returnvalue unsigned int : number of the fence
+ */
+unsigned int CGeofenceIndex::addCircle(const string& name, double latitude,
+		double longitude, double radiusMetres)
+{
+	unsigned int fence = addFence(name, latitude, longitude, radiusMetres);
+
+	m_radiusMetres.push_back(radiusMetres);
+	m_cornerBegin.push_back(m_cornerX.size());
+	return fence;
+}
+
+/**
+ * Function adds a polygonal fence
+ * @param const std::string& name               : IN name of the fence
+ * @param const std::vector<CWaypoint>& corners : IN corners of the polygon (at least 3), closed automatically
+ * @returnvalue unsigned int : number of the fence, GEOFENCE_INVALID if the polygon has less than 3 corners
+ */
+unsigned int CGeofenceIndex::addPolygon(const string& name,
+		const vector<CWaypoint>& corners)
+{
+	if (corners.size() < 3)
+	{
+		cout << "ERROR : polygon " << name << " needs at least 3 corners"
+				<< endl;
+		return GEOFENCE_INVALID;
+	}
+
+	// reference point in the middle of the corners
+	double latitude = 0.0, longitude = 0.0;
+	for (unsigned int i = 0; i < corners.size(); i++)
+	{
+		latitude += corners[i].getLatitude();
+		longitude += corners[i].getLongitude();
+	}
+	latitude /= corners.size();
+	longitude /= corners.size();
+
+	double metresPerDegreeLongitude = METRES_PER_DEGREE
+			* cos(latitude * DEG_TO_RAD);
+	double extentMetres = 0.0;
+
+	for (unsigned int i = 0; i < corners.size(); i++)
+	{
+		double x = (corners[i].getLongitude() - longitude)
+				* metresPerDegreeLongitude;
+		double y = (corners[i].getLatitude() - latitude) * METRES_PER_DEGREE;
+
+		m_cornerX.push_back(x);
+		m_cornerY.push_back(y);
+		extentMetres = max(extentMetres, sqrt(x * x + y * y));
+	}
+
+	unsigned int fence = addFence(name, latitude, longitude, extentMetres);
+
+	m_radiusMetres.push_back(-1.0);
+	m_cornerBegin.push_back(m_cornerX.size());
+	return fence;
+}
+
+/**
+ * Function adds a circular fence around each POI of a type in the POI Database
+ * @param const CPoiDatabase& poiDatabase : IN POI Database
+ * @param CPOI::t_poi type                : IN type of the POIs, e.g. GASSTATION
+ * @param double radiusMetres             : IN radius of the fences
+ * @returnvalue unsigned int : number of added fences
+ */
+unsigned int CGeofenceIndex::addPoiFences(const CPoiDatabase& poiDatabase,
+		CPOI::t_poi type, double radiusMetres)
+{
+	const vector<const CPOI*>& pois = poiDatabase.getPoisOfType(type);
+	string name, description;
+	double latitude, longitude;
+	CPOI::t_poi poiType;
+
+	for (unsigned int i = 0; i < pois.size(); i++)
+	{
+		pois[i]->getAllDataByReference(name, latitude, longitude, poiType,
+				description);
+		addCircle(name, latitude, longitude, radiusMetres);
+	}
+	return pois.size();
+}
+
+/**
+ * Function processes a fix of a vehicle and appends the raised events
+ * @param unsigned int vehicle                  : IN number of the vehicle (any number, the state is created on the first fix)
+ * @param const t_gpsFix& fix                   : IN position of the vehicle
+ * @param std::vector<t_geofenceEvent>& events  : OUT raised events are appended
+ * @returnvalue void
+ */
+void CGeofenceIndex::update(unsigned int vehicle, const t_gpsFix& fix,
+		vector<t_geofenceEvent>& events)
+{
+	if (!m_gridValid)
+		buildGrid();
+
+	unordered_map<unsigned int, unsigned int>::const_iterator slot =
+			m_vehicleSlots.find(vehicle);
+
+	if (slot == m_vehicleSlots.end())
+	// first fix of the vehicle, its state is appended to the dense array
+	{
+		t_vehicleState newVehicle;
+		newVehicle.hasCell = false;
+		newVehicle.cell = 0;
+		newVehicle.candidateBegin = 0;
+		newVehicle.candidateEnd = 0;
+		slot = m_vehicleSlots.insert(
+				make_pair(vehicle, (unsigned int) m_vehicles.size())).first;
+		m_vehicles.push_back(newVehicle);
+	}
+
+	t_vehicleState& state = m_vehicles[slot->second];
+	long long cell = getCell(fix.latitude, fix.longitude);
+
+	if (!state.hasCell || cell != state.cell)
+	// vehicle moved to another cell, looking up its fences
+	{
+		unordered_map<long long, unsigned int>::const_iterator itr =
+				m_cellIndex.find(cell);
+
+		state.hasCell = true;
+		state.cell = cell;
+		state.candidateBegin = 0;
+		state.candidateEnd = 0;
+
+		if (itr != m_cellIndex.end())
+		{
+			state.candidateBegin = m_cellStart[itr->second];
+			state.candidateEnd = m_cellStart[itr->second + 1];
+		}
+	}
+
+	t_geofenceEvent event;
+	event.vehicle = vehicle;
+	event.timestamp = fix.timestamp;
+
+	for (unsigned int i = 0; i < state.inside.size(); i++)
+		state.inside[i].stillInCell = false;
+
+	for (unsigned int c = state.candidateBegin; c < state.candidateEnd; c++)
+	{
+		unsigned int fence = m_cellFences[c];
+		t_fenceSide side = testFence(fence, fix.latitude, fix.longitude);
+
+		unsigned int i = 0;
+		while (i < state.inside.size() && state.inside[i].fence != fence)
+			i++;
+
+		event.fence = fence;
+
+		if (i == state.inside.size())
+		// vehicle was outside of the fence
+		{
+			if (side == SIDE_INSIDE)
+			{
+				t_insideFence inside;
+				inside.fence = fence;
+				inside.enterTimestamp = fix.timestamp;
+				inside.dwellRaised = false;
+				inside.stillInCell = true;
+				state.inside.push_back(inside);
+
+				event.type = GEOFENCE_ENTER;
+				events.push_back(event);
+			}
+		}
+		else if (side != SIDE_OUTSIDE)
+		// vehicle is still inside, otherwise the exit is raised below
+		{
+			state.inside[i].stillInCell = true;
+
+			if (!state.inside[i].dwellRaised
+					&& fix.timestamp - state.inside[i].enterTimestamp
+							>= m_dwellSeconds)
+			{
+				state.inside[i].dwellRaised = true;
+				event.type = GEOFENCE_DWELL;
+				events.push_back(event);
+			}
+		}
+	}
+
+	// fences left : outside of the border or not in the cell any more (outside of their bounding box)
+	unsigned int kept = 0;
+	for (unsigned int i = 0; i < state.inside.size(); i++)
+	{
+		if (state.inside[i].stillInCell)
+			state.inside[kept++] = state.inside[i];
+		else
+		{
+			event.fence = state.inside[i].fence;
+			event.type = GEOFENCE_EXIT;
+			events.push_back(event);
+		}
+	}
+	state.inside.resize(kept);
+}
+
+/**
+ * Function returns the name of a fence
+ * @param unsigned int fence : IN number of the fence
+ * @returnvalue const std::string& : name of the fence
+ */
+const string& CGeofenceIndex::getFenceName(unsigned int fence) const
+{
+	return m_names[fence];
+}
+
+/**
+ * Function returns the number of fences
+ * @param no parameters
+ * @returnvalue unsigned int : number of fences
+ */
+unsigned int CGeofenceIndex::getNoFences() const
+{
+	return m_names.size();
+}
+
+/**
+ * Function returns the number of fence tests done so far (for benchmarks)
+ * @param no parameters
+ * @returnvalue unsigned long long : number of tests of a fix against a fence
+ */
+unsigned long long CGeofenceIndex::getNoFenceTests() const
+{
+	return m_noFenceTests;
+}
+
+/**
+ * Function returns the key of the grid cell of a position
+ * @param double latitude  : IN latitude
+ * @param double longitude : IN longitude
+ * @returnvalue long long : key of the cell
+ */
+long long CGeofenceIndex::getCell(double latitude, double longitude) const
+{
+	long long row = (long long) floor(latitude / m_cellDegree);
+	long long column = (long long) floor(longitude / m_cellDegree);
+
+	return cellKey(row, column);
+}
+
+/**
+ * Function returns the key of a grid cell
+ * @param long long row    : IN row of the cell (latitude / cell size)
+ * @param long long column : IN column of the cell (longitude / cell size)
+ * @returnvalue long long : key of the cell
+ */
+long long CGeofenceIndex::cellKey(long long row, long long column)
+{
+	// unique as long as |column| < 50000000 : cells of at least 10 m have less than 2000000 columns
+	return row * 100000000LL + column;
+}
+
+/**
+ * Function registers all fences in the grid (cells in CSR format)
+ * @param no parameters
+ * @returnvalue void
+ */
+void CGeofenceIndex::buildGrid()
+{
+	vector<pair<long long, unsigned int> > cellFences;
+
+	for (unsigned int fence = 0; fence < m_names.size(); fence++)
+	{
+		long long firstRow = (long long) floor(m_minLatitude[fence] / m_cellDegree);
+		long long lastRow = (long long) floor(m_maxLatitude[fence] / m_cellDegree);
+		long long firstColumn = (long long) floor(m_minLongitude[fence] / m_cellDegree);
+		long long lastColumn = (long long) floor(m_maxLongitude[fence] / m_cellDegree);
+
+		for (long long row = firstRow; row <= lastRow; row++)
+			for (long long column = firstColumn; column <= lastColumn; column++)
+				cellFences.push_back(make_pair(cellKey(row, column), fence));
+	}
+
+	sort(cellFences.begin(), cellFences.end());
+
+	m_cellIndex.clear();
+	m_cellStart.clear();
+	m_cellFences.resize(cellFences.size());
+
+	for (unsigned int i = 0; i < cellFences.size(); i++)
+	{
+		if (i == 0 || cellFences[i].first != cellFences[i - 1].first)
+		// first fence of a new cell
+		{
+			m_cellIndex[cellFences[i].first] = m_cellStart.size();
+			m_cellStart.push_back(i);
+		}
+		m_cellFences[i] = cellFences[i].second;
+	}
+	m_cellStart.push_back(cellFences.size());
+
+	// the candidates of the vehicles refer to the old grid
+	for (unsigned int i = 0; i < m_vehicles.size(); i++)
+		m_vehicles[i].hasCell = false;
+
+	m_gridValid = true;
+}
+
+/**
+ * Function tests on which side of the border of a fence a position is
+ * @param unsigned int fence : IN number of the fence
+ * @param double latitude    : IN latitude
+ * @param double longitude   : IN longitude
+ * @returnvalue t_fenceSide : inside, in the hysteresis band or outside
+ */
+CGeofenceIndex::t_fenceSide CGeofenceIndex::testFence(unsigned int fence,
+		double latitude, double longitude)
+{
+	m_noFenceTests++;
+
+	if (latitude < m_minLatitude[fence] || latitude > m_maxLatitude[fence]
+			|| longitude < m_minLongitude[fence]
+			|| longitude > m_maxLongitude[fence])
+		// outside of the bounding box, which includes the hysteresis
+		return SIDE_OUTSIDE;
+
+	double x = (longitude - m_longitude[fence])
+			* m_metresPerDegreeLongitude[fence];
+	double y = (latitude - m_latitude[fence]) * METRES_PER_DEGREE;
+	double h = m_hysteresisMetres;
+
+	if (m_radiusMetres[fence] >= 0.0)
+	// circle : squared distances, no square root
+	{
+		double squaredDistance = x * x + y * y;
+		double inner = m_radiusMetres[fence] - h;
+		double outer = m_radiusMetres[fence] + h;
+
+		if (inner > 0.0 && squaredDistance <= inner * inner)
+			return SIDE_INSIDE;
+		if (squaredDistance >= outer * outer)
+			return SIDE_OUTSIDE;
+		return SIDE_BORDER;
+	}
+
+	// polygon : ray casting for inside/outside, distance to the nearest edge for the hysteresis
+	bool inside = false;
+	double minSquaredDistance = -1.0;
+	unsigned int begin = m_cornerBegin[fence], end = m_cornerBegin[fence + 1];
+
+	for (unsigned int i = begin, j = end - 1; i < end; j = i++)
+	{
+		double xi = m_cornerX[i], yi = m_cornerY[i];
+		double xj = m_cornerX[j], yj = m_cornerY[j];
+
+		if ((yi > y) != (yj > y)
+				&& x < (xj - xi) * (y - yi) / (yj - yi) + xi)
+			inside = !inside;
+
+		// distance to the edge from corner j to corner i
+		double dx = xi - xj, dy = yi - yj;
+		double lengthSquared = dx * dx + dy * dy;
+		double t = (lengthSquared > 0.0) ?
+				((x - xj) * dx + (y - yj) * dy) / lengthSquared : 0.0;
+		t = (t < 0.0) ? 0.0 : ((t > 1.0) ? 1.0 : t);
+
+		double ex = xj + t * dx - x, ey = yj + t * dy - y;
+		double squaredDistance = ex * ex + ey * ey;
+
+		if (minSquaredDistance < 0.0 || squaredDistance < minSquaredDistance)
+			minSquaredDistance = squaredDistance;
+	}
+
+	if (minSquaredDistance < h * h)
+		return SIDE_BORDER;
+	return inside ? SIDE_INSIDE : SIDE_OUTSIDE;
+}
+
+/**
+ * Function adds the bounding box and the common data of a new fence
+ * @param const std::string& name : IN name of the fence
+ * @param double latitude         : IN latitude of the reference point
+ * @param double longitude        : IN longitude of the reference point
+ * @param double extentMetres     : IN largest distance of the border from the reference point
+ * @returnvalue unsigned int : number of the fence
+ */
+unsigned int CGeofenceIndex::addFence(const string& name, double latitude,
+		double longitude, double extentMetres)
+{
+	double metresPerDegreeLongitude = METRES_PER_DEGREE
+			* cos(latitude * DEG_TO_RAD);
+	if (metresPerDegreeLongitude < 1.0)
+		// at the poles
+		metresPerDegreeLongitude = 1.0;
+
+	double reach = extentMetres + m_hysteresisMetres;
+
+	m_names.push_back(name);
+	m_latitude.push_back(latitude);
+	m_longitude.push_back(longitude);
+	m_metresPerDegreeLongitude.push_back(metresPerDegreeLongitude);
+	m_minLatitude.push_back(latitude - reach / METRES_PER_DEGREE);
+	m_maxLatitude.push_back(latitude + reach / METRES_PER_DEGREE);
+	m_minLongitude.push_back(longitude - reach / metresPerDegreeLongitude);
+	m_maxLongitude.push_back(longitude + reach / metresPerDegreeLongitude);
+
+	m_gridValid = false;
+	return m_names.size() - 1;
+}
@@ -0,0 +1,236 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CGEOFENCEINDEX.H
+ * Author          : George Sebastian
+ * Description     : CGeofenceIndex raises alerts when vehicles enter or leave zones
+ *                   (geofences) : circles, e.g. around the POIs of a type in the POI
+ *                   Database, or arbitrary polygons.
+ *                   The fences are registered in a grid of cells (about 1 km), each fix is
+ *                   only tested against the fences of the cell of the vehicle. Each vehicle
+ *                   remembers its cell and the fences it is inside of.
+ *                   Hysteresis : a vehicle enters a fence when it is deeper than the
+ *                   hysteresis distance inside of it and leaves it when it is further than
+ *                   this distance outside, so GPS jitter at the border raises no events.
+ *                   A dwell event is raised once per visit after the vehicle stayed inside
+ *                   for the dwell time.
+ *                   Distances are calculated in a local plane around each fence, fences
+ *                   should be smaller than about 50 km and must not cross the date line.
+ ****************************************************************************/
+#ifndef CGEOFENCEINDEX_H
+#define CGEOFENCEINDEX_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+#include "CPositionSensor.h"
+#include "CPoiDatabase.h"
+
+#define GEOFENCE_INVALID 0xFFFFFFFFu        // no fence, returned for a polygon with less than 3 corners
+
+/*
+ * kind of a geofence event
+ */
+typedef enum geofenceEventType
+{
+	GEOFENCE_ENTER, GEOFENCE_EXIT, GEOFENCE_DWELL
+} t_geofenceEventType;
+
+/*
+ * event raised by a fix of a vehicle
+ */
+struct t_geofenceEvent
+{
+	unsigned int vehicle;
+	unsigned int fence;
+	t_geofenceEventType type;
+	double timestamp;             // timestamp of the fix which raised the event
+};
+
+class CGeofenceIndex
+{
+public:
+
+	/**
+	 * Constructor of class CGeofenceIndex
+	 * @param double hysteresisMetres : IN distance inside/outside of the border needed to enter/leave a fence
+	 * @param double dwellSeconds     : IN time inside of a fence after which a dwell event is raised
+	 * @param double cellMetres       : IN size of the grid cells
+	 * @return no value
+	 */
+	CGeofenceIndex(double hysteresisMetres = 10.0, double dwellSeconds = 300.0,
+			double cellMetres = 1000.0);
+
+	/**
+	 * Function adds a circular fence
+	 * @param const std::string& name : IN name of the fence
+	 * @param double latitude         : IN latitude of the centre
+	 * @param double longitude        : IN longitude of the centre
+	 * @param double radiusMetres     : IN radius
+	 * @returnvalue unsigned int : number of the fence
+	 */
+	unsigned int addCircle(const std::string& name, double latitude,
+			double longitude, double radiusMetres);
+
+	/**
+	 * Function adds a polygonal fence
+	 * @param const std::string& name               : IN name of the fence
+	 * @param const std::vector<CWaypoint>& corners : IN corners of the polygon (at least 3), closed automatically
+	 * @returnvalue unsigned int : number of the fence, GEOFENCE_INVALID if the polygon has less than 3 corners
+	 */
+	unsigned int addPolygon(const std::string& name,
+			const std::vector<CWaypoint>& corners);
+
+	/**
+	 * Function adds a circular fence around each POI of a type in the POI Database
+	 * @param const CPoiDatabase& poiDatabase : IN POI Database
+	 * @param CPOI::t_poi type                : IN type of the POIs, e.g. GASSTATION
+	 * @param double radiusMetres             : IN radius of the fences
+	 * @returnvalue unsigned int : number of added fences
+	 */
+	unsigned int addPoiFences(const CPoiDatabase& poiDatabase, CPOI::t_poi type,
+			double radiusMetres);
+
+	/**
+	 * Function processes a fix of a vehicle and appends the raised events
+	 * @param unsigned int vehicle                  : IN number of the vehicle (any number, the state is created on the first fix)
+	 * @param const t_gpsFix& fix                   : IN position of the vehicle
+	 * @param std::vector<t_geofenceEvent>& events  : OUT raised events are appended
+	 * @returnvalue void
+	 */
+	void update(unsigned int vehicle, const t_gpsFix& fix,
+			std::vector<t_geofenceEvent>& events);
+
+	/**
+	 * Function returns the name of a fence
+	 * @param unsigned int fence : IN number of the fence
+	 * @returnvalue const std::string& : name of the fence
+	 */
+	const std::string& getFenceName(unsigned int fence) const;
+
+	/**
+	 * Function returns the number of fences
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of fences
+	 */
+	unsigned int getNoFences() const;
+
+	/**
+	 * Function returns the number of fence tests done so far (for benchmarks)
+	 * @param no parameters
+	 * @returnvalue unsigned long long : number of tests of a fix against a fence
+	 */
+	unsigned long long getNoFenceTests() const;
+
+private:
+
+	/*
+	 * position of a vehicle relative to a fence
+	 */
+	enum t_fenceSide
+	{
+		SIDE_INSIDE,      // deeper than the hysteresis inside
+		SIDE_BORDER,      // within the hysteresis band around the border
+		SIDE_OUTSIDE      // further than the hysteresis outside
+	};
+
+	/*
+	 * fence the vehicle is inside of
+	 */
+	struct t_insideFence
+	{
+		unsigned int fence;
+		double enterTimestamp;
+		bool dwellRaised;
+		bool stillInCell;          // set while the fences of the current cell are tested
+	};
+
+	/*
+	 * state of a vehicle
+	 */
+	struct t_vehicleState
+	{
+		bool hasCell;
+		long long cell;
+		unsigned int candidateBegin;   // fences of the cell : m_cellFences[candidateBegin .. candidateEnd - 1]
+		unsigned int candidateEnd;
+		std::vector<t_insideFence> inside;
+	};
+
+	/**
+	 * Function returns the key of the grid cell of a position
+	 * @param double latitude  : IN latitude
+	 * @param double longitude : IN longitude
+	 * @returnvalue long long : key of the cell
+	 */
+	long long getCell(double latitude, double longitude) const;
+
+	/**
+	 * Function returns the key of a grid cell
+	 * @param long long row    : IN row of the cell (latitude / cell size)
+	 * @param long long column : IN column of the cell (longitude / cell size)
+	 * @returnvalue long long : key of the cell
+	 */
+	static long long cellKey(long long row, long long column);
+
+	/**
+	 * Function registers all fences in the grid (cells in CSR format)
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void buildGrid();
+
+	/**
+	 * Function tests on which side of the border of a fence a position is
+	 * @param unsigned int fence : IN number of the fence
+	 * @param double latitude    : IN latitude
+	 * @param double longitude   : IN longitude
+	 * @returnvalue t_fenceSide : inside, in the hysteresis band or outside
+	 */
+	t_fenceSide testFence(unsigned int fence, double latitude,
+			double longitude);
+
+	/**
+	 * Function adds the bounding box and the common data of a new fence
+	 * @param const std::string& name : IN name of the fence
+	 * @param double latitude         : IN latitude of the reference point
+	 * @param double longitude        : IN longitude of the reference point
+	 * @param double extentMetres     : IN largest distance of the border from the reference point
+	 * @returnvalue unsigned int : number of the fence
+	 */
+	unsigned int addFence(const std::string& name, double latitude,
+			double longitude, double extentMetres);
+
+	double m_hysteresisMetres;
+	double m_dwellSeconds;
+	double m_cellDegree;
+
+	// fences, one array per attribute
+	std::vector<std::string> m_names;
+	std::vector<double> m_latitude;             // centre / reference point
+	std::vector<double> m_longitude;
+	std::vector<double> m_metresPerDegreeLongitude;
+	std::vector<double> m_radiusMetres;         // circle : radius, polygon : -1
+	std::vector<double> m_minLatitude;          // bounding box including the hysteresis
+	std::vector<double> m_maxLatitude;
+	std::vector<double> m_minLongitude;
+	std::vector<double> m_maxLongitude;
+	std::vector<unsigned int> m_cornerBegin;    // corners of fence f : m_cornerX/Y[m_cornerBegin[f] .. m_cornerBegin[f + 1] - 1], none for circles
+	std::vector<double> m_cornerX;              // metres east of the reference point
+	std::vector<double> m_cornerY;              // metres north of the reference point
+
+	// grid : fences of a cell are m_cellFences[m_cellStart[i] .. m_cellStart[i + 1] - 1] for i = m_cellIndex[cell]
+	bool m_gridValid;
+	std::unordered_map<long long, unsigned int> m_cellIndex;
+	std::vector<unsigned int> m_cellStart;
+	std::vector<unsigned int> m_cellFences;
+
+	std::unordered_map<unsigned int, unsigned int> m_vehicleSlots;   // number of a vehicle -> its state in m_vehicles
+	std::vector<t_vehicleState> m_vehicles;     // in the order of the first fixes
+	unsigned long long m_noFenceTests;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CGEOFENCEINDEX_H */
@@ -0,0 +1,365 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CHIERARCHYSEARCH.CPP
+ * Author          : George Sebastian
+ * Description     : CHierarchySearch answers shortest path queries on a
+ *                   CContractionHierarchy. Forward search : upward edges of the settled
+ *                   node; backward search : downward edges (the edges from higher ranked
+ *                   nodes into the settled node, followed backwards). A search stops when
+ *                   the smallest distance in its heap reaches the shortest path found so
+ *                   far; unlike bidirectional Dijkstra both searches have to reach this
+ *                   bound, the shortest path is found at its highest ranked node.
+ *                   Stall on demand : a settled node which a higher ranked node reaches on
+ *                   a shorter path is not on a shortest path of this search, its edges are
+ *                   not relaxed.
+ *                   A shortcut (u, w) with contracted node m is the downward edge (u, m)
+ *                   of m followed by the upward edge (m, w) of m; both can be shortcuts
+ *                   again and are unpacked with a stack.
+ ****************************************************************************/
+#include <algorithm>
+#include <functional>
+using namespace std;
+
+#include "CHierarchySearch.h"
+
+/**
+ * Constructor of class CHierarchySearch
+ * @param const CContractionHierarchy& hierarchy : IN built or loaded hierarchy, must not be changed while the search object is used
+ * @return no value
+ */
+CHierarchySearch::CHierarchySearch(const CContractionHierarchy& hierarchy) :
+		m_hierarchy(hierarchy)
+{
+	m_queryStamp = 0;
+	m_meetingNode = 0;
+	m_noSettledNodes = 0;
+}
+
+/**
+ * Function searches the shortest path between two nodes
+ * @param unsigned int from               : IN start node
+ * @param unsigned int to                 : IN destination node
+ * @param std::vector<unsigned int>& path : OUT nodes of the path from start to destination, shortcuts unpacked
+ * @param double& costKm                  : OUT cost of the path
+ * @returnvalue true if the destination can be reached from the start
+ */
+bool CHierarchySearch::shortestPath(unsigned int from, unsigned int to,
+		vector<unsigned int>& path, double& costKm)
+{
+	const CContractionHierarchy& ch = m_hierarchy;
+
+	path.clear();
+
+	if (ch.m_pGraph == NULL || from >= ch.m_rank.size() || to >= ch.m_rank.size())
+		return false;
+
+	startQuery();
+
+	const unsigned int* firstEdge[2] = { &ch.m_firstUp[0], &ch.m_firstDown[0] };
+	const unsigned int* edgeNode[2] =
+	{ ch.m_upNode.empty() ? NULL : &ch.m_upNode[0],
+			ch.m_downNode.empty() ? NULL : &ch.m_downNode[0] };
+	const double* edgeCost[2] =
+	{ ch.m_upCost.empty() ? NULL : &ch.m_upCost[0],
+			ch.m_downCost.empty() ? NULL : &ch.m_downCost[0] };
+	greater<pair<double, unsigned int> > smallestOnTop;
+
+	double bestKm = -1.0;           // shortest path found so far, -1 : none
+
+	if (from == to)
+	{
+		bestKm = 0.0;
+		m_meetingNode = from;
+	}
+
+	relax(0, from, 0.0, from, 0);
+	relax(1, to, 0.0, to, 0);
+
+	while (true)
+	{
+		bool active[2];
+
+		for (unsigned int direction = 0; direction < 2; direction++)
+			active[direction] = !m_heap[direction].empty()
+					&& (bestKm < 0.0 || m_heap[direction].front().first < bestKm);
+
+		if (!active[0] && !active[1])
+			// no path through an unsettled node can be shorter
+			break;
+
+		unsigned int direction = (!active[1]
+				|| (active[0] && m_heap[0].front().first <= m_heap[1].front().first)) ? 0 : 1;
+		vector<pair<double, unsigned int> >& heap = m_heap[direction];
+		unsigned int other = 1 - direction;
+
+		pair<double, unsigned int> top = heap.front();
+		pop_heap(heap.begin(), heap.end(), smallestOnTop);
+		heap.pop_back();
+
+		if (top.first > m_distance[direction][top.second])
+			// outdated entry
+			continue;
+
+		m_noSettledNodes++;
+
+		if (isStalled(direction, top.second))
+			continue;
+
+		for (unsigned int e = firstEdge[direction][top.second];
+				e < firstEdge[direction][top.second + 1]; e++)
+		{
+			unsigned int node = edgeNode[direction][e];
+			double distance = top.first + edgeCost[direction][e];
+
+			if (relax(direction, node, distance, top.second, e)
+					&& m_stamp[other][node] == m_queryStamp)
+			// node reached by both searches : path from start to destination through the node
+			{
+				double pathKm = distance + m_distance[other][node];
+
+				if (bestKm < 0.0 || pathKm < bestKm)
+				{
+					bestKm = pathKm;
+					m_meetingNode = node;
+				}
+			}
+		}
+	}
+
+	if (bestKm < 0.0)
+		return false;
+
+	costKm = bestKm;
+	extractPath(from, to, path);
+	return true;
+}
+
+/**
+ * Function searches the shortest path between two Waypoints and replaces the Route by it
+ * @param const std::string& from : IN name of the start Waypoint
+ * @param const std::string& to   : IN name of the destination Waypoint
+ * @param CRoute& route           : OUT Route along the path, has to be connected to the WP Database of the graph
+ * @param double& costKm          : OUT cost of the path
+ * @returnvalue true if both Waypoints are nodes and the destination can be reached
+ */
+bool CHierarchySearch::shortestRoute(const string& from, const string& to,
+		CRoute& route, double& costKm)
+{
+	const CRoadGraph* pGraph = m_hierarchy.getGraph();
+	unsigned int fromNode, toNode;
+
+	if (pGraph == NULL || !pGraph->getNode(from, fromNode)
+			|| !pGraph->getNode(to, toNode)
+			|| !shortestPath(fromNode, toNode, m_path, costKm))
+		return false;
+
+	route.rebuildFromIndices(vector<unsigned int>());    // empty Route
+
+	for (unsigned int i = 0; i < m_path.size(); i++)
+		route.addWaypoint(pGraph->getWaypoint(m_path[i])->getName());
+
+	return true;
+}
+
+/**
+ * Function returns the number of nodes settled by the last query, in both directions (for benchmarks)
+ * @param no parameters
+ * @returnvalue unsigned int : number of settled nodes
+ */
+unsigned int CHierarchySearch::getNoSettledNodes() const
+{
+	return m_noSettledNodes;
+}
+
+/**
+ * Function starts a new query : arrays are resized if the graph grew, the query stamp is incremented
+ * @param no parameters
+ * @returnvalue void
+ */
+void CHierarchySearch::startQuery()
+{
+	unsigned int noNodes = m_hierarchy.m_rank.size();
+
+	m_queryStamp++;
+
+	for (unsigned int direction = 0; direction < 2; direction++)
+	{
+		if (m_distance[direction].size() < noNodes)
+		{
+			m_distance[direction].resize(noNodes);
+			m_parent[direction].resize(noNodes);
+			m_parentEdge[direction].resize(noNodes);
+			m_stamp[direction].resize(noNodes, 0);
+		}
+
+		if (m_queryStamp == 0)
+			// stamp wrapped around, stamps of old queries could match again
+			fill(m_stamp[direction].begin(), m_stamp[direction].end(), 0);
+
+		m_heap[direction].clear();
+	}
+
+	if (m_queryStamp == 0)
+		m_queryStamp = 1;
+
+	m_noSettledNodes = 0;
+}
+
+/**
+ * Function sets the distance of a node if it is smaller than the known one and pushes it onto the heap
+ * @param unsigned int direction : IN 0 forward (upward edges), 1 backward (downward edges)
+ * @param unsigned int node      : IN node
+ * @param double distance        : IN distance from the start (forward) or to the destination (backward)
+ * @param unsigned int parent    : IN previous node of the search
+ * @param unsigned int edge      : IN edge from the parent, index in the upward or downward arrays of the hierarchy
+ * @returnvalue true if the distance of the node was improved
+ */
+bool CHierarchySearch::relax(unsigned int direction, unsigned int node,
+		double distance, unsigned int parent, unsigned int edge)
+{
+	if (m_stamp[direction][node] == m_queryStamp
+			&& m_distance[direction][node] <= distance)
+		// already reached on a path which is not longer
+		return false;
+
+	m_stamp[direction][node] = m_queryStamp;
+	m_distance[direction][node] = distance;
+	m_parent[direction][node] = parent;
+	m_parentEdge[direction][node] = edge;
+
+	m_heap[direction].push_back(make_pair(distance, node));
+	push_heap(m_heap[direction].begin(), m_heap[direction].end(),
+			greater<pair<double, unsigned int> >());
+	return true;
+}
+
+/**
+ * Function tells if a settled node is reached on a shorter path through a higher ranked node (stall on demand)
+ * @param unsigned int direction : IN 0 forward, 1 backward
+ * @param unsigned int node      : IN settled node
+ * @returnvalue true if the edges of the node need not be relaxed
+ */
+bool CHierarchySearch::isStalled(unsigned int direction, unsigned int node) const
+{
+	const CContractionHierarchy& ch = m_hierarchy;
+
+	// edges between the node and higher ranked nodes against the direction of the search
+	const vector<unsigned int>& firstEdge = (direction == 0) ? ch.m_firstDown : ch.m_firstUp;
+	const vector<unsigned int>& edgeNode = (direction == 0) ? ch.m_downNode : ch.m_upNode;
+	const vector<double>& edgeCost = (direction == 0) ? ch.m_downCost : ch.m_upCost;
+	double distance = m_distance[direction][node];
+
+	for (unsigned int e = firstEdge[node]; e < firstEdge[node + 1]; e++)
+	{
+		unsigned int higher = edgeNode[e];
+
+		if (m_stamp[direction][higher] == m_queryStamp
+				&& m_distance[direction][higher] + edgeCost[e] < distance)
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * Function appends the roads of an edge of the hierarchy to a path, shortcuts are unpacked
+ * @param unsigned int from               : IN start node of the edge (already in the path)
+ * @param unsigned int to                 : IN end node of the edge
+ * @param unsigned int middle             : IN contracted node of a shortcut, CH_NO_MIDDLE for a road
+ * @param std::vector<unsigned int>& path : IN/OUT path, the nodes after the start node are appended
+ * @returnvalue void
+ */
+void CHierarchySearch::unpackEdge(unsigned int from, unsigned int to,
+		unsigned int middle, vector<unsigned int>& path)
+{
+	const CContractionHierarchy& ch = m_hierarchy;
+
+	m_unpackStack.clear();
+	m_unpackStack.push_back(from);
+	m_unpackStack.push_back(to);
+	m_unpackStack.push_back(middle);
+
+	while (!m_unpackStack.empty())
+	{
+		middle = m_unpackStack.back();
+		m_unpackStack.pop_back();
+		to = m_unpackStack.back();
+		m_unpackStack.pop_back();
+		from = m_unpackStack.back();
+		m_unpackStack.pop_back();
+
+		if (middle == CH_NO_MIDDLE)
+		// road of the graph
+		{
+			path.push_back(to);
+			continue;
+		}
+
+		unsigned int firstMiddle = CH_NO_MIDDLE, secondMiddle = CH_NO_MIDDLE;
+
+		for (unsigned int e = ch.m_firstDown[middle]; e < ch.m_firstDown[middle + 1]; e++)
+		{
+			if (ch.m_downNode[e] == from)
+			{
+				firstMiddle = ch.m_downMiddle[e];
+				break;
+			}
+		}
+
+		for (unsigned int e = ch.m_firstUp[middle]; e < ch.m_firstUp[middle + 1]; e++)
+		{
+			if (ch.m_upNode[e] == to)
+			{
+				secondMiddle = ch.m_upMiddle[e];
+				break;
+			}
+		}
+
+		// second half pushed first, the first half is unpacked first
+		m_unpackStack.push_back(middle);
+		m_unpackStack.push_back(to);
+		m_unpackStack.push_back(secondMiddle);
+		m_unpackStack.push_back(from);
+		m_unpackStack.push_back(middle);
+		m_unpackStack.push_back(firstMiddle);
+	}
+}
+
+/**
+ * Function reads the path from the parents of the nodes and unpacks the shortcuts
+ * @param unsigned int from               : IN start node
+ * @param unsigned int to                 : IN destination node
+ * @param std::vector<unsigned int>& path : OUT nodes from start to destination
+ * @returnvalue void
+ */
+void CHierarchySearch::extractPath(unsigned int from, unsigned int to,
+		vector<unsigned int>& path)
+{
+	const CContractionHierarchy& ch = m_hierarchy;
+
+	m_hierarchyPath.clear();
+
+	// start .. meeting node : upward edges found by the forward search, collected backwards
+	for (unsigned int node = m_meetingNode; node != from; node = m_parent[0][node])
+	{
+		m_hierarchyPath.push_back(ch.m_upMiddle[m_parentEdge[0][node]]);
+		m_hierarchyPath.push_back(node);
+		m_hierarchyPath.push_back(m_parent[0][node]);
+	}
+	reverse(m_hierarchyPath.begin(), m_hierarchyPath.end());
+
+	// meeting node .. destination : downward edges found by the backward search
+	for (unsigned int node = m_meetingNode; node != to; node = m_parent[1][node])
+	{
+		m_hierarchyPath.push_back(node);
+		m_hierarchyPath.push_back(m_parent[1][node]);
+		m_hierarchyPath.push_back(ch.m_downMiddle[m_parentEdge[1][node]]);
+	}
+
+	path.clear();
+	path.push_back(from);
+	for (unsigned int i = 0; i < m_hierarchyPath.size(); i += 3)
+		unpackEdge(m_hierarchyPath[i], m_hierarchyPath[i + 1],
+				m_hierarchyPath[i + 2], path);
+}
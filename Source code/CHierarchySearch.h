@@ -0,0 +1,133 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CHIERARCHYSEARCH.H
+ * Author          : George Sebastian
+ * Description     : CHierarchySearch answers shortest path queries on a
+ *                   CContractionHierarchy : a search from the start follows the edges to
+ *                   higher ranked nodes, a search from the destination follows the same
+ *                   kind of edges backwards, the shortest path goes through the node where
+ *                   the sum of both distances is smallest. Shortcuts on the path are
+ *                   unpacked into the roads of the graph.
+ *                   Like CShortestPathSearch the object keeps its arrays between the
+ *                   queries and is created once per thread.
+ ****************************************************************************/
+#ifndef CHIERARCHYSEARCH_H
+#define CHIERARCHYSEARCH_H
+
+#include <vector>
+#include <string>
+
+#include "CContractionHierarchy.h"
+#include "CRoute.h"
+
+class CHierarchySearch
+{
+public:
+
+	/**
+	 * Constructor of class CHierarchySearch
+	 * @param const CContractionHierarchy& hierarchy : IN built or loaded hierarchy, must not be changed while the search object is used
+	 * @return no value
+	 */
+	CHierarchySearch(const CContractionHierarchy& hierarchy);
+
+	/**
+	 * Function searches the shortest path between two nodes
+	 * @param unsigned int from               : IN start node
+	 * @param unsigned int to                 : IN destination node
+	 * @param std::vector<unsigned int>& path : OUT nodes of the path from start to destination, shortcuts unpacked
+	 * @param double& costKm                  : OUT cost of the path
+	 * @returnvalue true if the destination can be reached from the start
+	 */
+	bool shortestPath(unsigned int from, unsigned int to,
+			std::vector<unsigned int>& path, double& costKm);
+
+	/**
+	 * Function searches the shortest path between two Waypoints and replaces the Route by it
+	 * @param const std::string& from : IN name of the start Waypoint
+	 * @param const std::string& to   : IN name of the destination Waypoint
+	 * @param CRoute& route           : OUT Route along the path, has to be connected to the WP Database of the graph
+	 * @param double& costKm          : OUT cost of the path
+	 * @returnvalue true if both Waypoints are nodes and the destination can be reached
+	 */
+	bool shortestRoute(const std::string& from, const std::string& to,
+			CRoute& route, double& costKm);
+
+	/**
+	 * Function returns the number of nodes settled by the last query, in both directions (for benchmarks)
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of settled nodes
+	 */
+	unsigned int getNoSettledNodes() const;
+
+private:
+
+	/**
+	 * Function starts a new query : arrays are resized if the graph grew, the query stamp is incremented
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void startQuery();
+
+	/**
+	 * Function sets the distance of a node if it is smaller than the known one and pushes it onto the heap
+	 * @param unsigned int direction : IN 0 forward (upward edges), 1 backward (downward edges)
+	 * @param unsigned int node      : IN node
+	 * @param double distance        : IN distance from the start (forward) or to the destination (backward)
+	 * @param unsigned int parent    : IN previous node of the search
+	 * @param unsigned int edge      : IN edge from the parent, index in the upward or downward arrays of the hierarchy
+	 * @returnvalue true if the distance of the node was improved
+	 */
+	bool relax(unsigned int direction, unsigned int node, double distance,
+			unsigned int parent, unsigned int edge);
+
+	/**
+	 * Function tells if a settled node is reached on a shorter path through a higher ranked node (stall on demand)
+	 * @param unsigned int direction : IN 0 forward, 1 backward
+	 * @param unsigned int node      : IN settled node
+	 * @returnvalue true if the edges of the node need not be relaxed
+	 */
+	bool isStalled(unsigned int direction, unsigned int node) const;
+
+	/**
+	 * Function appends the roads of an edge of the hierarchy to a path, shortcuts are unpacked
+	 * @param unsigned int from               : IN start node of the edge (already in the path)
+	 * @param unsigned int to                 : IN end node of the edge
+	 * @param unsigned int middle             : IN contracted node of a shortcut, CH_NO_MIDDLE for a road
+	 * @param std::vector<unsigned int>& path : IN/OUT path, the nodes after the start node are appended
+	 * @returnvalue void
+	 */
+	void unpackEdge(unsigned int from, unsigned int to, unsigned int middle,
+			std::vector<unsigned int>& path);
+
+	/**
+	 * Function reads the path from the parents of the nodes and unpacks the shortcuts
+	 * @param unsigned int from               : IN start node
+	 * @param unsigned int to                 : IN destination node
+	 * @param std::vector<unsigned int>& path : OUT nodes from start to destination
+	 * @returnvalue void
+	 */
+	void extractPath(unsigned int from, unsigned int to,
+			std::vector<unsigned int>& path);
+
+	const CContractionHierarchy& m_hierarchy;
+
+	// search state of the forward [0] and backward [1] search
+	std::vector<double> m_distance[2];
+	std::vector<unsigned int> m_parent[2];
+	std::vector<unsigned int> m_parentEdge[2];
+	std::vector<unsigned int> m_stamp[2];
+	std::vector<std::pair<double, unsigned int> > m_heap[2];
+	unsigned int m_queryStamp;
+	unsigned int m_meetingNode;
+
+	std::vector<unsigned int> m_hierarchyPath;  // edges of the path before unpacking, 3 entries each
+	std::vector<unsigned int> m_unpackStack;    // edges still to be unpacked, 3 entries each
+	std::vector<unsigned int> m_path;           // buffer of shortestRoute()
+	unsigned int m_noSettledNodes;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CHIERARCHYSEARCH_H */
@@ -0,0 +1,395 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CISOCHRONESEARCH.CPP
+ * Author          : George Sebastian
+ * Description     : CIsochroneSearch answers reachability queries on a CRoadGraph. The
+ *                   search is Dijkstra without a destination : nodes are only pushed if
+ *                   they are within the budget, so the heap never holds more than the
+ *                   border of the isochrone. The nodes are settled in the order of their
+ *                   distance, the POIs come out of the search already sorted except for
+ *                   the snap distances, which are added afterwards.
+ *                   The nearest node of a position is searched in a grid of cells of the
+ *                   snap distance (in degree of latitude); the cells of a row are narrower
+ *                   in km away from the equator, so more columns are searched there.
+ ****************************************************************************/
+#include <math.h>
+#include <algorithm>
+using namespace std;
+
+#include "CIsochroneSearch.h"
+#include "CUnitVector.h"
+#include "CPoiCategoryRegistry.h"
+
+#define PI 3.14159265358979323846
+
+/**
+ * Function compares reachable POIs by their distance
+ * @param const t_reachablePoi& a : IN first POI
+ * @param const t_reachablePoi& b : IN second POI
+ * @returnvalue true if a is nearer than b
+ */
+static bool isNearer(const t_reachablePoi& a, const t_reachablePoi& b)
+{
+	return a.distanceKm < b.distanceKm;
+}
+
+/**
+ * Constructor of class CIsochroneSearch
+ * @param const CRoadGraph& graph : IN graph to be searched, must not be changed while the search object is used
+ * @return no value
+ */
+CIsochroneSearch::CIsochroneSearch(const CRoadGraph& graph) :
+		m_graph(graph)
+{
+	m_maxSnapKm = 0.0;
+	m_cellDegree = 1.0;
+	m_queryStamp = 0;
+}
+
+/**
+ * Function attaches all POIs of the POI Database to their nearest node, replaces the attachments of an earlier call
+ * @param const CPoiDatabase& poiDatabase : IN POI Database, must not be changed while the attachments are used
+ * @param double maxSnapKm                : IN POIs (and start positions) further away from every node are not attached
+ * @returnvalue unsigned int : number of attached POIs
+ */
+unsigned int CIsochroneSearch::attachPois(const CPoiDatabase& poiDatabase,
+		double maxSnapKm)
+{
+	unsigned int noNodes = m_graph.getNoNodes();
+
+	// grid of the nodes
+	m_maxSnapKm = maxSnapKm;
+	m_cellDegree = max(maxSnapKm, 0.001) / CUnitVector::KM_PER_DEGREE;
+	m_nodeCells.clear();
+
+	for (unsigned int node = 0; node < noNodes; node++)
+	{
+		const CWaypoint* pWaypoint = m_graph.getWaypoint(node);
+		m_nodeCells[cellKey((long long) floor(pWaypoint->getLatitude() / m_cellDegree),
+				(long long) floor(pWaypoint->getLongitude() / m_cellDegree))].push_back(node);
+	}
+
+	// nearest node of each POI, the POIs of each category from the type index
+	vector<unsigned int> poiNode;
+	vector<const CPOI*> pois;
+	vector<CPOI::t_poi> types;
+	vector<double> snapKm;
+	double distanceKm;
+	unsigned int noCategories = CPoiCategoryRegistry::getNoCategories();
+
+	for (unsigned int category = 0; category < noCategories; category++)
+	{
+		const vector<const CPOI*>& poisOfType = poiDatabase.getPoisOfType(
+				(CPOI::t_poi) category);
+
+		for (unsigned int i = 0; i < poisOfType.size(); i++)
+		{
+			unsigned int node = nearestNode(poisOfType[i]->getLatitude(),
+					poisOfType[i]->getLongitude(), distanceKm);
+			if (node < noNodes)
+			{
+				poiNode.push_back(node);
+				pois.push_back(poisOfType[i]);
+				types.push_back((CPOI::t_poi) category);
+				snapKm.push_back(distanceKm);
+			}
+		}
+	}
+
+	// attachment table, counting sort by node
+	m_firstAttached.assign(noNodes + 1, 0);
+	for (unsigned int i = 0; i < poiNode.size(); i++)
+		m_firstAttached[poiNode[i] + 1]++;
+	for (unsigned int node = 0; node < noNodes; node++)
+		m_firstAttached[node + 1] += m_firstAttached[node];
+
+	m_attachedPoi.resize(pois.size());
+	m_attachedType.resize(pois.size());
+	m_attachedSnapKm.resize(pois.size());
+
+	vector<unsigned int> next(m_firstAttached.begin(), m_firstAttached.end() - 1);
+	for (unsigned int i = 0; i < poiNode.size(); i++)
+	{
+		unsigned int slot = next[poiNode[i]]++;
+
+		m_attachedPoi[slot] = pois[i];
+		m_attachedType[slot] = types[i];
+		m_attachedSnapKm[slot] = snapKm[i];
+	}
+
+	return pois.size();
+}
+
+/**
+ * Function searches all POIs of a type reachable from a node within a distance budget
+ * @param unsigned int from                      : IN start node
+ * @param double budgetKm                        : IN maximum network distance
+ * @param CPOI::t_poi type                       : IN type of the POIs
+ * @param std::vector<t_reachablePoi>& result    : OUT reachable POIs, nearest first
+ * @returnvalue true if the start node exists
+ */
+bool CIsochroneSearch::reachablePois(unsigned int from, double budgetKm,
+		CPOI::t_poi type, vector<t_reachablePoi>& result)
+{
+	m_typeFilter.clear();
+	m_typeFilter.add(type);
+	return reachablePois(from, budgetKm, m_typeFilter, result);
+}
+
+/**
+ * Function searches all POIs of a type reachable from a position within a distance budget,
+ * the search starts at the nearest node, the snap distance to it is part of the budget
+ * @param const CWaypoint& position              : IN start position
+ * @param double budgetKm                        : IN maximum network distance
+ * @param CPOI::t_poi type                       : IN type of the POIs
+ * @param std::vector<t_reachablePoi>& result    : OUT reachable POIs, nearest first
+ * @returnvalue true if a node is within the snap distance of attachPois() from the position
+ */
+bool CIsochroneSearch::reachablePois(const CWaypoint& position,
+		double budgetKm, CPOI::t_poi type, vector<t_reachablePoi>& result)
+{
+	m_typeFilter.clear();
+	m_typeFilter.add(type);
+	return reachablePois(position, budgetKm, m_typeFilter, result);
+}
+
+/**
+ * Function searches all POIs of the types of a filter reachable from a node within a distance budget
+ * @param unsigned int from                      : IN start node
+ * @param double budgetKm                        : IN maximum network distance
+ * @param const CPoiCategoryFilter& filter       : IN types of the POIs
+ * @param std::vector<t_reachablePoi>& result    : OUT reachable POIs, nearest first
+ * @returnvalue true if the start node exists
+ */
+bool CIsochroneSearch::reachablePois(unsigned int from, double budgetKm,
+		const CPoiCategoryFilter& filter, vector<t_reachablePoi>& result)
+{
+	result.clear();
+	m_reached.clear();
+
+	if (!m_graph.isReady() || from >= m_graph.getNoNodes())
+		return false;
+
+	search(from, 0.0, budgetKm, filter, result);
+	return true;
+}
+
+/**
+ * Function searches all POIs of the types of a filter reachable from a position within a distance budget,
+ * the search starts at the nearest node, the snap distance to it is part of the budget. attachPois() has to be called before.
+ * @param const CWaypoint& position              : IN start position
+ * @param double budgetKm                        : IN maximum network distance
+ * @param const CPoiCategoryFilter& filter       : IN types of the POIs
+ * @param std::vector<t_reachablePoi>& result    : OUT reachable POIs, nearest first
+ * @returnvalue true if a node is within the snap distance of attachPois() from the position
+ */
+bool CIsochroneSearch::reachablePois(const CWaypoint& position,
+		double budgetKm, const CPoiCategoryFilter& filter,
+		vector<t_reachablePoi>& result)
+{
+	result.clear();
+	m_reached.clear();
+
+	if (!m_graph.isReady())
+		return false;
+
+	double snapKm;
+	unsigned int from = nearestNode(position.getLatitude(),
+			position.getLongitude(), snapKm);
+
+	if (from >= m_graph.getNoNodes())
+		return false;
+
+	search(from, snapKm, budgetKm, filter, result);
+	return true;
+}
+
+/**
+ * Function returns the nodes settled by the last query, the isochrone
+ * @param no parameters
+ * @returnvalue const std::vector<unsigned int>& : nodes within the budget, in the order of their distance
+ */
+const vector<unsigned int>& CIsochroneSearch::getReachedNodes() const
+{
+	return m_reached;
+}
+
+/**
+ * Function returns the network distance of a node reached by the last query
+ * @param unsigned int node : IN node from getReachedNodes()
+ * @returnvalue double : distance from the start in km
+ */
+double CIsochroneSearch::getDistance(unsigned int node) const
+{
+	return m_distance[node];
+}
+
+/**
+ * Function returns the number of attached POIs
+ * @param no parameters
+ * @returnvalue unsigned int : number of POIs in the attachment table
+ */
+unsigned int CIsochroneSearch::getNoAttachedPois() const
+{
+	return m_attachedPoi.size();
+}
+
+/**
+ * Function searches the nearest node of a position in the cells of the node grid
+ * @param double latitude   : IN latitude of the position
+ * @param double longitude  : IN longitude of the position
+ * @param double& distanceKm : OUT great circle distance to the node
+ * @returnvalue unsigned int : nearest node within the snap distance, number of nodes if there is none
+ */
+unsigned int CIsochroneSearch::nearestNode(double latitude, double longitude,
+		double& distanceKm) const
+{
+	unsigned int nearest = m_graph.getNoNodes();
+	CUnitVector position = CUnitVector::fromLatLon(latitude, longitude);
+	long long row = (long long) floor(latitude / m_cellDegree);
+	long long column = (long long) floor(longitude / m_cellDegree);
+
+	// a cell is cos(latitude) times narrower than high, at the pole side of the rows around the position
+	double cosLat = cos((fabs(latitude) + m_cellDegree) * PI / 180.0);
+	long long maxColumns = (long long) (360.0 / m_cellDegree) + 1;
+	long long span = (cosLat > 0.0) ? (long long) ceil(1.0 / cosLat) : maxColumns;
+
+	distanceKm = m_maxSnapKm;
+
+	for (long long r = row - 1; r <= row + 1; r++)
+	{
+		for (long long c = column - min(span, maxColumns);
+				c <= column + min(span, maxColumns); c++)
+		{
+			unordered_map<long long, vector<unsigned int> >::const_iterator cell =
+					m_nodeCells.find(cellKey(r, c));
+
+			if (cell == m_nodeCells.end())
+				continue;
+
+			for (unsigned int i = 0; i < cell->second.size(); i++)
+			{
+				unsigned int node = cell->second[i];
+				double nodeKm = position.distanceTo(m_graph.m_positions[node]);
+
+				if (nodeKm <= distanceKm)
+				{
+					distanceKm = nodeKm;
+					nearest = node;
+				}
+			}
+		}
+	}
+
+	return nearest;
+}
+
+/**
+ * Function returns the key of the grid cell of a position
+ * @param long long row    : IN row of the cell (latitude / cell size)
+ * @param long long column : IN column of the cell (longitude / cell size)
+ * @returnvalue long long : key of the cell
+ */
+long long CIsochroneSearch::cellKey(long long row, long long column)
+{
+	return row * 100000000LL + column;
+}
+
+/**
+ * Function runs the bounded search and collects the attached POIs of the settled nodes
+ * @param unsigned int from                      : IN start node
+ * @param double startKm                         : IN distance of the start node (snap distance)
+ * @param double budgetKm                        : IN maximum network distance
+ * @param const CPoiCategoryFilter& filter       : IN types of the POIs
+ * @param std::vector<t_reachablePoi>& result    : OUT reachable POIs, nearest first
+ * @returnvalue void
+ */
+void CIsochroneSearch::search(unsigned int from, double startKm,
+		double budgetKm, const CPoiCategoryFilter& filter,
+		vector<t_reachablePoi>& result)
+{
+	unsigned int noNodes = m_graph.getNoNodes();
+
+	if (startKm > budgetKm)
+		return;
+
+	// start a new query : arrays are resized if the graph grew, the query stamp is incremented
+	if (m_distance.size() < noNodes)
+	{
+		m_distance.resize(noNodes);
+		m_stamp.resize(noNodes, 0);
+	}
+	if (++m_queryStamp == 0)
+	{
+		// stamp wrapped around, stamps of old queries could match again
+		fill(m_stamp.begin(), m_stamp.end(), 0);
+		m_queryStamp = 1;
+	}
+	m_heap.clear();
+
+	bool attached = (m_firstAttached.size() == noNodes + 1);
+	const unsigned int* firstEdge = &m_graph.m_firstEdge[0];
+	const unsigned int* edgeTarget = m_graph.m_edgeTarget.empty() ? NULL : &m_graph.m_edgeTarget[0];
+	const double* edgeCost = m_graph.m_edgeCost.empty() ? NULL : &m_graph.m_edgeCost[0];
+
+	t_heapEntry entry;
+	entry.distance = startKm;
+	entry.node = from;
+	m_distance[from] = startKm;
+	m_stamp[from] = m_queryStamp;
+	m_heap.push_back(entry);
+
+	while (!m_heap.empty())
+	{
+		t_heapEntry top = m_heap.front();
+		pop_heap(m_heap.begin(), m_heap.end());
+		m_heap.pop_back();
+
+		if (top.distance > m_distance[top.node])
+			// outdated entry, the node was settled with a smaller distance
+			continue;
+
+		m_reached.push_back(top.node);
+
+		if (attached)
+		{
+			for (unsigned int i = m_firstAttached[top.node];
+					i < m_firstAttached[top.node + 1]; i++)
+			{
+				if (!filter.contains(m_attachedType[i])
+						|| top.distance + m_attachedSnapKm[i] > budgetKm)
+					continue;
+
+				t_reachablePoi poi;
+				poi.pPoi = m_attachedPoi[i];
+				poi.distanceKm = top.distance + m_attachedSnapKm[i];
+				poi.node = top.node;
+				result.push_back(poi);
+			}
+		}
+
+		for (unsigned int e = firstEdge[top.node]; e < firstEdge[top.node + 1]; e++)
+		{
+			unsigned int target = edgeTarget[e];
+			double distance = top.distance + edgeCost[e];
+
+			if (distance > budgetKm
+					|| (m_stamp[target] == m_queryStamp
+							&& m_distance[target] <= distance))
+				// outside of the isochrone or already reached on a path which is not longer
+				continue;
+
+			m_stamp[target] = m_queryStamp;
+			m_distance[target] = distance;
+
+			entry.distance = distance;
+			entry.node = target;
+			m_heap.push_back(entry);
+			push_heap(m_heap.begin(), m_heap.end());
+		}
+	}
+
+	// settled in the order of the nodes, the snap distances of the POIs may change it
+	stable_sort(result.begin(), result.end(), isNearer);
+}
@@ -0,0 +1,197 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CISOCHRONESEARCH.H
+ * Author          : George Sebastian
+ * Description     : CIsochroneSearch answers reachability queries on a CRoadGraph, e.g.
+ *                   "all restaurants within 10 km driving" : a Dijkstra search from the
+ *                   start which stops at the distance budget settles exactly the nodes of
+ *                   the isochrone; the POIs attached to these nodes are the result.
+ *                   Attachment table : each POI of the POI Database is attached to the
+ *                   nearest node (within a snap distance), the POIs of node n are
+ *                   m_attachedPoi[m_firstAttached[n] .. m_firstAttached[n + 1] - 1]
+ *                   (compressed sparse row like the edges of the graph). The type of each
+ *                   attached POI is stored next to it, the filter does not touch the POIs.
+ *                   The network distance of a POI includes the snap distance from its node.
+ *                   The object keeps its search arrays between the queries like
+ *                   CShortestPathSearch : created once per thread and reused, a query
+ *                   neither allocates nor clears arrays of the size of the graph.
+ ****************************************************************************/
+#ifndef CISOCHRONESEARCH_H
+#define CISOCHRONESEARCH_H
+
+#include <vector>
+#include <unordered_map>
+
+#include "CRoadGraph.h"
+#include "CPoiDatabase.h"
+#include "CPoiCategoryFilter.h"
+
+/*
+ * POI found by a reachability query
+ */
+struct t_reachablePoi
+{
+	const CPOI* pPoi;           // POI in the POI Database
+	double distanceKm;          // network distance from the start, snap distances included
+	unsigned int node;          // node the POI is attached to
+};
+
+class CIsochroneSearch
+{
+public:
+
+	/**
+	 * Constructor of class CIsochroneSearch
+	 * @param const CRoadGraph& graph : IN graph to be searched, must not be changed while the search object is used
+	 * @return no value
+	 */
+	CIsochroneSearch(const CRoadGraph& graph);
+
+	/**
+	 * Function attaches all POIs of the POI Database to their nearest node, replaces the attachments of an earlier call
+	 * @param const CPoiDatabase& poiDatabase : IN POI Database, must not be changed while the attachments are used
+	 * @param double maxSnapKm                : IN POIs (and start positions) further away from every node are not attached
+	 * @returnvalue unsigned int : number of attached POIs
+	 */
+	unsigned int attachPois(const CPoiDatabase& poiDatabase,
+			double maxSnapKm = 1.0);
+
+	/**
+	 * Function searches all POIs of a type reachable from a node within a distance budget
+	 * @param unsigned int from                      : IN start node
+	 * @param double budgetKm                        : IN maximum network distance
+	 * @param CPOI::t_poi type                       : IN type of the POIs
+	 * @param std::vector<t_reachablePoi>& result    : OUT reachable POIs, nearest first
+	 * @returnvalue true if the start node exists
+	 */
+	bool reachablePois(unsigned int from, double budgetKm, CPOI::t_poi type,
+			std::vector<t_reachablePoi>& result);
+
+	/**
+	 * Function searches all POIs of a type reachable from a position within a distance budget,
+	 * the search starts at the nearest node, the snap distance to it is part of the budget. attachPois() has to be called before.
+	 * @param const CWaypoint& position              : IN start position
+	 * @param double budgetKm                        : IN maximum network distance
+	 * @param CPOI::t_poi type                       : IN type of the POIs
+	 * @param std::vector<t_reachablePoi>& result    : OUT reachable POIs, nearest first
+	 * @returnvalue true if a node is within the snap distance of attachPois() from the position
+	 */
+	bool reachablePois(const CWaypoint& position, double budgetKm,
+			CPOI::t_poi type, std::vector<t_reachablePoi>& result);
+
+	/**
+	 * Function searches all POIs of the types of a filter reachable from a node within a distance budget
+	 * @param unsigned int from                      : IN start node
+	 * @param double budgetKm                        : IN maximum network distance
+	 * @param const CPoiCategoryFilter& filter       : IN types of the POIs
+	 * @param std::vector<t_reachablePoi>& result    : OUT reachable POIs, nearest first
+	 * @returnvalue true if the start node exists
+	 */
+	bool reachablePois(unsigned int from, double budgetKm,
+			const CPoiCategoryFilter& filter, std::vector<t_reachablePoi>& result);
+
+	/**
+	 * Function searches all POIs of the types of a filter reachable from a position within a distance budget,
+	 * the search starts at the nearest node, the snap distance to it is part of the budget. attachPois() has to be called before.
+	 * @param const CWaypoint& position              : IN start position
+	 * @param double budgetKm                        : IN maximum network distance
+	 * @param const CPoiCategoryFilter& filter       : IN types of the POIs
+	 * @param std::vector<t_reachablePoi>& result    : OUT reachable POIs, nearest first
+	 * @returnvalue true if a node is within the snap distance of attachPois() from the position
+	 */
+	bool reachablePois(const CWaypoint& position, double budgetKm,
+			const CPoiCategoryFilter& filter, std::vector<t_reachablePoi>& result);
+
+	/**
+	 * Function returns the nodes settled by the last query, the isochrone
+	 * @param no parameters
+	 * @returnvalue const std::vector<unsigned int>& : nodes within the budget, in the order of their distance
+	 */
+	const std::vector<unsigned int>& getReachedNodes() const;
+
+	/**
+	 * Function returns the network distance of a node reached by the last query
+	 * @param unsigned int node : IN node from getReachedNodes()
+	 * @returnvalue double : distance from the start in km
+	 */
+	double getDistance(unsigned int node) const;
+
+	/**
+	 * Function returns the number of attached POIs
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of POIs in the attachment table
+	 */
+	unsigned int getNoAttachedPois() const;
+
+private:
+
+	/*
+	 * entry of the binary heap, entries of nodes with a smaller distance found later are skipped when popped
+	 */
+	struct t_heapEntry
+	{
+		double distance;
+		unsigned int node;
+
+		bool operator<(const t_heapEntry& other) const
+		{
+			return distance > other.distance;     // std heap functions build a max heap, smallest distance on top
+		}
+	};
+
+	/**
+	 * Function searches the nearest node of a position in the cells of the node grid
+	 * @param double latitude   : IN latitude of the position
+	 * @param double longitude  : IN longitude of the position
+	 * @param double& distanceKm : OUT great circle distance to the node
+	 * @returnvalue unsigned int : nearest node within the snap distance, number of nodes if there is none
+	 */
+	unsigned int nearestNode(double latitude, double longitude,
+			double& distanceKm) const;
+
+	/**
+	 * Function returns the key of the grid cell of a position
+	 * @param long long row    : IN row of the cell (latitude / cell size)
+	 * @param long long column : IN column of the cell (longitude / cell size)
+	 * @returnvalue long long : key of the cell
+	 */
+	static long long cellKey(long long row, long long column);
+
+	/**
+	 * Function runs the bounded search and collects the attached POIs of the settled nodes
+	 * @param unsigned int from                      : IN start node
+	 * @param double startKm                         : IN distance of the start node (snap distance)
+	 * @param double budgetKm                        : IN maximum network distance
+	 * @param const CPoiCategoryFilter& filter       : IN types of the POIs
+	 * @param std::vector<t_reachablePoi>& result    : OUT reachable POIs, nearest first
+	 * @returnvalue void
+	 */
+	void search(unsigned int from, double startKm, double budgetKm,
+			const CPoiCategoryFilter& filter, std::vector<t_reachablePoi>& result);
+
+	const CRoadGraph& m_graph;
+
+	// attachment table
+	std::vector<unsigned int> m_firstAttached;      // number of nodes + 1 entries
+	std::vector<const CPOI*> m_attachedPoi;
+	std::vector<CPOI::t_poi> m_attachedType;
+	std::vector<double> m_attachedSnapKm;
+	double m_maxSnapKm;
+
+	// nodes in grid cells of m_maxSnapKm, to find the node of a POI or start position
+	std::unordered_map<long long, std::vector<unsigned int> > m_nodeCells;
+	double m_cellDegree;
+
+	// search state, reused by the queries
+	std::vector<double> m_distance;
+	std::vector<unsigned int> m_stamp;      // query which set the distance of the node
+	std::vector<t_heapEntry> m_heap;
+	std::vector<unsigned int> m_reached;
+	unsigned int m_queryStamp;
+	CPoiCategoryFilter m_typeFilter;        // filter of the queries for a single type
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CISOCHRONESEARCH_H */
@@ -21,13 +21,6 @@ using namespace std;
 #include "CJsonScanner.h"
 using namespace APT;
 
-/**
- * Function returns the type of POI based on the input string
- * @param const string& type : IN type of POI in string
- * @returnvalue t_poi type of POI
- */
-CPOI::t_poi stringToPoi(const string& type);
-
 /**
  * Template Function for translating Database (WP Database or POI Database) to JSON Format.
  * Translated version can be found in the string "line"
@@ -116,6 +109,7 @@ bool CJsonPersistence::readData(CWpDatabase& waypointDb, CPoiDatabase& poiDb,
 	state nextState;
 	string databaseName, attributeName; // declaring variables required for State Machine processing
 	string name, type, description;
+	t_poiCategory category;
 	double longitude, latitude;
 	bool objectOK = true;
 	unsigned int attributeCount = 0;
@@ -129,8 +123,8 @@ bool CJsonPersistence::readData(CWpDatabase& waypointDb, CPoiDatabase& poiDb,
 
 	if (mode == REPLACE) // If merge mode is REPLACE, the content of persistent storage will completely replace
 	{                            // the content of WP Database and POI Database.
-		waypointDb.clearDb();
-		poiDb.clearDb();                    // clearing both Database
+		waypointDb.clearWpDb();
+		poiDb.clearPoiDb();                 // clearing both Database (and the type index of the POIs)
 	}
 
 	try
@@ -381,7 +375,8 @@ bool CJsonPersistence::readData(CWpDatabase& waypointDb, CPoiDatabase& poiDb,
 						}
 						else
 						{
-							CWaypoint wp(name, latitude, longitude);
+							CWaypoint wp(name, latitude, longitude,
+									waypointDb.getStringPool());
 							waypointDb.addWaypoint(wp); // WP is added to WP Database
 						}
 					}
@@ -397,11 +392,19 @@ bool CJsonPersistence::readData(CWpDatabase& waypointDb, CPoiDatabase& poiDb,
 									<< "  Therefore skipping current object.."
 									<< endl;
 						}
+						else if ((category = CPoiCategoryRegistry::registerCategory(type))
+								== POI_CATEGORY_INVALID)
+						// an unknown type is registered as new category
+						{
+							cout << "ERROR: Invalid POI type " << type
+									<< " at line :" << scan.scannedLine()
+									<< "  Therefore skipping current object.."
+									<< endl;
+						}
 						else
-
 						{
-							CPOI poi(stringToPoi(type), name, description,
-									latitude, longitude);
+							CPOI poi(category, name, description,
+									latitude, longitude, poiDb.getStringPool());
 							poiDb.addPoi(poi);   // POI is added to POI Database
 						}
 					}
@@ -495,21 +498,3 @@ void CJsonPersistence::setMediaName(const std::string& name)
 {
 	m_mediaName = name;
 }
-
-/**
- * Function returns the type of POI based on the input string
- * @param const string& type : IN type of POI in string
- * @returnvalue t_poi type of POI
- */
-CPOI::t_poi stringToPoi(const string& type)
-{
-
-	if (type.compare("RESTAURANT") == 0)
-		return CPOI::RESTAURANT;
-	else if (type.compare("TOURISTIC") == 0)
-		return CPOI::TOURISTIC;
-	else if (type.compare("GASSTATION") == 0)
-		return CPOI::GASSTATION;
-	else
-		return CPOI::UNIVERSITY;
-}
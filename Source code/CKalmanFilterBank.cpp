@@ -0,0 +1,263 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CKALMANFILTERBANK.CPP
+ * Author          : George Sebastian
+ * Description     : CKalmanFilterBank smooths the GPS fixes of many vehicles with a
+ *                   constant velocity Kalman filter per vehicle. Each filter works in
+ *                   the local tangent plane (metres east/north) around a reference point
+ *                   near the vehicle and returns the smoothed position and the velocity.
+ *                   Model per axis : state [position velocity], transition [1 dt; 0 1],
+ *                   white noise acceleration, the GPS measures the position.
+ ****************************************************************************/
+#include <math.h>
+using namespace std;
+
+#include "CKalmanFilterBank.h"
+#include "CUnitVector.h"
+
+#define METRES_PER_DEGREE (1000.0 * CUnitVector::KM_PER_DEGREE)
+#define DEG_TO_RAD 0.017453292519943295
+#define MAX_GAP_SECONDS 60.0                // after a longer gap the filter starts again
+#define MAX_REFERENCE_DISTANCE 10000.0      // metres, the reference point follows the vehicle (scale error of the plane < 0.2%)
+#define INITIAL_VELOCITY_SIGMA 30.0         // m/s, velocity is unknown at the first fix
+#define INNOVATION_GATE 10.0                // fixes further than 10 standard deviations from the prediction restart the filter
+
+/**
+ * Constructor of class CKalmanFilterBank
+ * @param unsigned int noVehicles      : IN number of vehicles, each vehicle has its own filter
+ * @param double accelerationNoise     : IN standard deviation of the acceleration of the vehicles in m/s^2
+ * @param double measurementNoise      : IN standard deviation of the GPS noise in metres
+ * @return no value
+ */
+CKalmanFilterBank::CKalmanFilterBank(unsigned int noVehicles,
+		double accelerationNoise, double measurementNoise)
+{
+	m_accelerationVariance = accelerationNoise * accelerationNoise;
+	m_measurementVariance = measurementNoise * measurementNoise;
+
+	if (m_measurementVariance <= 0.0)
+		// position would be taken without smoothing and the gain divides by zero
+		m_measurementVariance = 1e-6;
+
+	m_refLatitude.resize(noVehicles);
+	m_refLongitude.resize(noVehicles);
+	m_metresPerDegreeEast.resize(noVehicles);
+	m_east.resize(noVehicles);
+	m_north.resize(noVehicles);
+	m_velocityEast.resize(noVehicles);
+	m_velocityNorth.resize(noVehicles);
+	m_p00.resize(noVehicles);
+	m_p01.resize(noVehicles);
+	m_p11.resize(noVehicles);
+	m_lastTimestamp.resize(noVehicles);
+	m_initialised.assign(noVehicles, 0);
+}
+
+/**
+ * Function filters a fix of a vehicle. The first fix (or a fix after a long gap) initialises the filter.
+ * @param unsigned int vehicle     : IN number of the vehicle, 0 .. number of vehicles - 1
+ * @param const t_gpsFix& fix      : IN raw fix
+ * @param t_filteredFix& filtered  : OUT smoothed position and velocity
+ * @returnvalue void
+ */
+void CKalmanFilterBank::filter(unsigned int vehicle, const t_gpsFix& fix,
+		t_filteredFix& filtered)
+{
+	double dt = fix.timestamp - m_lastTimestamp[vehicle];
+
+	if (!m_initialised[vehicle] || dt > MAX_GAP_SECONDS || dt < 0.0)
+	// first fix, the vehicle was lost or the timestamps jumped back
+		initialise(vehicle, fix);
+	else
+	{
+		// prediction : P = F P F^T + Q for F = [1 dt; 0 1], Q = q [dt^4/4 dt^3/2; dt^3/2 dt^2]
+		double dt2 = dt * dt;
+		double q = m_accelerationVariance;
+		double p00 = m_p00[vehicle], p01 = m_p01[vehicle], p11 = m_p11[vehicle];
+
+		p00 += 2 * dt * p01 + dt2 * p11 + q * dt2 * dt2 * 0.25;
+		p01 += dt * p11 + q * dt2 * dt * 0.5;
+		p11 += q * dt2;
+
+		double east = m_east[vehicle] + dt * m_velocityEast[vehicle];
+		double north = m_north[vehicle] + dt * m_velocityNorth[vehicle];
+
+		// update with the measured position : gain K = P H^T / (H P H^T + R) for H = [1 0]
+		double gainPosition = p00 / (p00 + m_measurementVariance);
+		double gainVelocity = p01 / (p00 + m_measurementVariance);
+
+		double longitudeDifference = fix.longitude - m_refLongitude[vehicle];
+		if (longitudeDifference > 180.0)
+			// vehicle crossed the date line
+			longitudeDifference -= 360.0;
+		else if (longitudeDifference < -180.0)
+			longitudeDifference += 360.0;
+
+		double innovationEast = longitudeDifference
+				* m_metresPerDegreeEast[vehicle] - east;
+		double innovationNorth = (fix.latitude - m_refLatitude[vehicle])
+				* METRES_PER_DEGREE - north;
+
+		if (innovationEast * innovationEast + innovationNorth * innovationNorth
+				> INNOVATION_GATE * INNOVATION_GATE
+						* (p00 + m_measurementVariance))
+		// position jumped (e.g. new recording, teleported test vehicle), the state is useless
+		{
+			initialise(vehicle, fix);
+			outputState(vehicle, fix.timestamp, filtered);
+			return;
+		}
+
+		m_east[vehicle] = east + gainPosition * innovationEast;
+		m_north[vehicle] = north + gainPosition * innovationNorth;
+		m_velocityEast[vehicle] += gainVelocity * innovationEast;
+		m_velocityNorth[vehicle] += gainVelocity * innovationNorth;
+
+		// P = (I - K H) P
+		m_p00[vehicle] = (1 - gainPosition) * p00;
+		m_p01[vehicle] = (1 - gainPosition) * p01;
+		m_p11[vehicle] = p11 - gainVelocity * p01;
+		m_lastTimestamp[vehicle] = fix.timestamp;
+
+		if (fabs(m_east[vehicle]) > MAX_REFERENCE_DISTANCE
+				|| fabs(m_north[vehicle]) > MAX_REFERENCE_DISTANCE)
+			moveReferencePoint(vehicle);
+	}
+
+	outputState(vehicle, fix.timestamp, filtered);
+}
+
+/**
+ * Function filters a batch of fixes of different vehicles, in the order of the batch
+ * @param const unsigned int* vehicles  : IN vehicle of each fix
+ * @param const t_gpsFix* fixes         : IN raw fixes
+ * @param unsigned int noFixes          : IN number of fixes in the batch
+ * @param t_filteredFix* filtered       : OUT smoothed fixes, array of noFixes elements
+ * @returnvalue void
+ */
+void CKalmanFilterBank::filterBatch(const unsigned int* vehicles,
+		const t_gpsFix* fixes, unsigned int noFixes, t_filteredFix* filtered)
+{
+	for (unsigned int i = 0; i < noFixes; i++)
+		filter(vehicles[i], fixes[i], filtered[i]);
+}
+
+/**
+ * Function forgets the state of a vehicle, the next fix initialises its filter again
+ * @param unsigned int vehicle : IN number of the vehicle
+ * @returnvalue void
+ */
+void CKalmanFilterBank::reset(unsigned int vehicle)
+{
+	m_initialised[vehicle] = 0;
+}
+
+/**
+ * Function adds a filter for one more vehicle
+ * @param no parameters
+ * @returnvalue unsigned int : number of the new vehicle
+ */
+unsigned int CKalmanFilterBank::addVehicle()
+{
+	m_refLatitude.push_back(0.0);
+	m_refLongitude.push_back(0.0);
+	m_metresPerDegreeEast.push_back(METRES_PER_DEGREE);
+	m_east.push_back(0.0);
+	m_north.push_back(0.0);
+	m_velocityEast.push_back(0.0);
+	m_velocityNorth.push_back(0.0);
+	m_p00.push_back(0.0);
+	m_p01.push_back(0.0);
+	m_p11.push_back(0.0);
+	m_lastTimestamp.push_back(0.0);
+	m_initialised.push_back(0);
+
+	return m_initialised.size() - 1;
+}
+
+/**
+ * Function returns the number of vehicles
+ * @param no parameters
+ * @returnvalue unsigned int : number of vehicles
+ */
+unsigned int CKalmanFilterBank::getNoVehicles() const
+{
+	return m_initialised.size();
+}
+
+/**
+ * Function starts the filter of a vehicle at a fix, the fix is the reference point of the tangent plane
+ * @param unsigned int vehicle : IN number of the vehicle
+ * @param const t_gpsFix& fix  : IN first fix
+ * @returnvalue void
+ */
+void CKalmanFilterBank::initialise(unsigned int vehicle, const t_gpsFix& fix)
+{
+	m_refLatitude[vehicle] = fix.latitude;
+	m_refLongitude[vehicle] = fix.longitude;
+	m_metresPerDegreeEast[vehicle] = METRES_PER_DEGREE
+			* cos(fix.latitude * DEG_TO_RAD);
+
+	if (m_metresPerDegreeEast[vehicle] < 1.0)
+		// at the poles
+		m_metresPerDegreeEast[vehicle] = 1.0;
+
+	m_east[vehicle] = 0.0;
+	m_north[vehicle] = 0.0;
+	m_velocityEast[vehicle] = 0.0;
+	m_velocityNorth[vehicle] = 0.0;
+
+	m_p00[vehicle] = m_measurementVariance;
+	m_p01[vehicle] = 0.0;
+	m_p11[vehicle] = INITIAL_VELOCITY_SIGMA * INITIAL_VELOCITY_SIGMA;
+
+	m_lastTimestamp[vehicle] = fix.timestamp;
+	m_initialised[vehicle] = 1;
+}
+
+/**
+ * Function converts the state of a vehicle to a smoothed fix
+ * @param unsigned int vehicle    : IN number of the vehicle
+ * @param double timestamp        : IN timestamp of the fix
+ * @param t_filteredFix& filtered : OUT smoothed position and velocity
+ * @returnvalue void
+ */
+void CKalmanFilterBank::outputState(unsigned int vehicle, double timestamp,
+		t_filteredFix& filtered) const
+{
+	filtered.latitude = m_refLatitude[vehicle]
+			+ m_north[vehicle] / METRES_PER_DEGREE;
+	filtered.longitude = m_refLongitude[vehicle]
+			+ m_east[vehicle] / m_metresPerDegreeEast[vehicle];
+	if (filtered.longitude > 180.0)
+		filtered.longitude -= 360.0;
+	else if (filtered.longitude < -180.0)
+		filtered.longitude += 360.0;
+	filtered.timestamp = timestamp;
+	filtered.velocityNorth = m_velocityNorth[vehicle];
+	filtered.velocityEast = m_velocityEast[vehicle];
+}
+
+/**
+ * Function moves the reference point of the tangent plane of a vehicle to its current position
+ * @param unsigned int vehicle : IN number of the vehicle
+ * @returnvalue void
+ */
+void CKalmanFilterBank::moveReferencePoint(unsigned int vehicle)
+{
+	m_refLatitude[vehicle] += m_north[vehicle] / METRES_PER_DEGREE;
+	m_refLongitude[vehicle] += m_east[vehicle] / m_metresPerDegreeEast[vehicle];
+	if (m_refLongitude[vehicle] > 180.0)
+		m_refLongitude[vehicle] -= 360.0;
+	else if (m_refLongitude[vehicle] < -180.0)
+		m_refLongitude[vehicle] += 360.0;
+	m_metresPerDegreeEast[vehicle] = METRES_PER_DEGREE
+			* cos(m_refLatitude[vehicle] * DEG_TO_RAD);
+
+	if (m_metresPerDegreeEast[vehicle] < 1.0)
+		m_metresPerDegreeEast[vehicle] = 1.0;
+
+	m_east[vehicle] = 0.0;
+	m_north[vehicle] = 0.0;
+}
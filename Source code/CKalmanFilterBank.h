@@ -0,0 +1,143 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CKALMANFILTERBANK.H
+ * Author          : George Sebastian
+ * Description     : CKalmanFilterBank smooths the GPS fixes of many vehicles with a
+ *                   constant velocity Kalman filter per vehicle. Each filter works in
+ *                   the local tangent plane (metres east/north) around a reference point
+ *                   near the vehicle and returns the smoothed position and the velocity.
+ *                   The states of all vehicles are kept in one array per component
+ *                   (structure of arrays), a fix is filtered with a few multiplications
+ *                   and without allocation.
+ *                   East and north use the same model and the same measurement noise,
+ *                   so their 2x2 covariance matrices are equal and stored only once.
+ ****************************************************************************/
+#ifndef CKALMANFILTERBANK_H
+#define CKALMANFILTERBANK_H
+
+#include <vector>
+
+#include "CPositionSensor.h"
+
+/*
+ * smoothed fix of a vehicle
+ */
+struct t_filteredFix
+{
+	double latitude;          // degree
+	double longitude;         // degree
+	double timestamp;         // seconds, as the raw fix
+	double velocityNorth;     // m/s
+	double velocityEast;      // m/s
+};
+
+class CKalmanFilterBank
+{
+public:
+
+	/**
+	 * Constructor of class CKalmanFilterBank
+	 * @param unsigned int noVehicles      : IN number of vehicles, each vehicle has its own filter
+	 * @param double accelerationNoise     : IN standard deviation of the acceleration of the vehicles in m/s^2
+	 * @param double measurementNoise      : IN standard deviation of the GPS noise in metres
+	 * @return no value
+	 */
+	CKalmanFilterBank(unsigned int noVehicles = 1,
+			double accelerationNoise = 2.0, double measurementNoise = 10.0);
+
+	/**
+	 * Function filters a fix of a vehicle. The first fix (or a fix after a long gap or a jump) initialises the filter.
+	 * @param unsigned int vehicle     : IN number of the vehicle, 0 .. number of vehicles - 1
+	 * @param const t_gpsFix& fix      : IN raw fix
+	 * @param t_filteredFix& filtered  : OUT smoothed position and velocity
+	 * @returnvalue void
+	 */
+	void filter(unsigned int vehicle, const t_gpsFix& fix,
+			t_filteredFix& filtered);
+
+	/**
+	 * Function filters a batch of fixes of different vehicles, in the order of the batch
+	 * @param const unsigned int* vehicles  : IN vehicle of each fix
+	 * @param const t_gpsFix* fixes         : IN raw fixes
+	 * @param unsigned int noFixes          : IN number of fixes in the batch
+	 * @param t_filteredFix* filtered       : OUT smoothed fixes, array of noFixes elements
+	 * @returnvalue void
+	 */
+	void filterBatch(const unsigned int* vehicles, const t_gpsFix* fixes,
+			unsigned int noFixes, t_filteredFix* filtered);
+
+	/**
+	 * Function forgets the state of a vehicle, the next fix initialises its filter again
+	 * @param unsigned int vehicle : IN number of the vehicle
+	 * @returnvalue void
+	 */
+	void reset(unsigned int vehicle);
+
+	/**
+	 * Function adds a filter for one more vehicle
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of the new vehicle
+	 */
+	unsigned int addVehicle();
+
+	/**
+	 * Function returns the number of vehicles
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of vehicles
+	 */
+	unsigned int getNoVehicles() const;
+
+private:
+
+	/**
+	 * Function starts the filter of a vehicle at a fix, the fix is the reference point of the tangent plane
+	 * @param unsigned int vehicle : IN number of the vehicle
+	 * @param const t_gpsFix& fix  : IN first fix
+	 * @returnvalue void
+	 */
+	void initialise(unsigned int vehicle, const t_gpsFix& fix);
+
+	/**
+	 * Function converts the state of a vehicle to a smoothed fix
+	 * @param unsigned int vehicle    : IN number of the vehicle
+	 * @param double timestamp        : IN timestamp of the fix
+	 * @param t_filteredFix& filtered : OUT smoothed position and velocity
+	 * @returnvalue void
+	 */
+	void outputState(unsigned int vehicle, double timestamp,
+			t_filteredFix& filtered) const;
+
+	/**
+	 * Function moves the reference point of the tangent plane of a vehicle to its current position
+	 * @param unsigned int vehicle : IN number of the vehicle
+	 * @returnvalue void
+	 */
+	void moveReferencePoint(unsigned int vehicle);
+
+	double m_accelerationVariance;    // (m/s^2)^2
+	double m_measurementVariance;     // m^2
+
+	// reference point of the tangent plane of each vehicle
+	std::vector<double> m_refLatitude;
+	std::vector<double> m_refLongitude;
+	std::vector<double> m_metresPerDegreeEast;
+
+	// state : position in metres east/north of the reference point and velocity in m/s
+	std::vector<double> m_east;
+	std::vector<double> m_north;
+	std::vector<double> m_velocityEast;
+	std::vector<double> m_velocityNorth;
+
+	// covariance [p00 p01; p01 p11] of position and velocity, equal for east and north
+	std::vector<double> m_p00;
+	std::vector<double> m_p01;
+	std::vector<double> m_p11;
+
+	std::vector<double> m_lastTimestamp;
+	std::vector<unsigned char> m_initialised;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CKALMANFILTERBANK_H */
@@ -0,0 +1,547 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CLANDMARKTABLE.CPP
+ * Author          : George Sebastian
+ * Description     : CLandmarkTable holds the landmark distances of ALT. The distances of
+ *                   a landmark (from it along the edges, to it along the reverse edges) are
+ *                   two independent Dijkstra searches over the whole graph; they run as
+ *                   tasks of a thread pool. FARTHEST selects all landmarks first and then
+ *                   searches for all of them at once; AVOID needs the landmarks chosen so
+ *                   far for the next one and runs the two searches of each landmark in
+ *                   parallel.
+ *                   Metres are rounded to the nearest integer, so a difference of two
+ *                   stored values is at most 1 m larger than the difference of the exact
+ *                   distances : the lower bound subtracts 1 m and stays admissible.
+ *                   File format (32 byte header, then the arrays as in memory) :
+ *                   "NVLM", version, number of nodes, number of landmarks, fingerprint of
+ *                   the graph (nodes, edges and costs), 8 bytes reserved, landmark nodes,
+ *                   table. Distances of another graph would make the lower bounds
+ *                   inadmissible, so such a file is rejected.
+ ****************************************************************************/
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <math.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+#include "CLandmarkTable.h"
+#include "CWorkStealingPool.h"
+
+#define LANDMARK_FILE_VERSION 2       // 2 : fingerprint of the graph includes the edges
+#define LANDMARK_HEADER_SIZE 32
+#define HEURISTIC_FACTOR 0.999999    // great circle bound reduced slightly, rounding must not make it larger than an edge cost
+
+/**
+ * Constructor of class CLandmarkTable, the table is empty
+ * @param no parameters
+ * @return no value
+ */
+CLandmarkTable::CLandmarkTable()
+{
+	m_pGraph = NULL;
+	m_noLandmarks = 0;
+	m_pTable = NULL;
+	m_pMapping = NULL;
+	m_mappingSize = 0;
+}
+
+/**
+ * Destructor of class CLandmarkTable, unmaps a loaded file
+ * @param no parameters
+ * @return no value
+ */
+CLandmarkTable::~CLandmarkTable()
+{
+	clear();
+}
+
+/**
+ * Function selects the landmarks and computes their distances, the searches run on a thread pool
+ * @param const CRoadGraph& graph : IN graph, buildAdjacency() has to be called before; must live as long as the table
+ * @param unsigned int noLandmarks : IN number of landmarks (16 is a good choice for road networks)
+ * @param t_selection selection    : IN selection of the landmarks
+ * @param unsigned int noThreads   : IN threads for the searches, 0 for the number of cores
+ * @returnvalue void
+ */
+void CLandmarkTable::build(const CRoadGraph& graph, unsigned int noLandmarks,
+		t_selection selection, unsigned int noThreads)
+{
+	unsigned int noNodes = graph.getNoNodes();
+
+	clear();
+	m_pGraph = &graph;
+	m_noLandmarks = min(noLandmarks, noNodes);
+	m_table.assign(2 * (size_t) noNodes * m_noLandmarks, LANDMARK_UNREACHABLE);
+	m_pTable = m_table.empty() ? NULL : &m_table[0];
+
+	CWorkStealingPool pool(noThreads);
+
+	if (selection == FARTHEST)
+	{
+		selectFarthest(m_noLandmarks);
+
+		// all searches at once : task 2 l from landmark l, task 2 l + 1 to it
+		vector<vector<double> > distances(2 * m_noLandmarks);
+		pool.parallelFor(2 * m_noLandmarks, [&](unsigned int task)
+		{
+			searchAll(m_landmarks[task / 2], task % 2 == 1, distances[task], NULL, NULL);
+		});
+
+		for (unsigned int l = 0; l < m_noLandmarks; l++)
+			storeDistances(l, distances[2 * l], distances[2 * l + 1]);
+	}
+	else
+	{
+		vector<double> distances[2];
+
+		for (unsigned int l = 0; l < m_noLandmarks; l++)
+		{
+			// roots spread over the node numbers
+			unsigned int root = (unsigned int) ((l * 2654435761ULL + 1) % noNodes);
+			unsigned int landmark = selectAvoid(root);
+
+			m_landmarks.push_back(landmark);
+			pool.parallelFor(2, [&](unsigned int task)
+			{
+				searchAll(landmark, task == 1, distances[task], NULL, NULL);
+			});
+			storeDistances(l, distances[0], distances[1]);
+		}
+	}
+}
+
+/**
+ * Function writes the table to a binary file
+ * @param const std::string& fileName : IN name of the file
+ * @returnvalue true if the file could be written
+ */
+bool CLandmarkTable::save(const string& fileName) const
+{
+	if (m_pGraph == NULL)
+		return false;
+
+	ofstream file(fileName.c_str(), ios::binary);
+	if (!file)
+	{
+		cout << "ERROR : " << fileName << " could not be opened" << endl;
+		return false;
+	}
+
+	char header[LANDMARK_HEADER_SIZE] = { 'N', 'V', 'L', 'M' };
+	uint32_t version = LANDMARK_FILE_VERSION;
+	uint32_t noNodes = m_pGraph->getNoNodes();
+	uint32_t noLandmarks = m_noLandmarks;
+	uint64_t fingerprint = m_pGraph->getFingerprint();
+
+	copy((const char*) &version, (const char*) &version + 4, header + 4);
+	copy((const char*) &noNodes, (const char*) &noNodes + 4, header + 8);
+	copy((const char*) &noLandmarks, (const char*) &noLandmarks + 4, header + 12);
+	copy((const char*) &fingerprint, (const char*) &fingerprint + 8, header + 16);
+
+	file.write(header, LANDMARK_HEADER_SIZE);
+	for (unsigned int l = 0; l < m_noLandmarks; l++)
+	{
+		uint32_t landmark = m_landmarks[l];
+		file.write((const char*) &landmark, sizeof(landmark));
+	}
+	file.write((const char*) m_pTable,
+			2 * (size_t) noNodes * m_noLandmarks * sizeof(uint32_t));
+
+	return (bool) file;
+}
+
+/**
+ * Function maps a file written by save() into memory
+ * @param const std::string& fileName : IN name of the file
+ * @param const CRoadGraph& graph     : IN graph from which the table was built (same nodes in the same order, same edges and costs)
+ * @returnvalue true if the file could be mapped and belongs to the graph
+ */
+bool CLandmarkTable::load(const string& fileName, const CRoadGraph& graph)
+{
+	clear();
+
+	ifstream file(fileName.c_str(), ios::binary);
+	if (!file)
+	{
+		cout << "ERROR : " << fileName << " could not be opened" << endl;
+		return false;
+	}
+
+	char header[LANDMARK_HEADER_SIZE];
+	uint32_t version = 0, noNodes = 0, noLandmarks = 0;
+	uint64_t fingerprint = 0;
+
+	file.read(header, LANDMARK_HEADER_SIZE);
+	copy(header + 4, header + 8, (char*) &version);
+	copy(header + 8, header + 12, (char*) &noNodes);
+	copy(header + 12, header + 16, (char*) &noLandmarks);
+	copy(header + 16, header + 24, (char*) &fingerprint);
+
+	if (!file || string(header, 4) != "NVLM" || version != LANDMARK_FILE_VERSION)
+	{
+		cout << "ERROR : " << fileName << " is no landmark table" << endl;
+		return false;
+	}
+
+	if (noNodes != graph.getNoNodes() || fingerprint != graph.getFingerprint())
+	{
+		cout << "ERROR : " << fileName << " was built from another graph" << endl;
+		return false;
+	}
+
+	size_t tableOffset = LANDMARK_HEADER_SIZE + noLandmarks * sizeof(uint32_t);
+	size_t tableSize = 2 * (size_t) noNodes * noLandmarks * sizeof(uint32_t);
+
+	file.seekg(0, ios::end);
+	if ((size_t) file.tellg() != tableOffset + tableSize)
+	{
+		cout << "ERROR : " << fileName << " is corrupted" << endl;
+		return false;
+	}
+
+	m_landmarks.resize(noLandmarks);
+	file.seekg(LANDMARK_HEADER_SIZE);
+	for (unsigned int l = 0; l < noLandmarks; l++)
+	{
+		uint32_t landmark;
+		file.read((char*) &landmark, sizeof(landmark));
+		m_landmarks[l] = landmark;
+	}
+
+#ifdef _WIN32
+	// no mapping : the table is read
+	m_table.resize(tableSize / sizeof(uint32_t));
+	file.read((char*) &m_table[0], tableSize);
+	m_pTable = m_table.empty() ? NULL : &m_table[0];
+#else
+	file.close();
+
+	int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+		return false;
+
+	void* pMapping = mmap(NULL, tableOffset + tableSize, PROT_READ, MAP_PRIVATE,
+			fileDescriptor, 0);
+	close(fileDescriptor);     // the mapping stays valid
+
+	if (pMapping == MAP_FAILED)
+	{
+		cout << "ERROR : " << fileName << " could not be mapped" << endl;
+		m_landmarks.clear();
+		return false;
+	}
+
+	m_pMapping = pMapping;
+	m_mappingSize = tableOffset + tableSize;
+	m_pTable = (const uint32_t*) ((const char*) pMapping + tableOffset);
+#endif
+
+	m_pGraph = &graph;
+	m_noLandmarks = noLandmarks;
+	return true;
+}
+
+/**
+ * Function returns a lower bound of the shortest path distance between two nodes
+ * @param unsigned int from : IN start node
+ * @param unsigned int to   : IN destination node
+ * @returnvalue double : lower bound in km
+ */
+double CLandmarkTable::lowerBound(unsigned int from, unsigned int to) const
+{
+	const uint32_t* pFrom = m_pTable + 2 * (size_t) from * m_noLandmarks;
+	const uint32_t* pTo = m_pTable + 2 * (size_t) to * m_noLandmarks;
+	uint32_t bestMetres = 0;
+
+	for (unsigned int l = 0; l < 2 * m_noLandmarks; l += 2)
+	{
+		// d(from,to) >= d(L,to) - d(L,from)
+		if (pTo[l] != LANDMARK_UNREACHABLE && pFrom[l] != LANDMARK_UNREACHABLE
+				&& pTo[l] > pFrom[l] + 1)
+			bestMetres = max(bestMetres, pTo[l] - pFrom[l] - 1);
+
+		// d(from,to) >= d(from,L) - d(to,L)
+		if (pFrom[l + 1] != LANDMARK_UNREACHABLE
+				&& pTo[l + 1] != LANDMARK_UNREACHABLE && pFrom[l + 1] > pTo[l + 1] + 1)
+			bestMetres = max(bestMetres, pFrom[l + 1] - pTo[l + 1] - 1);
+	}
+
+	return bestMetres / 1000.0;
+}
+
+/**
+ * Function returns the graph of the table
+ * @param no parameters
+ * @returnvalue const CRoadGraph* : graph, NULL if the table is empty
+ */
+const CRoadGraph* CLandmarkTable::getGraph() const
+{
+	return m_pGraph;
+}
+
+/**
+ * Function returns the number of landmarks
+ * @param no parameters
+ * @returnvalue unsigned int : number of landmarks
+ */
+unsigned int CLandmarkTable::getNoLandmarks() const
+{
+	return m_noLandmarks;
+}
+
+/**
+ * Function returns the node of a landmark
+ * @param unsigned int landmark : IN number of the landmark
+ * @returnvalue unsigned int : node
+ */
+unsigned int CLandmarkTable::getLandmark(unsigned int landmark) const
+{
+	return m_landmarks[landmark];
+}
+
+/**
+ * Function computes the shortest path distances from a node to all nodes (or from all nodes to it)
+ * @param unsigned int source               : IN start node
+ * @param bool backward                     : IN distances to the node along the reverse edges
+ * @param std::vector<double>& distance     : OUT distances in km, negative : unreachable
+ * @param std::vector<unsigned int>* pOrder : OUT nodes in the order they were settled, may be NULL
+ * @param std::vector<unsigned int>* pParent : OUT parent in the shortest path tree, may be NULL
+ * @returnvalue void
+ */
+void CLandmarkTable::searchAll(unsigned int source, bool backward,
+		vector<double>& distance, vector<unsigned int>* pOrder,
+		vector<unsigned int>* pParent) const
+{
+	const CRoadGraph& graph = *m_pGraph;
+	const vector<unsigned int>& firstEdge = backward ? graph.m_firstReverseEdge : graph.m_firstEdge;
+	const vector<unsigned int>& edgeNode = backward ? graph.m_reverseEdgeSource : graph.m_edgeTarget;
+	const vector<double>& edgeCost = backward ? graph.m_reverseEdgeCost : graph.m_edgeCost;
+	greater<pair<double, unsigned int> > smallestOnTop;
+	vector<pair<double, unsigned int> > heap;
+
+	distance.assign(graph.getNoNodes(), -1.0);
+	if (pOrder != NULL)
+		pOrder->clear();
+	if (pParent != NULL)
+		pParent->assign(graph.getNoNodes(), source);
+
+	distance[source] = 0.0;
+	heap.push_back(make_pair(0.0, source));
+
+	while (!heap.empty())
+	{
+		pair<double, unsigned int> top = heap.front();
+		pop_heap(heap.begin(), heap.end(), smallestOnTop);
+		heap.pop_back();
+
+		if (top.first > distance[top.second])
+			// outdated entry
+			continue;
+
+		if (pOrder != NULL)
+			pOrder->push_back(top.second);
+
+		for (unsigned int e = firstEdge[top.second]; e < firstEdge[top.second + 1]; e++)
+		{
+			unsigned int node = edgeNode[e];
+			double nodeDistance = top.first + edgeCost[e];
+
+			if (distance[node] >= 0.0 && distance[node] <= nodeDistance)
+				continue;
+
+			distance[node] = nodeDistance;
+			if (pParent != NULL)
+				(*pParent)[node] = top.second;
+			heap.push_back(make_pair(nodeDistance, node));
+			push_heap(heap.begin(), heap.end(), smallestOnTop);
+		}
+	}
+}
+
+/**
+ * Function selects the landmarks by the farthest great circle distance to the landmarks chosen before
+ * @param unsigned int noLandmarks : IN number of landmarks
+ * @returnvalue void
+ */
+void CLandmarkTable::selectFarthest(unsigned int noLandmarks)
+{
+	const vector<CUnitVector>& positions = m_pGraph->m_positions;
+	unsigned int noNodes = positions.size();
+
+	// smallest chord to the chosen landmarks, the first landmark is the node farthest from node 0
+	vector<double> nearest(noNodes);
+	for (unsigned int node = 0; node < noNodes; node++)
+	{
+		double dx = positions[node].m_x - positions[0].m_x;
+		double dy = positions[node].m_y - positions[0].m_y;
+		double dz = positions[node].m_z - positions[0].m_z;
+		nearest[node] = dx * dx + dy * dy + dz * dz;
+	}
+
+	while (m_landmarks.size() < noLandmarks)
+	{
+		unsigned int landmark = max_element(nearest.begin(), nearest.end())
+				- nearest.begin();
+		const CUnitVector& p = positions[landmark];
+
+		m_landmarks.push_back(landmark);
+		for (unsigned int node = 0; node < noNodes; node++)
+		{
+			double dx = positions[node].m_x - p.m_x;
+			double dy = positions[node].m_y - p.m_y;
+			double dz = positions[node].m_z - p.m_z;
+			nearest[node] = min(nearest[node], dx * dx + dy * dy + dz * dz);
+		}
+	}
+}
+
+/**
+ * Function selects the next landmark as leaf of the heaviest subtree of a shortest path tree (avoid)
+ * @param unsigned int root : IN root of the tree
+ * @returnvalue unsigned int : node of the new landmark
+ */
+unsigned int CLandmarkTable::selectAvoid(unsigned int root) const
+{
+	const vector<CUnitVector>& positions = m_pGraph->m_positions;
+	unsigned int noNodes = m_pGraph->getNoNodes();
+	vector<double> distance;
+	vector<unsigned int> order, parent;
+
+	searchAll(root, false, distance, &order, &parent);
+
+	// weight : how much the best lower bound (landmarks or great circle) underestimates the distance from the root
+	vector<double> size(noNodes, 0.0);
+	vector<unsigned char> hasLandmark(noNodes, 0);
+
+	for (unsigned int i = 0; i < order.size(); i++)
+	{
+		unsigned int node = order[i];
+		double dx = positions[node].m_x - positions[root].m_x;
+		double dy = positions[node].m_y - positions[root].m_y;
+		double dz = positions[node].m_z - positions[root].m_z;
+		double bound = max(lowerBound(root, node),
+				sqrt(dx * dx + dy * dy + dz * dz) * CUnitVector::EARTH_RADIUS
+						* HEURISTIC_FACTOR);
+
+		size[node] = max(0.0, distance[node] - bound);
+	}
+
+	for (unsigned int l = 0; l < m_landmarks.size(); l++)
+		hasLandmark[m_landmarks[l]] = 1;
+
+	// size of a subtree : sum of the weights, 0 if it contains a landmark; children are settled after their parent
+	for (unsigned int i = order.size(); i-- > 1;)
+	{
+		unsigned int node = order[i];
+
+		if (hasLandmark[node])
+			size[node] = 0.0;
+		size[parent[node]] += size[node];
+		hasLandmark[parent[node]] |= hasLandmark[node];
+	}
+	if (hasLandmark[root])
+		size[root] = 0.0;
+
+	// children of the nodes in compressed sparse row arrays
+	vector<unsigned int> firstChild(noNodes + 1, 0), children(order.size());
+	for (unsigned int i = 1; i < order.size(); i++)
+		firstChild[parent[order[i]] + 1]++;
+	for (unsigned int node = 0; node < noNodes; node++)
+		firstChild[node + 1] += firstChild[node];
+	vector<unsigned int> next(firstChild.begin(), firstChild.end() - 1);
+	for (unsigned int i = 1; i < order.size(); i++)
+		children[next[parent[order[i]]]++] = order[i];
+
+	// from the heaviest subtree down to a leaf, always into the heaviest child
+	unsigned int node = root;
+	double heaviest = 0.0;
+	for (unsigned int i = 0; i < order.size(); i++)
+	{
+		if (size[order[i]] > heaviest)
+		{
+			heaviest = size[order[i]];
+			node = order[i];
+		}
+	}
+
+	if (heaviest == 0.0)
+	// all subtrees contain landmarks : farthest node from the root which is no landmark
+	{
+		for (unsigned int i = order.size(); i-- > 0;)
+		{
+			if (find(m_landmarks.begin(), m_landmarks.end(), order[i])
+					== m_landmarks.end())
+				return order[i];
+		}
+		return root;
+	}
+
+	while (firstChild[node] < firstChild[node + 1])
+	{
+		unsigned int heaviestChild = children[firstChild[node]];
+
+		for (unsigned int c = firstChild[node] + 1; c < firstChild[node + 1]; c++)
+		{
+			if (size[children[c]] > size[heaviestChild])
+				heaviestChild = children[c];
+		}
+		node = heaviestChild;
+	}
+
+	return node;
+}
+
+/**
+ * Function stores the distances of a landmark in the table
+ * @param unsigned int landmark           : IN number of the landmark
+ * @param const std::vector<double>& from : IN distances from the landmark in km
+ * @param const std::vector<double>& to   : IN distances to the landmark in km
+ * @returnvalue void
+ */
+void CLandmarkTable::storeDistances(unsigned int landmark,
+		const vector<double>& from, const vector<double>& to)
+{
+	const double maxMetres = LANDMARK_UNREACHABLE - 1.0;
+
+	for (unsigned int node = 0; node < from.size(); node++)
+	{
+		size_t position = 2 * ((size_t) node * m_noLandmarks + landmark);
+		double fromMetres = floor(from[node] * 1000.0 + 0.5);
+		double toMetres = floor(to[node] * 1000.0 + 0.5);
+
+		// distances too long for 32 bit stay unreachable, a smaller value would break the lower bound
+		if (from[node] >= 0.0 && fromMetres <= maxMetres)
+			m_table[position] = (uint32_t) fromMetres;
+		if (to[node] >= 0.0 && toMetres <= maxMetres)
+			m_table[position + 1] = (uint32_t) toMetres;
+	}
+}
+
+/**
+ * Function unmaps a mapped file and empties the table
+ * @param no parameters
+ * @returnvalue void
+ */
+void CLandmarkTable::clear()
+{
+#ifndef _WIN32
+	if (m_pMapping != NULL)
+		munmap(m_pMapping, m_mappingSize);
+#endif
+
+	m_pMapping = NULL;
+	m_mappingSize = 0;
+	m_pTable = NULL;
+	m_table.clear();
+	m_landmarks.clear();
+	m_noLandmarks = 0;
+	m_pGraph = NULL;
+}
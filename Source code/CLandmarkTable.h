@@ -0,0 +1,177 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CLANDMARKTABLE.H
+ * Author          : George Sebastian
+ * Description     : CLandmarkTable holds the preprocessing of ALT (A*, landmarks, triangle
+ *                   inequality) for a CRoadGraph : the shortest path distances from and to
+ *                   a few landmark nodes. By the triangle inequality
+ *                       d(v,t) >= d(L,t) - d(L,v)   and   d(v,t) >= d(v,L) - d(t,L)
+ *                   for every landmark L, which gives A* a lower bound far better than the
+ *                   great circle distance when roads are not straight.
+ *                   Landmark selection :
+ *                   - FARTHEST : each landmark as far (great circle) from the chosen ones as
+ *                     possible, the landmarks end up at the border of the graph
+ *                   - AVOID : a shortest path tree from a root is built, nodes whose lower
+ *                     bound is bad weigh much; the landmark is the leaf at the end of the
+ *                     heaviest subtree without landmarks
+ *                   The distances are stored as unsigned 32 bit metres, all landmarks of a
+ *                   node next to each other. The file written by save() is the table as it
+ *                   is in memory; load() maps it into memory (POSIX) instead of reading it.
+ ****************************************************************************/
+#ifndef CLANDMARKTABLE_H
+#define CLANDMARKTABLE_H
+
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+#include "CRoadGraph.h"
+
+#define LANDMARK_UNREACHABLE 0xFFFFFFFFu      // no path between landmark and node
+
+class CLandmarkTable
+{
+public:
+
+	/*
+	 * landmark selection
+	 */
+	enum t_selection
+	{
+		FARTHEST, AVOID
+	};
+
+	/**
+	 * Constructor of class CLandmarkTable, the table is empty
+	 * @param no parameters
+	 * @return no value
+	 */
+	CLandmarkTable();
+
+	/**
+	 * Destructor of class CLandmarkTable, unmaps a loaded file
+	 * @param no parameters
+	 * @return no value
+	 */
+	~CLandmarkTable();
+
+	/**
+	 * Function selects the landmarks and computes their distances, the searches run on a thread pool
+	 * @param const CRoadGraph& graph : IN graph, buildAdjacency() has to be called before; must live as long as the table
+	 * @param unsigned int noLandmarks : IN number of landmarks (16 is a good choice for road networks)
+	 * @param t_selection selection    : IN selection of the landmarks
+	 * @param unsigned int noThreads   : IN threads for the searches, 0 for the number of cores
+	 * @returnvalue void
+	 */
+	void build(const CRoadGraph& graph, unsigned int noLandmarks,
+			t_selection selection = AVOID, unsigned int noThreads = 0);
+
+	/**
+	 * Function writes the table to a binary file
+	 * @param const std::string& fileName : IN name of the file
+	 * @returnvalue true if the file could be written
+	 */
+	bool save(const std::string& fileName) const;
+
+	/**
+	 * Function maps a file written by save() into memory
+	 * @param const std::string& fileName : IN name of the file
+	 * @param const CRoadGraph& graph     : IN graph from which the table was built (same nodes in the same order, same edges and costs)
+	 * @returnvalue true if the file could be mapped and belongs to the graph
+	 */
+	bool load(const std::string& fileName, const CRoadGraph& graph);
+
+	/**
+	 * Function returns a lower bound of the shortest path distance between two nodes
+	 * @param unsigned int from : IN start node
+	 * @param unsigned int to   : IN destination node
+	 * @returnvalue double : lower bound in km
+	 */
+	double lowerBound(unsigned int from, unsigned int to) const;
+
+	/**
+	 * Function returns the graph of the table
+	 * @param no parameters
+	 * @returnvalue const CRoadGraph* : graph, NULL if the table is empty
+	 */
+	const CRoadGraph* getGraph() const;
+
+	/**
+	 * Function returns the number of landmarks
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of landmarks
+	 */
+	unsigned int getNoLandmarks() const;
+
+	/**
+	 * Function returns the node of a landmark
+	 * @param unsigned int landmark : IN number of the landmark
+	 * @returnvalue unsigned int : node
+	 */
+	unsigned int getLandmark(unsigned int landmark) const;
+
+private:
+
+	/**
+	 * Function computes the shortest path distances from a node to all nodes (or from all nodes to it)
+	 * @param unsigned int source               : IN start node
+	 * @param bool backward                     : IN distances to the node along the reverse edges
+	 * @param std::vector<double>& distance     : OUT distances in km, negative : unreachable
+	 * @param std::vector<unsigned int>* pOrder : OUT nodes in the order they were settled, may be NULL
+	 * @param std::vector<unsigned int>* pParent : OUT parent in the shortest path tree, may be NULL
+	 * @returnvalue void
+	 */
+	void searchAll(unsigned int source, bool backward,
+			std::vector<double>& distance, std::vector<unsigned int>* pOrder,
+			std::vector<unsigned int>* pParent) const;
+
+	/**
+	 * Function selects the landmarks by the farthest great circle distance to the landmarks chosen before
+	 * @param unsigned int noLandmarks : IN number of landmarks
+	 * @returnvalue void
+	 */
+	void selectFarthest(unsigned int noLandmarks);
+
+	/**
+	 * Function selects the next landmark as leaf of the heaviest subtree of a shortest path tree (avoid)
+	 * @param unsigned int root : IN root of the tree
+	 * @returnvalue unsigned int : node of the new landmark
+	 */
+	unsigned int selectAvoid(unsigned int root) const;
+
+	/**
+	 * Function stores the distances of a landmark in the table
+	 * @param unsigned int landmark           : IN number of the landmark
+	 * @param const std::vector<double>& from : IN distances from the landmark in km
+	 * @param const std::vector<double>& to   : IN distances to the landmark in km
+	 * @returnvalue void
+	 */
+	void storeDistances(unsigned int landmark, const std::vector<double>& from,
+			const std::vector<double>& to);
+
+	/**
+	 * Function unmaps a mapped file and empties the table
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void clear();
+
+	// no copies : a copy would unmap the file of the original
+	CLandmarkTable(const CLandmarkTable&);
+	CLandmarkTable& operator=(const CLandmarkTable&);
+
+	const CRoadGraph* m_pGraph;
+	unsigned int m_noLandmarks;
+	std::vector<unsigned int> m_landmarks;
+
+	// node v, landmark l : [2 * (v * m_noLandmarks + l)] metres from l to v, [.. + 1] metres from v to l
+	const uint32_t* m_pTable;
+	std::vector<uint32_t> m_table;      // table built in memory
+	void* m_pMapping;                   // file mapped by load(), NULL if none
+	size_t m_mappingSize;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CLANDMARKTABLE_H */
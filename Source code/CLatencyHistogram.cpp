@@ -0,0 +1,131 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CLATENCYHISTOGRAM.CPP
+ * Author          : George Sebastian
+ * Description     : CLatencyHistogram counts latencies (e.g. from the arrival of a GPS
+ *                   fix until the navigation loop consumes it) in buckets of powers of 2
+ *                   nanoseconds. Recording a latency is a few instructions and does not
+ *                   allocate, so it can be used in the navigation loop.
+ ****************************************************************************/
+#include <iostream>
+using namespace std;
+
+#include "CLatencyHistogram.h"
+
+/**
+ * Constructor of class CLatencyHistogram
+ * @param no parameters
+ * @return no value
+ */
+CLatencyHistogram::CLatencyHistogram()
+{
+	clear();
+}
+
+/**
+ * Function counts a latency
+ * @param long long latencyNs : IN latency in ns
+ * @returnvalue void
+ */
+void CLatencyHistogram::record(long long latencyNs)
+{
+	if (latencyNs < 0)
+		// clocks of producer and consumer differ slightly
+		latencyNs = 0;
+
+	unsigned int bucket = 0;
+	while (bucket < LATENCY_NO_BUCKETS - 1 && (latencyNs >> bucket) != 0)
+		bucket++;
+
+	m_buckets[bucket]++;
+	m_count++;
+	m_sumNs += latencyNs;
+	if (latencyNs > m_maxNs)
+		m_maxNs = latencyNs;
+}
+
+/**
+ * Function removes all counted latencies
+ * @param no parameters
+ * @returnvalue void
+ */
+void CLatencyHistogram::clear()
+{
+	for (unsigned int i = 0; i < LATENCY_NO_BUCKETS; i++)
+		m_buckets[i] = 0;
+
+	m_count = 0;
+	m_sumNs = 0.0;
+	m_maxNs = 0;
+}
+
+/**
+ * Function returns the number of counted latencies
+ * @param no parameters
+ * @returnvalue unsigned long : number of latencies
+ */
+unsigned long CLatencyHistogram::getCount() const
+{
+	return m_count;
+}
+
+/**
+ * Function returns the mean of the counted latencies
+ * @param no parameters
+ * @returnvalue double : mean latency in ns, 0 if nothing was counted
+ */
+double CLatencyHistogram::getMeanNs() const
+{
+	return (m_count > 0) ? m_sumNs / m_count : 0.0;
+}
+
+/**
+ * Function returns the largest counted latency
+ * @param no parameters
+ * @returnvalue long long : maximum latency in ns
+ */
+long long CLatencyHistogram::getMaxNs() const
+{
+	return m_maxNs;
+}
+
+/**
+ * Function returns an upper bound of the latency below which the given fraction of the latencies lies
+ * @param double fraction : IN fraction between 0 and 1, e.g. 0.99 for the 99th percentile
+ * @returnvalue long long : upper limit of the bucket containing the percentile in ns
+ */
+long long CLatencyHistogram::getPercentileNs(double fraction) const
+{
+	unsigned long rank = (unsigned long) (fraction * m_count);
+	unsigned long counted = 0;
+
+	for (unsigned int bucket = 0; bucket < LATENCY_NO_BUCKETS - 1; bucket++)
+	{
+		counted += m_buckets[bucket];
+		if (counted > rank)
+			// the maximum is a tighter bound for the highest percentiles
+			return ((1LL << bucket) - 1 < m_maxNs) ? (1LL << bucket) - 1 : m_maxNs;
+	}
+	return m_maxNs;
+}
+
+/**
+ * Function prints the percentiles and the non empty buckets
+ * @param std::ostream& out : IN/OUT stream to print to
+ * @returnvalue void
+ */
+void CLatencyHistogram::print(ostream& out) const
+{
+	out << "latency of " << m_count << " values : mean " << getMeanNs() / 1000
+			<< " us, 50% < " << getPercentileNs(0.5) / 1000.0 << " us, 99% < "
+			<< getPercentileNs(0.99) / 1000.0 << " us, max "
+			<< m_maxNs / 1000.0 << " us" << endl;
+
+	for (unsigned int bucket = 0; bucket < LATENCY_NO_BUCKETS; bucket++)
+	{
+		if (m_buckets[bucket] > 0)
+			out << "   < " << (1LL << bucket) / 1000.0 << " us : "
+					<< m_buckets[bucket] << endl;
+	}
+}
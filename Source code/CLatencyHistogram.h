@@ -0,0 +1,88 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CLATENCYHISTOGRAM.H
+ * Author          : George Sebastian
+ * Description     : CLatencyHistogram counts latencies (e.g. from the arrival of a GPS
+ *                   fix until the navigation loop consumes it) in buckets of powers of 2
+ *                   nanoseconds. Recording a latency is a few instructions and does not
+ *                   allocate, so it can be used in the navigation loop.
+ ****************************************************************************/
+#ifndef CLATENCYHISTOGRAM_H
+#define CLATENCYHISTOGRAM_H
+
+#include <ostream>
+
+#define LATENCY_NO_BUCKETS 48               // bucket i counts latencies from 2^(i-1) to 2^i - 1 ns, the last bucket everything above
+
+class CLatencyHistogram
+{
+public:
+
+	/**
+	 * Constructor of class CLatencyHistogram
+	 * @param no parameters
+	 * @return no value
+	 */
+	CLatencyHistogram();
+
+	/**
+	 * Function counts a latency
+	 * @param long long latencyNs : IN latency in ns
+	 * @returnvalue void
+	 */
+	void record(long long latencyNs);
+
+	/**
+	 * Function removes all counted latencies
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void clear();
+
+	/**
+	 * Function returns the number of counted latencies
+	 * @param no parameters
+	 * @returnvalue unsigned long : number of latencies
+	 */
+	unsigned long getCount() const;
+
+	/**
+	 * Function returns the mean of the counted latencies
+	 * @param no parameters
+	 * @returnvalue double : mean latency in ns, 0 if nothing was counted
+	 */
+	double getMeanNs() const;
+
+	/**
+	 * Function returns the largest counted latency
+	 * @param no parameters
+	 * @returnvalue long long : maximum latency in ns
+	 */
+	long long getMaxNs() const;
+
+	/**
+	 * Function returns an upper bound of the latency below which the given fraction of the latencies lies
+	 * @param double fraction : IN fraction between 0 and 1, e.g. 0.99 for the 99th percentile
+	 * @returnvalue long long : upper limit of the bucket containing the percentile in ns
+	 */
+	long long getPercentileNs(double fraction) const;
+
+	/**
+	 * Function prints the percentiles and the non empty buckets
+	 * @param std::ostream& out : IN/OUT stream to print to
+	 * @returnvalue void
+	 */
+	void print(std::ostream& out) const;
+
+private:
+
+	unsigned long m_buckets[LATENCY_NO_BUCKETS];
+	unsigned long m_count;
+	double m_sumNs;
+	long long m_maxNs;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CLATENCYHISTOGRAM_H */
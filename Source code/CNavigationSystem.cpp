@@ -9,11 +9,39 @@
  *                   is taken and the distance to the nearest POI in our Route is estimated
  ****************************************************************************/
 #include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+#include <math.h>
 using namespace std;
 
 #include "CNavigationSystem.h"
 #include "CCSV.h"
 #include "CJsonPersistence.h"
+#include "CRouteOptimizer.h"
+#include "CRouteSimplifier.h"
+#include "CRouteMatcher.h"
+#include "CNmeaSensor.h"
+#include "CSensorProducer.h"
+#include "CTrajectoryGenerator.h"
+#include "CKalmanFilterBank.h"
+#include "CSessionManager.h"
+#include "CGeofenceIndex.h"
+#include "CDeviationDetector.h"
+#include "CRoadGraph.h"
+#include "CShortestPathSearch.h"
+#include "CLatencyHistogram.h"
+#include "CContractionHierarchy.h"
+#include "CHierarchySearch.h"
+#include "CDistanceMatrix.h"
+#include "CLandmarkTable.h"
+#include "CIsochroneSearch.h"
+#include "CStringPool.h"
+#include "CRouteTable.h"
 
 #define DEGREE 1                           // printing longitude and latitude in Degree format
 #define MMSS 2                             // printing longitude and latitude in Minutes,seconds format
@@ -33,6 +61,28 @@ using namespace std;
 #define TESTCASE_FILE_WRITE 0              // Testcase for testing File write operations
 #define TESTCASE_FILE_READ_MERGE 0         // Testcase for testing File Read operations in MERGE mode
 #define TESTCASE_FILE_READ_REPLACE 0       // Testcase for testing File Read operations in REPLACE mode
+#define TESTCASE_ROUTE_OPTIMISATION 0      // Testcase (benchmark) for reordering the stops of a Route, 2 : parallel multi start
+#define TESTCASE_ROUTE_SIMPLIFICATION 0    // Testcase for the simplification of a dense Route
+#define TESTCASE_ROUTE_MATCHING 0          // Testcase (benchmark) for projecting positions onto a Route
+#define TESTCASE_NMEA_REPLAY 0             // Testcase (benchmark) for the navigation loop driven by a NMEA recording, 2 : through the ring buffer
+#define TESTCASE_TRAJECTORY_GENERATOR 0    // Testcase (benchmark) for the synthetic trajectories of many vehicles
+#define TESTCASE_KALMAN_FILTER 0           // Testcase (benchmark) for smoothing the fixes of many vehicles
+#define TESTCASE_SESSION_ENGINE 0          // Testcase (benchmark) for many navigation sessions processed on a thread pool
+#define TESTCASE_GEOFENCING 0              // Testcase (benchmark) for enter/exit/dwell events of many vehicles and fences
+#define TESTCASE_OFF_ROUTE 0               // Testcase (benchmark) for off route detection and re-join points
+#define TESTCASE_ROAD_GRAPH 0              // Testcase (benchmark) for the road graph and Dijkstra's shortest paths
+#define TESTCASE_PATH_SEARCH 0             // Testcase (benchmark) comparing Dijkstra, A* and the bidirectional searches
+#define TESTCASE_CONTRACTION_HIERARCHY 0   // Testcase (benchmark) for the contraction hierarchy and its queries
+#define TESTCASE_DISTANCE_MATRIX 0         // Testcase (benchmark) for many to many distance matrices
+#define TESTCASE_LANDMARKS 0               // Testcase (benchmark) for ALT : landmark selection, table file and queries
+#define TESTCASE_ISOCHRONE 0               // Testcase (benchmark) for reachable POIs within a distance budget
+#define TESTCASE_POI_TYPE_INDEX 0          // Testcase (benchmark) for the nearest POI of a type with the type index
+#define TESTCASE_POI_CATEGORIES 0          // Testcase (benchmark) for registered POI categories and category filters
+#define TESTCASE_STRING_POOL 0             // Testcase (benchmark) for the memory of interned names and descriptions
+#define TESTCASE_COMPACT_COORDINATES 0     // Testcase (benchmark) for the precision and size of fixed point coordinates
+#define TESTCASE_DATABASE_ARENA 0          // Testcase (benchmark) for loading and clearing a Database with nodes in slabs
+#define TESTCASE_ROUTE_TABLE 0             // Testcase (benchmark) for the nearest POI of a Route from the route table
+#define TESTCASE_DISTANCE_PRECISION 0      // Testcase (benchmark) for the precision of calculateDistance() against a reference
 
 /**
  * Testcase for populating WP and POI Databases
@@ -89,6 +139,2357 @@ void CNavigationSystem::TC_readFromFile()
 	m_PoiDatabase.print();
 }
 
+/**
+ * Testcase (benchmark) for the Route optimiser on Routes with 50, 200 and 1000 randomly placed stops
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_optimiseRoute()
+{
+	const unsigned int noStops[] = { 50, 200, 1000 };
+
+	srand(42);                                 // same stops in every run
+
+	for (unsigned int run = 0; run < 3; run++)
+	{
+		CWpDatabase wpDatabase;
+		CRoute route;
+		route.connectToWpDatabase(&wpDatabase);
+
+		for (unsigned int i = 0; i < noStops[run]; i++)
+		// random stops in Germany, added to the Route in the order of creation
+		{
+			ostringstream name;
+			name << "stop" << i;
+
+			CWaypoint wp(name.str(), 47.0 + 8.0 * rand() / RAND_MAX,
+					6.0 + 9.0 * rand() / RAND_MAX);
+			wpDatabase.addWaypoint(wp);
+			route.addWaypoint(name.str());
+		}
+
+		CRouteOptimizer optimizer;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		optimizer.optimize(route, 5000.0);
+		double elapsedMs = chrono::duration<double, milli>(
+				chrono::steady_clock::now() - start).count();
+
+		cout << noStops[run] << " stops : " << optimizer.getInitialLength()
+				<< " km -> " << optimizer.getOptimizedLength() << " km in "
+				<< elapsedMs << " ms" << endl;
+	}
+}
+
+/**
+ * Testcase (benchmark) for the parallel multi start Route optimiser on a Route with 500 stops.
+ * Prints the number of restarts done within a fixed time budget for 1, 2, 4 and 8 threads
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_optimiseRouteMultiStart()
+{
+	CWpDatabase wpDatabase;
+	CRoute route;
+	route.connectToWpDatabase(&wpDatabase);
+
+	srand(42);
+
+	for (unsigned int i = 0; i < 500; i++)
+	{
+		ostringstream name;
+		name << "stop" << i;
+
+		CWaypoint wp(name.str(), 47.0 + 8.0 * rand() / RAND_MAX,
+				6.0 + 9.0 * rand() / RAND_MAX);
+		wpDatabase.addWaypoint(wp);
+		route.addWaypoint(name.str());
+	}
+
+	for (unsigned int noThreads = 1; noThreads <= 8; noThreads *= 2)
+	{
+		CRoute copy = route;
+		CRouteOptimizer optimizer;
+
+		optimizer.optimizeMultiStart(copy, 2000.0, noThreads);
+
+		cout << noThreads << " threads : " << optimizer.getNoRestarts()
+				<< " restarts in 2000 ms, best " << optimizer.getOptimizedLength()
+				<< " km" << endl;
+	}
+
+	CRoute copy = route;                       // deterministic mode gives the same result in every run
+	CRouteOptimizer optimizer;
+	optimizer.optimizeMultiStart(copy, 0.0, 4, 32, 1);
+	cout << "deterministic (32 restarts, seed 1) : "
+			<< optimizer.getOptimizedLength() << " km" << endl;
+}
+
+/**
+ * Testcase for the simplification of a dense Route (20000 points with POIs) with a tolerance of 5 m
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_simplifyRoute()
+{
+	CWpDatabase wpDatabase;
+	CPoiDatabase poiDatabase;
+	CRoute route;
+	route.connectToWpDatabase(&wpDatabase);
+	route.connectToPoiDatabase(&poiDatabase);
+
+	for (unsigned int i = 0; i < 20000; i++)
+	// slightly winding track from Darmstadt to the north east, every 1000th point is a POI
+	{
+		ostringstream name;
+		name << "point" << i;
+
+		double t = i * 0.0001;
+		double latitude = 49.87 + 0.1 * t + 0.0005 * sin(30 * t);
+		double longitude = 8.65 + 0.2 * t;
+
+		if (i % 1000 == 500)
+		{
+			CPOI poi(CPOI::GASSTATION, name.str(), "on the track", latitude,
+					longitude);
+			poiDatabase.addPoi(poi);
+			route.addPoi(name.str());
+		}
+		else
+		{
+			CWaypoint wp(name.str(), latitude, longitude);
+			wpDatabase.addWaypoint(wp);
+			route.addWaypoint(name.str());
+		}
+	}
+
+	CRouteSimplifier simplifier(5.0);
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	CRoute simplified = simplifier.simplifiedRoute(route);
+	double elapsedMs = chrono::duration<double, milli>(
+			chrono::steady_clock::now() - start).count();
+
+	cout << "Route with " << route.getRoute().size() << " points simplified to "
+			<< simplified.getRoute().size() << " points in " << elapsedMs
+			<< " ms" << endl;
+}
+
+/**
+ * Testcase (benchmark) for projecting positions onto a Route with 5000 points, prints the time per position
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_matchRoute()
+{
+	CWpDatabase wpDatabase;
+	CRoute route;
+	route.connectToWpDatabase(&wpDatabase);
+
+	for (unsigned int i = 0; i < 5000; i++)
+	// winding Route of about 560 km
+	{
+		ostringstream name;
+		name << "point" << i;
+
+		double t = i * 0.001;
+		CWaypoint wp(name.str(), 49.8 + 0.5 * sin(3 * t), 8.6 + 0.5 * t);
+		wpDatabase.addWaypoint(wp);
+		route.addWaypoint(name.str());
+	}
+
+	vector<CWaypoint> positions;
+	for (unsigned int i = 0; i < 1000000; i++)
+	// vehicle driving along the Route
+	{
+		double t = i * 0.000005;
+		positions.push_back(
+				CWaypoint("Current position", 49.8 + 0.5 * sin(3 * t),
+						8.6 + 0.5 * t));
+	}
+
+	CRouteMatcher matcher;
+	matcher.setRoute(route);
+
+	t_routeMatch match;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < positions.size(); i++)
+		matcher.match(positions[i], match);
+
+	double elapsedNs = chrono::duration<double, nano>(
+			chrono::steady_clock::now() - start).count();
+
+	cout << positions.size() << " positions projected onto "
+			<< matcher.getNoSegments() << " segments : "
+			<< elapsedNs / positions.size() << " ns per position, last at "
+			<< match.alongTrackKm << " of " << matcher.getRouteLength() << " km"
+			<< endl;
+}
+
+/**
+ * Function creates a straight Route of about 130 km to the north east of Darmstadt with 200 points,
+ * every 20th point is a POI. Used by the testcases of the sensors.
+ * @param CWpDatabase& wpDatabase   : OUT database with the Waypoints of the Route
+ * @param CPoiDatabase& poiDatabase : OUT database with the POIs of the Route
+ * @param CRoute& route             : OUT Route connected to both databases
+ * @returnvalue void
+ */
+void CNavigationSystem::createTestRoute(CWpDatabase& wpDatabase,
+		CPoiDatabase& poiDatabase, CRoute& route)
+{
+	route.connectToWpDatabase(&wpDatabase);
+	route.connectToPoiDatabase(&poiDatabase);
+
+	for (unsigned int i = 0; i < 200; i++)
+	{
+		ostringstream name;
+		name << "point" << i;
+
+		if (i % 20 == 10)
+		{
+			CPOI poi(CPOI::RESTAURANT, name.str(), "along the Route",
+					49.8 + 0.005 * i, 8.6 + 0.005 * i);
+			poiDatabase.addPoi(poi);
+			route.addPoi(name.str());
+		}
+		else
+		{
+			wpDatabase.addWaypoint(
+					CWaypoint(name.str(), 49.8 + 0.005 * i, 8.6 + 0.005 * i));
+			route.addWaypoint(name.str());
+		}
+	}
+}
+
+/**
+ * Function writes a NMEA recording along the test Route : one GGA sentence per second starting at 11:06:40,
+ * every 1000th sentence has a wrong checksum
+ * @param const std::string& fileName : IN name of the file
+ * @param unsigned int noFixes        : IN number of sentences
+ * @returnvalue void
+ */
+void CNavigationSystem::writeNmeaRecording(const string& fileName,
+		unsigned int noFixes)
+{
+	ofstream recording(fileName.c_str());
+	t_gpsFix fix;
+
+	for (unsigned int i = 0; i < noFixes; i++)
+	{
+		fix.latitude = 49.8 + 0.000005 * i;
+		fix.longitude = 8.6 + 0.000005 * i;
+		fix.timestamp = 40000.0 + i;
+
+		string sentence = CNmeaSensor::createGgaSentence(fix);
+		if (i % 1000 == 999)
+			sentence[10] = (sentence[10] == '0') ? '1' : '0';
+
+		recording << sentence << "\r\n";
+	}
+}
+
+/**
+ * Function runs the navigation loop : the fixes of the sensor are read by a producer thread, the loop takes them
+ * from the ring buffer, optionally smooths them, projects them onto the Route and calculates the distance to the
+ * next POI. Prints the throughput, the overruns, the changes of the next POI and the latency histogram at the end
+ * of the input.
+ * @param CRoute& route                               : IN Route to be followed
+ * @param CPositionSensor& sensor                     : IN source of the positions
+ * @param CSensorProducer::t_overrunPolicy policy     : IN behaviour if the navigation loop is behind the sensor
+ * @param bool smoothFixes                            : IN fixes are smoothed by a Kalman filter before they are used
+ * @returnvalue void
+ */
+void CNavigationSystem::followRoute(CRoute& route, CPositionSensor& sensor,
+		CSensorProducer::t_overrunPolicy policy, bool smoothFixes)
+{
+	CRouteMatcher matcher;
+	matcher.setRoute(route);
+
+	CKalmanFilterBank smoothing(1);
+	t_filteredFix filtered;
+
+	CSensorProducer producer(sensor, 1024, policy);
+	t_gpsFix fix;
+	t_routeMatch match = t_routeMatch();
+	unsigned long noProcessed = 0, noPoiChanges = 0;
+	double distanceNextPoi = 0.0;
+	string nextPoi;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	producer.start();
+
+	while (!producer.isFinished())
+	{
+		if (!producer.popFix(fix))
+		{
+			// waiting for the sensor
+			this_thread::yield();
+			continue;
+		}
+
+		if (smoothFixes)
+		{
+			smoothing.filter(0, fix, filtered);
+			fix.latitude = filtered.latitude;
+			fix.longitude = filtered.longitude;
+		}
+
+		CWaypoint position("Current position", fix.latitude, fix.longitude);
+		CPOI poi;
+
+		matcher.match(position, match);
+		distanceNextPoi = route.getDistanceNextPoi(position, poi);
+		noProcessed++;
+
+		if (poi.getName() != nextPoi)
+		// next POI changed, e.g. because of jitter between two POIs at a similar distance
+		{
+			nextPoi = poi.getName();
+			noPoiChanges++;
+		}
+	}
+	producer.stop();
+
+	double elapsedS = chrono::duration<double>(
+			chrono::steady_clock::now() - start).count();
+
+	cout << noProcessed << " of " << producer.getNoFixes()
+			<< " fixes processed : " << noProcessed / elapsedS
+			<< " fixes per second, " << producer.getNoOverruns()
+			<< " overruns, " << producer.getNoDroppedFixes()
+			<< " dropped, last fix at " << match.alongTrackKm << " km, "
+			<< distanceNextPoi << " km to the next POI, " << noPoiChanges
+			<< " changes of the next POI" << endl;
+	producer.getLatencyHistogram().print(cout);
+}
+
+/**
+ * Testcase (benchmark) for the navigation loop driven by a recorded NMEA file : each fix is
+ * projected onto the Route and the distance to the next POI is calculated. Prints the fixes per second
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_replayNmea()
+{
+	const string fileName = "replay.nmea";
+	CWpDatabase wpDatabase;
+	CPoiDatabase poiDatabase;
+	CRoute route;
+	createTestRoute(wpDatabase, poiDatabase, route);
+
+	// one fix per second over midnight
+	writeNmeaRecording(fileName, 200000);
+
+	CNmeaSensor sensor;
+	if (!sensor.open(fileName))
+		return;
+
+	CRouteMatcher matcher;
+	matcher.setRoute(route);
+
+	t_gpsFix fix;
+	t_routeMatch match;
+	unsigned long noFixes = 0;
+	double distanceNextPoi = 0.0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	while (sensor.getNextFix(fix))
+	{
+		CWaypoint position("Current position", fix.latitude, fix.longitude);
+		CPOI poi;
+
+		matcher.match(position, match);
+		distanceNextPoi = route.getDistanceNextPoi(position, poi);
+		noFixes++;
+	}
+
+	double elapsedS = chrono::duration<double>(
+			chrono::steady_clock::now() - start).count();
+
+	cout << noFixes << " fixes of " << sensor.getNoSentences()
+			<< " sentences replayed (" << sensor.getNoChecksumErrors()
+			<< " checksum errors) : " << noFixes / elapsedS
+			<< " fixes per second, last fix at " << match.alongTrackKm
+			<< " km, " << distanceNextPoi << " km to the next POI" << endl;
+
+	remove(fileName.c_str());
+}
+
+/**
+ * Testcase (benchmark) for the navigation loop consuming the fixes of a NMEA replay through the ring buffer :
+ * lossless replay as fast as possible, then replay at 10000 times the recorded rate, where late fixes are dropped
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_sensorPipeline()
+{
+	const string fileName = "replay.nmea";
+	CWpDatabase wpDatabase;
+	CPoiDatabase poiDatabase;
+	CRoute route;
+	createTestRoute(wpDatabase, poiDatabase, route);
+
+	writeNmeaRecording(fileName, 200000);
+
+	CNmeaSensor sensor;
+	if (!sensor.open(fileName))
+		return;
+
+	cout << "NMEA replay as fast as possible, waiting for space in the buffer"
+			<< endl;
+	followRoute(route, sensor, CSensorProducer::WAIT_FOR_SPACE);
+
+	writeNmeaRecording(fileName, 20000);
+	sensor.open(fileName, CNmeaSensor::RECORDED_RATE, 10000);
+
+	cout << endl << "NMEA replay at 10000 times the recorded rate, dropping fixes"
+			<< endl;
+	followRoute(route, sensor, CSensorProducer::DROP_FIX);
+
+	remove(fileName.c_str());
+}
+
+/**
+ * Testcase (benchmark) for the trajectory generator : generation rate for many vehicles along a Route and
+ * in a random walk, repeatability with the same seed and the navigation loop driven by generated fixes
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_generateTrajectories()
+{
+	CWpDatabase wpDatabase;
+	CPoiDatabase poiDatabase;
+	CRoute route;
+	createTestRoute(wpDatabase, poiDatabase, route);
+
+	CTrajectoryGenerator generator(42);
+	generator.setRoute(route);
+	generator.setNoVehicles(1000);
+	generator.setSpeed(80.0);
+	generator.setNoise(5.0);
+	generator.setRate(10.0);
+
+	t_gpsFix fix;
+	unsigned int vehicle;
+	double checksum = 0.0;
+	const unsigned long noFixes = 10000000;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (unsigned long i = 0; i < noFixes; i++)
+	{
+		generator.getNextFix(fix, vehicle);
+		checksum += fix.latitude;
+	}
+	double elapsedS = chrono::duration<double>(
+			chrono::steady_clock::now() - start).count();
+
+	cout << noFixes << " fixes of 1000 vehicles along the Route : "
+			<< noFixes / elapsedS << " fixes per second, checksum "
+			<< checksum / noFixes << endl;
+
+	// same seed gives the same fixes
+	t_gpsFix first[1000];
+	generator.restart();
+	for (unsigned int i = 0; i < 1000; i++)
+		generator.getNextFix(first[i]);
+
+	bool repeatable = true;
+	generator.restart();
+	for (unsigned int i = 0; i < 1000; i++)
+	{
+		generator.getNextFix(fix);
+		repeatable = repeatable && fix.latitude == first[i].latitude
+				&& fix.longitude == first[i].longitude
+				&& fix.timestamp == first[i].timestamp;
+	}
+	cout << "same fixes after restart : " << (repeatable ? "yes" : "no")
+			<< endl;
+
+	CTrajectoryGenerator walker(7);
+	walker.setRandomWalk(CWaypoint("Darmstadt", 49.8728, 8.6512));
+	walker.setNoVehicles(100000);
+	walker.setNoise(5.0);
+
+	start = chrono::steady_clock::now();
+	for (unsigned long i = 0; i < noFixes; i++)
+	{
+		walker.getNextFix(fix, vehicle);
+		checksum += fix.longitude;
+	}
+	elapsedS = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout << noFixes << " fixes of 100000 vehicles in a random walk : "
+			<< noFixes / elapsedS << " fixes per second, last at latitude "
+			<< fix.latitude << ", longitude " << fix.longitude << endl;
+
+	// one vehicle through the whole navigation pipeline
+	CTrajectoryGenerator vehicleOnRoute(42);
+	vehicleOnRoute.setRoute(route);
+	vehicleOnRoute.setSpeed(100.0);
+	vehicleOnRoute.setNoise(10.0);
+	vehicleOnRoute.setRate(100.0);
+	vehicleOnRoute.setMaxFixes(1000000);
+
+	cout << endl << "navigation loop driven by the trajectory generator" << endl;
+	followRoute(route, vehicleOnRoute, CSensorProducer::WAIT_FOR_SPACE);
+}
+
+/**
+ * Testcase (benchmark) for the Kalman filter : filtered fixes per second for 10000 vehicles with 10 m GPS noise,
+ * error of the raw and of the filtered positions, and the navigation loop with and without smoothing
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_filterFixes()
+{
+	CWpDatabase wpDatabase;
+	CPoiDatabase poiDatabase;
+	CRoute route;
+	createTestRoute(wpDatabase, poiDatabase, route);
+
+	const unsigned int noVehicles = 10000, noPeriods = 200;
+	const unsigned int noFixes = noVehicles * noPeriods;
+
+	// same seed : the generator without noise gives the true positions of the vehicles
+	CTrajectoryGenerator noisy(3), exact(3);
+	noisy.setRoute(route);
+	exact.setRoute(route);
+	noisy.setNoVehicles(noVehicles);
+	exact.setNoVehicles(noVehicles);
+	noisy.setRate(10.0);
+	exact.setRate(10.0);
+	noisy.setNoise(10.0);
+
+	vector<unsigned int> vehicles(noFixes);
+	vector<t_gpsFix> fixes(noFixes), truth(noFixes);
+	vector<t_filteredFix> filtered(noFixes);
+
+	for (unsigned int i = 0; i < noFixes; i++)
+	{
+		noisy.getNextFix(fixes[i], vehicles[i]);
+		exact.getNextFix(truth[i]);
+	}
+
+	CKalmanFilterBank filterBank(noVehicles, 2.0, 10.0);
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	filterBank.filterBatch(&vehicles[0], &fixes[0], noFixes, &filtered[0]);
+	double elapsedS = chrono::duration<double>(
+			chrono::steady_clock::now() - start).count();
+
+	// errors after the filters settled (second half)
+	double rawSquares = 0.0, filteredSquares = 0.0;
+	for (unsigned int i = noFixes / 2; i < noFixes; i++)
+	{
+		CWaypoint exactPosition("", truth[i].latitude, truth[i].longitude);
+		double rawKm = exactPosition.calculateDistance(
+				CWaypoint("", fixes[i].latitude, fixes[i].longitude));
+		double filteredKm = exactPosition.calculateDistance(
+				CWaypoint("", filtered[i].latitude, filtered[i].longitude));
+
+		rawSquares += rawKm * rawKm;
+		filteredSquares += filteredKm * filteredKm;
+	}
+
+	cout << noFixes << " fixes of " << noVehicles << " vehicles filtered : "
+			<< noFixes / elapsedS << " fixes per second" << endl;
+	cout << "RMS error raw " << sqrt(rawSquares / (noFixes / 2)) * 1000
+			<< " m, filtered " << sqrt(filteredSquares / (noFixes / 2)) * 1000
+			<< " m, speed of the last vehicle "
+			<< sqrt(filtered.back().velocityNorth * filtered.back().velocityNorth
+					+ filtered.back().velocityEast * filtered.back().velocityEast)
+					* 3.6 << " km/h" << endl;
+
+	CTrajectoryGenerator vehicleOnRoute(5);
+	vehicleOnRoute.setRoute(route);
+	vehicleOnRoute.setNoise(10.0);
+	vehicleOnRoute.setMaxFixes(100000);
+
+	cout << endl << "navigation loop with raw fixes" << endl;
+	followRoute(route, vehicleOnRoute, CSensorProducer::WAIT_FOR_SPACE);
+
+	vehicleOnRoute.restart();
+	cout << endl << "navigation loop with smoothed fixes" << endl;
+	followRoute(route, vehicleOnRoute, CSensorProducer::WAIT_FOR_SPACE, true);
+}
+
+/**
+ * Testcase (benchmark) for the session manager : 5000 vehicles on 50 different Routes through shared
+ * Databases, batches of 2 updates per vehicle, processed with 1, 2 and 4 threads. Prints the updates per second
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_sessionEngine()
+{
+	const unsigned int noRoutes = 50, noVehiclesPerRoute = 100, noBatches = 100;
+	CWpDatabase wpDatabase;
+	CPoiDatabase poiDatabase;
+
+	// 50 streets of 20 WPs with a POI after every 5th WP, fanning out from Darmstadt
+	vector<vector<string> > stops(noRoutes);
+	for (unsigned int r = 0; r < noRoutes; r++)
+	{
+		double heading = 2 * acos(-1.0) * r / noRoutes;
+
+		for (unsigned int i = 0; i < 20; i++)
+		{
+			ostringstream name;
+			name << "street" << r << "_" << i;
+			double latitude = 49.87 + 0.01 * i * cos(heading);
+			double longitude = 8.65 + 0.015 * i * sin(heading);
+
+			wpDatabase.addWaypoint(CWaypoint(name.str(), latitude, longitude));
+			stops[r].push_back(name.str());
+
+			if (i % 5 == 4)
+			{
+				name << "_poi";
+				CPOI poi(CPOI::GASSTATION, name.str(), "next to the street",
+						latitude + 0.001, longitude);
+				poiDatabase.addPoi(poi);
+				stops[r].push_back(name.str());
+			}
+		}
+	}
+
+	unsigned int threadCounts[] =
+	{ 1, 2, 4 };
+
+	for (unsigned int t = 0; t < 3; t++)
+	{
+		CSessionManager manager(wpDatabase, poiDatabase, threadCounts[t]);
+		vector<CTrajectoryGenerator*> generators;
+
+		for (unsigned int r = 0; r < noRoutes; r++)
+		{
+			for (unsigned int v = 0; v < noVehiclesPerRoute; v++)
+				manager.createSession(stops[r]);
+
+			// vehicle v of generator r drives in session r * noVehiclesPerRoute + v
+			generators.push_back(new CTrajectoryGenerator(r + 1));
+			generators[r]->setRoute(manager.getRoute(r * noVehiclesPerRoute));
+			generators[r]->setNoVehicles(noVehiclesPerRoute);
+			generators[r]->setNoise(5.0);
+		}
+
+		vector<vector<t_positionUpdate> > batches(noBatches);
+		t_positionUpdate update;
+		unsigned int vehicle;
+
+		for (unsigned int b = 0; b < noBatches; b++)
+		{
+			for (unsigned int period = 0; period < 2; period++)
+			{
+				for (unsigned int r = 0; r < noRoutes; r++)
+				{
+					for (unsigned int v = 0; v < noVehiclesPerRoute; v++)
+					{
+						generators[r]->getNextFix(update.fix, vehicle);
+						update.session = r * noVehiclesPerRoute + vehicle;
+						batches[b].push_back(update);
+					}
+				}
+			}
+		}
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (unsigned int b = 0; b < noBatches; b++)
+			manager.processBatch(batches[b]);
+		double elapsedS = chrono::duration<double>(
+				chrono::steady_clock::now() - start).count();
+
+		unsigned long noUpdates = 0, noOutOfOrder = 0;
+		for (unsigned int session = 0; session < manager.getNoSessions(); session++)
+		{
+			noUpdates += manager.getSessionState(session).noUpdates;
+			noOutOfOrder += manager.getSessionState(session).noOutOfOrder;
+		}
+
+		const t_sessionState& state = manager.getSessionState(0);
+		cout << manager.getPool().getNoThreads() << " threads : "
+				<< manager.getNoSessions() << " sessions, " << noUpdates
+				<< " updates : " << noUpdates / elapsedS
+				<< " updates per second, " << noOutOfOrder
+				<< " out of order, " << manager.getPool().getNoSteals()
+				<< " stolen tasks, session 0 at " << state.match.alongTrackKm
+				<< " km, " << state.distanceNextPoiKm << " km to "
+				<< state.pNextPoi->getName() << endl;
+
+		for (unsigned int r = 0; r < noRoutes; r++)
+			delete generators[r];
+	}
+}
+
+/**
+ * Testcase (benchmark) for the geofence index : 100000 circles and 1000 polygons around Darmstadt and fences
+ * around the gas stations of the POI Database, 10000 vehicles in a random walk with one fix per second.
+ * Prints the fixes per second, the fence tests per fix and the number of events of each kind
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_geofencing()
+{
+	const unsigned int noCircles = 100000, noPolygons = 1000;
+	const unsigned int noVehicles = 10000, noPeriods = 600;
+	const double centreLatitude = 49.8728, centreLongitude = 8.6512;
+
+	CGeofenceIndex geofences(10.0, 60.0);
+
+	// fences spread over about 60 km x 60 km
+	srand(42);
+	for (unsigned int i = 0; i < noCircles; i++)
+	{
+		ostringstream name;
+		name << "circle" << i;
+		double latitude = centreLatitude
+				+ ((double) rand() / RAND_MAX - 0.5) * 0.54;
+		double longitude = centreLongitude
+				+ ((double) rand() / RAND_MAX - 0.5) * 0.83;
+		double radiusMetres = 30.0
+				+ 170.0 * rand() / RAND_MAX;
+
+		geofences.addCircle(name.str(), latitude, longitude, radiusMetres);
+	}
+
+	for (unsigned int i = 0; i < noPolygons; i++)
+	{
+		ostringstream name;
+		name << "polygon" << i;
+		double latitude = centreLatitude
+				+ ((double) rand() / RAND_MAX - 0.5) * 0.54;
+		double longitude = centreLongitude
+				+ ((double) rand() / RAND_MAX - 0.5) * 0.83;
+
+		// triangle or concave "L" of a few hundred metres
+		vector<CWaypoint> corners;
+		corners.push_back(CWaypoint("", latitude, longitude));
+		corners.push_back(CWaypoint("", latitude, longitude + 0.006));
+		if (i % 2 == 0)
+		{
+			corners.push_back(CWaypoint("", latitude + 0.002, longitude + 0.006));
+			corners.push_back(CWaypoint("", latitude + 0.002, longitude + 0.002));
+			corners.push_back(CWaypoint("", latitude + 0.004, longitude + 0.002));
+			corners.push_back(CWaypoint("", latitude + 0.004, longitude));
+		}
+		else
+			corners.push_back(CWaypoint("", latitude + 0.004, longitude));
+
+		geofences.addPolygon(name.str(), corners);
+	}
+
+	unsigned int noPoiFences = geofences.addPoiFences(m_PoiDatabase,
+			CPOI::GASSTATION, 500.0);
+
+	CTrajectoryGenerator walker(11);
+	walker.setRandomWalk(CWaypoint("Darmstadt", centreLatitude, centreLongitude));
+	walker.setNoVehicles(noVehicles);
+	walker.setNoise(5.0);
+	walker.setRate(1.0);
+
+	vector<t_geofenceEvent> events;
+	unsigned long noEvents[3] =
+	{ 0, 0, 0 };
+	t_gpsFix fix;
+	unsigned int vehicle;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (unsigned int i = 0; i < noVehicles * noPeriods; i++)
+	{
+		walker.getNextFix(fix, vehicle);
+		geofences.update(vehicle, fix, events);
+
+		for (unsigned int e = 0; e < events.size(); e++)
+			noEvents[events[e].type]++;
+		events.clear();
+	}
+	double elapsedS = chrono::duration<double>(
+			chrono::steady_clock::now() - start).count();
+
+	cout << geofences.getNoFences() << " fences (" << noPoiFences
+			<< " around gas stations), " << noVehicles << " vehicles, "
+			<< noPeriods << " fixes each : "
+			<< noVehicles * noPeriods / elapsedS << " fixes per second, "
+			<< (double) geofences.getNoFenceTests() / (noVehicles * noPeriods)
+			<< " fence tests per fix" << endl;
+	cout << noEvents[GEOFENCE_ENTER] << " enter, " << noEvents[GEOFENCE_EXIT]
+			<< " exit, " << noEvents[GEOFENCE_DWELL] << " dwell events" << endl;
+}
+
+/**
+ * Testcase (benchmark) for the deviation detector : a vehicle follows the test Route, takes a detour of about
+ * 2 km to the north west and comes back. Prints the fixes where it left and re-joined the Route with the
+ * suggested re-join points, then the time per fix on and off the Route
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_detectOffRoute()
+{
+	CWpDatabase wpDatabase;
+	CPoiDatabase poiDatabase;
+	CRoute route;
+	createTestRoute(wpDatabase, poiDatabase, route);
+
+	// about 15 m per second along the Route (north east), detour between fix 1000 and 1600
+	const unsigned int noFixes = 3000;
+	vector<t_gpsFix> fixes(noFixes);
+	for (unsigned int i = 0; i < noFixes; i++)
+	{
+		double detour = 0.0;
+		if (i > 1000 && i < 1600)
+			detour = 0.00005 * min(i - 1000, 1600 - i);
+
+		fixes[i].latitude = 49.8 + 0.0001 * i + detour;
+		fixes[i].longitude = 8.6 + 0.0001 * i - detour;
+		fixes[i].timestamp = i;
+	}
+
+	CDeviationDetector detector(0.05, 60.0, 3);
+	detector.setRoute(route);
+	t_deviation deviation;
+
+	for (unsigned int i = 0; i < noFixes; i++)
+	{
+		detector.update(fixes[i], deviation);
+
+		if (deviation.changed || (deviation.offRoute && i % 100 == 0))
+		{
+			cout << "fix " << i << " : " << (deviation.offRoute ? "off" : "on")
+					<< " route, cross track " << deviation.match.crossTrackKm
+					<< " km, heading difference " << deviation.headingDegree;
+			if (deviation.offRoute)
+				cout << ", re-join after " << deviation.rejoin.distanceKm
+						<< " km at " << deviation.rejoin.alongTrackKm
+						<< " km of the Route, " << deviation.rejoin.remainingKm
+						<< " km remaining";
+			cout << endl;
+		}
+	}
+
+	// time per fix : on the Route (first 1000 fixes) and off the Route (detour), re-join search on every fix
+	const unsigned int noRepetitions = 1000;
+	unsigned int ranges[2][2] =
+	{
+	{ 0, 1000 },
+	{ 1100, 1500 } };
+	const char* names[2] =
+	{ "on the Route", "off the Route" };
+
+	for (unsigned int r = 0; r < 2; r++)
+	{
+		unsigned long long noTests = detector.getNoSegmentTests();
+		unsigned long noUpdates = 0, noOffRoute = 0;
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (unsigned int n = 0; n < noRepetitions; n++)
+		{
+			detector.reset();
+			for (unsigned int i = ranges[r][0]; i < ranges[r][1]; i++)
+			{
+				detector.update(fixes[i], deviation);
+				noOffRoute += deviation.offRoute;
+				noUpdates++;
+			}
+		}
+		double elapsedS = chrono::duration<double>(
+				chrono::steady_clock::now() - start).count();
+
+		cout << names[r] << " : " << elapsedS * 1e9 / noUpdates
+				<< " ns per fix, " << noOffRoute << " of " << noUpdates
+				<< " fixes off route, "
+				<< (double) (detector.getNoSegmentTests() - noTests) / noUpdates
+				<< " segments tested per fix" << endl;
+	}
+}
+
+/**
+ * Function creates a grid of size x size Waypoints (about 1 km apart) around Darmstadt and writes the roads between
+ * neighbours to an edge list file. Roads are 0 - 50 % longer than the straight line, every 7th road is one way.
+ * @param CWpDatabase& wpDatabase     : OUT database with the Waypoints "grid<row>_<column>"
+ * @param unsigned int size           : IN number of rows and columns
+ * @param const std::string& fileName : IN name of the edge list file
+ * @returnvalue void
+ */
+void CNavigationSystem::writeGridEdgeList(CWpDatabase& wpDatabase,
+		unsigned int size, const string& fileName)
+{
+	vector<string> names(size * size);
+	for (unsigned int row = 0; row < size; row++)
+	{
+		for (unsigned int column = 0; column < size; column++)
+		{
+			ostringstream name;
+			name << "grid" << row << "_" << column;
+			names[row * size + column] = name.str();
+			wpDatabase.addWaypoint(
+					CWaypoint(name.str(), 49.0 + 0.009 * row, 8.0 + 0.014 * column));
+		}
+	}
+
+	ofstream edgeList(fileName.c_str());
+	srand(42);
+
+	for (unsigned int node = 0; node < size * size; node++)
+	{
+		unsigned int neighbours[2] =
+		{ node + 1, node + size };
+		bool valid[2] =
+		{ (node + 1) % size != 0, node + size < size * size };
+
+		for (unsigned int n = 0; n < 2; n++)
+		{
+			if (!valid[n])
+				continue;
+
+			double costKm = wpDatabase.getPointerToWaypoint(names[node])->calculateDistance(
+					*wpDatabase.getPointerToWaypoint(names[neighbours[n]]))
+					* (1.0 + 0.5 * rand() / RAND_MAX);
+			bool oneWay = (rand() % 7 == 0);
+
+			edgeList << names[node] << ";" << names[neighbours[n]] << ";"
+					<< costKm << "\n";
+			if (!oneWay)
+				edgeList << names[neighbours[n]] << ";" << names[node] << ";"
+						<< costKm << "\n";
+		}
+	}
+}
+
+/**
+ * Testcase (benchmark) for the road graph : loads a grid of 300 x 300 Waypoints from an edge list file,
+ * prints a shortest Route and the time and settled nodes of 200 random Dijkstra queries
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_roadGraph()
+{
+	const unsigned int size = 300, noQueries = 200;
+	const string fileName = "road_edges.txt";
+	CWpDatabase wpDatabase;
+
+	writeGridEdgeList(wpDatabase, size, fileName);
+	{
+		// erroneous lines are reported and skipped
+		ofstream edgeList(fileName.c_str(), ios::app);
+		edgeList << "grid0_0;nowhere;1.0" << "\n" << "grid0_0;grid0_1;-2" << "\n";
+	}
+
+	CRoadGraph graph;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	graph.loadEdges(fileName, wpDatabase);
+	double elapsedS = chrono::duration<double>(
+			chrono::steady_clock::now() - start).count();
+	remove(fileName.c_str());
+
+	cout << graph.getNoNodes() << " nodes, " << graph.getNoEdges()
+			<< " edges loaded in " << elapsedS << " s" << endl;
+
+	CShortestPathSearch search(graph);
+	CRoute route;
+	double costKm;
+	route.connectToWpDatabase(&wpDatabase);
+
+	if (search.shortestRoute("grid0_0", "grid10_10", route, costKm))
+	{
+		cout << "shortest Route from grid0_0 to grid10_10 : " << costKm
+				<< " km, " << search.getNoSettledNodes() << " settled nodes"
+				<< endl;
+		route.print();
+	}
+
+	srand(7);
+	vector<unsigned int> path;
+	unsigned long noSettled = 0;
+	unsigned int noFound = 0;
+
+	start = chrono::steady_clock::now();
+	for (unsigned int q = 0; q < noQueries; q++)
+	{
+		unsigned int from = rand() % graph.getNoNodes();
+		unsigned int to = rand() % graph.getNoNodes();
+
+		noFound += search.shortestPath(from, to, path, costKm);
+		noSettled += search.getNoSettledNodes();
+	}
+	elapsedS = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout << noQueries << " random queries (" << noFound << " found) : "
+			<< elapsedS * 1000 / noQueries << " ms and " << noSettled / noQueries
+			<< " settled nodes per query" << endl;
+}
+
+/**
+ * Testcase (benchmark) for the search algorithms on a grid of 500 x 500 Waypoints : the same 100 random queries
+ * with Dijkstra, A*, bidirectional Dijkstra and bidirectional A*. Prints the settled nodes and the latency
+ * percentiles of each algorithm and checks that all algorithms find paths of the same cost
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_pathSearch()
+{
+	const unsigned int size = 500, noQueries = 100;
+	const string fileName = "road_edges.txt";
+	CWpDatabase wpDatabase;
+	CRoadGraph graph;
+
+	writeGridEdgeList(wpDatabase, size, fileName);
+	graph.loadEdges(fileName, wpDatabase);
+	remove(fileName.c_str());
+
+	cout << graph.getNoNodes() << " nodes, " << graph.getNoEdges() << " edges"
+			<< endl;
+
+	srand(11);
+	vector<unsigned int> from(noQueries), to(noQueries);
+	for (unsigned int q = 0; q < noQueries; q++)
+	{
+		from[q] = rand() % graph.getNoNodes();
+		to[q] = rand() % graph.getNoNodes();
+	}
+
+	CShortestPathSearch::t_algorithm algorithms[4] =
+	{ CShortestPathSearch::DIJKSTRA, CShortestPathSearch::ASTAR,
+			CShortestPathSearch::BIDIRECTIONAL_DIJKSTRA,
+			CShortestPathSearch::BIDIRECTIONAL_ASTAR };
+	const char* names[4] =
+	{ "Dijkstra", "A*", "bidirectional Dijkstra", "bidirectional A*" };
+
+	CShortestPathSearch search(graph);
+	vector<double> dijkstraKm(noQueries);
+	vector<unsigned int> path;
+	double costKm;
+
+	for (unsigned int a = 0; a < 4; a++)
+	{
+		CLatencyHistogram latency;
+		unsigned long noSettled = 0;
+		unsigned int noDifferent = 0;
+
+		for (unsigned int q = 0; q < noQueries; q++)
+		{
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			bool found = search.shortestPath(from[q], to[q], path, costKm,
+					algorithms[a]);
+			latency.record(
+					chrono::duration_cast<chrono::nanoseconds>(
+							chrono::steady_clock::now() - start).count());
+
+			if (!found)
+				costKm = -1.0;
+			if (a == 0)
+				dijkstraKm[q] = costKm;
+			else if (fabs(costKm - dijkstraKm[q]) > 1e-6)
+				noDifferent++;
+
+			noSettled += search.getNoSettledNodes();
+		}
+
+		cout << names[a] << " : " << noSettled / noQueries
+				<< " settled nodes per query, mean "
+				<< latency.getMeanNs() / 1e6 << " ms, 50% < "
+				<< latency.getPercentileNs(0.5) / 1e6 << " ms, 99% < "
+				<< latency.getPercentileNs(0.99) / 1e6 << " ms, "
+				<< noDifferent << " different costs" << endl;
+	}
+}
+
+/**
+ * Testcase (benchmark) for the contraction hierarchy of a grid of 150 x 150 Waypoints : builds, saves and loads
+ * the hierarchy, prints one Route with unpacked shortcuts and compares 1000 random queries with Dijkstra
+ * (settled nodes, latency percentiles, different costs)
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_contractionHierarchy()
+{
+	const unsigned int size = 150, largeSize = 212, noQueries = 1000;
+	const string edgeFileName = "road_edges.txt", hierarchyFileName = "road_hierarchy.ch";
+	const string editedFileName = "road_edges_edited.txt";
+	CWpDatabase wpDatabase;
+	CRoadGraph graph;
+
+	writeGridEdgeList(wpDatabase, size, edgeFileName);
+	graph.loadEdges(edgeFileName, wpDatabase);
+
+	cout << graph.getNoNodes() << " nodes, " << graph.getNoEdges() << " edges"
+			<< endl;
+
+	CContractionHierarchy built;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	built.build(graph);
+	double elapsedS = chrono::duration<double>(
+			chrono::steady_clock::now() - start).count();
+
+	cout << "hierarchy built in " << elapsedS << " s : "
+			<< built.getNoShortcuts() << " shortcuts, " << built.getNoRounds()
+			<< " rounds" << endl;
+
+	CContractionHierarchy hierarchy;
+	if (!built.save(hierarchyFileName)
+			|| !hierarchy.load(hierarchyFileName, graph))
+		return;
+
+	// the edge list edited after save() : same Waypoints, the cost of the first edge changed
+	ifstream original(edgeFileName.c_str());
+	ofstream edited(editedFileName.c_str());
+	string line;
+	for (bool isFirst = true; getline(original, line); isFirst = false)
+	{
+		if (isFirst)
+			line = line.substr(0, line.rfind(';') + 1) + "99";
+		edited << line << "\n";
+	}
+	original.close();
+	edited.close();
+
+	CRoadGraph editedGraph;
+	CContractionHierarchy stale;
+	editedGraph.loadEdges(editedFileName, wpDatabase);
+	bool isAccepted = stale.load(hierarchyFileName, editedGraph);
+	cout << "hierarchy file for the graph with one edited cost : "
+			<< (isAccepted ? "accepted (ERROR)" : "rejected") << endl;
+
+	// the middle node of the last down edge overwritten with a node number outside of the graph
+	fstream corrupted(hierarchyFileName.c_str(), ios::in | ios::out | ios::binary);
+	unsigned int badMiddle = graph.getNoNodes() + 5;
+	corrupted.seekp(-(streamoff) sizeof(badMiddle), ios::end);
+	corrupted.write((const char*) &badMiddle, sizeof(badMiddle));
+	corrupted.close();
+	isAccepted = stale.load(hierarchyFileName, graph);
+	cout << "hierarchy file with a corrupted middle node : "
+			<< (isAccepted ? "accepted (ERROR)" : "rejected") << endl;
+
+	remove(editedFileName.c_str());
+	remove(edgeFileName.c_str());
+	remove(hierarchyFileName.c_str());
+
+	CHierarchySearch search(hierarchy);
+	CRoute route;
+	double costKm;
+	route.connectToWpDatabase(&wpDatabase);
+
+	if (search.shortestRoute("grid0_0", "grid10_10", route, costKm))
+	{
+		cout << "shortest Route from grid0_0 to grid10_10 : " << costKm
+				<< " km, " << search.getNoSettledNodes() << " settled nodes"
+				<< endl;
+		route.print();
+	}
+
+	runHierarchyQueries(hierarchy, graph, noQueries);
+
+	// the same on a grid with twice the nodes
+	CWpDatabase largeWpDatabase;
+	CRoadGraph largeGraph;
+	CContractionHierarchy largeHierarchy;
+
+	writeGridEdgeList(largeWpDatabase, largeSize, edgeFileName);
+	largeGraph.loadEdges(edgeFileName, largeWpDatabase);
+	remove(edgeFileName.c_str());
+
+	start = chrono::steady_clock::now();
+	largeHierarchy.build(largeGraph);
+	elapsedS = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout << largeGraph.getNoNodes() << " nodes, " << largeGraph.getNoEdges()
+			<< " edges : hierarchy built in " << elapsedS << " s : "
+			<< largeHierarchy.getNoShortcuts() << " shortcuts, "
+			<< largeHierarchy.getNoRounds() << " rounds" << endl;
+
+	runHierarchyQueries(largeHierarchy, largeGraph, noQueries);
+}
+
+/**
+ * Function runs random queries on a contraction hierarchy, prints their latency and compares their costs with Dijkstra
+ * @param const CContractionHierarchy& hierarchy : IN hierarchy
+ * @param const CRoadGraph& graph                : IN graph of the hierarchy
+ * @param unsigned int noQueries                 : IN number of queries
+ * @returnvalue void
+ */
+void CNavigationSystem::runHierarchyQueries(
+		const CContractionHierarchy& hierarchy, const CRoadGraph& graph,
+		unsigned int noQueries)
+{
+	srand(13);
+	CHierarchySearch search(hierarchy);
+	CShortestPathSearch dijkstra(graph);
+	CLatencyHistogram latency;
+	vector<unsigned int> path;
+	unsigned long noSettled = 0;
+	unsigned int noDifferent = 0;
+	double costKm, dijkstraKm;
+
+	for (unsigned int q = 0; q < noQueries; q++)
+	{
+		unsigned int from = rand() % graph.getNoNodes();
+		unsigned int to = rand() % graph.getNoNodes();
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		bool found = search.shortestPath(from, to, path, costKm);
+		latency.record(
+				chrono::duration_cast<chrono::nanoseconds>(
+						chrono::steady_clock::now() - start).count());
+		noSettled += search.getNoSettledNodes();
+
+		if (!found)
+			costKm = -1.0;
+		if (!dijkstra.shortestPath(from, to, path, dijkstraKm))
+			dijkstraKm = -1.0;
+		if (fabs(costKm - dijkstraKm) > 1e-6)
+			noDifferent++;
+	}
+
+	cout << noQueries << " random queries : " << noSettled / noQueries
+			<< " settled nodes per query, mean " << latency.getMeanNs() / 1e3
+			<< " us, 50% < " << latency.getPercentileNs(0.5) / 1e3
+			<< " us, 99% < " << latency.getPercentileNs(0.99) / 1e3 << " us, "
+			<< noDifferent << " different costs than Dijkstra" << endl;
+}
+
+/**
+ * Testcase (benchmark) for the distance matrix from 1000 vehicles to 5000 POIs : pairwise calculateDistance()
+ * against the great circle mode and the cost function mode (travel time), prints the largest difference and
+ * the POIs closest to the first vehicle by travel time
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_distanceMatrix()
+{
+	const unsigned int noVehicles = 1000, noPois = 5000, noClosest = 3;
+	vector<CWaypoint> vehicles;
+	vector<CPOI> pois;
+	vector<const CWaypoint*> sources, targets;
+
+	srand(17);
+	for (unsigned int i = 0; i < noVehicles; i++)
+		vehicles.push_back(
+				CWaypoint("vehicle" + to_string(i),
+						49.0 + (double) rand() / RAND_MAX,
+						8.0 + 1.5 * rand() / RAND_MAX));
+	for (unsigned int i = 0; i < noPois; i++)
+		pois.push_back(
+				CPOI((CPOI::t_poi) (i % 4), "poi" + to_string(i), "benchmark POI",
+						49.0 + (double) rand() / RAND_MAX,
+						8.0 + 1.5 * rand() / RAND_MAX));
+
+	for (unsigned int i = 0; i < noVehicles; i++)
+		sources.push_back(&vehicles[i]);
+	for (unsigned int i = 0; i < noPois; i++)
+		targets.push_back(&pois[i]);
+
+	vector<double> pairwise((size_t) noVehicles * noPois);
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (unsigned int i = 0; i < noVehicles; i++)
+	{
+		for (unsigned int j = 0; j < noPois; j++)
+			pairwise[(size_t) i * noPois + j] = vehicles[i].calculateDistance(pois[j]);
+	}
+	double pairwiseS = chrono::duration<double>(
+			chrono::steady_clock::now() - start).count();
+
+	CDistanceMatrix matrix;
+	start = chrono::steady_clock::now();
+	matrix.compute(sources, targets);
+	double matrixS = chrono::duration<double>(
+			chrono::steady_clock::now() - start).count();
+
+	double maxDifference = 0.0;
+	for (unsigned int i = 0; i < noVehicles; i++)
+	{
+		for (unsigned int j = 0; j < noPois; j++)
+			maxDifference = max(maxDifference,
+					fabs(matrix.get(i, j) - pairwise[(size_t) i * noPois + j]));
+	}
+
+	cout << noVehicles << " x " << noPois << " distances : pairwise "
+			<< pairwiseS * 1000 << " ms, matrix " << matrixS * 1000 << " ms on "
+			<< thread::hardware_concurrency() << " cores, largest difference "
+			<< maxDifference * 1e6 << " mm" << endl;
+
+	// travel time in minutes : roads 1.3 times longer than the great circle, 50 km/h
+	start = chrono::steady_clock::now();
+	matrix.compute(sources, targets,
+			[](const CWaypoint& source, const CWaypoint& target)
+			{
+				return source.calculateDistance(target) * 1.3 / 50.0 * 60.0;
+			});
+	cout << "travel time matrix : "
+			<< chrono::duration<double>(chrono::steady_clock::now() - start).count()
+					* 1000 << " ms" << endl;
+
+	vector<unsigned int> closest(noPois);
+	for (unsigned int j = 0; j < noPois; j++)
+		closest[j] = j;
+	partial_sort(closest.begin(), closest.begin() + noClosest, closest.end(),
+			[&matrix](unsigned int a, unsigned int b)
+			{
+				return matrix.get(0, a) < matrix.get(0, b);
+			});
+
+	for (unsigned int k = 0; k < noClosest; k++)
+		cout << pois[closest[k]].getName() << " : " << matrix.get(0, closest[k])
+				<< " min from " << vehicles[0].getName() << endl;
+}
+
+/**
+ * Testcase (benchmark) for ALT on a grid of 300 x 300 Waypoints : 16 landmarks selected by FARTHEST and AVOID,
+ * the tables are saved and mapped from the files. The same 100 random queries with A* (great circle) and
+ * ALT with both tables; prints preprocessing time, settled nodes, latency and the costs different from Dijkstra
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_landmarks()
+{
+	const unsigned int size = 300, noQueries = 100, noLandmarks = 16;
+	const string edgeFileName = "road_edges.txt", tableFileName = "road_landmarks.alt";
+	CWpDatabase wpDatabase;
+	CRoadGraph graph;
+
+	writeGridEdgeList(wpDatabase, size, edgeFileName);
+	graph.loadEdges(edgeFileName, wpDatabase);
+	remove(edgeFileName.c_str());
+
+	cout << graph.getNoNodes() << " nodes, " << graph.getNoEdges() << " edges"
+			<< endl;
+
+	srand(19);
+	vector<unsigned int> from(noQueries), to(noQueries);
+	vector<double> dijkstraKm(noQueries);
+	vector<unsigned int> path;
+	CShortestPathSearch search(graph);
+	unsigned long noSettled = 0;
+
+	for (unsigned int q = 0; q < noQueries; q++)
+	{
+		from[q] = rand() % graph.getNoNodes();
+		to[q] = rand() % graph.getNoNodes();
+		if (!search.shortestPath(from[q], to[q], path, dijkstraKm[q]))
+			dijkstraKm[q] = -1.0;
+		noSettled += search.getNoSettledNodes();
+	}
+	cout << "Dijkstra : " << noSettled / noQueries << " settled nodes per query"
+			<< endl;
+
+	CLandmarkTable::t_selection selections[2] =
+	{ CLandmarkTable::FARTHEST, CLandmarkTable::AVOID };
+	const char* names[2] = { "farthest", "avoid" };
+
+	for (unsigned int a = 0; a < 3; a++)
+	{
+		CLandmarkTable built, landmarks;
+		CShortestPathSearch::t_algorithm algorithm = CShortestPathSearch::ASTAR;
+
+		if (a > 0)
+		// ALT with the landmarks of a selection, mapped from the file
+		{
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			built.build(graph, noLandmarks, selections[a - 1]);
+			double elapsedS = chrono::duration<double>(
+					chrono::steady_clock::now() - start).count();
+
+			if (!built.save(tableFileName)
+					|| !landmarks.load(tableFileName, graph))
+				return;
+			remove(tableFileName.c_str());
+
+			cout << noLandmarks << " landmarks (" << names[a - 1] << ") in "
+					<< elapsedS << " s, table "
+					<< 8 * graph.getNoNodes() * noLandmarks / 1024 << " kB" << endl;
+
+			search.setLandmarks(&landmarks);
+			algorithm = CShortestPathSearch::ALT;
+		}
+
+		CLatencyHistogram latency;
+		unsigned int noDifferent = 0;
+		double costKm;
+		noSettled = 0;
+
+		for (unsigned int q = 0; q < noQueries; q++)
+		{
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			if (!search.shortestPath(from[q], to[q], path, costKm, algorithm))
+				costKm = -1.0;
+			latency.record(
+					chrono::duration_cast<chrono::nanoseconds>(
+							chrono::steady_clock::now() - start).count());
+
+			noSettled += search.getNoSettledNodes();
+			if (fabs(costKm - dijkstraKm[q]) > 1e-6)
+				noDifferent++;
+		}
+
+		cout << ((a == 0) ? "A* (great circle)" : "ALT") << " : "
+				<< noSettled / noQueries << " settled nodes per query, mean "
+				<< latency.getMeanNs() / 1e6 << " ms, 99% < "
+				<< latency.getPercentileNs(0.99) / 1e6 << " ms, " << noDifferent
+				<< " different costs" << endl;
+
+		search.setLandmarks(NULL);
+	}
+}
+
+/**
+ * Testcase (benchmark) for reachability queries on a grid of 300 x 300 Waypoints with 20000 POIs of all types
+ * at Waypoints : 100 queries "restaurants within 10 km" from random positions. The POIs are checked with
+ * Dijkstra : every restaurant within 10 km great circle distance is searched, it has to be in the result
+ * exactly if its network distance is within the budget
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_isochrone()
+{
+	const unsigned int size = 300, noPois = 20000, noQueries = 100;
+	const double budgetKm = 10.0;
+	const string edgeFileName = "road_edges.txt";
+	CWpDatabase wpDatabase;
+	CPoiDatabase poiDatabase;
+	CRoadGraph graph;
+
+	writeGridEdgeList(wpDatabase, size, edgeFileName);
+	graph.loadEdges(edgeFileName, wpDatabase);
+	remove(edgeFileName.c_str());
+
+	srand(43);
+	vector<unsigned int> restaurantNodes;      // node of each restaurant, for the check
+	for (unsigned int i = 0; i < noPois; i++)
+	{
+		unsigned int node = rand() % graph.getNoNodes();
+		CPOI::t_poi type = (CPOI::t_poi) (rand() % 4);
+		const CWaypoint* pWaypoint = graph.getWaypoint(node);
+		ostringstream name;
+		name << "poi" << i;
+		poiDatabase.addPoi(
+				CPOI(type, name.str(), "isochrone testcase",
+						pWaypoint->getLatitude(), pWaypoint->getLongitude()));
+		if (type == CPOI::RESTAURANT)
+			restaurantNodes.push_back(node);
+	}
+
+	CIsochroneSearch isochrone(graph);
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	unsigned int noAttached = isochrone.attachPois(poiDatabase, 0.5);
+	cout << noAttached << " POIs attached in "
+			<< chrono::duration<double>(chrono::steady_clock::now() - start).count() * 1000
+			<< " ms" << endl;
+
+	CShortestPathSearch search(graph);
+	CLatencyHistogram latency;
+	vector<t_reachablePoi> result;
+	vector<unsigned int> path;
+	unsigned long noReached = 0, noFound = 0;
+	unsigned int noWrong = 0;
+
+	for (unsigned int q = 0; q < noQueries; q++)
+	{
+		CWaypoint position("position", 49.0 + 0.009 * (size - 1) * rand() / RAND_MAX,
+				8.0 + 0.014 * (size - 1) * rand() / RAND_MAX);
+
+		start = chrono::steady_clock::now();
+		if (!isochrone.reachablePois(position, budgetKm, CPOI::RESTAURANT, result))
+			continue;
+		latency.record(
+				chrono::duration_cast<chrono::nanoseconds>(
+						chrono::steady_clock::now() - start).count());
+
+		noReached += isochrone.getReachedNodes().size();
+		noFound += result.size();
+
+		// check : start node and snap distance from the isochrone, restaurants within the budget with Dijkstra
+		unsigned int from = isochrone.getReachedNodes()[0];
+		double snapKm = isochrone.getDistance(from);
+		unsigned int noExpected = 0;
+
+		for (unsigned int i = 0; i < restaurantNodes.size(); i++)
+		{
+			double costKm;
+
+			if (position.calculateDistance(*graph.getWaypoint(restaurantNodes[i]))
+					<= budgetKm + 1.0
+					&& search.shortestPath(from, restaurantNodes[i], path, costKm)
+					&& snapKm + costKm <= budgetKm)
+				noExpected++;
+		}
+
+		if (noExpected != result.size())
+			noWrong++;
+	}
+
+	cout << noQueries << " queries, restaurants within " << budgetKm
+			<< " km : " << noReached / noQueries << " nodes reached, "
+			<< (double) noFound / noQueries << " restaurants found, mean "
+			<< latency.getMeanNs() / 1e3 << " us, 99% < "
+			<< latency.getPercentileNs(0.99) / 1e3 << " us, " << noWrong
+			<< " wrong results" << endl;
+}
+
+/**
+ * Testcase (benchmark) for the type index of the POI Database : 100000 random POIs of all types, 1000 queries
+ * "nearest gas station" and "gas stations within 5 km" with the index and by scanning the whole POI map;
+ * both have to find the same POIs. The Database is cleared and filled again to check the index is rebuilt.
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_poiTypeIndex()
+{
+	const unsigned int noPois = 100000, noQueries = 1000;
+	const double radiusKm = 5.0;
+	CPoiDatabase poiDatabase;
+
+	for (unsigned int round = 0; round < 2; round++)
+	{
+		poiDatabase.clearPoiDb();
+		srand(44 + round);
+		for (unsigned int i = 0; i < noPois; i++)
+		{
+			ostringstream name;
+			name << "poi" << i;
+			poiDatabase.addPoi(
+					CPOI((CPOI::t_poi) (rand() % 4), name.str(), "type index testcase",
+							47.5 + 7.0 * rand() / RAND_MAX, 6.0 + 9.0 * rand() / RAND_MAX));
+		}
+	}
+
+	map<string, CPOI> poiMap;
+	poiDatabase.getPoiMap(poiMap);
+	cout << poiMap.size() << " POIs, "
+			<< poiDatabase.getPoisOfType(CPOI::GASSTATION).size()
+			<< " gas stations" << endl;
+
+	vector<CWaypoint> positions;
+	for (unsigned int q = 0; q < noQueries; q++)
+		positions.push_back(
+				CWaypoint("position", 47.5 + 7.0 * rand() / RAND_MAX,
+						6.0 + 9.0 * rand() / RAND_MAX));
+
+	// index
+	vector<const CPOI*> nearestIndex(noQueries);
+	vector<unsigned int> noWithinIndex(noQueries);
+	vector<const CPOI*> pois;
+	double distanceKm;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (unsigned int q = 0; q < noQueries; q++)
+	{
+		nearestIndex[q] = poiDatabase.getNearestPoi(CPOI::GASSTATION,
+				positions[q].getLatitude(), positions[q].getLongitude(), distanceKm);
+		noWithinIndex[q] = poiDatabase.getPoisWithinRadius(CPOI::GASSTATION,
+				positions[q].getLatitude(), positions[q].getLongitude(), radiusKm, pois);
+	}
+	double indexMs = chrono::duration<double, milli>(
+			chrono::steady_clock::now() - start).count();
+
+	// scan of the whole POI map
+	unsigned int noDifferent = 0;
+	string name, description;
+	double latitude, longitude;
+	CPOI::t_poi type;
+
+	start = chrono::steady_clock::now();
+	for (unsigned int q = 0; q < noQueries; q++)
+	{
+		CUnitVector position = CUnitVector::fromWaypoint(positions[q]);
+		const CPOI* pNearest = NULL;
+		double nearestKm = 0.0;
+		unsigned int noWithin = 0;
+
+		for (map<string, CPOI>::const_iterator itr = poiMap.begin();
+				itr != poiMap.end(); ++itr)
+		{
+			itr->second.getAllDataByReference(name, latitude, longitude, type,
+					description);
+			if (type != CPOI::GASSTATION)
+				continue;
+
+			double poiKm = position.distanceTo(CUnitVector::fromLatLon(latitude, longitude));
+			if (pNearest == NULL || poiKm < nearestKm)
+			{
+				pNearest = poiDatabase.getPointerToPoi(name);
+				nearestKm = poiKm;
+			}
+			if (poiKm <= radiusKm)
+				noWithin++;
+		}
+
+		if (pNearest != nearestIndex[q] || noWithin != noWithinIndex[q])
+			noDifferent++;
+	}
+	double scanMs = chrono::duration<double, milli>(
+			chrono::steady_clock::now() - start).count();
+
+	cout << noQueries << " queries : type index " << indexMs << " ms, scan "
+			<< scanMs << " ms, " << noDifferent << " different results" << endl;
+}
+
+/**
+ * Function of a thread of TC_poiCategories() : registers the categories "SHARED_<n>", each thread in another order
+ * @param unsigned int thread                : IN number of the thread
+ * @param unsigned int noNames               : IN number of categories
+ * @param std::vector<t_poiCategory>* pIds   : OUT ID of each category
+ * @returnvalue void
+ */
+void CNavigationSystem::registerSharedCategories(unsigned int thread,
+		unsigned int noNames, vector<t_poiCategory>* pIds)
+{
+	for (unsigned int i = 0; i < noNames; i++)
+	{
+		unsigned int n = (7 * i + 13 * thread) % noNames;
+		ostringstream name;
+		name << "SHARED_" << n;
+		(*pIds)[n] = CPoiCategoryRegistry::registerCategory(name.str());
+	}
+}
+
+/**
+ * Testcase (benchmark) for the POI category registry : 300 categories are registered, 4 threads register the
+ * same 200 categories at the same time, 1000000 lookups of category names with the registry and with a
+ * std::map, then 50000 POIs of random categories and 1000 queries "nearest POI of 3 categories" with a
+ * category filter compared with a scan of the whole POI map
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_poiCategories()
+{
+	const unsigned int noCategories = 300, noLookups = 1000000, noPois = 50000,
+			noQueries = 1000;
+	vector<string> names;
+	map<string, t_poiCategory> categoryMap;
+
+	for (unsigned int i = 0; i < noCategories; i++)
+	{
+		ostringstream name;
+		name << "CATEGORY_" << i;
+		t_poiCategory id = CPoiCategoryRegistry::registerCategory(name.str());
+		names.push_back(name.str());
+		categoryMap[name.str()] = id;
+	}
+	cout << CPoiCategoryRegistry::getNoCategories() << " categories registered, "
+			<< names[7] << " has ID "
+			<< CPoiCategoryRegistry::registerCategory(names[7]) << ", ID 2 is "
+			<< CPoiCategoryRegistry::getName(2) << endl;
+
+	// the same categories registered by several threads get one ID each
+	const unsigned int noThreads = 4, noShared = 200;
+	unsigned int noBefore = CPoiCategoryRegistry::getNoCategories();
+	vector<vector<t_poiCategory> > sharedIds(noThreads,
+			vector<t_poiCategory>(noShared));
+	vector<thread> threads;
+
+	for (unsigned int t = 0; t < noThreads; t++)
+		threads.push_back(
+				thread(registerSharedCategories, t, noShared, &sharedIds[t]));
+	for (unsigned int t = 0; t < noThreads; t++)
+		threads[t].join();
+
+	unsigned int noConflicts = 0;
+	for (unsigned int t = 1; t < noThreads; t++)
+		for (unsigned int n = 0; n < noShared; n++)
+			if (sharedIds[t][n] != sharedIds[0][n])
+				noConflicts++;
+
+	cout << noThreads << " threads registered " << noShared << " categories : "
+			<< CPoiCategoryRegistry::getNoCategories() - noBefore
+			<< " new IDs, " << noConflicts << " different IDs for the same name"
+			<< endl;
+
+	// lookups
+	srand(45);
+	vector<unsigned int> lookups(noLookups);
+	for (unsigned int i = 0; i < noLookups; i++)
+		lookups[i] = rand() % noCategories;
+
+	unsigned long sum = 0;
+	t_poiCategory id;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (unsigned int i = 0; i < noLookups; i++)
+		if (CPoiCategoryRegistry::getId(names[lookups[i]], id))
+			sum += id;
+	double registryMs = chrono::duration<double, milli>(
+			chrono::steady_clock::now() - start).count();
+
+	unsigned long mapSum = 0;
+	start = chrono::steady_clock::now();
+	for (unsigned int i = 0; i < noLookups; i++)
+		mapSum += categoryMap.find(names[lookups[i]])->second;
+	double mapMs = chrono::duration<double, milli>(
+			chrono::steady_clock::now() - start).count();
+
+	cout << noLookups << " lookups : registry " << registryMs << " ms, std::map "
+			<< mapMs << " ms, " << ((sum == mapSum) ? "same IDs" : "different IDs")
+			<< endl;
+
+	// queries with a filter of 3 categories
+	CPoiDatabase poiDatabase;
+	for (unsigned int i = 0; i < noPois; i++)
+	{
+		ostringstream name;
+		name << "poi" << i;
+		poiDatabase.addPoi(
+				CPOI(categoryMap[names[rand() % noCategories]], name.str(),
+						"category testcase", 47.5 + 7.0 * rand() / RAND_MAX,
+						6.0 + 9.0 * rand() / RAND_MAX));
+	}
+
+	CPoiCategoryFilter filter;
+	filter.add(categoryMap[names[3]]);
+	filter.add(categoryMap[names[100]]);
+	filter.add(categoryMap[names[299]]);
+
+	map<string, CPOI> poiMap;
+	poiDatabase.getPoiMap(poiMap);
+
+	unsigned int noDifferent = 0;
+	double indexMs = 0.0;
+	string name, description;
+	double latitude, longitude, distanceKm;
+	CPOI::t_poi type;
+
+	for (unsigned int q = 0; q < noQueries; q++)
+	{
+		CWaypoint position("position", 47.5 + 7.0 * rand() / RAND_MAX,
+				6.0 + 9.0 * rand() / RAND_MAX);
+
+		start = chrono::steady_clock::now();
+		const CPOI* pNearest = poiDatabase.getNearestPoi(filter,
+				position.getLatitude(), position.getLongitude(), distanceKm);
+		indexMs += chrono::duration<double, milli>(
+				chrono::steady_clock::now() - start).count();
+
+		// scan
+		CUnitVector unitVector = CUnitVector::fromWaypoint(position);
+		const CPOI* pScanned = NULL;
+		double scannedKm = 0.0;
+
+		for (map<string, CPOI>::const_iterator itr = poiMap.begin();
+				itr != poiMap.end(); ++itr)
+		{
+			itr->second.getAllDataByReference(name, latitude, longitude, type,
+					description);
+			if (!filter.contains(type))
+				continue;
+
+			double poiKm = unitVector.distanceTo(
+					CUnitVector::fromLatLon(latitude, longitude));
+			if (pScanned == NULL || poiKm < scannedKm)
+			{
+				pScanned = poiDatabase.getPointerToPoi(name);
+				scannedKm = poiKm;
+			}
+		}
+
+		if (pScanned != pNearest)
+			noDifferent++;
+	}
+
+	cout << noQueries << " queries for 3 of " << noCategories
+			<< " categories : filter " << indexMs << " ms, " << noDifferent
+			<< " different from a scan" << endl;
+}
+
+/**
+ * Testcase (benchmark) for the string pool : 500000 POIs with 20 different descriptions are added to the POI
+ * Database. The memory of names and descriptions is compared with one std::string per attribute (object
+ * plus heap block for strings longer than the small string buffer), the time of getPoiMap() is measured and
+ * the strings read back are checked.
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_stringPool()
+{
+	const unsigned int noPois = 500000, noDescriptions = 20;
+	const size_t smallString = 15, heapOverhead = 16;   // characters without heap block, bytes per heap block (typical)
+	CPoiDatabase poiDatabase;
+	vector<string> descriptions;
+
+	for (unsigned int i = 0; i < noDescriptions; i++)
+	{
+		ostringstream description;
+		description << "French Restaurant with excellent service, branch " << i;
+		descriptions.push_back(description.str());
+	}
+
+	size_t poolBytesBefore = CStringPool::getMemoryBytes();
+	size_t stringBytes = 0;             // memory of the same strings as std::string
+
+	srand(46);
+	for (unsigned int i = 0; i < noPois; i++)
+	{
+		ostringstream name;
+		name << "restaurant " << i;
+		const string& description = descriptions[rand() % noDescriptions];
+
+		poiDatabase.addPoi(
+				CPOI(CPOI::RESTAURANT, name.str(), description,
+						47.5 + 7.0 * rand() / RAND_MAX, 6.0 + 9.0 * rand() / RAND_MAX));
+
+		string attributes[2] =
+		{ name.str(), description };
+		for (unsigned int a = 0; a < 2; a++)
+		{
+			stringBytes += sizeof(string);
+			if (attributes[a].size() > smallString)
+				stringBytes += ((attributes[a].size() + 1 + 15) / 16) * 16
+						+ heapOverhead;
+		}
+	}
+
+	size_t poolBytes = CStringPool::getMemoryBytes() - poolBytesBefore;
+	size_t idBytes = 2 * sizeof(uint32_t) * noPois;
+
+	cout << noPois << " POIs, " << CStringPool::getNoStrings()
+			<< " strings in the pool" << endl;
+	cout << "names and descriptions as std::string : " << stringBytes / 1024
+			<< " kB, interned : " << (idBytes + poolBytes) / 1024 << " kB (IDs "
+			<< idBytes / 1024 << " kB, pool " << poolBytes / 1024 << " kB), saved "
+			<< ((double) stringBytes - (idBytes + poolBytes)) / (1024 * 1024)
+			<< " MB" << endl;
+	cout << "sizeof(CPOI) = " << sizeof(CPOI) << " bytes, with std::string attributes "
+			<< sizeof(CPOI) - 2 * sizeof(uint32_t) + 2 * sizeof(string)
+			<< " bytes" << endl;
+
+	// copy of the Database and check of the strings
+	map<string, CPOI> poiMap;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	poiDatabase.getPoiMap(poiMap);
+	double copyMs = chrono::duration<double, milli>(
+			chrono::steady_clock::now() - start).count();
+
+	unsigned int noWrong = 0;
+	for (map<string, CPOI>::const_iterator itr = poiMap.begin();
+			itr != poiMap.end(); ++itr)
+	{
+		if (itr->second.getName() != itr->first
+				|| itr->second.getPoiDescription().compare(0, 17, "French Restaurant") != 0)
+			noWrong++;
+	}
+
+	cout << "getPoiMap() " << copyMs << " ms, " << noWrong << " wrong strings"
+			<< endl;
+}
+
+/**
+ * Testcase (benchmark) for the fixed point coordinates : the sizes of CWaypoint and CPOI are printed,
+ * 1000000 random positions on the whole globe are stored in Waypoints and the largest difference of the
+ * decoded coordinates is converted to cm. A bounding box is searched in the Waypoints by comparing the
+ * encoded coordinates and by comparing the decoded ones, both must find the same Waypoints.
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_compactCoordinates()
+{
+	const unsigned int noWaypoints = 1000000;
+	const double cmPerDegree = 111.32 * 100000;     // on the equator, the largest length of a degree
+	vector<CWaypoint> waypoints;
+	double maxLatitudeError = 0, maxLongitudeError = 0;
+
+	cout << "COMPACT_COORDINATES = " << COMPACT_COORDINATES << " : sizeof(CWaypoint) = "
+			<< sizeof(CWaypoint) << " bytes, sizeof(CPOI) = " << sizeof(CPOI)
+			<< " bytes" << endl;
+
+	waypoints.reserve(noWaypoints);
+	srand(47);
+	for (unsigned int i = 0; i < noWaypoints; i++)
+	{
+		double latitude = -90.0 + 180.0 * rand() / RAND_MAX;
+		double longitude = -180.0 + 360.0 * rand() / RAND_MAX;
+
+		waypoints.push_back(CWaypoint("wp", latitude, longitude));
+		maxLatitudeError = max(maxLatitudeError,
+				fabs(waypoints.back().getLatitude() - latitude));
+		maxLongitudeError = max(maxLongitudeError,
+				fabs(waypoints.back().getLongitude() - longitude));
+	}
+
+	cout << noWaypoints << " Waypoints : largest error latitude "
+			<< maxLatitudeError * cmPerDegree << " cm, longitude "
+			<< maxLongitudeError * cmPerDegree << " cm" << endl;
+
+	// bounding box around Germany
+	const double south = 47.3, north = 55.1, west = 5.9, east = 15.0;
+	int32_t southE7 = CWaypoint::encodeCoordinate(south), northE7 =
+			CWaypoint::encodeCoordinate(north);
+	int32_t westE7 = CWaypoint::encodeCoordinate(west), eastE7 =
+			CWaypoint::encodeCoordinate(east);
+	unsigned int noEncoded = 0, noDecoded = 0;
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (unsigned int i = 0; i < noWaypoints; i++)
+	{
+		int32_t latitude = waypoints[i].getLatitudeE7(), longitude =
+				waypoints[i].getLongitudeE7();
+
+		if (latitude >= southE7 && latitude <= northE7 && longitude >= westE7
+				&& longitude <= eastE7)
+			noEncoded++;
+	}
+	double encodedMs = chrono::duration<double, milli>(
+			chrono::steady_clock::now() - start).count();
+
+	start = chrono::steady_clock::now();
+	for (unsigned int i = 0; i < noWaypoints; i++)
+	{
+		double latitude = waypoints[i].getLatitude(), longitude =
+				waypoints[i].getLongitude();
+
+		if (latitude >= south && latitude <= north && longitude >= west
+				&& longitude <= east)
+			noDecoded++;
+	}
+	double decodedMs = chrono::duration<double, milli>(
+			chrono::steady_clock::now() - start).count();
+
+	cout << "bounding box : encoded " << noEncoded << " Waypoints in " << encodedMs
+			<< " ms, decoded " << noDecoded << " Waypoints in " << decodedMs
+			<< " ms" << endl;
+}
+
+/**
+ * Testcase (benchmark) for the slabs of the Databases : 1000000 Waypoints are added to a Waypoint Database
+ * and to a std::map with std::allocator in the same way (search, then insert), then both are cleared. The
+ * load is repeated after clearing, and the contents are compared. The names copied by the Database must not
+ * be added to the shared CStringPool.
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_databaseArena()
+{
+	const unsigned int noWaypoints = 1000000, noRounds = 2;
+	vector<CWaypoint> waypoints;
+	CWpDatabase wpDatabase;
+	map<string, CWaypoint> heapMap;
+
+	waypoints.reserve(noWaypoints);
+	srand(48);
+	for (unsigned int i = 0; i < noWaypoints; i++)
+	{
+		ostringstream name;
+		name << "wp " << i;
+		waypoints.push_back(
+				CWaypoint(name.str(), 47.5 + 7.0 * rand() / RAND_MAX,
+						6.0 + 9.0 * rand() / RAND_MAX));
+	}
+	unsigned int noSharedStrings = CStringPool::getNoStrings();
+
+	for (unsigned int round = 0; round < noRounds; round++)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (unsigned int i = 0; i < noWaypoints; i++)
+			wpDatabase.addWaypoint(waypoints[i]);
+		double arenaLoadMs = chrono::duration<double, milli>(
+				chrono::steady_clock::now() - start).count();
+
+		start = chrono::steady_clock::now();
+		for (unsigned int i = 0; i < noWaypoints; i++)
+		{
+			string name = waypoints[i].getName();
+
+			if (heapMap.find(name) == heapMap.end())
+				heapMap.insert(pair<string, CWaypoint>(name, waypoints[i]));
+		}
+		double heapLoadMs = chrono::duration<double, milli>(
+				chrono::steady_clock::now() - start).count();
+
+		// the contents have to be equal
+		map<string, CWaypoint> wpMap;
+		wpDatabase.getWpMap(wpMap);
+		unsigned int noDifferent = (wpMap.size() == heapMap.size()) ? 0 : 1;
+		for (map<string, CWaypoint>::const_iterator itr = wpMap.begin(), heapItr =
+				heapMap.begin(); noDifferent == 0 && itr != wpMap.end();
+				++itr, ++heapItr)
+		{
+			if (itr->first != heapItr->first
+					|| itr->second.getLatitudeE7() != heapItr->second.getLatitudeE7()
+					|| itr->second.getLongitudeE7() != heapItr->second.getLongitudeE7())
+				noDifferent++;
+		}
+
+		start = chrono::steady_clock::now();
+		wpDatabase.clearWpDb();
+		double arenaClearMs = chrono::duration<double, milli>(
+				chrono::steady_clock::now() - start).count();
+
+		start = chrono::steady_clock::now();
+		heapMap.clear();
+		double heapClearMs = chrono::duration<double, milli>(
+				chrono::steady_clock::now() - start).count();
+
+		cout << "round " << round + 1 << ", " << noWaypoints
+				<< " Waypoints : Database (DATABASE_ARENA = " << DATABASE_ARENA
+				<< ") load " << arenaLoadMs << " ms, clear " << arenaClearMs
+				<< " ms; std::map load " << heapLoadMs << " ms, clear "
+				<< heapClearMs << " ms; " << noDifferent << " differences, "
+				<< CStringPool::getNoStrings() - noSharedStrings
+				<< " strings added to the shared pool" << endl;
+	}
+}
+
+/**
+ * Testcase (benchmark) for the route table : a Route of 2000 elements, every second one a POI of one of
+ * 4 categories, is searched for the nearest POI of 100000 positions. The loop over the view of the Route
+ * with CWaypoint::calculateDistance() (as the session engine did before) is compared with the table, for
+ * all POIs and for gas stations only. Both must find the same POIs or POIs at the same distance.
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_routeTable()
+{
+	const unsigned int noElements = 2000, noQueries = 100000;
+	CWpDatabase wpDatabase;
+	CPoiDatabase poiDatabase;
+	CRoute route;
+
+	route.connectToWpDatabase(&wpDatabase);
+	route.connectToPoiDatabase(&poiDatabase);
+
+	srand(49);
+	for (unsigned int i = 0; i < noElements; i++)
+	{
+		ostringstream name;
+		name << "element" << i;
+		double latitude = 49.0 + 2.0 * rand() / RAND_MAX;
+		double longitude = 8.0 + 3.0 * rand() / RAND_MAX;
+
+		if (i % 2 == 1)
+		{
+			poiDatabase.addPoi(
+					CPOI((CPOI::t_poi) (rand() % 4), name.str(), "on the Route",
+							latitude, longitude));
+			route.addPoi(name.str());
+		}
+		else
+		{
+			wpDatabase.addWaypoint(CWaypoint(name.str(), latitude, longitude));
+			route.addWaypoint(name.str());
+		}
+	}
+
+	CRouteTable table;
+	table.build(route);
+
+	vector<CWaypoint> positions;
+	for (unsigned int q = 0; q < noQueries; q++)
+		positions.push_back(
+				CWaypoint("", 49.0 + 2.0 * rand() / RAND_MAX,
+						8.0 + 3.0 * rand() / RAND_MAX));
+
+	for (unsigned int pass = 0; pass < 2; pass++)
+	{
+		// pass 0 : all POIs, pass 1 : gas stations
+		CPoiCategoryFilter filter;
+		if (pass == 0)
+			filter.addAll();
+		else
+			filter.add(CPOI::GASSTATION);
+
+		vector<const CPOI*> viewResults(noQueries), tableResults(noQueries);
+		CRouteView view = route.getRouteView();
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (unsigned int q = 0; q < noQueries; q++)
+		{
+			double nearestKm = 0.0;
+			const CPOI* pNearest = NULL;
+
+			for (CRouteView::const_iterator itr = view.begin(); itr != view.end();
+					++itr)
+			{
+				if (itr->isPoi()
+						&& (pass == 0 || itr->getPoi()->getType() == "GASSTATION"))
+				{
+					double distance = itr->pWaypoint->calculateDistance(
+							positions[q]);
+
+					if (pNearest == NULL || distance < nearestKm)
+					{
+						pNearest = itr->getPoi();
+						nearestKm = distance;
+					}
+				}
+			}
+			viewResults[q] = pNearest;
+		}
+		double viewMs = chrono::duration<double, milli>(
+				chrono::steady_clock::now() - start).count();
+
+		start = chrono::steady_clock::now();
+		for (unsigned int q = 0; q < noQueries; q++)
+		{
+			double nearestKm;
+			CUnitVector position = CUnitVector::fromWaypoint(positions[q]);
+			int nearest = (pass == 0) ?
+					table.getNearestPoi(position, nearestKm) :
+					table.getNearestPoi(position, filter, nearestKm);
+
+			tableResults[q] = (nearest >= 0) ? table.getPoi(nearest) : NULL;
+		}
+		double tableMs = chrono::duration<double, milli>(
+				chrono::steady_clock::now() - start).count();
+
+		unsigned int noDifferent = 0;
+		for (unsigned int q = 0; q < noQueries; q++)
+		{
+			// POIs at the same distance (within 1 cm, the rounding of acos() in calculateDistance()) may be taken in a different order
+			if (viewResults[q] != tableResults[q]
+					&& fabs(viewResults[q]->calculateDistance(positions[q])
+							- tableResults[q]->calculateDistance(positions[q])) > 1e-5)
+				noDifferent++;
+		}
+
+		cout << noQueries << " queries, " << table.getNoPois() << " POIs"
+				<< ((pass == 0) ? "" : ", gas stations") << " : view "
+				<< viewMs << " ms, table " << tableMs << " ms, " << noDifferent
+				<< " different results" << endl;
+	}
+}
+
+/**
+ * Function computes the length of the geodesic between two positions on the WGS84 ellipsoid with the
+ * inverse formula of Vincenty in long double (error below 1 mm), reference of TC_distancePrecision()
+ * @param double latitude1        : IN latitude of the first position in degree
+ * @param double longitude1       : IN longitude of the first position in degree
+ * @param double latitude2        : IN latitude of the second position in degree
+ * @param double longitude2       : IN longitude of the second position in degree
+ * @param long double& distanceKm : OUT length of the geodesic
+ * @returnvalue bool : false if the iteration does not converge (nearly antipodal positions)
+ */
+bool CNavigationSystem::calculateGeodesicDistance(double latitude1,
+		double longitude1, double latitude2, double longitude2,
+		long double& distanceKm)
+{
+	const long double degree = 3.14159265358979323846264338327950288L / 180;
+	const long double a = 6378.137L, f = 1 / 298.257223563L;   // WGS84
+	const long double b = a * (1 - f);
+
+	long double L = (longitude2 - longitude1) * degree;
+	long double U1 = atanl((1 - f) * tanl(latitude1 * degree));
+	long double U2 = atanl((1 - f) * tanl(latitude2 * degree));
+	long double sinU1 = sinl(U1), cosU1 = cosl(U1);
+	long double sinU2 = sinl(U2), cosU2 = cosl(U2);
+
+	long double lambda = L, sinSigma = 0, cosSigma = 0, sigma = 0;
+	long double cosSqAlpha = 0, cos2SigmaM = 0;
+	bool isConverged = false;
+
+	for (unsigned int i = 0; i < 1000 && !isConverged; i++)
+	{
+		long double sinLambda = sinl(lambda), cosLambda = cosl(lambda);
+		long double p = cosU2 * sinLambda;
+		long double q = cosU1 * sinU2 - sinU1 * cosU2 * cosLambda;
+
+		sinSigma = sqrtl(p * p + q * q);
+		if (sinSigma == 0)
+		// same position
+		{
+			distanceKm = 0;
+			return true;
+		}
+
+		cosSigma = sinU1 * sinU2 + cosU1 * cosU2 * cosLambda;
+		sigma = atan2l(sinSigma, cosSigma);
+		long double sinAlpha = cosU1 * cosU2 * sinLambda / sinSigma;
+		cosSqAlpha = 1 - sinAlpha * sinAlpha;
+		cos2SigmaM = (cosSqAlpha != 0) ?
+				cosSigma - 2 * sinU1 * sinU2 / cosSqAlpha : 0;   // 0 on the equator
+
+		long double C = f / 16 * cosSqAlpha * (4 + f * (4 - 3 * cosSqAlpha));
+		long double previousLambda = lambda;
+		lambda = L
+				+ (1 - C) * f * sinAlpha
+						* (sigma
+								+ C * sinSigma
+										* (cos2SigmaM
+												+ C * cosSigma
+														* (-1 + 2 * cos2SigmaM * cos2SigmaM)));
+
+		isConverged = fabsl(lambda - previousLambda) < 1e-15L;
+	}
+
+	if (!isConverged)
+		return false;
+
+	long double uSq = cosSqAlpha * (a * a - b * b) / (b * b);
+	long double A = 1 + uSq / 16384 * (4096 + uSq * (-768 + uSq * (320 - 175 * uSq)));
+	long double B = uSq / 1024 * (256 + uSq * (-128 + uSq * (74 - 47 * uSq)));
+	long double deltaSigma = B * sinSigma
+			* (cos2SigmaM
+					+ B / 4
+							* (cosSigma * (-1 + 2 * cos2SigmaM * cos2SigmaM)
+									- B / 6 * cos2SigmaM
+											* (-3 + 4 * sinSigma * sinSigma)
+											* (-3 + 4 * cos2SigmaM * cos2SigmaM)));
+
+	distanceKm = b * A * (sigma - deltaSigma);
+	return true;
+}
+
+/**
+ * Testcase (benchmark) for the precision of CWaypoint::calculateDistance() : for pairs of Waypoints about
+ * 1 m, 100 m, 10 km and 1000 km apart and for nearly antipodal pairs
+ * - the numerical error : the distance is compared with a reference on the same sphere, computed in long
+ *   double with the haversine formula (atan2 form) from the stored coordinates. The formula used before
+ *   (acos of the spherical law of cosines with PI = 3.14159) is compared as well.
+ * - the error of the sphere : the distance is compared with the geodesic on the WGS84 ellipsoid, for the
+ *   mean radius and for the equatorial radius used before (6378.17 km). Pairs for which the geodesic
+ *   does not converge are counted and left out.
+ * Then the time of 10000000 distances is measured for both formulas.
+ * @param no parameters
+ * @reutrn no value
+ */
+void CNavigationSystem::TC_distancePrecision()
+{
+	const unsigned int noPairs = 100000, noClasses = 5;
+	const char* classNames[noClasses] =
+	{ "1 m", "100 m", "10 km", "1000 km", "antipodal" };
+	const double offsetDegree[noClasses] =
+	{ 0.00001, 0.001, 0.1, 10.0, 0.1 };
+	const long double preciseDegree = 3.14159265358979323846264338327950288L / 180;
+	const double oldDegree = 3.14159 / 180;          // PI of the formula used before
+	const double oldEarthRadius = 6378.17;           // radius used before
+
+	srand(50);
+	for (unsigned int c = 0; c < noClasses; c++)
+	{
+		double maxError = 0.0, maxOldError = 0.0;       // metres
+		double maxRelative = 0.0, maxOldRelative = 0.0;
+		double maxSphereError = 0.0, maxOldSphereError = 0.0;
+		double maxSphereRelative = 0.0, maxOldSphereRelative = 0.0;
+		unsigned int noNotConverged = 0;
+
+		for (unsigned int i = 0; i < noPairs; i++)
+		{
+			double latitude = -80.0 + 160.0 * rand() / RAND_MAX;
+			double longitude = -170.0 + 340.0 * rand() / RAND_MAX;
+			double otherLatitude = latitude
+					+ offsetDegree[c] * (rand() / (double) RAND_MAX - 0.5);
+			double otherLongitude = longitude
+					+ offsetDegree[c] * (rand() / (double) RAND_MAX - 0.5);
+
+			if (c == noClasses - 1)
+			// nearly opposite side of the earth
+			{
+				otherLatitude = -otherLatitude;
+				otherLongitude += (otherLongitude < 0) ? 180.0 : -180.0;
+			}
+
+			CWaypoint wp("a", latitude, longitude), other("b", otherLatitude,
+					otherLongitude);
+			double distance = wp.calculateDistance(other);
+
+			// reference from the stored coordinates
+			long double lat1 = wp.getLatitude() * preciseDegree, lat2 =
+					other.getLatitude() * preciseDegree;
+			long double deltaLon = (other.getLongitude() - wp.getLongitude())
+					* preciseDegree;
+			long double sinLat = sinl((lat2 - lat1) / 2), sinLon = sinl(
+					deltaLon / 2);
+			long double a = sinLat * sinLat
+					+ cosl(lat1) * cosl(lat2) * sinLon * sinLon;
+			double reference = (double) (CUnitVector::EARTH_RADIUS * 2
+					* atan2l(sqrtl(a), sqrtl(1 - a)));
+
+			// formula used before
+			double cosAngle = sin(wp.getLatitude() * oldDegree)
+					* sin(other.getLatitude() * oldDegree)
+					+ cos(wp.getLatitude() * oldDegree)
+							* cos(other.getLatitude() * oldDegree)
+							* cos((other.getLongitude() - wp.getLongitude())
+									* oldDegree);
+			double oldDistance = CUnitVector::EARTH_RADIUS
+					* acos(min(1.0, max(-1.0, cosAngle)));
+
+			double error = fabs(distance - reference) * 1000;
+			double oldError = fabs(oldDistance - reference) * 1000;
+
+			maxError = max(maxError, error);
+			maxOldError = max(maxOldError, oldError);
+			if (reference > 0)
+			{
+				maxRelative = max(maxRelative, error / (reference * 1000));
+				maxOldRelative = max(maxOldRelative,
+						oldError / (reference * 1000));
+			}
+
+			// geodesic on the ellipsoid
+			long double geodesic;
+			if (!calculateGeodesicDistance(wp.getLatitude(), wp.getLongitude(),
+					other.getLatitude(), other.getLongitude(), geodesic))
+			{
+				noNotConverged++;
+			}
+			else if (geodesic > 0)
+			{
+				double sphereError = fabs(distance - (double) geodesic) * 1000;
+				double oldSphereError = fabs(
+						distance * oldEarthRadius / CUnitVector::EARTH_RADIUS
+								- (double) geodesic) * 1000;
+
+				maxSphereError = max(maxSphereError, sphereError);
+				maxOldSphereError = max(maxOldSphereError, oldSphereError);
+				maxSphereRelative = max(maxSphereRelative,
+						sphereError / (double) (geodesic * 1000));
+				maxOldSphereRelative = max(maxOldSphereRelative,
+						oldSphereError / (double) (geodesic * 1000));
+			}
+		}
+
+		cout << classNames[c] << " : largest error calculateDistance() "
+				<< maxError << " m (relative " << maxRelative
+				<< "), formula before " << maxOldError << " m (relative "
+				<< maxOldRelative << ")" << endl;
+		cout << classNames[c] << " : largest error of the sphere against the WGS84 geodesic, radius "
+				<< CUnitVector::EARTH_RADIUS << " km " << maxSphereError
+				<< " m (relative " << maxSphereRelative << "), radius before "
+				<< oldEarthRadius << " km " << maxOldSphereError
+				<< " m (relative " << maxOldSphereRelative << ")";
+		if (noNotConverged > 0)
+			cout << ", geodesic not converged for " << noNotConverged
+					<< " pairs";
+		cout << endl;
+	}
+
+	// time of repeated distances between the same Waypoints
+	const unsigned int noWaypoints = 1000, noRepetitions = 10000;
+	vector<CWaypoint> waypoints;
+	for (unsigned int i = 0; i < noWaypoints; i++)
+		waypoints.push_back(
+				CWaypoint("wp", 47.5 + 7.0 * rand() / RAND_MAX,
+						6.0 + 9.0 * rand() / RAND_MAX));
+
+	double sum = 0.0, oldSum = 0.0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (unsigned int r = 0; r < noRepetitions; r++)
+	{
+		for (unsigned int i = 0; i < noWaypoints; i++)
+			sum += waypoints[i].calculateDistance(waypoints[(i + r + 1) % noWaypoints]);
+	}
+	double cachedMs = chrono::duration<double, milli>(
+			chrono::steady_clock::now() - start).count();
+
+	start = chrono::steady_clock::now();
+	for (unsigned int r = 0; r < noRepetitions; r++)
+	{
+		for (unsigned int i = 0; i < noWaypoints; i++)
+		{
+			const CWaypoint& wp = waypoints[i];
+			const CWaypoint& other = waypoints[(i + r + 1) % noWaypoints];
+			double cosAngle = sin(wp.getLatitude() * oldDegree)
+					* sin(other.getLatitude() * oldDegree)
+					+ cos(wp.getLatitude() * oldDegree)
+							* cos(other.getLatitude() * oldDegree)
+							* cos((other.getLongitude() - wp.getLongitude())
+									* oldDegree);
+			oldSum += CUnitVector::EARTH_RADIUS
+					* acos(min(1.0, max(-1.0, cosAngle)));
+		}
+	}
+	double oldMs = chrono::duration<double, milli>(
+			chrono::steady_clock::now() - start).count();
+
+	cout << noWaypoints * noRepetitions << " distances (WAYPOINT_UNIT_VECTOR = "
+			<< WAYPOINT_UNIT_VECTOR << ", sizeof(CWaypoint) = " << sizeof(CWaypoint)
+			<< ") : calculateDistance() " << cachedMs << " ms, formula before "
+			<< oldMs << " ms, sums " << sum << " km / " << oldSum << " km"
+			<< endl;
+}
+
 /**
  * Constructor for CNavigationSystem class
  * @param no parameters
@@ -96,7 +2497,31 @@ void CNavigationSystem::TC_readFromFile()
  */
 CNavigationSystem::CNavigationSystem()
 {
+	m_pPositionSensor = &m_GPSSensor;
+	m_pSensorProducer = NULL;
+}
+
+/**
+ * Destructor for CNavigationSystem class, stops the producer thread of the position sensor
+ * @param no parameters
+ * @reutrn no value
+ */
+CNavigationSystem::~CNavigationSystem()
+{
+	delete m_pSensorProducer;
+}
 
+/**
+ * Function connects the Navigation System to the sensor of the current position, by default the GPS Sensor.
+ * The producer thread of the previous sensor is stopped.
+ * @param CPositionSensor* pSensor : IN sensor, has to live longer than the Navigation System
+ * @returnvalue void
+ */
+void CNavigationSystem::connectToPositionSensor(CPositionSensor* pSensor)
+{
+	delete m_pSensorProducer;
+	m_pSensorProducer = NULL;
+	m_pPositionSensor = pSensor;
 }
 
 /**
@@ -137,6 +2562,260 @@ void CNavigationSystem::run()
 
 	TC_readFromFile();               // reads from File, mode could be Merge or Replace
 
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE ROUTE OPTIMISER
+	 * ==================================================
+	 */
+#if TESTCASE_ROUTE_OPTIMISATION == 1
+
+	TC_optimiseRoute();
+
+#endif
+
+#if TESTCASE_ROUTE_OPTIMISATION == 2
+
+	TC_optimiseRouteMultiStart();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE FOR THE SIMPLIFICATION OF A ROUTE
+	 * ==================================================
+	 */
+#if TESTCASE_ROUTE_SIMPLIFICATION == 1
+
+	TC_simplifyRoute();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE ROUTE MATCHING
+	 * ==================================================
+	 */
+#if TESTCASE_ROUTE_MATCHING == 1
+
+	TC_matchRoute();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE NMEA REPLAY
+	 * ==================================================
+	 */
+#if TESTCASE_NMEA_REPLAY == 1
+
+	TC_replayNmea();
+
+#endif
+
+#if TESTCASE_NMEA_REPLAY == 2
+
+	TC_sensorPipeline();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE TRAJECTORY GENERATOR
+	 * ==================================================
+	 */
+#if TESTCASE_TRAJECTORY_GENERATOR == 1
+
+	TC_generateTrajectories();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE KALMAN FILTER
+	 * ==================================================
+	 */
+#if TESTCASE_KALMAN_FILTER == 1
+
+	TC_filterFixes();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE SESSION MANAGER
+	 * ==================================================
+	 */
+#if TESTCASE_SESSION_ENGINE == 1
+
+	TC_sessionEngine();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE GEOFENCE INDEX
+	 * ==================================================
+	 */
+#if TESTCASE_GEOFENCING == 1
+
+	TC_geofencing();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE OFF ROUTE DETECTION
+	 * ==================================================
+	 */
+#if TESTCASE_OFF_ROUTE == 1
+
+	TC_detectOffRoute();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE ROAD GRAPH
+	 * ==================================================
+	 */
+#if TESTCASE_ROAD_GRAPH == 1
+
+	TC_roadGraph();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE PATH SEARCH ALGORITHMS
+	 * ==================================================
+	 */
+#if TESTCASE_PATH_SEARCH == 1
+
+	TC_pathSearch();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE CONTRACTION HIERARCHY
+	 * ==================================================
+	 */
+#if TESTCASE_CONTRACTION_HIERARCHY == 1
+
+	TC_contractionHierarchy();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE DISTANCE MATRIX
+	 * ==================================================
+	 */
+#if TESTCASE_DISTANCE_MATRIX == 1
+
+	TC_distanceMatrix();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE ALT LANDMARKS
+	 * ==================================================
+	 */
+#if TESTCASE_LANDMARKS == 1
+
+	TC_landmarks();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE REACHABLE POIS
+	 * ==================================================
+	 */
+#if TESTCASE_ISOCHRONE == 1
+
+	TC_isochrone();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE TYPE INDEX OF THE POIS
+	 * ==================================================
+	 */
+#if TESTCASE_POI_TYPE_INDEX == 1
+
+	TC_poiTypeIndex();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE POI CATEGORIES
+	 * ==================================================
+	 */
+#if TESTCASE_POI_CATEGORIES == 1
+
+	TC_poiCategories();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE STRING POOL
+	 * ==================================================
+	 */
+#if TESTCASE_STRING_POOL == 1
+
+	TC_stringPool();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR FIXED POINT COORDINATES
+	 * ==================================================
+	 */
+#if TESTCASE_COMPACT_COORDINATES == 1
+
+	TC_compactCoordinates();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE SLABS OF THE DATABASES
+	 * ==================================================
+	 */
+#if TESTCASE_DATABASE_ARENA == 1
+
+	TC_databaseArena();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE ROUTE TABLE
+	 * ==================================================
+	 */
+#if TESTCASE_ROUTE_TABLE == 1
+
+	TC_routeTable();
+
+#endif
+
+	/**
+	 * ==================================================
+	 *  TESTCASE (BENCHMARK) FOR THE PRECISION OF DISTANCES
+	 * ==================================================
+	 */
+#if TESTCASE_DISTANCE_PRECISION == 1
+
+	TC_distancePrecision();
+
 #endif
 
 	/**
@@ -643,7 +3322,8 @@ void CNavigationSystem::enterRoute()
 
 /**
  * Function detects current position of the user and prints the distance from
- * current position to the nearest POI in our route
+ * current position to the nearest POI in our route. The current position is the newest
+ * fix in the ring buffer of the position sensor; the first call starts the producer thread.
  * @param no parameters
  * @returnvalue void
  */
@@ -661,7 +3341,22 @@ void CNavigationSystem::printDistanceCurPosNextPoi()
 
 #endif
 
-	CWaypoint currentPosition = m_GPSSensor.getCurrentPosition(); // getting current position of user
+	if (m_pSensorProducer == NULL)
+	{
+		m_pSensorProducer = new CSensorProducer(*m_pPositionSensor);
+		m_pSensorProducer->start();
+	}
+
+	// newest fix of the ring buffer, waits for the first fix of the sensor
+	t_gpsFix fix;
+	bool hasFix;
+	while (!(hasFix = m_pSensorProducer->popLatestFix(fix))
+			&& !m_pSensorProducer->isFinished())
+		this_thread::yield();
+
+	CWaypoint currentPosition; // "default city" if the sensor delivered no position
+	if (hasFix)
+		currentPosition = CWaypoint("Current position", fix.latitude, fix.longitude);
 
 	CPOI poi;
 	double distance;
@@ -685,7 +3380,7 @@ void CNavigationSystem::printDistanceCurPosNextPoi()
 	else
 		// in case latitude/longitude entered is out of range
 		cout << endl
-				<< "GPS Sensor reporting invalid Latitude/Longitude,current position not found!";
+				<< "Position Sensor reporting invalid Latitude/Longitude,current position not found!";
 
 }
 
@@ -15,6 +15,8 @@
 #include "CRoute.h"
 #include "CPoiDatabase.h"
 #include "CWpDatabase.h"
+#include "CSensorProducer.h"
+#include "CContractionHierarchy.h"
 
 class CNavigationSystem
 {
@@ -27,6 +29,21 @@ public:
 	 */
 	CNavigationSystem();
 
+	/**
+	 * Destructor for CNavigationSystem class, stops the producer thread of the position sensor
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	~CNavigationSystem();
+
+	/**
+	 * Function connects the Navigation System to the sensor of the current position, by default the GPS Sensor.
+	 * The producer thread of the previous sensor is stopped.
+	 * @param CPositionSensor* pSensor : IN sensor, has to live longer than the Navigation System
+	 * @returnvalue void
+	 */
+	void connectToPositionSensor(CPositionSensor* pSensor);
+
 	/**
      * Function calls all the other private member functions of the Navigation System
 	 * @param no parameters
@@ -35,6 +52,23 @@ public:
 	void run();
 
 private:
+
+	/**
+	 * Copy constructor of class CNavigationSystem, not available : the position sensor may point to the
+	 * own GPS Sensor and the Route to the own Databases
+	 * @param const CNavigationSystem& other : IN Navigation System
+	 * @reutrn no value
+	 */
+	CNavigationSystem(const CNavigationSystem& other);
+
+	/**
+	 * Assignment operator of class CNavigationSystem, not available : the position sensor may point to the
+	 * own GPS Sensor and the Route to the own Databases
+	 * @param const CNavigationSystem& other : IN Navigation System
+	 * @returnvalue CNavigationSystem&
+	 */
+	CNavigationSystem& operator=(const CNavigationSystem& other);
+
 	/**
 	 * Function for adding Waypoints and POIs to our route
 	 * @param no parameters
@@ -77,6 +111,256 @@ private:
 	 */
 	void TC_readFromFile();
 
+	/**
+	 * Testcase (benchmark) for the Route optimiser on Routes with 50, 200 and 1000 randomly placed stops
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_optimiseRoute();
+
+	/**
+	 * Testcase (benchmark) for the parallel multi start Route optimiser on a Route with 500 stops.
+	 * Prints the number of restarts done within a fixed time budget for 1, 2, 4 and 8 threads
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_optimiseRouteMultiStart();
+
+	/**
+	 * Testcase for the simplification of a dense Route (20000 points with POIs) with a tolerance of 5 m
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_simplifyRoute();
+
+	/**
+	 * Testcase (benchmark) for projecting positions onto a Route with 5000 points, prints the time per position
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_matchRoute();
+
+	/**
+	 * Testcase (benchmark) for the navigation loop driven by a recorded NMEA file, prints the fixes per second
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_replayNmea();
+
+	/**
+	 * Testcase (benchmark) for the navigation loop consuming a NMEA replay through the ring buffer of the sensor producer.
+	 * Prints the fixes per second, the overruns and the latency histogram
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_sensorPipeline();
+
+	/**
+	 * Testcase (benchmark) for the trajectory generator with many vehicles along a Route and in a random walk.
+	 * Prints the fixes per second and checks that the same seed gives the same fixes
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_generateTrajectories();
+
+	/**
+	 * Testcase (benchmark) for the Kalman filter smoothing the fixes of 10000 vehicles.
+	 * Prints the filtered fixes per second and the error of the raw and the filtered positions
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_filterFixes();
+
+	/**
+	 * Testcase (benchmark) for the session manager with 5000 vehicles on Routes through shared Databases.
+	 * Prints the updates per second for 1, 2 and 4 threads
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_sessionEngine();
+
+	/**
+	 * Testcase (benchmark) for the geofence index with 100000 fences and 10000 vehicles at one fix per second.
+	 * Prints the fixes per second and the number of enter, exit and dwell events
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_geofencing();
+
+	/**
+	 * Testcase (benchmark) for the deviation detector with a detour from the test Route.
+	 * Prints the re-join points and the time per fix on and off the Route
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_detectOffRoute();
+
+	/**
+	 * Testcase (benchmark) for the road graph loaded from an edge list file and Dijkstra's shortest paths.
+	 * Prints a shortest Route and the time per query
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_roadGraph();
+
+	/**
+	 * Testcase (benchmark) comparing Dijkstra, A* and the bidirectional searches on the same random queries.
+	 * Prints the settled nodes and the latency percentiles
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_pathSearch();
+
+	/**
+	 * Testcase (benchmark) for the contraction hierarchy : build, save and load, one Route with unpacked shortcuts
+	 * and random queries compared with Dijkstra, then build and queries on a larger grid
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_contractionHierarchy();
+
+	/**
+	 * Testcase (benchmark) for the distance matrix from many vehicles to many POIs, great circle and cost function mode
+	 * compared with pairwise calculateDistance()
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_distanceMatrix();
+
+	/**
+	 * Testcase (benchmark) for ALT : landmarks selected by FARTHEST and AVOID, saved and mapped from a file,
+	 * settled nodes and latency compared with A* on the great circle distance
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_landmarks();
+
+	/**
+	 * Testcase (benchmark) for reachability queries : restaurants within 10 km network distance from random
+	 * positions, latency and a check of the results with Dijkstra
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_isochrone();
+
+	/**
+	 * Testcase (benchmark) for the type index of the POI Database : nearest gas station and gas stations
+	 * within a radius with the index compared with a scan of the whole Database
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_poiTypeIndex();
+
+	/**
+	 * Testcase (benchmark) for the POI category registry : registration by several threads, lookups of category
+	 * names and queries with a filter of several categories
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_poiCategories();
+
+	/**
+	 * Testcase (benchmark) for the string pool : memory of interned names and descriptions of many POIs
+	 * compared with std::string attributes
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_stringPool();
+
+	/**
+	 * Testcase (benchmark) for the fixed point coordinates : sizes, precision and a bounding box search
+	 * on the encoded coordinates
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_compactCoordinates();
+
+	/**
+	 * Testcase (benchmark) for the slabs of the Databases : time of loading and clearing compared with a
+	 * std::map with std::allocator
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_databaseArena();
+
+	/**
+	 * Testcase (benchmark) for the route table : nearest POI of a Route from the arrays of the table compared
+	 * with the loop over the view of the Route
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_routeTable();
+
+	/**
+	 * Testcase (benchmark) for the precision of calculateDistance() : numerical error against a long double
+	 * distance on the same sphere, error of the sphere against the geodesic on the WGS84 ellipsoid, and the
+	 * time of repeated distances
+	 * @param no parameters
+	 * @reutrn no value
+	 */
+	void TC_distancePrecision();
+
+	/**
+	 * Function computes the length of the geodesic between two positions on the WGS84 ellipsoid with the
+	 * inverse formula of Vincenty in long double (error below 1 mm), reference of TC_distancePrecision()
+	 * @param double latitude1        : IN latitude of the first position in degree
+	 * @param double longitude1       : IN longitude of the first position in degree
+	 * @param double latitude2        : IN latitude of the second position in degree
+	 * @param double longitude2       : IN longitude of the second position in degree
+	 * @param long double& distanceKm : OUT length of the geodesic
+	 * @returnvalue bool : false if the iteration does not converge (nearly antipodal positions)
+	 */
+	static bool calculateGeodesicDistance(double latitude1, double longitude1,
+			double latitude2, double longitude2, long double& distanceKm);
+
+	/**
+	 * Function creates a straight Route of about 130 km with 200 points, every 20th point is a POI
+	 * @param CWpDatabase& wpDatabase   : OUT database with the Waypoints of the Route
+	 * @param CPoiDatabase& poiDatabase : OUT database with the POIs of the Route
+	 * @param CRoute& route             : OUT Route connected to both databases
+	 * @returnvalue void
+	 */
+	void createTestRoute(CWpDatabase& wpDatabase, CPoiDatabase& poiDatabase,
+			CRoute& route);
+
+	/**
+	 * Function writes a NMEA recording along the test Route, one GGA sentence per second
+	 * @param const std::string& fileName : IN name of the file
+	 * @param unsigned int noFixes        : IN number of sentences
+	 * @returnvalue void
+	 */
+	void writeNmeaRecording(const std::string& fileName, unsigned int noFixes);
+
+	/**
+	 * Function creates a grid of Waypoints about 1 km apart and writes the roads between neighbours to an edge list file
+	 * @param CWpDatabase& wpDatabase     : OUT database with the Waypoints "grid<row>_<column>"
+	 * @param unsigned int size           : IN number of rows and columns
+	 * @param const std::string& fileName : IN name of the edge list file
+	 * @returnvalue void
+	 */
+	void writeGridEdgeList(CWpDatabase& wpDatabase, unsigned int size,
+			const std::string& fileName);
+
+	/**
+	 * Function runs random queries on a contraction hierarchy, prints their latency and compares their costs with Dijkstra
+	 * @param const CContractionHierarchy& hierarchy : IN hierarchy
+	 * @param const CRoadGraph& graph                : IN graph of the hierarchy
+	 * @param unsigned int noQueries                 : IN number of queries
+	 * @returnvalue void
+	 */
+	void runHierarchyQueries(const CContractionHierarchy& hierarchy,
+			const CRoadGraph& graph, unsigned int noQueries);
+
+	/**
+	 * Function of a thread of TC_poiCategories() : registers the categories "SHARED_<n>", each thread in another order
+	 * @param unsigned int thread                : IN number of the thread
+	 * @param unsigned int noNames               : IN number of categories
+	 * @param std::vector<t_poiCategory>* pIds   : OUT ID of each category
+	 * @returnvalue void
+	 */
+	static void registerSharedCategories(unsigned int thread,
+			unsigned int noNames, std::vector<t_poiCategory>* pIds);
+
 private:
 	/**
 	 * Function for printing our route
@@ -86,13 +370,28 @@ private:
 	void printRoute();
 
 	/*
-	 * Function for printing the distance from current position to the nearest POI in our route
+	 * Function for printing the distance from current position to the nearest POI in our route. The current position
+	 * is the newest fix in the ring buffer of the position sensor; the first call starts the producer thread.
 	 * @param no parameters
 	 * @returnvalue void
 	 */
 	void printDistanceCurPosNextPoi();
 
+	/**
+	 * Function runs the navigation loop : a producer thread reads the sensor, the loop takes the fixes from
+	 * the ring buffer, optionally smooths them, projects them onto the Route and calculates the distance to the next POI
+	 * @param CRoute& route                           : IN Route to be followed
+	 * @param CPositionSensor& sensor                 : IN source of the positions
+	 * @param CSensorProducer::t_overrunPolicy policy : IN behaviour if the navigation loop is behind the sensor
+	 * @param bool smoothFixes                        : IN fixes are smoothed by a Kalman filter before they are used
+	 * @returnvalue void
+	 */
+	void followRoute(CRoute& route, CPositionSensor& sensor,
+			CSensorProducer::t_overrunPolicy policy, bool smoothFixes = false);
+
 	CGPSSensor m_GPSSensor;
+	CPositionSensor* m_pPositionSensor;         // sensor of the current position, &m_GPSSensor by default
+	CSensorProducer* m_pSensorProducer;         // reads m_pPositionSensor in its own thread, NULL until the first position is needed
 	CRoute m_route;
 	CPoiDatabase m_PoiDatabase;
 	CWpDatabase m_WpDatabase;
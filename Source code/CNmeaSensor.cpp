@@ -0,0 +1,488 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CNMEASENSOR.CPP
+ * Author          : George Sebastian
+ * Description     : CNmeaSensor replays recorded GPS positions from a file or a pipe in
+ *                   NMEA 0183 format ($GPGGA and $GPRMC sentences, any talker ID).
+ *                   The input is read in large blocks and each sentence is parsed in place
+ *                   (no string per line or field), the checksum of each sentence is
+ *                   validated. Fixes are replayed as fast as possible or at the rate given
+ *                   by their recorded timestamps.
+ *                   Like CGPSSensor, getCurrentPosition() returns the next position, an
+ *                   invalid position ("default city") is returned at the end of the input.
+ ****************************************************************************/
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <math.h>
+#include <thread>
+using namespace std;
+
+#include "CNmeaSensor.h"
+
+#define READ_BLOCK_SIZE 65536         // input is read in blocks of this size
+#define SECONDS_PER_DAY 86400.0
+
+/**
+ * Function parses a field of digits with optional sign and decimal point
+ * @param const char* begin : IN first character of the field
+ * @param const char* end   : IN character behind the field
+ * @param double& value     : OUT value of the field
+ * @returnvalue true if the field is a valid number
+ */
+static bool parseNumber(const char* begin, const char* end, double& value)
+{
+	bool negative = false, digitFound = false;
+	double result = 0.0, scale = 0.0;
+
+	if (begin < end && *begin == '-')
+	{
+		negative = true;
+		begin++;
+	}
+
+	for (; begin < end; begin++)
+	{
+		if (*begin >= '0' && *begin <= '9')
+		{
+			digitFound = true;
+			if (scale == 0.0)
+				result = result * 10 + (*begin - '0');
+			else
+			// digits after the decimal point
+			{
+				result += (*begin - '0') * scale;
+				scale *= 0.1;
+			}
+		}
+		else if (*begin == '.' && scale == 0.0)
+			scale = 0.1;
+		else
+			return false;
+	}
+
+	value = negative ? -result : result;
+	return digitFound;
+}
+
+/**
+ * Function returns the next comma separated field of a sentence
+ * @param const char*& pos      : IN/OUT start of the field, moved behind the following comma
+ * @param const char* stop      : IN end of the fields (position of '*')
+ * @param const char*& fieldEnd : OUT character behind the field
+ * @returnvalue const char* : first character of the field
+ */
+static const char* nextField(const char*& pos, const char* stop,
+		const char*& fieldEnd)
+{
+	const char* fieldBegin = pos;
+
+	fieldEnd = pos;
+	while (fieldEnd < stop && *fieldEnd != ',')
+		fieldEnd++;
+
+	pos = (fieldEnd < stop) ? fieldEnd + 1 : stop;
+	return fieldBegin;
+}
+
+/**
+ * Function converts a NMEA coordinate field (ddmm.mmmm / dddmm.mmmm) and its hemisphere to degree
+ * @param const char* begin, end            : IN coordinate field
+ * @param const char* hemiBegin, hemiEnd    : IN hemisphere field (N/S or E/W)
+ * @param double& degree                    : OUT coordinate in degree, south/west negative
+ * @returnvalue true if both fields are valid
+ */
+static bool parseCoordinate(const char* begin, const char* end,
+		const char* hemiBegin, const char* hemiEnd, double& degree)
+{
+	double value;
+
+	if (!parseNumber(begin, end, value) || hemiEnd - hemiBegin != 1)
+		return false;
+
+	double wholeDegree = floor(value / 100);
+	degree = wholeDegree + (value - wholeDegree * 100) / 60;
+
+	if (*hemiBegin == 'S' || *hemiBegin == 'W')
+		degree = -degree;
+	else if (*hemiBegin != 'N' && *hemiBegin != 'E')
+		return false;
+
+	return true;
+}
+
+/**
+ * Function converts a NMEA time field (hhmmss.ss) to seconds since midnight
+ * @param const char* begin : IN first character of the field
+ * @param const char* end   : IN character behind the field
+ * @param double& seconds   : OUT seconds since midnight
+ * @returnvalue true if the field is valid
+ */
+static bool parseTime(const char* begin, const char* end, double& seconds)
+{
+	double value;
+
+	if (end - begin < 6 || !parseNumber(begin, end, value))
+		return false;
+
+	double hours = floor(value / 10000);
+	double minutes = floor((value - hours * 10000) / 100);
+	seconds = hours * 3600 + minutes * 60 + (value - hours * 10000 - minutes * 100);
+
+	return true;
+}
+
+/**
+ * Function returns the value of a hexadecimal digit
+ * @param char c : IN character
+ * @returnvalue int : value 0..15, -1 if c is no hexadecimal digit
+ */
+static int hexValue(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	return -1;
+}
+
+/**
+ * Constructor of class CNmeaSensor
+ * @param no parameters
+ * @return no value
+ */
+CNmeaSensor::CNmeaSensor()
+{
+	m_pInput = NULL;
+	m_bufferBegin = 0;
+	m_bufferEnd = 0;
+	m_endOfInput = true;
+	m_mode = AS_FAST_AS_POSSIBLE;
+	m_speedFactor = 1.0;
+	m_hasPreviousFix = false;
+	m_previousTimestamp = 0.0;
+	m_dayOffset = 0.0;
+	m_firstTimestamp = 0.0;
+	m_noSentences = 0;
+	m_noChecksumErrors = 0;
+}
+
+/**
+ * Function opens a file with NMEA sentences for replay. "-" replays from standard input (pipe).
+ * @param const std::string& fileName : IN name of the file
+ * @param t_replayMode mode           : IN replay as fast as possible or at the recorded rate
+ * @param double speedFactor          : IN in RECORDED_RATE mode, 2.0 replays twice as fast as recorded
+ * @returnvalue true if the file could be opened
+ */
+bool CNmeaSensor::open(const string& fileName, t_replayMode mode,
+		double speedFactor)
+{
+	if (m_file.is_open())
+		m_file.close();
+
+	if (fileName == "-")
+		m_pInput = &cin;
+	else
+	{
+		m_file.clear();
+		m_file.open(fileName.c_str(), ios::in | ios::binary);
+		m_pInput = &m_file;
+
+		if (!m_file.is_open())
+		{
+			cout << "ERROR : NMEA file " << fileName << " could not be opened"
+					<< endl;
+			m_endOfInput = true;
+			return false;
+		}
+	}
+
+	m_buffer.resize(READ_BLOCK_SIZE);
+	m_bufferBegin = 0;
+	m_bufferEnd = 0;
+	m_endOfInput = false;
+	m_mode = mode;
+	m_speedFactor = (speedFactor > 0.0) ? speedFactor : 1.0;
+	m_hasPreviousFix = false;
+	m_dayOffset = 0.0;
+	m_noSentences = 0;
+	m_noChecksumErrors = 0;
+
+	return true;
+}
+
+/**
+ * Function reads the next valid fix. Sentences with wrong checksum, without valid position
+ * or with the same timestamp as the previous fix (GGA and RMC of the same second) are skipped.
+ * In RECORDED_RATE mode the function waits until the fix is due.
+ * @param t_gpsFix& fix : OUT next fix
+ * @returnvalue true if a fix was read, false at the end of the input
+ */
+bool CNmeaSensor::getNextFix(t_gpsFix& fix)
+{
+	const char* begin;
+	const char* end;
+
+	while (nextLine(begin, end))
+	{
+		if (begin == end || *begin != '$')
+			// blank line or no NMEA sentence
+			continue;
+
+		m_noSentences++;
+
+		if (!parseSentence(begin, end, fix))
+			continue;
+
+		fix.timestamp += m_dayOffset;
+
+		if (m_hasPreviousFix
+				&& fix.timestamp < m_previousTimestamp - SECONDS_PER_DAY / 2)
+		// recording continues after midnight
+		{
+			m_dayOffset += SECONDS_PER_DAY;
+			fix.timestamp += SECONDS_PER_DAY;
+		}
+
+		if (m_hasPreviousFix && fix.timestamp == m_previousTimestamp)
+			// second sentence of the same epoch
+			continue;
+
+		waitForFix(fix.timestamp);
+
+		m_hasPreviousFix = true;
+		m_previousTimestamp = fix.timestamp;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Function to get the current position of the user, i.e. the next fix of the replay
+ * @param no parameters
+ * @returnvalue CWaypoint : current position, "default city" at the end of the input
+ */
+CWaypoint CNmeaSensor::getCurrentPosition()
+{
+	t_gpsFix fix;
+
+	if (getNextFix(fix))
+		return CWaypoint("Current position", fix.latitude, fix.longitude);
+	else
+		// end of the replay, invalid position
+		return CWaypoint();
+}
+
+/**
+ * Function parses a single NMEA sentence without copying it
+ * @param const char* begin : IN first character of the sentence ('$')
+ * @param const char* end   : IN character behind the sentence (without line end)
+ * @param t_gpsFix& fix     : OUT fix of the sentence
+ * @returnvalue true if the sentence is a GGA or RMC sentence with correct checksum and valid position
+ */
+bool CNmeaSensor::parseSentence(const char* begin, const char* end,
+		t_gpsFix& fix)
+{
+	// checksum : XOR of all characters between '$' and '*', followed by 2 hex digits
+	unsigned char checksum = 0;
+	const char* star = begin + 1;
+
+	while (star < end && *star != '*')
+		checksum ^= (unsigned char) *star++;
+
+	if (end - star < 3 || hexValue(star[1]) < 0 || hexValue(star[2]) < 0
+			|| hexValue(star[1]) * 16 + hexValue(star[2]) != checksum)
+	{
+		m_noChecksumErrors++;
+		return false;
+	}
+
+	if (star - begin < 7 || begin[6] != ',')
+		return false;
+
+	bool isGga = (memcmp(begin + 3, "GGA", 3) == 0);
+	bool isRmc = (memcmp(begin + 3, "RMC", 3) == 0);
+
+	if (!isGga && !isRmc)
+		// other sentences are not needed for the position
+		return false;
+
+	const char* pos = begin + 7;
+	const char *timeBegin, *timeEnd, *latBegin, *latEnd, *nsBegin, *nsEnd;
+	const char *lonBegin, *lonEnd, *ewBegin, *ewEnd;
+	const char *statusBegin = star, *statusEnd = star;
+
+	timeBegin = nextField(pos, star, timeEnd);
+
+	if (isRmc)
+		// RMC : time, status, latitude, N/S, longitude, E/W
+		statusBegin = nextField(pos, star, statusEnd);
+
+	latBegin = nextField(pos, star, latEnd);
+	nsBegin = nextField(pos, star, nsEnd);
+	lonBegin = nextField(pos, star, lonEnd);
+	ewBegin = nextField(pos, star, ewEnd);
+
+	if (isGga)
+		// GGA : time, latitude, N/S, longitude, E/W, fix quality
+		statusBegin = nextField(pos, star, statusEnd);
+
+	if (statusEnd - statusBegin != 1
+			|| (isRmc && *statusBegin != 'A') // RMC : A = valid, V = warning
+			|| (isGga && *statusBegin == '0')) // GGA : 0 = no fix
+		return false;
+
+	return parseTime(timeBegin, timeEnd, fix.timestamp)
+			&& parseCoordinate(latBegin, latEnd, nsBegin, nsEnd, fix.latitude)
+			&& parseCoordinate(lonBegin, lonEnd, ewBegin, ewEnd, fix.longitude)
+			&& fix.latitude >= -90 && fix.latitude <= 90
+			&& fix.longitude >= -180 && fix.longitude <= 180;
+}
+
+/**
+ * Function creates a GGA sentence with checksum for a fix, e.g. for recording positions
+ * @param const t_gpsFix& fix : IN fix
+ * @returnvalue std::string : sentence without line end
+ */
+string CNmeaSensor::createGgaSentence(const t_gpsFix& fix)
+{
+	char sentence[128];
+	double timeOfDay = fmod(fix.timestamp, SECONDS_PER_DAY);
+	int hours = (int) (timeOfDay / 3600);
+	int minutes = (int) ((timeOfDay - hours * 3600) / 60);
+	double seconds = timeOfDay - hours * 3600 - minutes * 60;
+
+	double latitude = fabs(fix.latitude), longitude = fabs(fix.longitude);
+	double latDegree = floor(latitude), lonDegree = floor(longitude);
+
+	int length = snprintf(sentence, sizeof(sentence),
+			"$GPGGA,%02d%02d%05.2f,%02d%08.5f,%c,%03d%08.5f,%c,1,08,1.0,0.0,M,0.0,M,,",
+			hours, minutes, seconds, (int) latDegree,
+			(latitude - latDegree) * 60, (fix.latitude < 0) ? 'S' : 'N',
+			(int) lonDegree, (longitude - lonDegree) * 60,
+			(fix.longitude < 0) ? 'W' : 'E');
+
+	unsigned char checksum = 0;
+	for (int i = 1; i < length; i++)
+		checksum ^= (unsigned char) sentence[i];
+
+	snprintf(sentence + length, sizeof(sentence) - length, "*%02X", checksum);
+	return sentence;
+}
+
+/**
+ * Function returns the number of sentences read so far
+ * @param no parameters
+ * @returnvalue unsigned long : number of sentences
+ */
+unsigned long CNmeaSensor::getNoSentences() const
+{
+	return m_noSentences;
+}
+
+/**
+ * Function returns the number of sentences with wrong or missing checksum
+ * @param no parameters
+ * @returnvalue unsigned long : number of checksum errors
+ */
+unsigned long CNmeaSensor::getNoChecksumErrors() const
+{
+	return m_noChecksumErrors;
+}
+
+/**
+ * Function returns the next line of the input, pointing into the read buffer
+ * @param const char*& begin : OUT first character of the line
+ * @param const char*& end   : OUT character behind the line (without line end)
+ * @returnvalue true if a line was found, false at the end of the input
+ */
+bool CNmeaSensor::nextLine(const char*& begin, const char*& end)
+{
+	while (true)
+	{
+		char* data = &m_buffer[0];
+		char* lineEnd = (char*) memchr(data + m_bufferBegin, '\n',
+				m_bufferEnd - m_bufferBegin);
+
+		if (lineEnd != NULL || (m_endOfInput && m_bufferBegin < m_bufferEnd))
+		// complete line in the buffer, or last line without line end
+		{
+			if (lineEnd == NULL)
+				lineEnd = data + m_bufferEnd;
+
+			begin = data + m_bufferBegin;
+			end = lineEnd;
+			m_bufferBegin = (lineEnd - data) + 1;
+			if (m_bufferBegin > m_bufferEnd)
+				m_bufferBegin = m_bufferEnd;
+
+			if (end > begin && *(end - 1) == '\r')
+				// DOS line end
+				end--;
+			return true;
+		}
+
+		if (m_endOfInput || m_pInput == NULL)
+			return false;
+
+		// moving the incomplete line to the front of the buffer and reading the next block behind it
+		memmove(data, data + m_bufferBegin, m_bufferEnd - m_bufferBegin);
+		m_bufferEnd -= m_bufferBegin;
+		m_bufferBegin = 0;
+
+		if (m_bufferEnd == m_buffer.size())
+			// line longer than the buffer
+			m_buffer.resize(m_buffer.size() * 2);
+
+		data = &m_buffer[0];
+
+		// readsome() returns what is available without blocking (pipes), get() waits for at least one character
+		streamsize noRead = m_pInput->readsome(data + m_bufferEnd,
+				m_buffer.size() - m_bufferEnd);
+
+		if (noRead <= 0)
+		{
+			int c = m_pInput->get();
+
+			if (c == EOF)
+				m_endOfInput = true;
+			else
+			{
+				data[m_bufferEnd++] = (char) c;
+				noRead = m_pInput->readsome(data + m_bufferEnd,
+						m_buffer.size() - m_bufferEnd);
+			}
+		}
+
+		if (noRead > 0)
+			m_bufferEnd += noRead;
+	}
+}
+
+/**
+ * Function waits until a fix with the given timestamp is due in RECORDED_RATE mode
+ * @param double timestamp : IN recorded timestamp of the fix
+ * @returnvalue void
+ */
+void CNmeaSensor::waitForFix(double timestamp)
+{
+	if (m_mode != RECORDED_RATE)
+		return;
+
+	if (!m_hasPreviousFix)
+	// first fix of the replay is due immediately
+	{
+		m_firstTimestamp = timestamp;
+		m_replayStart = chrono::steady_clock::now();
+		return;
+	}
+
+	chrono::steady_clock::time_point due = m_replayStart
+			+ chrono::microseconds(
+					(long long) ((timestamp - m_firstTimestamp) / m_speedFactor
+							* 1e6));
+	this_thread::sleep_until(due);
+}
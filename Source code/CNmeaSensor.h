@@ -0,0 +1,140 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CNMEASENSOR.H
+ * Author          : George Sebastian
+ * Description     : CNmeaSensor replays recorded GPS positions from a file or a pipe in
+ *                   NMEA 0183 format ($GPGGA and $GPRMC sentences, any talker ID).
+ *                   The input is read in large blocks and each sentence is parsed in place
+ *                   (no string per line or field), the checksum of each sentence is
+ *                   validated. Fixes are replayed as fast as possible or at the rate given
+ *                   by their recorded timestamps.
+ *                   Like CGPSSensor, getCurrentPosition() returns the next position, an
+ *                   invalid position ("default city") is returned at the end of the input.
+ ****************************************************************************/
+#ifndef CNMEASENSOR_H
+#define CNMEASENSOR_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+
+#include "CWaypoint.h"
+#include "CPositionSensor.h"
+
+class CNmeaSensor: public CPositionSensor
+{
+public:
+
+	/*
+	 * replay rate of the fixes
+	 */
+	enum t_replayMode
+	{
+		AS_FAST_AS_POSSIBLE, RECORDED_RATE
+	};
+
+	/**
+	 * Constructor of class CNmeaSensor
+	 * @param no parameters
+	 * @return no value
+	 */
+	CNmeaSensor();
+
+	/**
+	 * Function opens a file with NMEA sentences for replay. "-" replays from standard input (pipe).
+	 * @param const std::string& fileName : IN name of the file
+	 * @param t_replayMode mode           : IN replay as fast as possible or at the recorded rate
+	 * @param double speedFactor          : IN in RECORDED_RATE mode, 2.0 replays twice as fast as recorded
+	 * @returnvalue true if the file could be opened
+	 */
+	bool open(const std::string& fileName, t_replayMode mode =
+			AS_FAST_AS_POSSIBLE, double speedFactor = 1.0);
+
+	/**
+	 * Function reads the next valid fix. Sentences with wrong checksum, without valid position
+	 * or with the same timestamp as the previous fix (GGA and RMC of the same second) are skipped.
+	 * In RECORDED_RATE mode the function waits until the fix is due.
+	 * @param t_gpsFix& fix : OUT next fix
+	 * @returnvalue true if a fix was read, false at the end of the input
+	 */
+	virtual bool getNextFix(t_gpsFix& fix);
+
+	/**
+	 * Function to get the current position of the user, i.e. the next fix of the replay
+	 * @param no parameters
+	 * @returnvalue CWaypoint : current position, "default city" at the end of the input
+	 */
+	virtual CWaypoint getCurrentPosition();
+
+	/**
+	 * Function parses a single NMEA sentence without copying it
+	 * @param const char* begin : IN first character of the sentence ('$')
+	 * @param const char* end   : IN character behind the sentence (without line end)
+	 * @param t_gpsFix& fix     : OUT fix of the sentence
+	 * @returnvalue true if the sentence is a GGA or RMC sentence with correct checksum and valid position
+	 */
+	bool parseSentence(const char* begin, const char* end, t_gpsFix& fix);
+
+	/**
+	 * Function creates a GGA sentence with checksum for a fix, e.g. for recording positions
+	 * @param const t_gpsFix& fix : IN fix
+	 * @returnvalue std::string : sentence without line end
+	 */
+	static std::string createGgaSentence(const t_gpsFix& fix);
+
+	/**
+	 * Function returns the number of sentences read so far
+	 * @param no parameters
+	 * @returnvalue unsigned long : number of sentences
+	 */
+	unsigned long getNoSentences() const;
+
+	/**
+	 * Function returns the number of sentences with wrong or missing checksum
+	 * @param no parameters
+	 * @returnvalue unsigned long : number of checksum errors
+	 */
+	unsigned long getNoChecksumErrors() const;
+
+private:
+
+	/**
+	 * Function returns the next line of the input, pointing into the read buffer
+	 * @param const char*& begin : OUT first character of the line
+	 * @param const char*& end   : OUT character behind the line (without line end)
+	 * @returnvalue true if a line was found, false at the end of the input
+	 */
+	bool nextLine(const char*& begin, const char*& end);
+
+	/**
+	 * Function waits until a fix with the given timestamp is due in RECORDED_RATE mode
+	 * @param double timestamp : IN recorded timestamp of the fix
+	 * @returnvalue void
+	 */
+	void waitForFix(double timestamp);
+
+	std::ifstream m_file;
+	std::istream* m_pInput;
+	std::vector<char> m_buffer;
+	unsigned int m_bufferBegin;     // first unprocessed character in m_buffer
+	unsigned int m_bufferEnd;       // end of valid data in m_buffer
+	bool m_endOfInput;
+
+	t_replayMode m_mode;
+	double m_speedFactor;
+	bool m_hasPreviousFix;
+	double m_previousTimestamp;
+	double m_dayOffset;            // added to the timestamps after midnight rollovers
+	double m_firstTimestamp;
+	std::chrono::steady_clock::time_point m_replayStart;
+
+	unsigned long m_noSentences;
+	unsigned long m_noChecksumErrors;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CNMEASENSOR_H */
@@ -11,24 +11,18 @@
 using namespace std;
 
 #include "CPOI.h"
+#include "CStringPool.h"
 
 #define DEGREE 1 // printing longitude and latitude in Degree format
 #define MMSS 2   // printing longitude and latitude in Minutes,seconds format
 
-/**
- * Function takes poi type from user and converts it to string for the ease of printing
- * @param CPOI::t_poi type : IN type of the POI
- * @returnvalue string type of poi
- */
-string getPoiType(CPOI::t_poi type);
-
 /**
  * Function returns type of Poi in string form
  * @returnvalue string type of poi
  */
 string CPOI::getType()const
 {
-	return getPoiType(m_type);
+	return CPoiCategoryRegistry::getName(m_type);
 }
 
 /**
@@ -37,7 +31,7 @@ string CPOI::getType()const
  */
 string CPOI::getPoiDescription()const
 {
-	return m_description;
+	return CStringPool::getString(m_descriptionId);
 }
 
 /**
@@ -56,7 +50,8 @@ void CPOI::getAllDataByReference(string& name, double & latitude,
 	latitude = getLatitude();
 	longitude = getLongitude();
 	type = m_type;
-	description = m_description;
+	description.assign(CStringPool::get(m_descriptionId),
+			CStringPool::getLength(m_descriptionId));
 }
 
 /**
@@ -64,15 +59,15 @@ void CPOI::getAllDataByReference(string& name, double & latitude,
  * @param no parameters
  * @returnvalue void
  */
-void CPOI::print(int format)
+void CPOI::print(int format) const
 {
 	if (format == DEGREE)
 	{
 
-	string type=getPoiType(m_type);
+	string type=CPoiCategoryRegistry::getName(m_type);
 
 	cout << endl << "Point of Interest " << endl << "=================" << endl
-			<< "of type " << type << " : " <<m_description << endl;
+			<< "of type " << type << " : " <<CStringPool::get(m_descriptionId) << endl;
 
 	CWaypoint::print(DEGREE);
 
@@ -92,10 +87,10 @@ ostream& operator<<(ostream& out, const CPOI& poi)  // friend function & transfo
 {
 	CPOI lpoi=poi;
 
-	string type=getPoiType(lpoi.m_type);
+	string type=CPoiCategoryRegistry::getName(lpoi.m_type);
 
 	out << "Point of Interest " << endl << "=================" << endl
-			<< "of type " << type << " : " <<lpoi.m_description << endl;
+			<< "of type " << type << " : " <<CStringPool::get(lpoi.m_descriptionId) << endl;
 
 	int degLongitude = 0, mmLongitude = 0, degLatitude = 0, mmLatitude = 0;
 	double ssLongitude = 0.0,ssLatitude = 0.0;
@@ -124,32 +119,48 @@ return out;
  * @param string description : IN description about the POI
  * @param double latitude    : IN latitude of the POI
  * @param double longitude   : IN longitude of the POI
+ * @param CStringPool* pPool : IN pool of the name and the description, NULL : shared pool
  * @returnvalue void
  */
 void CPOI::set(t_poi type, string name, string description, double latitude,
-		double longitude)
+		double longitude, CStringPool* pPool)
 {
+	CStringPool& pool = (pPool != NULL) ? *pPool : CStringPool::getSharedPool();
+
 	// checking the validity of parameter values and writing the correct values to the attributes.
 	if (latitude >= -90 && latitude <= 90 && longitude >= -180
 			&& longitude <= 180)
 	{
-		m_name = name;
-		m_latitude = latitude;
-		m_longitude = longitude;
+		m_nameId = pool.add(name);
+		setPosition(latitude, longitude);
 		m_type = type;
-		m_description = description;
+		m_descriptionId = pool.add(description);
 	}
 	//In case of invalid parameter values, writing '0' to the attributes
 	else
 	{
-		m_latitude = 0;
-		m_longitude = 0;
-		m_name = "default city";
+		setPosition(0, 0);
+		m_nameId = pool.add("default city");
 		m_type = RESTAURANT;
-		m_description = "default description";
+		m_descriptionId = pool.add("default description");
 	}
 }
 
+/**
+ * Function moves the name and the description into a pool, strings already in the pool are not copied
+ * Overrides the inherited function
+ * @param CStringPool& pool : IN pool, e.g. the one of the Database the POI is added to
+ * @returnvalue void
+ */
+void CPOI::internStrings(CStringPool& pool)
+{
+	CWaypoint::internStrings(pool);
+
+	if (!pool.owns(m_descriptionId))
+		m_descriptionId = pool.add(CStringPool::get(m_descriptionId),
+				CStringPool::getLength(m_descriptionId));
+}
+
 /**
  * Default constructor of Class CPOI
  * @param t_poi type         : IN type of the POI
@@ -157,34 +168,14 @@ void CPOI::set(t_poi type, string name, string description, double latitude,
  * @param string description : IN description about the POI
  * @param double latitude    : IN latitude of the POI
  * @param double longitude   : IN longitude of the POI
+ * @param CStringPool* pPool : IN pool of the name and the description, NULL : shared pool
  * @return no value
  */
 CPOI::CPOI(t_poi type, string name, string description, double latitude,
-		double longitude) :
-		CWaypoint(name, latitude, longitude), m_type(type), m_description(
-				description)
+		double longitude, CStringPool* pPool) :
+		CWaypoint(name, latitude, longitude, pPool), m_type(type), m_descriptionId(
+				((pPool != NULL) ? *pPool : CStringPool::getSharedPool()).add(
+						description))
 {
 
 }
-
-/**
- * Function takes poi type from user and converts it to string for the ease of printing
- * @param CPOI::t_poi type : IN type of the POI
- * @returnvalue string type of poi
- */
-string getPoiType(CPOI::t_poi type)
-{
-	switch(type)
-	{
-	case CPOI::RESTAURANT : return "RESTAURANT";
-	break;
-	case CPOI::TOURISTIC : return "TOURISTIC";
-	break;
-	case CPOI::GASSTATION : return"GASSTATION";
-	break;
-	case CPOI::UNIVERSITY : return"UNIVERSITY";
-	break;
-	default : return "default type";
-	}
-
-}
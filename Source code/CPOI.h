@@ -5,11 +5,14 @@
  * Author          : George Sebastian
  * Description     : CPOI class stores a POI and provides some simple operations
  *                   for POI
+ *                   The description is stored as ID of CStringPool like the name, equal
+ *                   descriptions share one copy. Both are in the same pool.
  ****************************************************************************/
 #ifndef CPOI_H
 #define CPOI_H
 
 #include "CWaypoint.h"
+#include "CPoiCategoryRegistry.h"
 
 class CPOI: public CWaypoint
 {
@@ -17,12 +20,17 @@ class CPOI: public CWaypoint
 public:
 
 	/*
-	 * enum for different types of POI
+	 * type of POI : ID of a category of CPoiCategoryRegistry
 	 */
-	typedef enum poi
+	typedef t_poiCategory t_poi;
+
+	/*
+	 * IDs of the built-in categories, further categories are registered in CPoiCategoryRegistry
+	 */
+	enum
 	{
 		RESTAURANT, TOURISTIC, GASSTATION, UNIVERSITY
-	} t_poi;
+	};
 
 	/**
 	 * Friend function to CPOI class
@@ -40,18 +48,19 @@ public:
 	 * @param string description : IN description about the POI
 	 * @param double latitude    : IN latitude of the POI
 	 * @param double longitude   : IN longitude of the POI
+	 * @param CStringPool* pPool : IN pool of the name and the description, NULL : shared pool
 	 * @return no value
 	 */
 	CPOI(t_poi type = RESTAURANT, std::string name = "default city",
 			std::string description = "default description", double latitude = 0.0,
-			double longitude = 0.0);
+			double longitude = 0.0, CStringPool* pPool = NULL);
 
 	/**
 	 * Function prints the latitude and longitude of POI in deg mm ss format along with the type and description of POI
 	 * @param no parameters
 	 * @returnvalue void
 	 */
-	void print(int format);
+	void print(int format) const;
 
 	/**
 	 * Function to get the values of all the attributes by reference
@@ -74,10 +83,19 @@ public:
 	 * @param string description : IN description about the POI
 	 * @param double latitude    : IN latitude of the POI
 	 * @param double longitude   : IN longitude of the POI
+	 * @param CStringPool* pPool : IN pool of the name and the description, NULL : shared pool
 	 * @returnvalue void
 	 */
 	void set(t_poi type, std::string name, std::string description, double latitude,
-			double longitude);
+			double longitude, CStringPool* pPool = NULL);
+
+	/**
+	 * Function moves the name and the description into a pool, strings already in the pool are not copied
+	 * Overrides the inherited function
+	 * @param CStringPool& pool : IN pool, e.g. the one of the Database the POI is added to
+	 * @returnvalue void
+	 */
+	void internStrings(CStringPool& pool);
 
 	/**
 	 * Function returns type of Poi in string form
@@ -94,7 +112,7 @@ public:
 private:
 
 	t_poi m_type;
-	std::string m_description;
+	uint32_t m_descriptionId;           // description in CStringPool
 };
 /********************
  **  CLASS END
@@ -0,0 +1,102 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CPOICATEGORYFILTER.CPP
+ * Author          : George Sebastian
+ * Description     : CPoiCategoryFilter is a bitset of POI categories. The categories are
+ *                   listed by shifting each word until no set bit is left, empty words
+ *                   cost one compare.
+ ****************************************************************************/
+#include <algorithm>
+using namespace std;
+
+#include "CPoiCategoryFilter.h"
+
+/**
+ * Constructor of class CPoiCategoryFilter, the filter is empty
+ * @param no parameters
+ * @return no value
+ */
+CPoiCategoryFilter::CPoiCategoryFilter()
+{
+}
+
+/**
+ * Constructor of class CPoiCategoryFilter, the filter contains one category
+ * @param t_poiCategory category : IN category
+ * @return no value
+ */
+CPoiCategoryFilter::CPoiCategoryFilter(t_poiCategory category)
+{
+	add(category);
+}
+
+/**
+ * Function adds a category to the filter
+ * @param t_poiCategory category : IN category
+ * @returnvalue void
+ */
+void CPoiCategoryFilter::add(t_poiCategory category)
+{
+	unsigned int word = category >> 6;
+
+	if (word >= m_bits.size())
+		m_bits.resize(word + 1, 0);
+
+	m_bits[word] |= (uint64_t) 1 << (category & 63);
+}
+
+/**
+ * Function removes a category from the filter
+ * @param t_poiCategory category : IN category
+ * @returnvalue void
+ */
+void CPoiCategoryFilter::remove(t_poiCategory category)
+{
+	unsigned int word = category >> 6;
+
+	if (word < m_bits.size())
+		m_bits[word] &= ~((uint64_t) 1 << (category & 63));
+}
+
+/**
+ * Function adds all categories registered so far
+ * @param no parameters
+ * @returnvalue void
+ */
+void CPoiCategoryFilter::addAll()
+{
+	unsigned int noCategories = CPoiCategoryRegistry::getNoCategories();
+
+	for (unsigned int category = 0; category < noCategories; category++)
+		add(category);
+}
+
+/**
+ * Function removes all categories, the words of the bitset are kept for reuse
+ * @param no parameters
+ * @returnvalue void
+ */
+void CPoiCategoryFilter::clear()
+{
+	fill(m_bits.begin(), m_bits.end(), 0);
+}
+
+/**
+ * Function returns the categories of the filter
+ * @param std::vector<t_poiCategory>& categories : OUT categories in ascending order
+ * @returnvalue void
+ */
+void CPoiCategoryFilter::getCategories(vector<t_poiCategory>& categories) const
+{
+	categories.clear();
+
+	for (unsigned int word = 0; word < m_bits.size(); word++)
+	{
+		unsigned int bit = 0;
+
+		for (uint64_t bits = m_bits[word]; bits != 0; bits >>= 1, bit++)
+			if ((bits & 1) != 0)
+				categories.push_back(word * 64 + bit);
+	}
+}
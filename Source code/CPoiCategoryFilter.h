@@ -0,0 +1,90 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CPOICATEGORYFILTER.H
+ * Author          : George Sebastian
+ * Description     : CPoiCategoryFilter is a set of POI categories for queries ("restaurants
+ *                   or gas stations"), stored as bitset : bit id % 64 of word id / 64 is
+ *                   set for each category of the filter. The test of a category is a shift
+ *                   and a mask, independent of the number of categories in the filter.
+ ****************************************************************************/
+#ifndef CPOICATEGORYFILTER_H
+#define CPOICATEGORYFILTER_H
+
+#include <vector>
+#include <stdint.h>
+
+#include "CPoiCategoryRegistry.h"
+
+class CPoiCategoryFilter
+{
+public:
+
+	/**
+	 * Constructor of class CPoiCategoryFilter, the filter is empty
+	 * @param no parameters
+	 * @return no value
+	 */
+	CPoiCategoryFilter();
+
+	/**
+	 * Constructor of class CPoiCategoryFilter, the filter contains one category
+	 * @param t_poiCategory category : IN category
+	 * @return no value
+	 */
+	CPoiCategoryFilter(t_poiCategory category);
+
+	/**
+	 * Function adds a category to the filter
+	 * @param t_poiCategory category : IN category
+	 * @returnvalue void
+	 */
+	void add(t_poiCategory category);
+
+	/**
+	 * Function removes a category from the filter
+	 * @param t_poiCategory category : IN category
+	 * @returnvalue void
+	 */
+	void remove(t_poiCategory category);
+
+	/**
+	 * Function adds all categories registered so far
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void addAll();
+
+	/**
+	 * Function removes all categories, the words of the bitset are kept for reuse
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void clear();
+
+	/**
+	 * Function tests if a category is in the filter
+	 * @param t_poiCategory category : IN category
+	 * @returnvalue true if the category is in the filter
+	 */
+	bool contains(t_poiCategory category) const
+	{
+		unsigned int word = category >> 6;
+		return word < m_bits.size() && ((m_bits[word] >> (category & 63)) & 1) != 0;
+	}
+
+	/**
+	 * Function returns the categories of the filter
+	 * @param std::vector<t_poiCategory>& categories : OUT categories in ascending order
+	 * @returnvalue void
+	 */
+	void getCategories(std::vector<t_poiCategory>& categories) const;
+
+private:
+
+	std::vector<uint64_t> m_bits;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CPOICATEGORYFILTER_H */
@@ -0,0 +1,217 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CPOICATEGORYREGISTRY.CPP
+ * Author          : George Sebastian
+ * Description     : CPoiCategoryRegistry maps category names to dense 16 bit IDs. The hash
+ *                   table has a power of 2 slots and is kept at most half full, linear
+ *                   probing finds a name after very few slots.
+ ****************************************************************************/
+#include <ctype.h>
+using namespace std;
+
+#include "CPoiCategoryRegistry.h"
+
+#define MIN_SLOTS 64                 // slots of the hash table for the built-in categories
+
+/**
+ * Function registers a category, a known category keeps its ID
+ * @param const std::string& name : IN name of the category, e.g. "PHARMACY"
+ * @returnvalue t_poiCategory : ID of the category, POI_CATEGORY_INVALID if all IDs are used
+ */
+t_poiCategory CPoiCategoryRegistry::registerCategory(const string& name)
+{
+	if (!isValidName(name))
+		return POI_CATEGORY_INVALID;
+
+	CPoiCategoryRegistry& registry = instance();
+	lock_guard<mutex> lock(registry.m_mutex);
+	uint32_t nameHash = hash(name);
+	unsigned int slot = registry.findSlot(name, nameHash);
+
+	if (registry.m_slots[slot] != 0)
+		// already registered
+		return registry.m_slots[slot] - 1;
+
+	if (registry.m_names.size() >= POI_CATEGORY_INVALID)
+		return POI_CATEGORY_INVALID;
+
+	t_poiCategory id = registry.m_names.size();
+	registry.m_names.push_back(name);
+	registry.m_hashes.push_back(nameHash);
+	registry.m_slots[slot] = id + 1;
+
+	if (2 * registry.m_names.size() > registry.m_slots.size())
+		registry.rehash(2 * registry.m_slots.size());
+
+	return id;
+}
+
+/**
+ * Function checks if a name can be the name of a category
+ * @param const std::string& name : IN name
+ * @returnvalue true if the name is not empty and has only letters, digits, '_' and blanks
+ */
+bool CPoiCategoryRegistry::isValidName(const string& name)
+{
+	if (name.empty())
+		return false;
+
+	for (unsigned int i = 0; i < name.size(); i++)
+	{
+		unsigned char character = name[i];
+		if (!isalnum(character) && character != '_' && character != ' ')
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Function returns the ID of a category
+ * @param const std::string& name : IN name of the category
+ * @param t_poiCategory& id       : OUT ID of the category
+ * @returnvalue true if the category is registered
+ */
+bool CPoiCategoryRegistry::getId(const string& name, t_poiCategory& id)
+{
+	CPoiCategoryRegistry& registry = instance();
+	lock_guard<mutex> lock(registry.m_mutex);
+	uint32_t slotValue = registry.m_slots[registry.findSlot(name, hash(name))];
+
+	if (slotValue == 0)
+		return false;
+
+	id = slotValue - 1;
+	return true;
+}
+
+/**
+ * Function checks if a category is registered
+ * @param const std::string& name : IN name of the category
+ * @returnvalue true if the category is registered
+ */
+bool CPoiCategoryRegistry::isKnown(const string& name)
+{
+	t_poiCategory id;
+	return getId(name, id);
+}
+
+/**
+ * Function returns the name of a category
+ * @param t_poiCategory id : IN ID of the category
+ * @returnvalue const std::string& : name of the category, "default type" for an unknown ID
+ */
+const string& CPoiCategoryRegistry::getName(t_poiCategory id)
+{
+	static const string unknown = "default type";
+	CPoiCategoryRegistry& registry = instance();
+	lock_guard<mutex> lock(registry.m_mutex);
+
+	return (id < registry.m_names.size()) ? registry.m_names[id] : unknown;
+}
+
+/**
+ * Function returns the number of registered categories, the IDs are 0 .. number - 1
+ * @param no parameters
+ * @returnvalue unsigned int : number of categories
+ */
+unsigned int CPoiCategoryRegistry::getNoCategories()
+{
+	CPoiCategoryRegistry& registry = instance();
+	lock_guard<mutex> lock(registry.m_mutex);
+
+	return registry.m_names.size();
+}
+
+/**
+ * Constructor of class CPoiCategoryRegistry, registers the built-in categories
+ * @param no parameters
+ * @return no value
+ */
+CPoiCategoryRegistry::CPoiCategoryRegistry()
+{
+	m_slots.assign(MIN_SLOTS, 0);
+
+	// same order as the constants of CPOI
+	const char* builtIn[] =
+	{ "RESTAURANT", "TOURISTIC", "GASSTATION", "UNIVERSITY" };
+
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		string name = builtIn[i];
+		uint32_t nameHash = hash(name);
+
+		m_slots[findSlot(name, nameHash)] = m_names.size() + 1;
+		m_names.push_back(name);
+		m_hashes.push_back(nameHash);
+	}
+}
+
+/**
+ * Function returns the registry of the program, created on the first use
+ * @param no parameters
+ * @returnvalue CPoiCategoryRegistry& : registry
+ */
+CPoiCategoryRegistry& CPoiCategoryRegistry::instance()
+{
+	static CPoiCategoryRegistry registry;
+	return registry;
+}
+
+/**
+ * Function returns the FNV-1a hash of a name
+ * @param const std::string& name : IN name of a category
+ * @returnvalue uint32_t : hash
+ */
+uint32_t CPoiCategoryRegistry::hash(const string& name)
+{
+	uint32_t nameHash = 2166136261u;
+
+	for (unsigned int i = 0; i < name.size(); i++)
+	{
+		nameHash ^= (unsigned char) name[i];
+		nameHash *= 16777619u;
+	}
+	return nameHash;
+}
+
+/**
+ * Function searches the slot of a name in the hash table
+ * @param const std::string& name : IN name of the category
+ * @param uint32_t nameHash       : IN hash of the name
+ * @returnvalue unsigned int : slot holding the name or the empty slot where it belongs
+ */
+unsigned int CPoiCategoryRegistry::findSlot(const string& name,
+		uint32_t nameHash) const
+{
+	unsigned int mask = m_slots.size() - 1;
+	unsigned int slot = nameHash & mask;
+
+	while (m_slots[slot] != 0
+			&& (m_hashes[m_slots[slot] - 1] != nameHash
+					|| m_names[m_slots[slot] - 1] != name))
+		slot = (slot + 1) & mask;
+
+	return slot;
+}
+
+/**
+ * Function rebuilds the hash table with a new number of slots
+ * @param unsigned int noSlots : IN number of slots, a power of 2
+ * @returnvalue void
+ */
+void CPoiCategoryRegistry::rehash(unsigned int noSlots)
+{
+	unsigned int mask = noSlots - 1;
+
+	m_slots.assign(noSlots, 0);
+
+	for (unsigned int id = 0; id < m_names.size(); id++)
+	{
+		unsigned int slot = m_hashes[id] & mask;
+
+		while (m_slots[slot] != 0)
+			slot = (slot + 1) & mask;
+		m_slots[slot] = id + 1;
+	}
+}
@@ -0,0 +1,133 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CPOICATEGORYREGISTRY.H
+ * Author          : George Sebastian
+ * Description     : CPoiCategoryRegistry maps the names of the POI categories (types) to
+ *                   dense 16 bit IDs and back. It is shared by the whole program : the
+ *                   parsers of the persistent storages, CPOI and the queries use the same
+ *                   IDs. The built-in categories RESTAURANT, TOURISTIC, GASSTATION and
+ *                   UNIVERSITY have the IDs 0 to 3 (the constants of CPOI), further
+ *                   categories are registered at run time, e.g. by the parsers for the
+ *                   unknown types of a file, and get the next free ID.
+ *                   Lookup of a name : open addressing hash table whose slots hold the IDs;
+ *                   the hash of each name is computed once when it is registered and
+ *                   compared before the strings, so a lookup costs one hash of the name
+ *                   and usually one string compare. A perfect hash function is not used :
+ *                   it would have to be recomputed for every category registered while a
+ *                   file is read, and the table which is at most half full already finds a
+ *                   name in about one probe.
+ *                   All functions lock the registry, categories can be registered and
+ *                   looked up by several threads. The names never move in memory, the
+ *                   reference returned by getName() stays valid.
+ ****************************************************************************/
+#ifndef CPOICATEGORYREGISTRY_H
+#define CPOICATEGORYREGISTRY_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <mutex>
+#include <stdint.h>
+
+/*
+ * ID of a POI category
+ */
+typedef uint16_t t_poiCategory;
+
+#define POI_CATEGORY_INVALID 0xFFFF      // no category, returned for an invalid name or when the registry is full
+
+class CPoiCategoryRegistry
+{
+public:
+
+	/**
+	 * Function registers a category, a known category keeps its ID
+	 * @param const std::string& name : IN name of the category, e.g. "PHARMACY" : letters, digits, '_' and blanks
+	 * @returnvalue t_poiCategory : ID of the category, POI_CATEGORY_INVALID for an invalid name or if all IDs are used
+	 */
+	static t_poiCategory registerCategory(const std::string& name);
+
+	/**
+	 * Function checks if a name can be the name of a category
+	 * @param const std::string& name : IN name
+	 * @returnvalue true if the name is not empty and has only letters, digits, '_' and blanks
+	 */
+	static bool isValidName(const std::string& name);
+
+	/**
+	 * Function returns the ID of a category
+	 * @param const std::string& name : IN name of the category
+	 * @param t_poiCategory& id       : OUT ID of the category
+	 * @returnvalue true if the category is registered
+	 */
+	static bool getId(const std::string& name, t_poiCategory& id);
+
+	/**
+	 * Function checks if a category is registered
+	 * @param const std::string& name : IN name of the category
+	 * @returnvalue true if the category is registered
+	 */
+	static bool isKnown(const std::string& name);
+
+	/**
+	 * Function returns the name of a category
+	 * @param t_poiCategory id : IN ID of the category
+	 * @returnvalue const std::string& : name of the category, "default type" for an unknown ID
+	 */
+	static const std::string& getName(t_poiCategory id);
+
+	/**
+	 * Function returns the number of registered categories, the IDs are 0 .. number - 1
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of categories
+	 */
+	static unsigned int getNoCategories();
+
+private:
+
+	/**
+	 * Constructor of class CPoiCategoryRegistry, registers the built-in categories
+	 * @param no parameters
+	 * @return no value
+	 */
+	CPoiCategoryRegistry();
+
+	/**
+	 * Function returns the registry of the program, created on the first use
+	 * @param no parameters
+	 * @returnvalue CPoiCategoryRegistry& : registry
+	 */
+	static CPoiCategoryRegistry& instance();
+
+	/**
+	 * Function returns the FNV-1a hash of a name
+	 * @param const std::string& name : IN name of a category
+	 * @returnvalue uint32_t : hash
+	 */
+	static uint32_t hash(const std::string& name);
+
+	/**
+	 * Function searches the slot of a name in the hash table
+	 * @param const std::string& name : IN name of the category
+	 * @param uint32_t nameHash       : IN hash of the name
+	 * @returnvalue unsigned int : slot holding the name or the empty slot where it belongs
+	 */
+	unsigned int findSlot(const std::string& name, uint32_t nameHash) const;
+
+	/**
+	 * Function rebuilds the hash table with a new number of slots
+	 * @param unsigned int noSlots : IN number of slots, a power of 2
+	 * @returnvalue void
+	 */
+	void rehash(unsigned int noSlots);
+
+	std::deque<std::string> m_names;        // name of each ID, a deque does not move them
+	std::vector<uint32_t> m_hashes;         // hash of each name
+	std::vector<uint32_t> m_slots;          // ID + 1, 0 : empty slot
+	std::mutex m_mutex;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CPOICATEGORYREGISTRY_H */
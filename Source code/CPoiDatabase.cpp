@@ -5,12 +5,27 @@
  * Author          : George Sebastian
  * Description     : CPOIDatabase class maintain a Database for POIs and POIs to our Route
  *                   are added from this Database
+ *                   Type index : the grid cells are POI_CELL_DEGREE high and wide, their key
+ *                   combines row and column, the columns wrap around at the date line.
+ *                   A cell further away than k - 1 cells in latitude or longitude gives a
+ *                   lower bound of the distance of its POIs; the nearest POI search stops
+ *                   at the first ring of cells whose bound is not smaller than the best
+ *                   distance found. When a search would visit more cells than there are
+ *                   POIs of the type (sparse types, positions far away from all POIs, near
+ *                   the poles), the dense arrays are scanned.
  ****************************************************************************/
 #include <iostream>
+#include <math.h>
+#include <algorithm>
 using namespace std;
 
 #include "CPoiDatabase.h"
 #include "CPOI.h"
+#include "CUnitVector.h"
+
+#define POI_CELL_DEGREE 0.1               // height and width of the grid cells of the type index (about 11 km)
+#define PI 3.14159265358979323846
+#define RADIAN (PI / 180.0)
 
 /**
  * Function checks for the POI having the same name as passed by the user in the POI Database
@@ -33,6 +48,32 @@ CPoiDatabase::CPoiDatabase()
 {
 }
 
+/**
+ * Copy constructor for the CPoiDatabase class, the type index refers to the copied POIs
+ * @param const CPoiDatabase& other : IN Database to be copied
+ * @return no values
+ */
+CPoiDatabase::CPoiDatabase(const CPoiDatabase& other) :
+		CDatabase<string, CPOI>(other)
+{
+	rebuildIndex(other);
+}
+
+/**
+ * Assignment operator for the CPoiDatabase class, the type index refers to the copied POIs
+ * @param const CPoiDatabase& other : IN Database to be copied
+ * @returnvalue CPoiDatabase&
+ */
+CPoiDatabase& CPoiDatabase::operator=(const CPoiDatabase& other)
+{
+	if (this != &other)
+	{
+		CDatabase<string, CPOI>::operator=(other);
+		rebuildIndex(other);
+	}
+	return *this;
+}
+
 /**
  * Function adds POI object provided by user to POI Database, if POI is valid
  * If POI is already existing in Database, it will be overwritten and Warning is
@@ -42,8 +83,74 @@ CPoiDatabase::CPoiDatabase()
  */
 void CPoiDatabase::addPoi(CPOI const& poi)
 {
+	addObjectToDb(poi);
+}
+
+/**
+ * Function adds a POI to the Map of the Database like CDatabase::addObjectToDb() and a new POI to the
+ * index of its type
+ * @param CPOI const& poi : IN POI object to be added to POI Database
+ * @returnvalue void
+ */
+void CPoiDatabase::addObjectToDb(CPOI const& poi)
+{
+	// the map keeps an existing POI of the same name, the index does the same
+	bool isNew = (CDatabase::getPointerToObject(poi.getName()) == NULL);
+
 	CDatabase::addObjectToDb(poi);
 
+	const CPOI* pPoi = CDatabase::getPointerToObject(poi.getName());
+	if (isNew && pPoi != NULL)
+		// added to the Database, added to the index of its type
+		indexPoi(pPoi);
+}
+
+/**
+ * Function adds a POI of the Database to the index of its type
+ * @param const CPOI* pPoi : IN POI in the Map of the Database
+ * @returnvalue void
+ */
+void CPoiDatabase::indexPoi(const CPOI* pPoi)
+{
+	string name, description;
+	double latitude, longitude;
+	CPOI::t_poi type;
+
+	pPoi->getAllDataByReference(name, latitude, longitude, type, description);
+
+	if (type >= m_typeIndex.size())
+		m_typeIndex.resize(type + 1);
+
+	t_typeIndex& index = m_typeIndex[type];
+	CUnitVector position = CUnitVector::fromLatLon(latitude, longitude);
+
+	index.cells[cellKey((long long) floor(latitude / POI_CELL_DEGREE),
+			(long long) floor(longitude / POI_CELL_DEGREE))].push_back(
+			index.pois.size());
+	index.pois.push_back(pPoi);
+	index.x.push_back(position.m_x);
+	index.y.push_back(position.m_y);
+	index.z.push_back(position.m_z);
+}
+
+/**
+ * Function builds the type index for the POIs of this Database in the order of the index of another
+ * Database with the same POIs (after copying)
+ * @param const CPoiDatabase& other : IN Database which was copied
+ * @returnvalue void
+ */
+void CPoiDatabase::rebuildIndex(const CPoiDatabase& other)
+{
+	m_typeIndex.clear();
+
+	for (unsigned int type = 0; type < other.m_typeIndex.size(); type++)
+	{
+		const vector<const CPOI*>& pois = other.m_typeIndex[type].pois;
+
+		// the POIs of this Database with the same names, not the ones of the other Database
+		for (unsigned int i = 0; i < pois.size(); i++)
+			indexPoi(CDatabase::getPointerToObject(pois[i]->getName()));
+	}
 }
 
 /**
@@ -78,6 +185,305 @@ const void CPoiDatabase::getPoiMap(std::map<std::string, CPOI>& poiMap) const
  * @returnvalue void
  */
 void CPoiDatabase::clearPoiDb()
+{
+	clearDb();
+}
+
+/**
+ * Function clears the Map of the Database like CDatabase::clearDb() and the type index
+ * @param no parameters
+ * @returnvalue void
+ */
+void CPoiDatabase::clearDb()
 {
 	CDatabase::clearDb();
+	m_typeIndex.clear();
+}
+
+/**
+ * Function returns the POIs of a type, from the type index without scanning the Database
+ * @param CPOI::t_poi type : IN type of the POIs
+ * @returnvalue const std::vector<const CPOI*>& : POIs of the type in the order they were added
+ */
+const vector<const CPOI*>& CPoiDatabase::getPoisOfType(CPOI::t_poi type) const
+{
+	static const vector<const CPOI*> noPois;
+
+	return (type < m_typeIndex.size()) ? m_typeIndex[type].pois : noPois;
+}
+
+/**
+ * Function searches the nearest POI of a type. Only the cells around the position are searched,
+ * ring by ring, until no cell further out can contain a nearer POI.
+ * @param CPOI::t_poi type   : IN type of the POI, e.g. GASSTATION
+ * @param double latitude    : IN latitude of the position
+ * @param double longitude   : IN longitude of the position
+ * @param double& distanceKm : OUT great circle distance to the POI
+ * @returnvalue const CPOI* : nearest POI, NULL if there is no POI of the type
+ */
+const CPOI* CPoiDatabase::getNearestPoi(CPOI::t_poi type, double latitude,
+		double longitude, double& distanceKm) const
+{
+	distanceKm = -1.0;
+
+	if (type >= m_typeIndex.size())
+		return NULL;
+
+	int nearest = nearestInIndex(m_typeIndex[type], latitude, longitude,
+			distanceKm);
+	return (nearest < 0) ? NULL : m_typeIndex[type].pois[nearest];
+}
+
+/**
+ * Function searches the POIs of a type within a radius around a position
+ * @param CPOI::t_poi type              : IN type of the POIs
+ * @param double latitude               : IN latitude of the position
+ * @param double longitude              : IN longitude of the position
+ * @param double radiusKm               : IN radius
+ * @param std::vector<const CPOI*>& pois : OUT POIs within the radius, in no particular order
+ * @returnvalue unsigned int : number of POIs found
+ */
+unsigned int CPoiDatabase::getPoisWithinRadius(CPOI::t_poi type,
+		double latitude, double longitude, double radiusKm,
+		vector<const CPOI*>& pois) const
+{
+	pois.clear();
+
+	if (type < m_typeIndex.size())
+		appendWithinRadius(m_typeIndex[type], latitude, longitude, radiusKm, pois);
+
+	return pois.size();
+}
+
+/**
+ * Function searches the nearest POI of any type of a filter
+ * @param const CPoiCategoryFilter& filter : IN types of the POI, e.g. RESTAURANT and GASSTATION
+ * @param double latitude                  : IN latitude of the position
+ * @param double longitude                 : IN longitude of the position
+ * @param double& distanceKm               : OUT great circle distance to the POI
+ * @returnvalue const CPOI* : nearest POI, NULL if there is no POI of the types
+ */
+const CPOI* CPoiDatabase::getNearestPoi(const CPoiCategoryFilter& filter,
+		double latitude, double longitude, double& distanceKm) const
+{
+	const CPOI* pNearest = NULL;
+
+	distanceKm = -1.0;
+
+	for (unsigned int type = 0; type < m_typeIndex.size(); type++)
+	{
+		if (!filter.contains(type))
+			continue;
+
+		double typeKm;
+		int nearest = nearestInIndex(m_typeIndex[type], latitude, longitude,
+				typeKm);
+
+		if (nearest >= 0 && (pNearest == NULL || typeKm < distanceKm))
+		{
+			pNearest = m_typeIndex[type].pois[nearest];
+			distanceKm = typeKm;
+		}
+	}
+
+	return pNearest;
+}
+
+/**
+ * Function searches the POIs of any type of a filter within a radius around a position
+ * @param const CPoiCategoryFilter& filter : IN types of the POIs
+ * @param double latitude                  : IN latitude of the position
+ * @param double longitude                 : IN longitude of the position
+ * @param double radiusKm                  : IN radius
+ * @param std::vector<const CPOI*>& pois   : OUT POIs within the radius, in no particular order
+ * @returnvalue unsigned int : number of POIs found
+ */
+unsigned int CPoiDatabase::getPoisWithinRadius(const CPoiCategoryFilter& filter,
+		double latitude, double longitude, double radiusKm,
+		vector<const CPOI*>& pois) const
+{
+	pois.clear();
+
+	for (unsigned int type = 0; type < m_typeIndex.size(); type++)
+		if (filter.contains(type))
+			appendWithinRadius(m_typeIndex[type], latitude, longitude, radiusKm,
+					pois);
+
+	return pois.size();
+}
+
+/**
+ * Function searches the nearest POI of a type index
+ * @param const t_typeIndex& index : IN type index
+ * @param double latitude          : IN latitude of the position
+ * @param double longitude         : IN longitude of the position
+ * @param double& distanceKm       : OUT great circle distance to the POI
+ * @returnvalue int : element of the nearest POI in the dense arrays, -1 if the index is empty
+ */
+int CPoiDatabase::nearestInIndex(const t_typeIndex& index, double latitude,
+		double longitude, double& distanceKm)
+{
+	CUnitVector position = CUnitVector::fromLatLon(latitude, longitude);
+	long long row = (long long) floor(latitude / POI_CELL_DEGREE);
+	long long column = (long long) floor(longitude / POI_CELL_DEGREE);
+	long long noPois = index.pois.size();
+	int nearest = -1;
+
+	distanceKm = -1.0;
+
+	for (long long ring = 0; noPois > 0; ring++)
+	{
+		if (ring > 0 && nearest >= 0)
+		{
+			// POIs in the ring are more than ring - 1 cells away in latitude or in longitude
+			double gapRadian = (ring - 1) * POI_CELL_DEGREE * RADIAN;
+			double maxLatitude = min(90.0,
+					fabs(latitude) + (ring + 1) * POI_CELL_DEGREE);
+			double latitudeBoundKm = CUnitVector::EARTH_RADIUS * gapRadian;
+			double longitudeBoundKm = 2.0 * CUnitVector::EARTH_RADIUS
+					* asin(cos(maxLatitude * RADIAN) * sin(0.5 * gapRadian));
+
+			if (min(latitudeBoundKm, longitudeBoundKm) >= distanceKm)
+				break;
+		}
+
+		if ((2 * ring + 1) * (2 * ring + 1) > noPois)
+		// more cells than POIs : scan the dense arrays
+		{
+			for (unsigned int i = 0; i < index.pois.size(); i++)
+			{
+				double poiKm = distanceTo(index, i, position.m_x, position.m_y,
+						position.m_z);
+				if (nearest < 0 || poiKm < distanceKm)
+				{
+					distanceKm = poiKm;
+					nearest = i;
+				}
+			}
+			break;
+		}
+
+		for (long long r = row - ring; r <= row + ring; r++)
+		{
+			// all cells of the first and last row of the ring, else only the first and last column
+			long long step = (r == row - ring || r == row + ring) ? 1 : 2 * ring;
+
+			for (long long c = column - ring; c <= column + ring;
+					c += step)
+			{
+				unordered_map<long long, vector<unsigned int> >::const_iterator cell =
+						index.cells.find(cellKey(r, c));
+
+				if (cell == index.cells.end())
+					continue;
+
+				for (unsigned int i = 0; i < cell->second.size(); i++)
+				{
+					double poiKm = distanceTo(index, cell->second[i], position.m_x,
+							position.m_y, position.m_z);
+					if (nearest < 0 || poiKm < distanceKm)
+					{
+						distanceKm = poiKm;
+						nearest = cell->second[i];
+					}
+				}
+			}
+		}
+	}
+
+	return nearest;
+}
+
+/**
+ * Function appends the POIs of a type index within a radius around a position
+ * @param const t_typeIndex& index       : IN type index
+ * @param double latitude                : IN latitude of the position
+ * @param double longitude               : IN longitude of the position
+ * @param double radiusKm                : IN radius
+ * @param std::vector<const CPOI*>& pois : OUT POIs within the radius are appended
+ * @returnvalue void
+ */
+void CPoiDatabase::appendWithinRadius(const t_typeIndex& index,
+		double latitude, double longitude, double radiusKm,
+		vector<const CPOI*>& pois)
+{
+	CUnitVector position = CUnitVector::fromLatLon(latitude, longitude);
+
+	// rows and columns of cells which can contain POIs within the radius
+	double radiusDegree = radiusKm / (CUnitVector::EARTH_RADIUS * RADIAN);
+	double maxLatitude = fabs(latitude) + radiusDegree;
+	long long firstRow = (long long) floor((latitude - radiusDegree) / POI_CELL_DEGREE);
+	long long lastRow = (long long) floor((latitude + radiusDegree) / POI_CELL_DEGREE);
+	long long noColumns = 0;
+
+	if (maxLatitude < 89.0)
+		noColumns = (long long) ceil(
+				radiusDegree / cos(maxLatitude * RADIAN) / POI_CELL_DEGREE) + 1;
+
+	if (noColumns == 0 || 2 * noColumns + 1 > (long long) (360.0 / POI_CELL_DEGREE)
+			|| (lastRow - firstRow + 1) * (2 * noColumns + 1)
+					> (long long) index.pois.size())
+	// more cells than POIs (or a pole within the radius, or all the way round) : scan the dense arrays
+	{
+		for (unsigned int i = 0; i < index.pois.size(); i++)
+			if (distanceTo(index, i, position.m_x, position.m_y, position.m_z)
+					<= radiusKm)
+				pois.push_back(index.pois[i]);
+
+		return;
+	}
+
+	long long column = (long long) floor(longitude / POI_CELL_DEGREE);
+
+	for (long long r = firstRow; r <= lastRow; r++)
+	{
+		for (long long c = column - noColumns; c <= column + noColumns; c++)
+		{
+			unordered_map<long long, vector<unsigned int> >::const_iterator cell =
+					index.cells.find(cellKey(r, c));
+
+			if (cell == index.cells.end())
+				continue;
+
+			for (unsigned int i = 0; i < cell->second.size(); i++)
+				if (distanceTo(index, cell->second[i], position.m_x, position.m_y,
+						position.m_z) <= radiusKm)
+					pois.push_back(index.pois[cell->second[i]]);
+		}
+	}
+}
+
+/**
+ * Function returns the key of a grid cell
+ * @param long long row    : IN row of the cell (latitude / POI_CELL_DEGREE)
+ * @param long long column : IN column of the cell (longitude / POI_CELL_DEGREE)
+ * @returnvalue long long : key of the cell
+ */
+long long CPoiDatabase::cellKey(long long row, long long column)
+{
+	// columns wrap around at the date line
+	long long noColumns = (long long) (360.0 / POI_CELL_DEGREE + 0.5);
+	column = ((column % noColumns) + noColumns) % noColumns;
+
+	return row * 100000LL + column;
+}
+
+/**
+ * Function returns the distance between a position and a POI of a type index
+ * @param const t_typeIndex& index : IN type index
+ * @param unsigned int element     : IN element of the POI in the dense arrays
+ * @param double x                 : IN x component of the unit vector of the position
+ * @param double y                 : IN y component
+ * @param double z                 : IN z component
+ * @returnvalue double : great circle distance in km
+ */
+double CPoiDatabase::distanceTo(const t_typeIndex& index, unsigned int element,
+		double x, double y, double z)
+{
+	double dx = index.x[element] - x;
+	double dy = index.y[element] - y;
+	double dz = index.z[element] - z;
+	double halfChord = 0.5 * sqrt(dx * dx + dy * dy + dz * dz);
+
+	return 2.0 * CUnitVector::EARTH_RADIUS * asin(min(halfChord, 1.0));
 }
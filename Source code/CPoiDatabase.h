@@ -5,20 +5,100 @@
  * Author          : George Sebastian
  * Description     : CPOIDatabase class maintain a Database for POIs and POIs to our Route
  *                   are added from this Database
+ *                   Besides the map by name, the POIs are indexed by type (category) : each type has
+ *                   its own partition with the positions in dense arrays (unit vectors)
+ *                   and a grid of cells (POI_CELL_DEGREE) over them, so a query for one
+ *                   type (e.g. the nearest gas station) touches only the POIs of this type
+ *                   in the cells around the position. The index is updated by
+ *                   addObjectToDb() and clearDb(), which override the functions of
+ *                   CDatabase, so also addPoi(), clearPoiDb() and calls through the base
+ *                   class keep it consistent.
  ****************************************************************************/
 #ifndef CPOIDATABASE_H
 #define CPOIDATABASE_H
 
 #include <map>
+#include <vector>
+#include <unordered_map>
 
 #include "CPOI.h"
 #include "CDatabase.h"
+#include "CPoiCategoryFilter.h"
 
 class CPoiDatabase: public CDatabase<std::string, CPOI>
 {
 private:
 
+	/*
+	 * POIs of one type : dense arrays, element i is the same POI in all of them, and a grid of cells
+	 */
+	struct t_typeIndex
+	{
+		std::vector<const CPOI*> pois;
+		std::vector<double> x, y, z;          // unit vectors of the positions
+		std::unordered_map<long long, std::vector<unsigned int> > cells;   // cell key -> elements
+	};
+
 	std::map<std::string, CPOI> m_poiMap;
+	std::vector<t_typeIndex> m_typeIndex;   // element : ID of the type, grows with the registered categories
+
+	/**
+	 * Function returns the key of a grid cell
+	 * @param long long row    : IN row of the cell (latitude / POI_CELL_DEGREE)
+	 * @param long long column : IN column of the cell (longitude / POI_CELL_DEGREE)
+	 * @returnvalue long long : key of the cell
+	 */
+	static long long cellKey(long long row, long long column);
+
+	/**
+	 * Function returns the distance between a position and a POI of a type index
+	 * @param const t_typeIndex& index : IN type index
+	 * @param unsigned int element     : IN element of the POI in the dense arrays
+	 * @param double x                 : IN x component of the unit vector of the position
+	 * @param double y                 : IN y component
+	 * @param double z                 : IN z component
+	 * @returnvalue double : great circle distance in km
+	 */
+	static double distanceTo(const t_typeIndex& index, unsigned int element,
+			double x, double y, double z);
+
+	/**
+	 * Function searches the nearest POI of a type index
+	 * @param const t_typeIndex& index : IN type index
+	 * @param double latitude          : IN latitude of the position
+	 * @param double longitude         : IN longitude of the position
+	 * @param double& distanceKm       : OUT great circle distance to the POI
+	 * @returnvalue int : element of the nearest POI in the dense arrays, -1 if the index is empty
+	 */
+	static int nearestInIndex(const t_typeIndex& index, double latitude,
+			double longitude, double& distanceKm);
+
+	/**
+	 * Function appends the POIs of a type index within a radius around a position
+	 * @param const t_typeIndex& index       : IN type index
+	 * @param double latitude                : IN latitude of the position
+	 * @param double longitude               : IN longitude of the position
+	 * @param double radiusKm                : IN radius
+	 * @param std::vector<const CPOI*>& pois : OUT POIs within the radius are appended
+	 * @returnvalue void
+	 */
+	static void appendWithinRadius(const t_typeIndex& index, double latitude,
+			double longitude, double radiusKm, std::vector<const CPOI*>& pois);
+
+	/**
+	 * Function adds a POI of the Database to the index of its type
+	 * @param const CPOI* pPoi : IN POI in the Map of the Database
+	 * @returnvalue void
+	 */
+	void indexPoi(const CPOI* pPoi);
+
+	/**
+	 * Function builds the type index for the POIs of this Database in the order of the index of another
+	 * Database with the same POIs (after copying)
+	 * @param const CPoiDatabase& other : IN Database which was copied
+	 * @returnvalue void
+	 */
+	void rebuildIndex(const CPoiDatabase& other);
 
 public:
 
@@ -29,6 +109,20 @@ public:
 	 */
 	CPoiDatabase();
 
+	/**
+	 * Copy constructor for the CPoiDatabase class, the type index refers to the copied POIs
+	 * @param const CPoiDatabase& other : IN Database to be copied
+	 * @return no values
+	 */
+	CPoiDatabase(const CPoiDatabase& other);
+
+	/**
+	 * Assignment operator for the CPoiDatabase class, the type index refers to the copied POIs
+	 * @param const CPoiDatabase& other : IN Database to be copied
+	 * @returnvalue CPoiDatabase&
+	 */
+	CPoiDatabase& operator=(const CPoiDatabase& other);
+
 	/**
 	 * Function checks for the POI having the same name as passed by the user in the POI Database
 	 * and returns the pointer to the POI in the POI Database
@@ -46,6 +140,14 @@ public:
 	 */
 	void addPoi(CPOI const& poi);
 
+	/**
+	 * Function adds a POI to the Map of the Database like CDatabase::addObjectToDb() and a new POI to the
+	 * index of its type
+	 * @param CPOI const& poi : IN POI object to be added to POI Database
+	 * @returnvalue void
+	 */
+	void addObjectToDb(CPOI const& poi);
+
 	/**
 	 * Function prints the contents of POI Database
 	 * @param no parameter
@@ -66,6 +168,68 @@ public:
 	 * @returnvalue void
 	 */
 	void clearPoiDb();
+
+	/**
+	 * Function clears the Map of the Database like CDatabase::clearDb() and the type index
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void clearDb();
+
+	/**
+	 * Function returns the POIs of a type, from the type index without scanning the Database
+	 * @param CPOI::t_poi type : IN type of the POIs
+	 * @returnvalue const std::vector<const CPOI*>& : POIs of the type in the order they were added
+	 */
+	const std::vector<const CPOI*>& getPoisOfType(CPOI::t_poi type) const;
+
+	/**
+	 * Function searches the nearest POI of a type. Only the cells around the position are searched,
+	 * ring by ring, until no cell further out can contain a nearer POI.
+	 * @param CPOI::t_poi type   : IN type of the POI, e.g. GASSTATION
+	 * @param double latitude    : IN latitude of the position
+	 * @param double longitude   : IN longitude of the position
+	 * @param double& distanceKm : OUT great circle distance to the POI
+	 * @returnvalue const CPOI* : nearest POI, NULL if there is no POI of the type
+	 */
+	const CPOI* getNearestPoi(CPOI::t_poi type, double latitude,
+			double longitude, double& distanceKm) const;
+
+	/**
+	 * Function searches the POIs of a type within a radius around a position
+	 * @param CPOI::t_poi type              : IN type of the POIs
+	 * @param double latitude               : IN latitude of the position
+	 * @param double longitude              : IN longitude of the position
+	 * @param double radiusKm               : IN radius
+	 * @param std::vector<const CPOI*>& pois : OUT POIs within the radius, in no particular order
+	 * @returnvalue unsigned int : number of POIs found
+	 */
+	unsigned int getPoisWithinRadius(CPOI::t_poi type, double latitude,
+			double longitude, double radiusKm, std::vector<const CPOI*>& pois) const;
+
+	/**
+	 * Function searches the nearest POI of any type of a filter
+	 * @param const CPoiCategoryFilter& filter : IN types of the POI, e.g. RESTAURANT and GASSTATION
+	 * @param double latitude                  : IN latitude of the position
+	 * @param double longitude                 : IN longitude of the position
+	 * @param double& distanceKm               : OUT great circle distance to the POI
+	 * @returnvalue const CPOI* : nearest POI, NULL if there is no POI of the types
+	 */
+	const CPOI* getNearestPoi(const CPoiCategoryFilter& filter, double latitude,
+			double longitude, double& distanceKm) const;
+
+	/**
+	 * Function searches the POIs of any type of a filter within a radius around a position
+	 * @param const CPoiCategoryFilter& filter : IN types of the POIs
+	 * @param double latitude                  : IN latitude of the position
+	 * @param double longitude                 : IN longitude of the position
+	 * @param double radiusKm                  : IN radius
+	 * @param std::vector<const CPOI*>& pois   : OUT POIs within the radius, in no particular order
+	 * @returnvalue unsigned int : number of POIs found
+	 */
+	unsigned int getPoisWithinRadius(const CPoiCategoryFilter& filter,
+			double latitude, double longitude, double radiusKm,
+			std::vector<const CPOI*>& pois) const;
 };
 
 /********************
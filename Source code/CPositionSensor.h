@@ -0,0 +1,55 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CPOSITIONSENSOR.H
+ * Author          : George Sebastian
+ * Description     : CPositionSensor class is an Abstract Class for all sources of
+ *                   positions (GPS Sensor, NMEA replay, ...).
+ *                   No objects of this class can be instantiated
+ ****************************************************************************/
+#ifndef CPOSITIONSENSOR_H
+#define CPOSITIONSENSOR_H
+
+#include "CWaypoint.h"
+
+/*
+ * timestamped position as delivered by a sensor
+ */
+struct t_gpsFix
+{
+	double latitude;     // degree, south negative
+	double longitude;    // degree, west negative
+	double timestamp;    // seconds since the start of the UTC day of the first fix
+};
+
+class CPositionSensor
+{
+public:
+
+	/**
+	 * Destructor of class CPositionSensor
+	 * @param no parameters
+	 * @return no value
+	 */
+	virtual ~CPositionSensor()
+	{
+	}
+
+	/**
+	 * Function reads the next fix of the sensor, may block until the fix is available
+	 * @param t_gpsFix& fix : OUT next fix
+	 * @returnvalue true if a fix was read, false if the sensor has no more fixes
+	 */
+	virtual bool getNextFix(t_gpsFix& fix)=0;
+
+	/**
+	 * Function to get the current position of the user
+	 * @param no parameters
+	 * @returnvalue CWaypoint : current position, "default city" if no valid position is available
+	 */
+	virtual CWaypoint getCurrentPosition()=0;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CPOSITIONSENSOR_H */
@@ -0,0 +1,191 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CRINGBUFFER.H
+ * Author          : George Sebastian
+ * Description     : CRingBuffer.h provides a Template Class for a lock free ring buffer
+ *                   between exactly one producer thread and one consumer thread
+ *                   (e.g. the sensor thread and the navigation loop).
+ *                   push() is only called by the producer, pop() only by the consumer.
+ *                   Neither blocks : push() fails if the buffer is full, pop() fails if
+ *                   it is empty.
+ *                   elementType -> Type of the objects stored in the buffer
+ ****************************************************************************/
+#ifndef CRINGBUFFER_H_
+#define CRINGBUFFER_H_
+
+#include <vector>
+#include <atomic>
+
+#define CACHE_LINE_SIZE 64                  // producer and consumer counters are kept in separate cache lines
+
+template<class elementType> // elementType -> Type of the objects stored in the buffer
+class CRingBuffer
+{
+
+private:
+
+	std::vector<elementType> m_elements;
+	unsigned int m_mask;                     // capacity - 1, the capacity is a power of 2
+
+	// written by the producer only
+	alignas(CACHE_LINE_SIZE) std::atomic<unsigned int> m_writeCount;
+	unsigned int m_cachedReadCount;          // last read count seen by the producer
+
+	// written by the consumer only
+	alignas(CACHE_LINE_SIZE) std::atomic<unsigned int> m_readCount;
+	unsigned int m_cachedWriteCount;         // last write count seen by the consumer
+
+	/**
+	 * Copy constructor and assignment operator are not available, the buffer is shared by two threads
+	 */
+	CRingBuffer(const CRingBuffer&);
+	CRingBuffer& operator=(const CRingBuffer&);
+
+public:
+
+	/**
+	 * Constructor for the CRingBuffer class
+	 * @param unsigned int capacity : IN minimum number of elements in the buffer, rounded up to a power of 2
+	 * @return no values
+	 */
+	CRingBuffer(unsigned int capacity = 1024);
+
+	/**
+	 * Function adds an element to the buffer. May only be called by the producer thread
+	 * @param elementType const& element : IN element to be added
+	 * @returnvalue true if the element was added, false if the buffer is full
+	 */
+	bool push(elementType const& element);
+
+	/**
+	 * Function removes the oldest element from the buffer. May only be called by the consumer thread
+	 * @param elementType& element : OUT oldest element
+	 * @returnvalue true if an element was removed, false if the buffer is empty
+	 */
+	bool pop(elementType& element);
+
+	/**
+	 * Function returns true if the buffer is empty. Exact only when called by the consumer thread
+	 * @param no parameters
+	 * @returnvalue bool : true if no element is in the buffer
+	 */
+	bool empty() const;
+
+	/**
+	 * Function returns the number of elements in the buffer, a snapshot while the other thread is running
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of elements
+	 */
+	unsigned int size() const;
+
+	/**
+	 * Function returns the number of elements the buffer can hold
+	 * @param no parameters
+	 * @returnvalue unsigned int : capacity
+	 */
+	unsigned int capacity() const;
+};
+
+/**
+ * Constructor for the CRingBuffer class
+ * @param unsigned int capacity : IN minimum number of elements in the buffer, rounded up to a power of 2
+ * @return no values
+ */
+template<class elementType>
+CRingBuffer<elementType>::CRingBuffer(unsigned int capacity) :
+		m_writeCount(0), m_cachedReadCount(0), m_readCount(0), m_cachedWriteCount(
+				0)
+{
+	unsigned int roundedCapacity = 2;
+	while (roundedCapacity < capacity)
+		roundedCapacity *= 2;
+
+	m_elements.resize(roundedCapacity);
+	m_mask = roundedCapacity - 1;
+}
+
+/**
+ * Function adds an element to the buffer. May only be called by the producer thread
+ * @param elementType const& element : IN element to be added
+ * @returnvalue true if the element was added, false if the buffer is full
+ */
+template<class elementType>
+bool CRingBuffer<elementType>::push(elementType const& element)
+{
+	// the counters run freely and wrap around, their difference is the number of elements
+	unsigned int writeCount = m_writeCount.load(std::memory_order_relaxed);
+
+	if (writeCount - m_cachedReadCount > m_mask)
+	// buffer seems to be full, the consumer may have removed elements in the meantime
+	{
+		m_cachedReadCount = m_readCount.load(std::memory_order_acquire);
+		if (writeCount - m_cachedReadCount > m_mask)
+			return false;
+	}
+
+	m_elements[writeCount & m_mask] = element;
+	m_writeCount.store(writeCount + 1, std::memory_order_release); // publishes the element to the consumer
+	return true;
+}
+
+/**
+ * Function removes the oldest element from the buffer. May only be called by the consumer thread
+ * @param elementType& element : OUT oldest element
+ * @returnvalue true if an element was removed, false if the buffer is empty
+ */
+template<class elementType>
+bool CRingBuffer<elementType>::pop(elementType& element)
+{
+	unsigned int readCount = m_readCount.load(std::memory_order_relaxed);
+
+	if (readCount == m_cachedWriteCount)
+	// buffer seems to be empty, the producer may have added elements in the meantime
+	{
+		m_cachedWriteCount = m_writeCount.load(std::memory_order_acquire);
+		if (readCount == m_cachedWriteCount)
+			return false;
+	}
+
+	element = m_elements[readCount & m_mask];
+	m_readCount.store(readCount + 1, std::memory_order_release); // gives the slot back to the producer
+	return true;
+}
+
+/**
+ * Function returns true if the buffer is empty. Exact only when called by the consumer thread
+ * @param no parameters
+ * @returnvalue bool : true if no element is in the buffer
+ */
+template<class elementType>
+bool CRingBuffer<elementType>::empty() const
+{
+	return m_readCount.load(std::memory_order_relaxed)
+			== m_writeCount.load(std::memory_order_acquire);
+}
+
+/**
+ * Function returns the number of elements in the buffer, a snapshot while the other thread is running
+ * @param no parameters
+ * @returnvalue unsigned int : number of elements
+ */
+template<class elementType>
+unsigned int CRingBuffer<elementType>::size() const
+{
+	// read count first : it can only grow up to the write count loaded afterwards
+	unsigned int readCount = m_readCount.load(std::memory_order_acquire);
+	return m_writeCount.load(std::memory_order_acquire) - readCount;
+}
+
+/**
+ * Function returns the number of elements the buffer can hold
+ * @param no parameters
+ * @returnvalue unsigned int : capacity
+ */
+template<class elementType>
+unsigned int CRingBuffer<elementType>::capacity() const
+{
+	return m_mask + 1;
+}
+
+#endif /* CRINGBUFFER_H_ */
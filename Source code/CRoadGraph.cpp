@@ -0,0 +1,342 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CROADGRAPH.CPP
+ * Author          : George Sebastian
+ * Description     : CRoadGraph is the road network between the Waypoints of a WP Database.
+ *                   Edges are collected in a list and moved into the compressed sparse row
+ *                   arrays with a counting sort by start node (and by end node for the
+ *                   reverse edges) in buildAdjacency().
+ ****************************************************************************/
+#include <iostream>
+#include <string.h>
+#include <stdint.h>
+using namespace std;
+
+#include "CRoadGraph.h"
+#include "CFileIO.h"
+#include "CString.h"
+
+/**
+ * Function adds bytes to a FNV-1a hash
+ * @param unsigned long long hash : IN hash of the bytes before
+ * @param const void* pBytes      : IN bytes
+ * @param size_t noBytes          : IN number of bytes
+ * @returnvalue unsigned long long : hash including the bytes
+ */
+static unsigned long long hashBytes(unsigned long long hash, const void* pBytes,
+		size_t noBytes)
+{
+	const unsigned char* pByte = (const unsigned char*) pBytes;
+
+	for (size_t i = 0; i < noBytes; i++)
+	{
+		hash ^= pByte[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+/**
+ * Constructor of class CRoadGraph, the graph is empty
+ * @param no parameters
+ * @return no value
+ */
+CRoadGraph::CRoadGraph()
+{
+	m_firstEdge.push_back(0);
+	m_firstReverseEdge.push_back(0);
+	m_ready = true;
+}
+
+/**
+ * Function reads the edges from an edge list file and builds the adjacency arrays.
+ * Lines with unknown Waypoints or an invalid cost are reported and skipped.
+ * @param const std::string& fileName : IN name of the edge list file
+ * @param CWpDatabase& wpDatabase     : IN database with the Waypoints named in the file
+ * @param bool bothDirections         : IN each line adds the edge and the reverse edge (roads without one way streets)
+ * @returnvalue true if the file could be opened
+ */
+bool CRoadGraph::loadEdges(const string& fileName, CWpDatabase& wpDatabase,
+		bool bothDirections)
+{
+	CFileIO myFile;
+	CString myString;
+	string line, from, to, cost;
+	unsigned int lineNumber = 0;
+
+	if (!myFile.openFile(fileName, CFileIO::IN))
+	{
+		cout << "ERROR : edge list " << fileName << " could not be opened"
+				<< endl;
+		return false;
+	}
+
+	while (myFile.readLineFromFile(line))
+	{
+		lineNumber++;
+
+		if (!line.empty() && line[line.size() - 1] == '\r')
+			// file written on Windows
+			line.erase(line.size() - 1);
+
+		if (line.empty())
+			// blank lines are skipped
+			continue;
+
+		string rest = line;
+		double costKm = -1.0;
+
+		if (!myString.cutLeft(rest, from))
+		{
+			cout << "ERROR : MISSING ATTRIBUTES in line " << lineNumber << " : "
+					<< line << endl;
+			continue;
+		}
+
+		if (myString.cutLeft(rest, to))
+		// cost is given
+		{
+			cost = rest;
+			if (!myString.isStringValidNumber(cost)
+					|| (costKm = myString.stringToDouble(cost)) < 0.0)
+			{
+				cout << "ERROR : INVALID COST in line " << lineNumber << " : "
+						<< line << endl;
+				continue;
+			}
+		}
+
+		if (!addEdge(wpDatabase, from, to, costKm))
+		{
+			cout << "ERROR : UNKNOWN WAYPOINT in line " << lineNumber << " : "
+					<< line << endl;
+			continue;
+		}
+
+		if (bothDirections)
+			addEdge(wpDatabase, to, from, costKm);
+	}
+
+	myFile.closeFile();
+	buildAdjacency();
+	return true;
+}
+
+/**
+ * Function adds a Waypoint as node, a Waypoint which is already a node keeps its number
+ * @param const CWaypoint* pWaypoint : IN Waypoint in the WP Database (must live as long as the graph)
+ * @returnvalue unsigned int : number of the node
+ */
+unsigned int CRoadGraph::addNode(const CWaypoint* pWaypoint)
+{
+	pair<unordered_map<string, unsigned int>::iterator, bool> inserted =
+			m_nodeNumbers.insert(
+					make_pair(pWaypoint->getName(), (unsigned int) m_pWaypoints.size()));
+
+	if (inserted.second)
+	// new node
+	{
+		m_pWaypoints.push_back(pWaypoint);
+		m_positions.push_back(CUnitVector::fromWaypoint(*pWaypoint));
+		m_ready = false;
+	}
+
+	return inserted.first->second;
+}
+
+/**
+ * Function adds a directed edge between two Waypoints of the WP Database. buildAdjacency() has to be called before searching.
+ * @param CWpDatabase& wpDatabase : IN database with the Waypoints
+ * @param const std::string& from : IN name of the start Waypoint
+ * @param const std::string& to   : IN name of the end Waypoint
+ * @param double costKm           : IN cost of the edge, negative : great circle distance between the Waypoints
+ * @returnvalue true if both Waypoints are in the WP Database
+ */
+bool CRoadGraph::addEdge(CWpDatabase& wpDatabase, const string& from,
+		const string& to, double costKm)
+{
+	unsigned int fromNode, toNode;
+
+	// Waypoints which are already nodes are not looked up in the database again
+	if (!getNode(from, fromNode))
+	{
+		const CWaypoint* pFrom = wpDatabase.getPointerToWaypoint(from);
+		if (pFrom == NULL)
+			return false;
+		fromNode = addNode(pFrom);
+	}
+
+	if (!getNode(to, toNode))
+	{
+		const CWaypoint* pTo = wpDatabase.getPointerToWaypoint(to);
+		if (pTo == NULL)
+			return false;
+		toNode = addNode(pTo);
+	}
+
+	addEdge(fromNode, toNode, costKm);
+	return true;
+}
+
+/**
+ * Function adds a directed edge between two nodes. buildAdjacency() has to be called before searching.
+ * @param unsigned int from : IN start node
+ * @param unsigned int to   : IN end node
+ * @param double costKm     : IN cost of the edge, negative : great circle distance between the nodes
+ * @returnvalue void
+ */
+void CRoadGraph::addEdge(unsigned int from, unsigned int to, double costKm)
+{
+	t_edge edge;
+
+	edge.from = from;
+	edge.to = to;
+	edge.costKm = (costKm >= 0.0) ?
+			costKm : m_pWaypoints[from]->calculateDistance(*m_pWaypoints[to]);
+
+	m_addedEdges.push_back(edge);
+	m_ready = false;
+}
+
+/**
+ * Function builds the compressed sparse row arrays from the added edges
+ * @param no parameters
+ * @returnvalue void
+ */
+void CRoadGraph::buildAdjacency()
+{
+	unsigned int noNodes = m_pWaypoints.size();
+
+	// counting sort of the edges by start node
+	m_firstEdge.assign(noNodes + 1, 0);
+	m_firstReverseEdge.assign(noNodes + 1, 0);
+	for (unsigned int e = 0; e < m_addedEdges.size(); e++)
+	{
+		m_firstEdge[m_addedEdges[e].from + 1]++;
+		m_firstReverseEdge[m_addedEdges[e].to + 1]++;
+	}
+
+	for (unsigned int node = 0; node < noNodes; node++)
+	{
+		m_firstEdge[node + 1] += m_firstEdge[node];
+		m_firstReverseEdge[node + 1] += m_firstReverseEdge[node];
+	}
+
+	vector<unsigned int> next(m_firstEdge.begin(), m_firstEdge.end() - 1);
+	vector<unsigned int> nextReverse(m_firstReverseEdge.begin(),
+			m_firstReverseEdge.end() - 1);
+	m_edgeTarget.resize(m_addedEdges.size());
+	m_edgeCost.resize(m_addedEdges.size());
+	m_reverseEdgeSource.resize(m_addedEdges.size());
+	m_reverseEdgeCost.resize(m_addedEdges.size());
+
+	for (unsigned int e = 0; e < m_addedEdges.size(); e++)
+	{
+		unsigned int position = next[m_addedEdges[e].from]++;
+		m_edgeTarget[position] = m_addedEdges[e].to;
+		m_edgeCost[position] = m_addedEdges[e].costKm;
+
+		position = nextReverse[m_addedEdges[e].to]++;
+		m_reverseEdgeSource[position] = m_addedEdges[e].from;
+		m_reverseEdgeCost[position] = m_addedEdges[e].costKm;
+	}
+
+	m_ready = true;
+}
+
+/**
+ * Function returns the number of a node
+ * @param const std::string& name : IN name of the Waypoint
+ * @param unsigned int& node      : OUT number of the node
+ * @returnvalue true if the Waypoint is a node of the graph
+ */
+bool CRoadGraph::getNode(const string& name, unsigned int& node) const
+{
+	unordered_map<string, unsigned int>::const_iterator itr =
+			m_nodeNumbers.find(name);
+
+	if (itr == m_nodeNumbers.end())
+		return false;
+
+	node = itr->second;
+	return true;
+}
+
+/**
+ * Function returns the Waypoint of a node
+ * @param unsigned int node : IN number of the node
+ * @returnvalue const CWaypoint* : Waypoint in the WP Database
+ */
+const CWaypoint* CRoadGraph::getWaypoint(unsigned int node) const
+{
+	return m_pWaypoints[node];
+}
+
+/**
+ * Function returns the number of nodes
+ * @param no parameters
+ * @returnvalue unsigned int : number of nodes
+ */
+unsigned int CRoadGraph::getNoNodes() const
+{
+	return m_pWaypoints.size();
+}
+
+/**
+ * Function returns the number of edges in the adjacency arrays
+ * @param no parameters
+ * @returnvalue unsigned int : number of edges
+ */
+unsigned int CRoadGraph::getNoEdges() const
+{
+	return m_edgeTarget.size();
+}
+
+/**
+ * Function tells if the adjacency arrays contain all added edges
+ * @param no parameters
+ * @returnvalue true if buildAdjacency() was called after the last change
+ */
+bool CRoadGraph::isReady() const
+{
+	return m_ready;
+}
+
+/**
+ * Function returns a fingerprint of the nodes and edges, to check that data precomputed for a graph and saved to
+ * a file belongs to it. A graph with the same nodes but other edges or costs has another fingerprint.
+ * Only the edges in the adjacency arrays are included, buildAdjacency() has to be called before.
+ * @param no parameters
+ * @returnvalue unsigned long long : FNV-1a hash of the names of the nodes and of the adjacency arrays
+ */
+unsigned long long CRoadGraph::getFingerprint() const
+{
+	unsigned long long hash = 14695981039346656037ULL;
+
+	for (unsigned int node = 0; node < m_pWaypoints.size(); node++)
+	{
+		// the terminating 0 separates the names
+		const char* name = m_pWaypoints[node]->getNameChars();
+		hash = hashBytes(hash, name, strlen(name) + 1);
+	}
+
+	for (unsigned int i = 0; i < m_firstEdge.size(); i++)
+	{
+		uint32_t first = m_firstEdge[i];
+		hash = hashBytes(hash, &first, sizeof(first));
+	}
+
+	for (unsigned int edge = 0; edge < m_edgeTarget.size(); edge++)
+	{
+		uint32_t target = m_edgeTarget[edge];
+		uint64_t costBits;
+
+		// the bits of the cost : every change of a cost changes the fingerprint
+		memcpy(&costBits, &m_edgeCost[edge], sizeof(costBits));
+		hash = hashBytes(hash, &target, sizeof(target));
+		hash = hashBytes(hash, &costBits, sizeof(costBits));
+	}
+
+	return hash;
+}
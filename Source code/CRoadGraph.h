@@ -0,0 +1,165 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CROADGRAPH.H
+ * Author          : George Sebastian
+ * Description     : CRoadGraph is the road network between the Waypoints of a WP Database.
+ *                   The Waypoints are the nodes, the roads are directed edges with a cost
+ *                   (length in km). The edges are stored in compressed sparse row format :
+ *                   the edges leaving node n are m_edgeTarget/m_edgeCost[m_firstEdge[n] ..
+ *                   m_firstEdge[n + 1] - 1], so a search reads them from 2 arrays without
+ *                   any pointer chasing.
+ *                   The reverse edges (edges entering a node) are stored the same way for
+ *                   searches from the destination backwards.
+ *                   The graph is read only after buildAdjacency(), several searches (one
+ *                   CShortestPathSearch per thread) can use it at the same time.
+ *                   Edge list file format, one edge per line : from;to[;cost in km]
+ *                   Without a cost the great circle distance between the Waypoints is used.
+ ****************************************************************************/
+#ifndef CROADGRAPH_H
+#define CROADGRAPH_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+#include "CWpDatabase.h"
+#include "CUnitVector.h"
+
+class CRoadGraph
+{
+public:
+
+	/**
+	 * Constructor of class CRoadGraph, the graph is empty
+	 * @param no parameters
+	 * @return no value
+	 */
+	CRoadGraph();
+
+	/**
+	 * Function reads the edges from an edge list file and builds the adjacency arrays.
+	 * Lines with unknown Waypoints or an invalid cost are reported and skipped.
+	 * @param const std::string& fileName : IN name of the edge list file
+	 * @param CWpDatabase& wpDatabase     : IN database with the Waypoints named in the file
+	 * @param bool bothDirections         : IN each line adds the edge and the reverse edge (roads without one way streets)
+	 * @returnvalue true if the file could be opened
+	 */
+	bool loadEdges(const std::string& fileName, CWpDatabase& wpDatabase,
+			bool bothDirections = false);
+
+	/**
+	 * Function adds a Waypoint as node, a Waypoint which is already a node keeps its number
+	 * @param const CWaypoint* pWaypoint : IN Waypoint in the WP Database (must live as long as the graph)
+	 * @returnvalue unsigned int : number of the node
+	 */
+	unsigned int addNode(const CWaypoint* pWaypoint);
+
+	/**
+	 * Function adds a directed edge between two Waypoints of the WP Database. buildAdjacency() has to be called before searching.
+	 * @param CWpDatabase& wpDatabase : IN database with the Waypoints
+	 * @param const std::string& from : IN name of the start Waypoint
+	 * @param const std::string& to   : IN name of the end Waypoint
+	 * @param double costKm           : IN cost of the edge, negative : great circle distance between the Waypoints
+	 * @returnvalue true if both Waypoints are in the WP Database
+	 */
+	bool addEdge(CWpDatabase& wpDatabase, const std::string& from,
+			const std::string& to, double costKm = -1.0);
+
+	/**
+	 * Function adds a directed edge between two nodes. buildAdjacency() has to be called before searching.
+	 * @param unsigned int from : IN start node
+	 * @param unsigned int to   : IN end node
+	 * @param double costKm     : IN cost of the edge, negative : great circle distance between the nodes
+	 * @returnvalue void
+	 */
+	void addEdge(unsigned int from, unsigned int to, double costKm = -1.0);
+
+	/**
+	 * Function builds the compressed sparse row arrays from the added edges
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void buildAdjacency();
+
+	/**
+	 * Function returns the number of a node
+	 * @param const std::string& name : IN name of the Waypoint
+	 * @param unsigned int& node      : OUT number of the node
+	 * @returnvalue true if the Waypoint is a node of the graph
+	 */
+	bool getNode(const std::string& name, unsigned int& node) const;
+
+	/**
+	 * Function returns the Waypoint of a node
+	 * @param unsigned int node : IN number of the node
+	 * @returnvalue const CWaypoint* : Waypoint in the WP Database
+	 */
+	const CWaypoint* getWaypoint(unsigned int node) const;
+
+	/**
+	 * Function returns the number of nodes
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of nodes
+	 */
+	unsigned int getNoNodes() const;
+
+	/**
+	 * Function returns the number of edges in the adjacency arrays
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of edges
+	 */
+	unsigned int getNoEdges() const;
+
+	/**
+	 * Function tells if the adjacency arrays contain all added edges
+	 * @param no parameters
+	 * @returnvalue true if buildAdjacency() was called after the last change
+	 */
+	bool isReady() const;
+
+	/**
+	 * Function returns a fingerprint of the nodes and edges, to check that data precomputed for a graph and saved to
+	 * a file belongs to it. A graph with the same nodes but other edges or costs has another fingerprint.
+	 * Only the edges in the adjacency arrays are included, buildAdjacency() has to be called before.
+	 * @param no parameters
+	 * @returnvalue unsigned long long : FNV-1a hash of the names of the nodes and of the adjacency arrays
+	 */
+	unsigned long long getFingerprint() const;
+
+private:
+
+	friend class CShortestPathSearch;
+	friend class CContractionHierarchy;
+	friend class CLandmarkTable;
+	friend class CIsochroneSearch;
+
+	/*
+	 * edge added but not yet in the adjacency arrays
+	 */
+	struct t_edge
+	{
+		unsigned int from;
+		unsigned int to;
+		double costKm;
+	};
+
+	std::vector<const CWaypoint*> m_pWaypoints;
+	std::unordered_map<std::string, unsigned int> m_nodeNumbers;
+	std::vector<CUnitVector> m_positions;       // position of the nodes, for the heuristics of the searches
+
+	std::vector<t_edge> m_addedEdges;
+
+	// compressed sparse row arrays
+	std::vector<unsigned int> m_firstEdge;     // number of nodes + 1 entries
+	std::vector<unsigned int> m_edgeTarget;
+	std::vector<double> m_edgeCost;
+	std::vector<unsigned int> m_firstReverseEdge;  // edges entering node n : m_reverseEdgeSource/Cost[m_firstReverseEdge[n] .. m_firstReverseEdge[n + 1] - 1]
+	std::vector<unsigned int> m_reverseEdgeSource;
+	std::vector<double> m_reverseEdgeCost;
+	bool m_ready;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CROADGRAPH_H */
@@ -128,7 +128,8 @@ void CRoute::addWaypoint(const string& name)
 		if (pWp != NULL)
 		// Waypoint 'name' is found in Waypoint Database
 		{
-			m_pWaypointList.push_back(pWp);
+			t_routeElement element = { pWp, ROUTE_WAYPOINT };
+			m_pWaypointList.push_back(element);
 			m_noWp++;
 		}
 
@@ -166,17 +167,15 @@ void CRoute::addPoi(const string& namePoi, const string& afterWp)
 			if (afterWp != "default WP")
 			// afterWp parameter is provided by user, add POI after 'afterWp' if found, otherwise, don't add POI to the Route
 			{
-				list<CWaypoint*>::iterator pos = m_pWaypointList.end(); // pos is initialized with the iterator pointing to the theoretical last element which follows the last element
+				list<t_routeElement>::iterator pos = m_pWaypointList.end(); // pos is initialized with the iterator pointing to the theoretical last element which follows the last element
 
-				for (list<CWaypoint*>::iterator itr = m_pWaypointList.begin();
+				for (list<t_routeElement>::iterator itr = m_pWaypointList.begin();
 						itr != m_pWaypointList.end(); ++itr)
 				{
-					if ((*itr)->getName() == afterWp)
+					if (itr->pWaypoint->getName() == afterWp)
 					// 'afterWp' is found in the Route
 					{
-						CPOI* pPoi = dynamic_cast<CPOI*>(*itr);
-
-						if (pPoi == NULL)
+						if (!itr->isPoi())
 							// Validating afterWp. POI and WP can have same name. 'namePoi' should be added after the last WAYPOINT 'afterWp' in the Route
 							pos = itr; // position of "LAST Wp" having the name 'afterWp' is found by iterating through the list
 					}
@@ -185,7 +184,8 @@ void CRoute::addPoi(const string& namePoi, const string& afterWp)
 				if (pos != m_pWaypointList.end())
 				//  'afterWp' is found in the Route
 				{
-					m_pWaypointList.insert(++pos, pPoi); // pPoi is inserted at the position ++pos, ie after 'afterWp'
+					t_routeElement element = { pPoi, ROUTE_POI };
+					m_pWaypointList.insert(++pos, element); // pPoi is inserted at the position ++pos, ie after 'afterWp'
 					m_noPoi++;
 				}
 				else
@@ -197,7 +197,8 @@ void CRoute::addPoi(const string& namePoi, const string& afterWp)
 			else
 			// afterWp parameter is not provided by user, add POI to the end of the list
 			{
-				m_pWaypointList.push_back(pPoi);
+				t_routeElement element = { pPoi, ROUTE_POI };
+				m_pWaypointList.push_back(element);
 				m_noPoi++;
 			}
 		}
@@ -219,28 +220,31 @@ void CRoute::addPoi(const string& namePoi, const string& afterWp)
 double CRoute::getDistanceNextPoi(CWaypoint const& wp, CPOI& poi)
 {
 	double distance = 0.0;
-	map<double, CPOI*> mapPoi;
+	double chordSquared = 0.0;
+	const CPOI* pNearestPoi = NULL;
 
 	if (m_noPoi != 0)
 	// making sure that atleast one POI is present in our route
 	{
-		for (list<CWaypoint*>::const_iterator itr = m_pWaypointList.begin();
+		for (list<t_routeElement>::const_iterator itr = m_pWaypointList.begin();
 				itr != m_pWaypointList.end(); ++itr)
 		{
-			CPOI* pPoi = dynamic_cast<CPOI*>(*itr);
-
-			if (pPoi != NULL)
-			// Validating whether *itr is a pointer to POI
+			if (itr->isPoi())
+			// only POIs are considered, the first of several POIs with the same distance is taken
 			{
-				mapPoi.insert(
-						pair<double, CPOI*>((*itr)->calculateDistance(wp),
-								pPoi));
+				// the chord grows with the distance, no trigonometry for the comparison
+				double poiChordSquared = itr->pWaypoint->calculateChordSquared(wp);
+
+				if (pNearestPoi == NULL || poiChordSquared < chordSquared)
+				{
+					pNearestPoi = itr->getPoi();
+					chordSquared = poiChordSquared;
+				}
 			}
 		}
 
-		map<double, CPOI*>::iterator itr = mapPoi.begin(); // Elements are stored in Map after sorting internally (ascending order of KEY = distance)
-		poi = *(itr->second);
-		distance = itr->first;
+		distance = pNearestPoi->calculateDistance(wp);
+		poi = *pNearestPoi;
 	}
 	else
 		throw ERROR_NO_POI_IN_ROUTE;
@@ -268,10 +272,10 @@ void CRoute::print()
 #if TESTCASE_ROUTE_PRINT == 0
 	// normal case . Polymorphism (Late Binding)
 
-	for (list<CWaypoint*>::const_iterator itr = m_pWaypointList.begin();
+	for (list<t_routeElement>::const_iterator itr = m_pWaypointList.begin();
 			itr != m_pWaypointList.end(); ++itr)
 	{
-		(*itr)->print(MMSS);   // Polymorphism (Late Binding)
+		itr->pWaypoint->print(MMSS);   // Polymorphism (Late Binding)
 
 	}
 
@@ -336,7 +340,7 @@ CRoute CRoute::operator+(CRoute const& rop)
 	{
 		result.m_pWaypointList = m_pWaypointList;        // lop copied to result
 
-		for (list<CWaypoint*>::const_iterator itr =
+		for (list<t_routeElement>::const_iterator itr =
 				rop.m_pWaypointList.begin(); itr != rop.m_pWaypointList.end();
 				++itr)
 		{
@@ -381,23 +385,71 @@ CRoute& CRoute::operator+=(const string& name)
 }
 
 /**
- * Function returns a vector containing the Route
+ * Function returns a vector containing the Route.
+ * Callers which only iterate through the Route should use getRouteView(), which does not allocate.
  * @param no parameter
- * @return const std::vector<const CWaypoint*> : vector containing Route
+ * @return std::vector<const CWaypoint*> : vector containing Route
  */
-const std::vector<const CWaypoint*> CRoute::getRoute()
+std::vector<const CWaypoint*> CRoute::getRoute() const
 {
 
-	 vector <const CWaypoint*> m_pWaypointVector;
+	vector<const CWaypoint*> pWaypointVector;
+	pWaypointVector.reserve(m_pWaypointList.size());
 
-	for (list<CWaypoint*>::const_iterator itr = m_pWaypointList.begin();
+	for (list<t_routeElement>::const_iterator itr = m_pWaypointList.begin();
 			itr != m_pWaypointList.end(); ++itr)
 	{
-		m_pWaypointVector.push_back(*itr);
+		pWaypointVector.push_back(itr->pWaypoint);
 
 	}
 
-	return m_pWaypointVector;
+	return pWaypointVector;                    // returned by value, moved to the caller
+}
+
+/**
+ * Function returns a read only view on the elements of the Route (Waypoint/POI and its kind).
+ * Nothing is copied, the view is valid until the Route is changed.
+ * @param no parameter
+ * @return CRouteView : view on the Route
+ */
+CRouteView CRoute::getRouteView() const
+{
+	return CRouteView(m_pWaypointList);
 }
 
+/**
+ * Function rebuilds our Route from the elements at the given positions of the current Route.
+ * Elements are taken in the order given by 'indices', elements whose position is not listed are removed.
+ * Used by the Route optimiser (reordering) and the Route simplification (dropping elements)
+ * @param const std::vector<unsigned int>& indices : IN positions (0 based, see getRoute()) of the elements of the new Route
+ * @returnvalue true if all positions are valid and the Route was rebuilt, otherwise false and the Route is unchanged
+ */
+bool CRoute::rebuildFromIndices(const std::vector<unsigned int>& indices)
+{
+	vector<t_routeElement> elements(m_pWaypointList.begin(),
+			m_pWaypointList.end());          // random access to the current elements
+
+	for (unsigned int i = 0; i < indices.size(); i++)
+	{
+		if (indices[i] >= elements.size())
+			// invalid position, Route is left unchanged
+			return false;
+	}
+
+	m_pWaypointList.clear();
+	m_noWp = 0;
+	m_noPoi = 0;
+
+	for (unsigned int i = 0; i < indices.size(); i++)
+	{
+		m_pWaypointList.push_back(elements[indices[i]]);
 
+		if (elements[indices[i]].isPoi())
+			// updating the number of WP and POI in our Route
+			m_noPoi++;
+		else
+			m_noWp++;
+	}
+
+	return true;
+}
@@ -17,6 +17,7 @@
 #include "CPoiDatabase.h"
 #include "CWpDatabase.h"
 #include "CWaypoint.h"
+#include "CRouteView.h"
 
 class CWaypoint;
 
@@ -24,7 +25,7 @@ class CRoute
 {
 private:
 
-    list <CWaypoint*> m_pWaypointList;
+    std::list<t_routeElement> m_pWaypointList;
 
     unsigned short int m_noPoi;
     unsigned short int m_noWp;
@@ -134,11 +135,29 @@ public:
 	void print();
 
 	/**
-	 * Function returns a vector containing the Route
+	 * Function returns a vector containing the Route.
+	 * Callers which only iterate through the Route should use getRouteView(), which does not allocate.
 	 * @param no parameter
-	 * @return const std::vector<const CWaypoint*> : vector containing Route
+	 * @return std::vector<const CWaypoint*> : vector containing Route
 	 */
-	const std::vector<const CWaypoint*> getRoute();
+	std::vector<const CWaypoint*> getRoute() const;
+
+	/**
+	 * Function returns a read only view on the elements of the Route (Waypoint/POI and its kind).
+	 * Nothing is copied, the view is valid until the Route is changed.
+	 * @param no parameter
+	 * @return CRouteView : view on the Route
+	 */
+	CRouteView getRouteView() const;
+
+	/**
+	 * Function rebuilds our Route from the elements at the given positions of the current Route.
+	 * Elements are taken in the order given by 'indices', elements whose position is not listed are removed.
+	 * Used by the Route optimiser (reordering) and the Route simplification (dropping elements)
+	 * @param const std::vector<unsigned int>& indices : IN positions (0 based, see getRoute()) of the elements of the new Route
+	 * @returnvalue true if all positions are valid and the Route was rebuilt, otherwise false and the Route is unchanged
+	 */
+	bool rebuildFromIndices(const std::vector<unsigned int>& indices);
 };
 /********************
  **  CLASS END
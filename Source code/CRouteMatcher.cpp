@@ -0,0 +1,471 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CROUTEMATCHER.CPP
+ * Author          : George Sebastian
+ * Description     : CRouteMatcher projects a position (e.g. the current position from
+ *                   the GPS Sensor) onto the segments of a Route. It returns the closest
+ *                   segment, the along track fraction on this segment, the distance from
+ *                   the start of the Route and the cross track distance (for off route
+ *                   detection).
+ *                   Each segment is stored with its precomputed great circle normal, so a
+ *                   segment is tested with 3 dot products and no trigonometry. Long Routes
+ *                   are searched with a grid of the segment bounding boxes. The previous
+ *                   match is used as hint: while the vehicle follows the Route, only the
+ *                   segments around the last match are tested.
+ ****************************************************************************/
+#include <math.h>
+#include <vector>
+#include <algorithm>
+using namespace std;
+
+#include "CRouteMatcher.h"
+
+#define PI 3.14159265358979323846
+#define HINT_SEGMENTS_BEHIND 1     // segments before the previous match tested with the hint
+#define HINT_SEGMENTS_AHEAD 3      // segments after the previous match tested with the hint
+#define MIN_CELL_KM 0.05           // cells of the grid are at least 50 m wide
+#define MAX_CELLS_PER_SEGMENT 4    // the grid has at most this number of cells per segment
+
+/**
+ * Constructor of class CRouteMatcher
+ * @param double hintAcceptKm : IN a match near the previous match is accepted without searching the whole Route, if it is closer than this distance in km
+ * @return no value
+ */
+CRouteMatcher::CRouteMatcher(double hintAcceptKm)
+{
+	double angle = hintAcceptKm / CUnitVector::EARTH_RADIUS;
+
+	m_hintAcceptSquaredSine = sin(angle) * sin(angle);
+	m_routeLengthKm = 0.0;
+	m_gridMinLatitude = 0.0;
+	m_gridMinLongitude = 0.0;
+	m_cellLatitude = 1.0;
+	m_cellLongitude = 1.0;
+	m_cellMinKm = 0.0;
+	m_noRows = 0;
+	m_noColumns = 0;
+	m_queryStamp = 0;
+	m_hasHint = false;
+	m_hintSegment = 0;
+}
+
+/**
+ * Function prepares the segments of the Route and the grid. Has to be called again after the Route was changed.
+ * @param const CRoute& route : IN Route onto which the positions are projected
+ * @returnvalue void
+ */
+void CRouteMatcher::setRoute(const CRoute& route)
+{
+	CRouteView view = route.getRouteView();
+	vector<CUnitVector> points;
+	vector<double> latitudes, longitudes;
+
+	for (CRouteView::const_iterator itr = view.begin(); itr != view.end();
+			++itr)
+	{
+		latitudes.push_back(itr->pWaypoint->getLatitude());
+		longitudes.push_back(itr->pWaypoint->getLongitude());
+		points.push_back(
+				CUnitVector::fromLatLon(latitudes.back(), longitudes.back()));
+	}
+
+	m_segments.clear();
+	m_routeLengthKm = 0.0;
+
+	for (unsigned int i = 0; i + 1 < points.size(); i++)
+	{
+		t_segment segment;
+		segment.a = points[i];
+		segment.b = points[i + 1];
+		segment.startKm = m_routeLengthKm;
+		segment.angle = points[i].angleTo(points[i + 1]);
+
+		CUnitVector normal = points[i].cross(points[i + 1]);
+
+		if (segment.angle > 0.0 && normal.length() > 0.0)
+		{
+			segment.normal = normal.normalized();
+			segment.towardsB = segment.normal.cross(segment.a);
+			segment.afterB = segment.b.cross(segment.normal);
+		}
+		else
+		// a and b are identical, the segment is treated as single point
+		{
+			segment.angle = 0.0;
+			segment.normal = CUnitVector(0.0, 0.0, 0.0);
+			segment.towardsB = segment.normal;
+			segment.afterB = segment.normal;
+		}
+
+		m_segments.push_back(segment);
+		m_routeLengthKm += segment.angle * CUnitVector::EARTH_RADIUS;
+	}
+
+	buildGrid(latitudes, longitudes);
+	resetHint();
+}
+
+/**
+ * Function projects a position onto the closest segment of the Route
+ * @param const CWaypoint& position : IN position to be projected, e.g. from the GPS Sensor
+ * @param t_routeMatch& match       : OUT result of the projection
+ * @returnvalue true if the Route has at least one segment and the position could be projected
+ */
+bool CRouteMatcher::match(const CWaypoint& position, t_routeMatch& match)
+{
+	return this->match(
+			CUnitVector::fromLatLon(position.getLatitude(),
+					position.getLongitude()), match);
+}
+
+/**
+ * Function projects a position given as unit vector onto the closest segment of the Route
+ * @param const CUnitVector& position : IN position to be projected
+ * @param t_routeMatch& match         : OUT result of the projection
+ * @returnvalue true if the Route has at least one segment and the position could be projected
+ */
+bool CRouteMatcher::match(const CUnitVector& position, t_routeMatch& match)
+{
+	if (m_segments.empty())
+		// Route with less than 2 points
+		return false;
+
+	unsigned int bestSegment = 0;
+	double bestDistance = 3.0;                 // larger than any sin^2 distance
+
+	if (m_hasHint)
+	// vehicle is expected to be near the previous match, testing only the segments around it
+	{
+		unsigned int first =
+				(m_hintSegment > HINT_SEGMENTS_BEHIND) ?
+						m_hintSegment - HINT_SEGMENTS_BEHIND : 0;
+		unsigned int last = min(m_hintSegment + HINT_SEGMENTS_AHEAD,
+				(unsigned int) m_segments.size() - 1);
+
+		testSegments(first, last, position, bestSegment, bestDistance);
+	}
+
+	if (!m_hasHint || bestDistance > m_hintAcceptSquaredSine)
+	// no hint or vehicle is not near the previous match, searching the whole Route
+	{
+		double latitude, longitude;
+		position.toLatLon(latitude, longitude);
+
+		searchGrid(position, latitude, longitude, bestSegment, bestDistance);
+	}
+
+	fillMatch(bestSegment, position, match);
+
+	m_hasHint = true;
+	m_hintSegment = bestSegment;
+
+	return true;
+}
+
+/**
+ * Function forgets the previous match, the next match searches the whole Route
+ * @param no parameters
+ * @returnvalue void
+ */
+void CRouteMatcher::resetHint()
+{
+	m_hasHint = false;
+	m_hintSegment = 0;
+}
+
+/**
+ * Function returns the number of segments of the Route
+ * @param no parameters
+ * @returnvalue unsigned int : number of segments
+ */
+unsigned int CRouteMatcher::getNoSegments() const
+{
+	return m_segments.size();
+}
+
+/**
+ * Function returns the length of the Route in km
+ * @param no parameters
+ * @returnvalue double : length of the Route
+ */
+double CRouteMatcher::getRouteLength() const
+{
+	return m_routeLengthKm;
+}
+
+/**
+ * Function returns sin^2 of the angular distance of a position to a segment, compares without trigonometry
+ * @param const t_segment& segment     : IN segment
+ * @param const CUnitVector& position : IN position
+ * @returnvalue double : sin^2 of the distance angle (monotonic in the distance up to 90 degree)
+ */
+double CRouteMatcher::squaredSineDistance(const t_segment& segment,
+		const CUnitVector& position) const
+{
+	if (segment.angle > 0.0 && position.dot(segment.towardsB) >= 0.0
+			&& position.dot(segment.afterB) >= 0.0)
+	// projection onto the great circle lies between a and b
+	{
+		double sinCrossTrack = position.dot(segment.normal);
+		return sinCrossTrack * sinCrossTrack;
+	}
+
+	// closest point is one of the end points
+	double cosDistance = max(position.dot(segment.a), position.dot(segment.b));
+
+	if (cosDistance >= 0.0)
+		return 1.0 - cosDistance * cosDistance;
+	else
+		// more than 90 degree away, continued monotonic above 1
+		return 1.0 + cosDistance * cosDistance;
+}
+
+/**
+ * Function tests the segments from 'first' to 'last' and updates the best segment
+ * @param unsigned int first          : IN first segment to be tested
+ * @param unsigned int last           : IN last segment to be tested
+ * @param const CUnitVector& position : IN position
+ * @param unsigned int& bestSegment   : IN/OUT closest segment so far
+ * @param double& bestDistance        : IN/OUT sin^2 distance of the closest segment so far
+ * @returnvalue void
+ */
+void CRouteMatcher::testSegments(unsigned int first, unsigned int last,
+		const CUnitVector& position, unsigned int& bestSegment,
+		double& bestDistance) const
+{
+	for (unsigned int i = first; i <= last; i++)
+	{
+		double distance = squaredSineDistance(m_segments[i], position);
+
+		if (distance < bestDistance)
+		{
+			bestDistance = distance;
+			bestSegment = i;
+		}
+	}
+}
+
+/**
+ * Function searches the grid ring by ring around the cell of the position until no closer segment is possible
+ * @param const CUnitVector& position : IN position
+ * @param double latitude             : IN latitude of the position
+ * @param double longitude            : IN longitude of the position
+ * @param unsigned int& bestSegment   : OUT closest segment
+ * @param double& bestDistance        : OUT sin^2 distance of the closest segment
+ * @returnvalue void
+ */
+void CRouteMatcher::searchGrid(const CUnitVector& position, double latitude,
+		double longitude, unsigned int& bestSegment, double& bestDistance)
+{
+	// cell of the position, positions outside of the grid start at the nearest border cell
+	int row = (int) floor((latitude - m_gridMinLatitude) / m_cellLatitude);
+	int column = (int) floor((longitude - m_gridMinLongitude) / m_cellLongitude);
+	row = max(0, min(row, m_noRows - 1));
+	column = max(0, min(column, m_noColumns - 1));
+
+	m_queryStamp++;
+	int maxRing = max(m_noRows, m_noColumns);
+
+	for (int ring = 0; ring <= maxRing; ring++)
+	{
+		for (int r = row - ring; r <= row + ring; r++)
+		{
+			if (r < 0 || r >= m_noRows)
+				continue;
+
+			// inner rows of the ring only have the first and the last column
+			int step = (r == row - ring || r == row + ring) ? 1 : 2 * ring;
+			if (step == 0)
+				step = 1;
+
+			for (int c = column - ring; c <= column + ring; c += step)
+			{
+				if (c < 0 || c >= m_noColumns)
+					continue;
+
+				unsigned int cell = r * m_noColumns + c;
+
+				for (unsigned int k = m_cellStart[cell]; k < m_cellStart[cell + 1];
+						k++)
+				{
+					unsigned int segment = m_cellSegments[k];
+
+					if (m_visitedStamp[segment] == m_queryStamp)
+						// already tested in this query
+						continue;
+
+					m_visitedStamp[segment] = m_queryStamp;
+					testSegments(segment, segment, position, bestSegment,
+							bestDistance);
+				}
+			}
+		}
+
+		// all cells outside of the searched rings are at least ring * m_cellMinKm away
+		double boundAngle = ring * m_cellMinKm / CUnitVector::EARTH_RADIUS;
+		if (boundAngle >= PI / 2)
+			boundAngle = PI / 2;
+
+		if (bestDistance <= sin(boundAngle) * sin(boundAngle))
+			break;
+	}
+}
+
+/**
+ * Function builds the grid (cells in CSR format) over the bounding boxes of all segments
+ * @param const std::vector<double>& latitudes  : IN latitudes of the points of the Route
+ * @param const std::vector<double>& longitudes : IN longitudes of the points of the Route
+ * @returnvalue void
+ */
+void CRouteMatcher::buildGrid(const vector<double>& latitudes,
+		const vector<double>& longitudes)
+{
+	unsigned int noSegments = m_segments.size();
+	m_visitedStamp.assign(noSegments, 0);
+	m_queryStamp = 0;
+	m_cellStart.assign(1, 0);
+	m_cellSegments.clear();
+	m_noRows = 0;
+	m_noColumns = 0;
+
+	if (noSegments == 0)
+		return;
+
+	double minLatitude = *min_element(latitudes.begin(), latitudes.end());
+	double maxLatitude = *max_element(latitudes.begin(), latitudes.end());
+	double minLongitude = *min_element(longitudes.begin(), longitudes.end());
+	double maxLongitude = *max_element(longitudes.begin(), longitudes.end());
+
+	// segment bounding boxes, great circles bulge towards the poles by up to the sagitta of the segment
+	vector<double> boxMinLat(noSegments), boxMaxLat(noSegments);
+	for (unsigned int i = 0; i < noSegments; i++)
+	{
+		double sagittaDegree = (1 - cos(m_segments[i].angle / 2)) * 180 / PI;
+		boxMinLat[i] = max(-90.0,
+				min(latitudes[i], latitudes[i + 1]) - sagittaDegree);
+		boxMaxLat[i] = min(90.0,
+				max(latitudes[i], latitudes[i + 1]) + sagittaDegree);
+		minLatitude = min(minLatitude, boxMinLat[i]);
+		maxLatitude = max(maxLatitude, boxMaxLat[i]);
+	}
+
+	double maxAbsLatitude = max(fabs(minLatitude), fabs(maxLatitude));
+	double cosMaxLatitude = max(cos(maxAbsLatitude * PI / 180), 0.01);
+	double cosMidLatitude = max(cos((minLatitude + maxLatitude) / 2 * PI / 180),
+			0.01);
+
+	// square cells (in km) with about one cell per segment
+	double heightKm = max((maxLatitude - minLatitude) * CUnitVector::KM_PER_DEGREE,
+			MIN_CELL_KM);
+	double widthKm = max(
+			(maxLongitude - minLongitude) * CUnitVector::KM_PER_DEGREE * cosMidLatitude,
+			MIN_CELL_KM);
+	double cellKm = max(sqrt(heightKm * widthKm / noSegments), MIN_CELL_KM);
+
+	m_cellLatitude = cellKm / CUnitVector::KM_PER_DEGREE;
+	m_cellLongitude = m_cellLatitude / cosMidLatitude;
+
+	while (true)
+	// limiting the memory of the grid
+	{
+		m_noRows = (int) ((maxLatitude - minLatitude) / m_cellLatitude) + 1;
+		m_noColumns = (int) ((maxLongitude - minLongitude) / m_cellLongitude) + 1;
+
+		if ((double) m_noRows * m_noColumns
+				<= (double) MAX_CELLS_PER_SEGMENT * noSegments + 16)
+			break;
+
+		m_cellLatitude *= 2;
+		m_cellLongitude *= 2;
+	}
+
+	m_gridMinLatitude = minLatitude;
+	m_gridMinLongitude = minLongitude;
+	m_cellMinKm = min(m_cellLatitude * CUnitVector::KM_PER_DEGREE,
+			m_cellLongitude * CUnitVector::KM_PER_DEGREE * cosMaxLatitude);
+
+	// first pass counts the segments per cell, second pass fills the cells
+	vector<unsigned int> count(m_noRows * m_noColumns + 1, 0);
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (unsigned int i = 0; i < noSegments; i++)
+		{
+			int firstRow = (int) ((boxMinLat[i] - minLatitude) / m_cellLatitude);
+			int lastRow = (int) ((boxMaxLat[i] - minLatitude) / m_cellLatitude);
+			int firstColumn = (int) ((min(longitudes[i], longitudes[i + 1])
+					- minLongitude) / m_cellLongitude);
+			int lastColumn = (int) ((max(longitudes[i], longitudes[i + 1])
+					- minLongitude) / m_cellLongitude);
+
+			for (int r = firstRow; r <= min(lastRow, m_noRows - 1); r++)
+			{
+				for (int c = firstColumn; c <= min(lastColumn, m_noColumns - 1);
+						c++)
+				{
+					unsigned int cell = r * m_noColumns + c;
+
+					if (pass == 0)
+						count[cell + 1]++;
+					else
+						m_cellSegments[count[cell]++] = i;
+				}
+			}
+		}
+
+		if (pass == 0)
+		// prefix sum gives the start of each cell
+		{
+			for (unsigned int c = 1; c < count.size(); c++)
+				count[c] += count[c - 1];
+
+			m_cellStart = count;
+			m_cellSegments.resize(count.back());
+		}
+	}
+}
+
+/**
+ * Function fills the result of a match for the given segment
+ * @param unsigned int segment        : IN closest segment
+ * @param const CUnitVector& position : IN position
+ * @param t_routeMatch& match         : OUT result of the projection
+ * @returnvalue void
+ */
+void CRouteMatcher::fillMatch(unsigned int segment, const CUnitVector& position,
+		t_routeMatch& match) const
+{
+	const t_segment& seg = m_segments[segment];
+	double distanceKm;
+
+	match.segment = segment;
+
+	if (seg.angle > 0.0)
+	{
+		// along track angle from a, measured in the plane of the great circle
+		double alongAngle = atan2(position.dot(seg.towardsB), position.dot(seg.a));
+		match.fraction = max(0.0, min(1.0, alongAngle / seg.angle));
+
+		if (position.dot(seg.towardsB) >= 0.0 && position.dot(seg.afterB) >= 0.0)
+		// projection lies on the segment, cross track distance to the great circle
+		{
+			double sinCrossTrack = max(-1.0, min(1.0, position.dot(seg.normal)));
+			distanceKm = fabs(asin(sinCrossTrack)) * CUnitVector::EARTH_RADIUS;
+		}
+		else
+			// distance to the nearer end point
+			distanceKm = (match.fraction < 0.5) ?
+					position.distanceTo(seg.a) : position.distanceTo(seg.b);
+	}
+	else
+	{
+		match.fraction = 0.0;
+		distanceKm = position.distanceTo(seg.a);
+	}
+
+	match.alongTrackKm = seg.startKm
+			+ match.fraction * seg.angle * CUnitVector::EARTH_RADIUS;
+	match.crossTrackKm =
+			(position.dot(seg.normal) >= 0.0) ? distanceKm : -distanceKm;
+}
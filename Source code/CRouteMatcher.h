@@ -0,0 +1,184 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CROUTEMATCHER.H
+ * Author          : George Sebastian
+ * Description     : CRouteMatcher projects a position (e.g. the current position from
+ *                   the GPS Sensor) onto the segments of a Route. It returns the closest
+ *                   segment, the along track fraction on this segment, the distance from
+ *                   the start of the Route and the cross track distance (for off route
+ *                   detection).
+ *                   Each segment is stored with its precomputed great circle normal, so a
+ *                   segment is tested with 3 dot products and no trigonometry. Long Routes
+ *                   are searched with a grid of the segment bounding boxes. The previous
+ *                   match is used as hint: while the vehicle follows the Route, only the
+ *                   segments around the last match are tested.
+ ****************************************************************************/
+#ifndef CROUTEMATCHER_H
+#define CROUTEMATCHER_H
+
+#include <vector>
+
+#include "CRoute.h"
+#include "CUnitVector.h"
+
+/*
+ * result of the projection of a position onto the Route
+ */
+struct t_routeMatch
+{
+	unsigned int segment;   // segment from Route element 'segment' to element 'segment' + 1
+	double fraction;        // along track fraction on the segment, 0 = start, 1 = end of the segment
+	double alongTrackKm;    // distance in km from the start of the Route to the projected position
+	double crossTrackKm;    // distance in km from the Route, positive left and negative right of the Route
+};
+
+class CRouteMatcher
+{
+public:
+
+	/**
+	 * Constructor of class CRouteMatcher
+	 * @param double hintAcceptKm : IN a match near the previous match is accepted without searching the whole Route, if it is closer than this distance in km
+	 * @return no value
+	 */
+	CRouteMatcher(double hintAcceptKm = 0.05);
+
+	/**
+	 * Function prepares the segments of the Route and the grid. Has to be called again after the Route was changed.
+	 * @param const CRoute& route : IN Route onto which the positions are projected
+	 * @returnvalue void
+	 */
+	void setRoute(const CRoute& route);
+
+	/**
+	 * Function projects a position onto the closest segment of the Route
+	 * @param const CWaypoint& position : IN position to be projected, e.g. from the GPS Sensor
+	 * @param t_routeMatch& match       : OUT result of the projection
+	 * @returnvalue true if the Route has at least one segment and the position could be projected
+	 */
+	bool match(const CWaypoint& position, t_routeMatch& match);
+
+	/**
+	 * Function projects a position given as unit vector onto the closest segment of the Route
+	 * @param const CUnitVector& position : IN position to be projected
+	 * @param t_routeMatch& match         : OUT result of the projection
+	 * @returnvalue true if the Route has at least one segment and the position could be projected
+	 */
+	bool match(const CUnitVector& position, t_routeMatch& match);
+
+	/**
+	 * Function forgets the previous match, the next match searches the whole Route
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void resetHint();
+
+	/**
+	 * Function returns the number of segments of the Route
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of segments
+	 */
+	unsigned int getNoSegments() const;
+
+	/**
+	 * Function returns the length of the Route in km
+	 * @param no parameters
+	 * @returnvalue double : length of the Route
+	 */
+	double getRouteLength() const;
+
+private:
+
+	/*
+	 * precomputed data of one segment from point a to point b
+	 */
+	struct t_segment
+	{
+		CUnitVector a;
+		CUnitVector b;
+		CUnitVector normal;        // unit normal of the great circle through a and b
+		CUnitVector towardsB;      // normal x a, direction of travel at a
+		CUnitVector afterB;        // b x normal, positions with a positive dot product are before b
+		double angle;              // length of the segment in radian, 0 for segments with a == b
+		double startKm;            // distance from the start of the Route to a
+	};
+
+	/**
+	 * Function returns sin^2 of the angular distance of a position to a segment, compares without trigonometry
+	 * @param const t_segment& segment     : IN segment
+	 * @param const CUnitVector& position : IN position
+	 * @returnvalue double : sin^2 of the distance angle (monotonic in the distance up to 90 degree)
+	 */
+	double squaredSineDistance(const t_segment& segment,
+			const CUnitVector& position) const;
+
+	/**
+	 * Function tests the segments from 'first' to 'last' and updates the best segment
+	 * @param unsigned int first          : IN first segment to be tested
+	 * @param unsigned int last           : IN last segment to be tested
+	 * @param const CUnitVector& position : IN position
+	 * @param unsigned int& bestSegment   : IN/OUT closest segment so far
+	 * @param double& bestDistance        : IN/OUT sin^2 distance of the closest segment so far
+	 * @returnvalue void
+	 */
+	void testSegments(unsigned int first, unsigned int last,
+			const CUnitVector& position, unsigned int& bestSegment,
+			double& bestDistance) const;
+
+	/**
+	 * Function searches the grid ring by ring around the cell of the position until no closer segment is possible
+	 * @param const CUnitVector& position : IN position
+	 * @param double latitude             : IN latitude of the position
+	 * @param double longitude            : IN longitude of the position
+	 * @param unsigned int& bestSegment   : OUT closest segment
+	 * @param double& bestDistance        : OUT sin^2 distance of the closest segment
+	 * @returnvalue void
+	 */
+	void searchGrid(const CUnitVector& position, double latitude,
+			double longitude, unsigned int& bestSegment, double& bestDistance);
+
+	/**
+	 * Function builds the grid (cells in CSR format) over the bounding boxes of all segments
+	 * @param const std::vector<double>& latitudes  : IN latitudes of the points of the Route
+	 * @param const std::vector<double>& longitudes : IN longitudes of the points of the Route
+	 * @returnvalue void
+	 */
+	void buildGrid(const std::vector<double>& latitudes,
+			const std::vector<double>& longitudes);
+
+	/**
+	 * Function fills the result of a match for the given segment
+	 * @param unsigned int segment        : IN closest segment
+	 * @param const CUnitVector& position : IN position
+	 * @param t_routeMatch& match         : OUT result of the projection
+	 * @returnvalue void
+	 */
+	void fillMatch(unsigned int segment, const CUnitVector& position,
+			t_routeMatch& match) const;
+
+	std::vector<t_segment> m_segments;
+	double m_routeLengthKm;
+
+	// grid over the bounding box of the Route, segments of cell c are m_cellSegments[m_cellStart[c] .. m_cellStart[c+1]-1]
+	double m_gridMinLatitude;
+	double m_gridMinLongitude;
+	double m_cellLatitude;      // size of a cell in degree latitude
+	double m_cellLongitude;     // size of a cell in degree longitude
+	double m_cellMinKm;         // smallest extent of a cell in km
+	int m_noRows;
+	int m_noColumns;
+	std::vector<unsigned int> m_cellStart;
+	std::vector<unsigned int> m_cellSegments;
+	std::vector<unsigned int> m_visitedStamp; // last query which tested the segment, avoids testing a segment twice
+	unsigned int m_queryStamp;
+
+	// hint from the previous match
+	bool m_hasHint;
+	unsigned int m_hintSegment;
+	double m_hintAcceptSquaredSine;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CROUTEMATCHER_H */
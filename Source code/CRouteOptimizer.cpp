@@ -0,0 +1,502 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CROUTEOPTIMIZER.CPP
+ * Author          : George Sebastian
+ * Description     : CRouteOptimizer reorders the stops of a Route in order to minimise
+ *                   the total great circle length of the Route. The first and the last
+ *                   element of the Route are kept fixed, all intermediate stops (WPs and POIs)
+ *                   are reordered. A nearest neighbour tour is constructed first and then
+ *                   improved by 2-opt and Or-opt moves until no move improves the Route any
+ *                   more or the time budget is used up. All distances are taken from a
+ *                   distance matrix which is computed once per Route.
+ *                   optimizeMultiStart() runs many randomised restarts of the local search
+ *                   in parallel threads, which share the distance matrix read only, and keeps
+ *                   the best tour.
+ ****************************************************************************/
+#include <iostream>
+#include <algorithm>
+#include <thread>
+using namespace std;
+
+#include "CRouteOptimizer.h"
+#include "CDistanceMatrix.h"
+
+#define MIN_IMPROVEMENT 1e-9   // moves gaining less than this (in km) are not applied, avoids endless loops due to rounding
+#define MAX_CHAIN_LENGTH 3     // Or-opt moves chains of 1 to MAX_CHAIN_LENGTH stops
+#define NO_RANDOM_CANDIDATES 3 // randomised nearest neighbour chooses among this number of nearest stops
+
+/**
+ * Constructor of class CRouteOptimizer
+ * @param no parameters
+ * @return no value
+ */
+CRouteOptimizer::CRouteOptimizer()
+{
+	m_noStops = 0;
+	m_initialLength = 0.0;
+	m_optimizedLength = 0.0;
+	m_noRestarts = 0;
+}
+
+/**
+ * Function reorders the intermediate stops of the Route so that the total length of the Route is minimised.
+ * First and last element of the Route are not moved. The Route is only changed if a shorter order was found.
+ * @param CRoute& route       : IN/OUT Route to be optimised
+ * @param double timeBudgetMs : IN maximum time in milliseconds spent for the improvement phase
+ * @returnvalue double : length of the Route in km after the optimisation
+ */
+double CRouteOptimizer::optimize(CRoute& route, double timeBudgetMs)
+{
+	vector<const CWaypoint*> stops = route.getRoute();
+	t_clock::time_point deadline = t_clock::now()
+			+ chrono::microseconds((long long) (timeBudgetMs * 1000.0));
+
+	buildDistanceMatrix(stops);
+
+	vector<unsigned int> userTour(m_noStops);    // order as entered by the user
+	for (unsigned int i = 0; i < m_noStops; i++)
+		userTour[i] = i;
+
+	m_initialLength = tourLength(userTour);
+	m_optimizedLength = m_initialLength;
+
+	if (m_noStops < 4)
+		// with less than 2 intermediate stops there is nothing to reorder
+		return m_optimizedLength;
+
+	vector<unsigned int> tour;
+	constructNearestNeighbour(tour);
+
+	if (tourLength(userTour) < tourLength(tour))
+		// the order entered by the user is the better starting point
+		tour = userTour;
+
+	localSearch(tour, deadline);
+
+	double length = tourLength(tour);
+
+	if (length < m_initialLength)
+	// only a shorter order is written back to the Route
+	{
+		route.rebuildFromIndices(tour);
+		m_optimizedLength = length;
+	}
+
+	return m_optimizedLength;
+}
+
+/**
+ * Function reorders the intermediate stops of the Route like optimize(), but runs many restarts of the
+ * local search from randomised nearest neighbour tours in parallel and keeps the best tour found.
+ * In case 'noRestarts' is 0, restarts are run until the time budget is used up (more threads -> more restarts).
+ * Otherwise exactly 'noRestarts' restarts are run independent of the time budget; restart r always uses
+ * the random seed 'seed' + r and ties are resolved by the lower restart number, so the result does not
+ * depend on the number of threads or the timing (deterministic mode, e.g. for tests).
+ * @param CRoute& route          : IN/OUT Route to be optimised
+ * @param double timeBudgetMs    : IN maximum time in milliseconds (ignored in deterministic mode)
+ * @param unsigned int noThreads : IN number of worker threads, 0 -> number of hardware threads
+ * @param unsigned int noRestarts: IN number of restarts for the deterministic mode, 0 -> time budget mode
+ * @param unsigned int seed      : IN base seed of the random number generators
+ * @returnvalue double : length of the Route in km after the optimisation
+ */
+double CRouteOptimizer::optimizeMultiStart(CRoute& route, double timeBudgetMs,
+		unsigned int noThreads, unsigned int noRestarts, unsigned int seed)
+{
+	vector<const CWaypoint*> stops = route.getRoute();
+	t_clock::time_point deadline =
+			(noRestarts != 0) ?
+					t_clock::time_point::max() : // deterministic mode, the number of restarts decides
+					t_clock::now()
+							+ chrono::microseconds(
+									(long long) (timeBudgetMs * 1000.0));
+
+	buildDistanceMatrix(stops);                  // shared read only by all threads
+
+	vector<unsigned int> userTour(m_noStops);
+	for (unsigned int i = 0; i < m_noStops; i++)
+		userTour[i] = i;
+
+	m_initialLength = tourLength(userTour);
+	m_optimizedLength = m_initialLength;
+	m_noRestarts = 0;
+
+	if (m_noStops < 4)
+		// with less than 2 intermediate stops there is nothing to reorder
+		return m_optimizedLength;
+
+	if (noThreads == 0)
+		noThreads = max(1u, thread::hardware_concurrency());
+
+	atomic<unsigned int> nextRestart(0);
+	vector<t_restartResult> results(noThreads);
+	vector<thread> workers;
+
+	for (unsigned int i = 0; i < noThreads; i++)
+		workers.push_back(
+				thread(&CRouteOptimizer::runRestarts, this, ref(nextRestart),
+						noRestarts, seed, cref(deadline), ref(results[i])));
+
+	for (unsigned int i = 0; i < noThreads; i++)
+		workers[i].join();
+
+	const t_restartResult* pBest = NULL;
+
+	for (unsigned int i = 0; i < noThreads; i++)
+	// best result of all threads, ties resolved by the restart number to stay independent of the scheduling
+	{
+		if (!results[i].tour.empty()
+				&& (pBest == NULL || results[i].length < pBest->length
+						|| (results[i].length == pBest->length
+								&& results[i].restart < pBest->restart)))
+			pBest = &results[i];
+	}
+
+	m_noRestarts = nextRestart.load();         // in deterministic mode each thread takes one number too much
+	if (noRestarts != 0 && m_noRestarts > noRestarts)
+		m_noRestarts = noRestarts;
+
+	if (pBest != NULL && pBest->length < m_initialLength)
+	// only a shorter order is written back to the Route
+	{
+		route.rebuildFromIndices(pBest->tour);
+		m_optimizedLength = pBest->length;
+	}
+
+	return m_optimizedLength;
+}
+
+/**
+ * Function returns the number of restarts run by the last call of optimizeMultiStart()
+ * @param no parameters
+ * @returnvalue unsigned int : number of restarts
+ */
+unsigned int CRouteOptimizer::getNoRestarts() const
+{
+	return m_noRestarts;
+}
+
+/**
+ * Function returns the length of the Route in km before the last optimisation
+ * @param no parameters
+ * @returnvalue double : length of the Route before the optimisation
+ */
+double CRouteOptimizer::getInitialLength() const
+{
+	return m_initialLength;
+}
+
+/**
+ * Function returns the length of the Route in km after the last optimisation
+ * @param no parameters
+ * @returnvalue double : length of the Route after the optimisation
+ */
+double CRouteOptimizer::getOptimizedLength() const
+{
+	return m_optimizedLength;
+}
+
+/**
+ * Function computes the distance between all pairs of stops and stores them in m_distanceMatrix
+ * @param const std::vector<const CWaypoint*>& stops : IN stops of the Route
+ * @returnvalue void
+ */
+void CRouteOptimizer::buildDistanceMatrix(
+		const vector<const CWaypoint*>& stops)
+{
+	CDistanceMatrix matrix(1);    // a Route has few stops, the calling thread computes the matrix
+
+	m_noStops = stops.size();
+	matrix.compute(stops, stops);
+	matrix.takeMatrix(m_distanceMatrix);
+}
+
+/**
+ * Function constructs a tour starting at the first stop, always continuing with the nearest stop
+ * not visited so far and ending at the last stop
+ * @param std::vector<unsigned int>& tour : OUT positions of the stops in visiting order
+ * @returnvalue void
+ */
+void CRouteOptimizer::constructNearestNeighbour(vector<unsigned int>& tour) const
+{
+	vector<bool> visited(m_noStops, false);
+	unsigned int current = 0;
+
+	tour.clear();
+	tour.push_back(0);
+	visited[0] = true;
+	visited[m_noStops - 1] = true;             // last stop is appended at the end
+
+	for (unsigned int step = 2; step < m_noStops; step++)
+	{
+		unsigned int nearest = 0;
+		double nearestDistance = -1.0;
+
+		for (unsigned int candidate = 1; candidate < m_noStops - 1; candidate++)
+		{
+			if (!visited[candidate]
+					&& (nearestDistance < 0.0
+							|| distance(current, candidate) < nearestDistance))
+			{
+				nearest = candidate;
+				nearestDistance = distance(current, candidate);
+			}
+		}
+
+		visited[nearest] = true;
+		tour.push_back(nearest);
+		current = nearest;
+	}
+
+	tour.push_back(m_noStops - 1);
+}
+
+/**
+ * Function constructs a nearest neighbour tour, but continues with a random one among the 3 nearest
+ * stops not visited so far. Used as starting point of the restarts.
+ * @param std::vector<unsigned int>& tour : OUT positions of the stops in visiting order
+ * @param std::mt19937& random            : IN/OUT random number generator
+ * @returnvalue void
+ */
+void CRouteOptimizer::constructRandomNearestNeighbour(
+		vector<unsigned int>& tour, mt19937& random) const
+{
+	vector<bool> visited(m_noStops, false);
+	unsigned int current = 0;
+
+	tour.clear();
+	tour.push_back(0);
+	visited[0] = true;
+	visited[m_noStops - 1] = true;             // last stop is appended at the end
+
+	for (unsigned int step = 2; step < m_noStops; step++)
+	{
+		unsigned int candidates[NO_RANDOM_CANDIDATES];
+		unsigned int noCandidates = 0;
+
+		for (unsigned int candidate = 1; candidate < m_noStops - 1; candidate++)
+		// keeping the NO_RANDOM_CANDIDATES nearest stops sorted by distance (insertion sort)
+		{
+			if (visited[candidate])
+				continue;
+
+			unsigned int pos = noCandidates;
+			while (pos > 0
+					&& distance(current, candidate)
+							< distance(current, candidates[pos - 1]))
+			{
+				if (pos < NO_RANDOM_CANDIDATES)
+					candidates[pos] = candidates[pos - 1];
+				pos--;
+			}
+			if (pos < NO_RANDOM_CANDIDATES)
+				candidates[pos] = candidate;
+			if (noCandidates < NO_RANDOM_CANDIDATES)
+				noCandidates++;
+		}
+
+		unsigned int next = candidates[random() % noCandidates];
+		visited[next] = true;
+		tour.push_back(next);
+		current = next;
+	}
+
+	tour.push_back(m_noStops - 1);
+}
+
+/**
+ * Function improves a tour by 2-opt and Or-opt moves until no move improves the tour or the deadline is reached
+ * @param std::vector<unsigned int>& tour     : IN/OUT tour to be improved
+ * @param const t_clock::time_point& deadline : IN time at which the improvement has to stop
+ * @returnvalue void
+ */
+void CRouteOptimizer::localSearch(vector<unsigned int>& tour,
+		const t_clock::time_point& deadline) const
+{
+	bool improved = true;
+
+	while (improved && t_clock::now() < deadline)
+	// alternate both neighbourhoods until none of them finds an improving move
+	{
+		improved = improveTwoOpt(tour, deadline);
+		improved = improveOrOpt(tour, deadline) || improved;
+	}
+}
+
+/**
+ * Function executed by each worker thread of optimizeMultiStart(). Takes the next restart number from
+ * 'nextRestart' until all restarts are done or the deadline is reached. Only reads the distance matrix.
+ * @param std::atomic<unsigned int>& nextRestart : IN/OUT shared counter of the restarts
+ * @param unsigned int noRestarts               : IN number of restarts, 0 -> until deadline
+ * @param unsigned int seed                     : IN base seed
+ * @param const t_clock::time_point& deadline   : IN time at which the restarts have to stop
+ * @param t_restartResult& best                 : OUT best tour found by this thread
+ * @returnvalue void
+ */
+void CRouteOptimizer::runRestarts(atomic<unsigned int>& nextRestart,
+		unsigned int noRestarts, unsigned int seed,
+		const t_clock::time_point& deadline, t_restartResult& best) const
+{
+	vector<unsigned int> tour;
+
+	best.tour.clear();
+	best.length = 0.0;
+	best.restart = 0;
+
+	while (t_clock::now() < deadline)
+	{
+		unsigned int restart = nextRestart++;
+
+		if (noRestarts != 0 && restart >= noRestarts)
+			// deterministic mode, all restarts are taken by the threads
+			break;
+
+		mt19937 random(seed + restart);        // each restart has its own reproducible random sequence
+
+		if (restart == 0)
+			// first restart is the plain nearest neighbour tour
+			constructNearestNeighbour(tour);
+		else
+			constructRandomNearestNeighbour(tour, random);
+
+		localSearch(tour, deadline);
+
+		double length = tourLength(tour);
+
+		if (best.tour.empty() || length < best.length
+				|| (length == best.length && restart < best.restart))
+		{
+			best.tour = tour;
+			best.length = length;
+			best.restart = restart;
+		}
+	}
+}
+
+/**
+ * Function applies improving 2-opt moves (reversal of a part of the tour) until no move improves the tour
+ * or the deadline is reached
+ * @param std::vector<unsigned int>& tour   : IN/OUT tour to be improved
+ * @param const t_clock::time_point& deadline : IN time at which the improvement has to stop
+ * @returnvalue true if the tour was improved
+ */
+bool CRouteOptimizer::improveTwoOpt(vector<unsigned int>& tour,
+		const t_clock::time_point& deadline) const
+{
+	bool improved = false;
+	bool moveFound = true;
+	unsigned int size = tour.size();
+
+	while (moveFound)
+	{
+		moveFound = false;
+
+		for (unsigned int i = 1; i + 2 < size; i++)
+		{
+			if (t_clock::now() >= deadline)
+				return improved;
+
+			for (unsigned int j = i + 1; j + 1 < size; j++)
+			{
+				// edges (i-1,i) and (j,j+1) are replaced by (i-1,j) and (i,j+1), part i..j is reversed
+				double delta = distance(tour[i - 1], tour[j])
+						+ distance(tour[i], tour[j + 1])
+						- distance(tour[i - 1], tour[i])
+						- distance(tour[j], tour[j + 1]);
+
+				if (delta < -MIN_IMPROVEMENT)
+				{
+					reverse(tour.begin() + i, tour.begin() + j + 1);
+					moveFound = true;
+					improved = true;
+				}
+			}
+		}
+	}
+	return improved;
+}
+
+/**
+ * Function applies improving Or-opt moves (moving a chain of up to 3 stops, optionally reversed, to another
+ * position of the tour) until no move improves the tour or the deadline is reached
+ * @param std::vector<unsigned int>& tour   : IN/OUT tour to be improved
+ * @param const t_clock::time_point& deadline : IN time at which the improvement has to stop
+ * @returnvalue true if the tour was improved
+ */
+bool CRouteOptimizer::improveOrOpt(vector<unsigned int>& tour,
+		const t_clock::time_point& deadline) const
+{
+	bool improved = false;
+	bool moveFound = true;
+	unsigned int size = tour.size();
+
+	while (moveFound)
+	{
+		moveFound = false;
+
+		for (unsigned int length = 1; length <= MAX_CHAIN_LENGTH; length++)
+		{
+			for (unsigned int i = 1; i + length < size; i++)
+			{
+				if (t_clock::now() >= deadline)
+					return improved;
+
+				// chain tour[i] .. tour[last] is cut out between prev and next
+				unsigned int last = i + length - 1;
+				unsigned int prev = tour[i - 1], next = tour[last + 1];
+				unsigned int first = tour[i], end = tour[last];
+
+				double removeGain = distance(prev, first) + distance(end, next)
+						- distance(prev, next);
+
+				for (unsigned int j = 0; j + 1 < size; j++)
+				{
+					if (j + 1 >= i && j <= last)
+						// insertion point must lie outside of the chain and its neighbouring edges
+						continue;
+
+					unsigned int a = tour[j], b = tour[j + 1];
+					double insertCost = distance(a, first) + distance(end, b)
+							- distance(a, b);
+					double insertCostReversed = distance(a, end)
+							+ distance(first, b) - distance(a, b);
+					bool reversed = insertCostReversed < insertCost;
+
+					if (removeGain - min(insertCost, insertCostReversed)
+							> MIN_IMPROVEMENT)
+					{
+						vector<unsigned int> chain(tour.begin() + i,
+								tour.begin() + last + 1);
+						if (reversed)
+							reverse(chain.begin(), chain.end());
+
+						tour.erase(tour.begin() + i, tour.begin() + last + 1);
+						unsigned int insertPos = (j < i) ? j + 1 : j + 1 - length; // position of b after the chain was removed
+						tour.insert(tour.begin() + insertPos, chain.begin(),
+								chain.end());
+
+						moveFound = true;
+						improved = true;
+						break;
+					}
+				}
+			}
+		}
+	}
+	return improved;
+}
+
+/**
+ * Function calculates the length of a tour using the distance matrix
+ * @param const std::vector<unsigned int>& tour : IN tour
+ * @returnvalue double : length of the tour in km
+ */
+double CRouteOptimizer::tourLength(const vector<unsigned int>& tour) const
+{
+	double length = 0.0;
+
+	for (unsigned int i = 1; i < tour.size(); i++)
+		length += distance(tour[i - 1], tour[i]);
+
+	return length;
+}
@@ -0,0 +1,196 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CROUTEOPTIMIZER.H
+ * Author          : George Sebastian
+ * Description     : CRouteOptimizer reorders the stops of a Route in order to minimise
+ *                   the total great circle length of the Route. The first and the last
+ *                   element of the Route are kept fixed, all intermediate stops (WPs and POIs)
+ *                   are reordered. A nearest neighbour tour is constructed first and then
+ *                   improved by 2-opt and Or-opt moves until no move improves the Route any
+ *                   more or the time budget is used up. All distances are taken from a
+ *                   distance matrix which is computed once per Route.
+ *                   optimizeMultiStart() runs many randomised restarts of the local search
+ *                   in parallel threads, which share the distance matrix read only, and keeps
+ *                   the best tour.
+ ****************************************************************************/
+#ifndef CROUTEOPTIMIZER_H
+#define CROUTEOPTIMIZER_H
+
+#include <vector>
+#include <chrono>
+#include <random>
+#include <atomic>
+
+#include "CRoute.h"
+
+class CRouteOptimizer
+{
+public:
+
+	/**
+	 * Constructor of class CRouteOptimizer
+	 * @param no parameters
+	 * @return no value
+	 */
+	CRouteOptimizer();
+
+	/**
+	 * Function reorders the intermediate stops of the Route so that the total length of the Route is minimised.
+	 * First and last element of the Route are not moved. The Route is only changed if a shorter order was found.
+	 * @param CRoute& route       : IN/OUT Route to be optimised
+	 * @param double timeBudgetMs : IN maximum time in milliseconds spent for the improvement phase
+	 * @returnvalue double : length of the Route in km after the optimisation
+	 */
+	double optimize(CRoute& route, double timeBudgetMs);
+
+	/**
+	 * Function reorders the intermediate stops of the Route like optimize(), but runs many restarts of the
+	 * local search from randomised nearest neighbour tours in parallel and keeps the best tour found.
+	 * In case 'noRestarts' is 0, restarts are run until the time budget is used up (more threads -> more restarts).
+	 * Otherwise exactly 'noRestarts' restarts are run independent of the time budget; restart r always uses
+	 * the random seed 'seed' + r and ties are resolved by the lower restart number, so the result does not
+	 * depend on the number of threads or the timing (deterministic mode, e.g. for tests).
+	 * @param CRoute& route          : IN/OUT Route to be optimised
+	 * @param double timeBudgetMs    : IN maximum time in milliseconds (ignored in deterministic mode)
+	 * @param unsigned int noThreads : IN number of worker threads, 0 -> number of hardware threads
+	 * @param unsigned int noRestarts: IN number of restarts for the deterministic mode, 0 -> time budget mode
+	 * @param unsigned int seed      : IN base seed of the random number generators
+	 * @returnvalue double : length of the Route in km after the optimisation
+	 */
+	double optimizeMultiStart(CRoute& route, double timeBudgetMs,
+			unsigned int noThreads, unsigned int noRestarts = 0,
+			unsigned int seed = 0);
+
+	/**
+	 * Function returns the number of restarts run by the last call of optimizeMultiStart()
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of restarts
+	 */
+	unsigned int getNoRestarts() const;
+
+	/**
+	 * Function returns the length of the Route in km before the last optimisation
+	 * @param no parameters
+	 * @returnvalue double : length of the Route before the optimisation
+	 */
+	double getInitialLength() const;
+
+	/**
+	 * Function returns the length of the Route in km after the last optimisation
+	 * @param no parameters
+	 * @returnvalue double : length of the Route after the optimisation
+	 */
+	double getOptimizedLength() const;
+
+private:
+
+	typedef std::chrono::steady_clock t_clock;
+
+	/*
+	 * best tour found by one worker thread of optimizeMultiStart()
+	 */
+	struct t_restartResult
+	{
+		std::vector<unsigned int> tour;
+		double length;
+		unsigned int restart;
+	};
+
+	/**
+	 * Function computes the distance between all pairs of stops and stores them in m_distanceMatrix
+	 * @param const std::vector<const CWaypoint*>& stops : IN stops of the Route
+	 * @returnvalue void
+	 */
+	void buildDistanceMatrix(const std::vector<const CWaypoint*>& stops);
+
+	/**
+	 * Function returns the precomputed distance between two stops
+	 * @param unsigned int from : IN position of the first stop
+	 * @param unsigned int to   : IN position of the second stop
+	 * @returnvalue double : distance in km
+	 */
+	double distance(unsigned int from, unsigned int to) const
+	{
+		return m_distanceMatrix[from * m_noStops + to];
+	}
+
+	/**
+	 * Function constructs a tour starting at the first stop, always continuing with the nearest stop
+	 * not visited so far and ending at the last stop
+	 * @param std::vector<unsigned int>& tour : OUT positions of the stops in visiting order
+	 * @returnvalue void
+	 */
+	void constructNearestNeighbour(std::vector<unsigned int>& tour) const;
+
+	/**
+	 * Function constructs a nearest neighbour tour, but continues with a random one among the 3 nearest
+	 * stops not visited so far. Used as starting point of the restarts.
+	 * @param std::vector<unsigned int>& tour : OUT positions of the stops in visiting order
+	 * @param std::mt19937& random            : IN/OUT random number generator
+	 * @returnvalue void
+	 */
+	void constructRandomNearestNeighbour(std::vector<unsigned int>& tour,
+			std::mt19937& random) const;
+
+	/**
+	 * Function improves a tour by 2-opt and Or-opt moves until no move improves the tour or the deadline is reached
+	 * @param std::vector<unsigned int>& tour     : IN/OUT tour to be improved
+	 * @param const t_clock::time_point& deadline : IN time at which the improvement has to stop
+	 * @returnvalue void
+	 */
+	void localSearch(std::vector<unsigned int>& tour,
+			const t_clock::time_point& deadline) const;
+
+	/**
+	 * Function executed by each worker thread of optimizeMultiStart(). Takes the next restart number from
+	 * 'nextRestart' until all restarts are done or the deadline is reached. Only reads the distance matrix.
+	 * @param std::atomic<unsigned int>& nextRestart : IN/OUT shared counter of the restarts
+	 * @param unsigned int noRestarts               : IN number of restarts, 0 -> until deadline
+	 * @param unsigned int seed                     : IN base seed
+	 * @param const t_clock::time_point& deadline   : IN time at which the restarts have to stop
+	 * @param t_restartResult& best                 : OUT best tour found by this thread
+	 * @returnvalue void
+	 */
+	void runRestarts(std::atomic<unsigned int>& nextRestart,
+			unsigned int noRestarts, unsigned int seed,
+			const t_clock::time_point& deadline, t_restartResult& best) const;
+
+	/**
+	 * Function applies improving 2-opt moves (reversal of a part of the tour) until no move improves the tour
+	 * or the deadline is reached
+	 * @param std::vector<unsigned int>& tour   : IN/OUT tour to be improved
+	 * @param const t_clock::time_point& deadline : IN time at which the improvement has to stop
+	 * @returnvalue true if the tour was improved
+	 */
+	bool improveTwoOpt(std::vector<unsigned int>& tour,
+			const t_clock::time_point& deadline) const;
+
+	/**
+	 * Function applies improving Or-opt moves (moving a chain of up to 3 stops, optionally reversed, to another
+	 * position of the tour) until no move improves the tour or the deadline is reached
+	 * @param std::vector<unsigned int>& tour   : IN/OUT tour to be improved
+	 * @param const t_clock::time_point& deadline : IN time at which the improvement has to stop
+	 * @returnvalue true if the tour was improved
+	 */
+	bool improveOrOpt(std::vector<unsigned int>& tour,
+			const t_clock::time_point& deadline) const;
+
+	/**
+	 * Function calculates the length of a tour using the distance matrix
+	 * @param const std::vector<unsigned int>& tour : IN tour
+	 * @returnvalue double : length of the tour in km
+	 */
+	double tourLength(const std::vector<unsigned int>& tour) const;
+
+	std::vector<double> m_distanceMatrix; // row major, m_noStops x m_noStops
+	unsigned int m_noStops;
+
+	double m_initialLength;
+	double m_optimizedLength;
+	unsigned int m_noRestarts;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CROUTEOPTIMIZER_H */
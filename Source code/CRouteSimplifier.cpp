@@ -0,0 +1,195 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CROUTESIMPLIFIER.CPP
+ * Author          : George Sebastian
+ * Description     : CRouteSimplifier reduces the number of points of a Route (polyline)
+ *                   for export and printing. Points are removed in the order of their
+ *                   importance (Visvalingam-Whyatt, importance = great circle distance
+ *                   to the segment between the neighbouring points) using a heap, which
+ *                   gives O(n log n). The importance includes an upper bound of the
+ *                   deviation of all points removed before, so every removed point stays
+ *                   within the tolerance (in metres) of the simplified polyline.
+ *                   POIs, the first and the last point of the Route are never removed.
+ *                   The result is available as view (positions/pointers of the kept
+ *                   points) or as new CRoute.
+ ****************************************************************************/
+#include <queue>
+#include <vector>
+#include <functional>
+using namespace std;
+
+#include "CRouteSimplifier.h"
+#include "CUnitVector.h"
+
+/*
+ * entry of the heap of removable points, outdated entries are recognised by the version
+ */
+struct t_heapEntry
+{
+	double importance;
+	unsigned int index;
+	unsigned int version;
+
+	bool operator>(const t_heapEntry& rop) const
+	{
+		return importance > rop.importance;
+	}
+};
+
+/**
+ * Constructor of class CRouteSimplifier
+ * @param double toleranceMetres : IN maximum distance in metres of a removed point to the simplified polyline
+ * @return no value
+ */
+CRouteSimplifier::CRouteSimplifier(double toleranceMetres)
+{
+	setTolerance(toleranceMetres);
+}
+
+/**
+ * Function sets the tolerance of the simplification
+ * @param double toleranceMetres : IN maximum distance in metres of a removed point to the simplified polyline
+ * @returnvalue void
+ */
+void CRouteSimplifier::setTolerance(double toleranceMetres)
+{
+	m_toleranceKm = toleranceMetres / 1000.0;  // all distances are calculated in km
+}
+
+/**
+ * Function simplifies the Route and returns the positions (see CRoute::getRoute()) of the kept points
+ * @param const CRoute& route                        : IN Route to be simplified, Route is not changed
+ * @param std::vector<unsigned int>& keptIndices : OUT positions of the kept points in ascending order
+ * @returnvalue void
+ */
+void CRouteSimplifier::simplify(const CRoute& route, vector<unsigned int>& keptIndices)
+{
+	simplifyPolyline(route.getRouteView(), keptIndices);
+}
+
+/**
+ * Function simplifies the Route and returns the kept points (view on the elements of the Route)
+ * @param const CRoute& route                           : IN Route to be simplified, Route is not changed
+ * @param std::vector<const CWaypoint*>& keptPoints : OUT kept points in the order of the Route
+ * @returnvalue void
+ */
+void CRouteSimplifier::simplify(const CRoute& route,
+		vector<const CWaypoint*>& keptPoints)
+{
+	vector<const CWaypoint*> points = route.getRoute();
+	vector<unsigned int> keptIndices;
+
+	simplifyPolyline(route.getRouteView(), keptIndices);
+
+	keptPoints.clear();
+	for (unsigned int i = 0; i < keptIndices.size(); i++)
+		keptPoints.push_back(points[keptIndices[i]]);
+}
+
+/**
+ * Function returns a new Route containing only the kept points. The new Route is connected to the same databases.
+ * @param const CRoute& route : IN Route to be simplified, Route is not changed
+ * @returnvalue CRoute : simplified Route
+ */
+CRoute CRouteSimplifier::simplifiedRoute(const CRoute& route)
+{
+	vector<unsigned int> keptIndices;
+	simplify(route, keptIndices);
+
+	CRoute result = route;                     // same databases, elements are dropped afterwards
+	result.rebuildFromIndices(keptIndices);
+
+	return result;
+}
+
+/**
+ * Function simplifies a polyline
+ * @param const CRouteView& points              : IN points of the polyline
+ * @param std::vector<unsigned int>& keptIndices : OUT positions of the kept points in ascending order
+ * @returnvalue void
+ */
+void CRouteSimplifier::simplifyPolyline(const CRouteView& points,
+		vector<unsigned int>& keptIndices) const
+{
+	unsigned int size = points.size();
+
+	vector<CUnitVector> position(size);
+	vector<unsigned int> prev(size), next(size), version(size, 0);
+	vector<double> deviation(size, 0.0); // distance of the point to the segment between its neighbours
+	vector<double> spanError(size, 0.0); // upper bound of the distance of the removed points between the point and its next neighbour to the segment
+	vector<bool> fixed(size, false), removed(size, false);
+
+	priority_queue<t_heapEntry, vector<t_heapEntry>, greater<t_heapEntry> > heap;
+
+	unsigned int i = 0;
+	for (CRouteView::const_iterator itr = points.begin(); itr != points.end();
+			++itr, i++)
+	{
+		position[i] = CUnitVector::fromWaypoint(*itr->pWaypoint);
+		prev[i] = (i > 0) ? i - 1 : 0;
+		next[i] = i + 1;
+
+		// POIs, start and end of the Route are never removed
+		fixed[i] = (i == 0 || i + 1 == size || itr->isPoi());
+	}
+
+	for (unsigned int i = 1; i + 1 < size; i++)
+	{
+		if (!fixed[i])
+		{
+			deviation[i] = position[i].distanceToSegment(position[i - 1],
+					position[i + 1]);
+			t_heapEntry entry = { deviation[i], i, 0 };
+			heap.push(entry);
+		}
+	}
+
+	while (!heap.empty())
+	{
+		t_heapEntry entry = heap.top();
+		heap.pop();
+
+		unsigned int i = entry.index;
+
+		if (removed[i] || entry.version != version[i])
+			// outdated entry, the point was removed or its importance changed
+			continue;
+
+		if (entry.importance > m_toleranceKm)
+			// all remaining points are more important than the tolerance allows
+			break;
+
+		// removing point i, the removed points around i are now represented by the segment prev - next
+		unsigned int p = prev[i], n = next[i];
+		removed[i] = true;
+		spanError[p] = max(spanError[p], spanError[i]) + deviation[i];
+		next[p] = n;
+		prev[n] = p;
+
+		unsigned int neighbours[2] = { p, n };
+		for (unsigned int k = 0; k < 2; k++)
+		// importance of the neighbours changed
+		{
+			unsigned int j = neighbours[k];
+
+			if (fixed[j])
+				continue;
+
+			deviation[j] = position[j].distanceToSegment(position[prev[j]],
+					position[next[j]]);
+			version[j]++;
+
+			t_heapEntry update = { deviation[j]
+					+ max(spanError[prev[j]], spanError[j]), j, version[j] };
+			heap.push(update);
+		}
+	}
+
+	keptIndices.clear();
+	for (unsigned int i = 0; i < size; i++)
+	{
+		if (!removed[i])
+			keptIndices.push_back(i);
+	}
+}
@@ -0,0 +1,81 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CROUTESIMPLIFIER.H
+ * Author          : George Sebastian
+ * Description     : CRouteSimplifier reduces the number of points of a Route (polyline)
+ *                   for export and printing. Points are removed in the order of their
+ *                   importance (Visvalingam-Whyatt, importance = great circle distance
+ *                   to the segment between the neighbouring points) using a heap, which
+ *                   gives O(n log n). The importance includes an upper bound of the
+ *                   deviation of all points removed before, so every removed point stays
+ *                   within the tolerance (in metres) of the simplified polyline.
+ *                   POIs, the first and the last point of the Route are never removed.
+ *                   The result is available as view (positions/pointers of the kept
+ *                   points) or as new CRoute.
+ ****************************************************************************/
+#ifndef CROUTESIMPLIFIER_H
+#define CROUTESIMPLIFIER_H
+
+#include <vector>
+
+#include "CRoute.h"
+
+class CRouteSimplifier
+{
+public:
+
+	/**
+	 * Constructor of class CRouteSimplifier
+	 * @param double toleranceMetres : IN maximum distance in metres of a removed point to the simplified polyline
+	 * @return no value
+	 */
+	CRouteSimplifier(double toleranceMetres = 10.0);
+
+	/**
+	 * Function sets the tolerance of the simplification
+	 * @param double toleranceMetres : IN maximum distance in metres of a removed point to the simplified polyline
+	 * @returnvalue void
+	 */
+	void setTolerance(double toleranceMetres);
+
+	/**
+	 * Function simplifies the Route and returns the positions (see CRoute::getRoute()) of the kept points
+	 * @param const CRoute& route                        : IN Route to be simplified, Route is not changed
+	 * @param std::vector<unsigned int>& keptIndices : OUT positions of the kept points in ascending order
+	 * @returnvalue void
+	 */
+	void simplify(const CRoute& route, std::vector<unsigned int>& keptIndices);
+
+	/**
+	 * Function simplifies the Route and returns the kept points (view on the elements of the Route)
+	 * @param const CRoute& route                           : IN Route to be simplified, Route is not changed
+	 * @param std::vector<const CWaypoint*>& keptPoints : OUT kept points in the order of the Route
+	 * @returnvalue void
+	 */
+	void simplify(const CRoute& route, std::vector<const CWaypoint*>& keptPoints);
+
+	/**
+	 * Function returns a new Route containing only the kept points. The new Route is connected to the same databases.
+	 * @param const CRoute& route : IN Route to be simplified, Route is not changed
+	 * @returnvalue CRoute : simplified Route
+	 */
+	CRoute simplifiedRoute(const CRoute& route);
+
+private:
+
+	/**
+	 * Function simplifies a polyline
+	 * @param const CRouteView& points              : IN points of the polyline
+	 * @param std::vector<unsigned int>& keptIndices : OUT positions of the kept points in ascending order
+	 * @returnvalue void
+	 */
+	void simplifyPolyline(const CRouteView& points,
+			std::vector<unsigned int>& keptIndices) const;
+
+	double m_toleranceKm;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CROUTESIMPLIFIER_H */
@@ -0,0 +1,213 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CROUTETABLE.CPP
+ * Author          : George Sebastian
+ * Description     : CRouteTable copies the elements of a Route into arrays. The nearest POI
+ *                   is the one with the largest dot product of the unit vectors (smallest
+ *                   angle), only its distance is computed with trigonometry.
+ ****************************************************************************/
+#include <string>
+using namespace std;
+
+#include "CRouteTable.h"
+#include "CPOI.h"
+
+/**
+ * Constructor of class CRouteTable, the table is empty
+ * @param no parameters
+ * @return no value
+ */
+CRouteTable::CRouteTable()
+{
+}
+
+/**
+ * Function copies the elements of a Route into the table
+ * @param const CRoute& route : IN Route
+ * @returnvalue void
+ */
+void CRouteTable::build(const CRoute& route)
+{
+	CRouteView view = route.getRouteView();
+
+	m_kind.clear();
+	m_payload.clear();
+	m_x.clear();
+	m_y.clear();
+	m_z.clear();
+	m_pWaypoints.clear();
+	m_pPois.clear();
+	m_poiX.clear();
+	m_poiY.clear();
+	m_poiZ.clear();
+	m_poiCategory.clear();
+
+	for (CRouteView::const_iterator itr = view.begin(); itr != view.end();
+			++itr)
+	{
+		CUnitVector position = CUnitVector::fromWaypoint(*itr->pWaypoint);
+
+		m_kind.push_back(itr->kind);
+		m_x.push_back(position.m_x);
+		m_y.push_back(position.m_y);
+		m_z.push_back(position.m_z);
+
+		if (itr->isPoi())
+		{
+			string name, description;
+			double latitude, longitude;
+			CPOI::t_poi type;
+
+			itr->getPoi()->getAllDataByReference(name, latitude, longitude, type,
+					description);
+
+			m_payload.push_back(m_pPois.size());
+			m_pPois.push_back(itr->getPoi());
+			m_poiX.push_back(position.m_x);
+			m_poiY.push_back(position.m_y);
+			m_poiZ.push_back(position.m_z);
+			m_poiCategory.push_back(type);
+		}
+		else
+		{
+			m_payload.push_back(m_pWaypoints.size());
+			m_pWaypoints.push_back(itr->pWaypoint);
+		}
+	}
+}
+
+/**
+ * Function returns the number of elements
+ * @param no parameters
+ * @returnvalue unsigned int : number of Waypoints and POIs of the Route
+ */
+unsigned int CRouteTable::size() const
+{
+	return m_kind.size();
+}
+
+/**
+ * Function returns the number of POIs
+ * @param no parameters
+ * @returnvalue unsigned int : number of POIs of the Route
+ */
+unsigned int CRouteTable::getNoPois() const
+{
+	return m_pPois.size();
+}
+
+/**
+ * Function returns the kind of an element
+ * @param unsigned int element : IN position in the Route
+ * @returnvalue t_routeElementKind : ROUTE_WAYPOINT or ROUTE_POI
+ */
+t_routeElementKind CRouteTable::getKind(unsigned int element) const
+{
+	return (t_routeElementKind) m_kind[element];
+}
+
+/**
+ * Function returns the position of an element
+ * @param unsigned int element : IN position in the Route
+ * @returnvalue CUnitVector : position
+ */
+CUnitVector CRouteTable::getPosition(unsigned int element) const
+{
+	return CUnitVector(m_x[element], m_y[element], m_z[element]);
+}
+
+/**
+ * Function returns the Waypoint or POI of an element
+ * @param unsigned int element : IN position in the Route
+ * @returnvalue const CWaypoint* : object in the database
+ */
+const CWaypoint* CRouteTable::getWaypoint(unsigned int element) const
+{
+	if (m_kind[element] == ROUTE_POI)
+		return m_pPois[m_payload[element]];
+
+	return m_pWaypoints[m_payload[element]];
+}
+
+/**
+ * Function returns a POI of the table
+ * @param unsigned int poi : IN number of the POI, 0 .. getNoPois() - 1 in the order of the Route
+ * @returnvalue const CPOI* : POI in the POI Database
+ */
+const CPOI* CRouteTable::getPoi(unsigned int poi) const
+{
+	return m_pPois[poi];
+}
+
+/**
+ * Function searches the nearest POI of the Route, the first of several POIs with the same distance is taken
+ * @param const CUnitVector& position : IN position
+ * @param double& distanceKm          : OUT great circle distance to the POI
+ * @returnvalue int : number of the POI, -1 if the Route has no POI
+ */
+int CRouteTable::getNearestPoi(const CUnitVector& position,
+		double& distanceKm) const
+{
+	const double* pX = m_poiX.data();
+	const double* pY = m_poiY.data();
+	const double* pZ = m_poiZ.data();
+	unsigned int noPois = m_poiX.size();
+	double bestDot = -2.0;              // below the dot product of any two unit vectors
+	int nearest = -1;
+
+	for (unsigned int i = 0; i < noPois; i++)
+	{
+		double dot = position.m_x * pX[i] + position.m_y * pY[i]
+				+ position.m_z * pZ[i];
+
+		if (dot > bestDot)
+		{
+			bestDot = dot;
+			nearest = i;
+		}
+	}
+
+	if (nearest >= 0)
+		distanceKm = position.distanceTo(
+				CUnitVector(pX[nearest], pY[nearest], pZ[nearest]));
+
+	return nearest;
+}
+
+/**
+ * Function searches the nearest POI of the Route of some categories, the first of several POIs with the
+ * same distance is taken
+ * @param const CUnitVector& position        : IN position
+ * @param const CPoiCategoryFilter& filter   : IN categories of the POIs
+ * @param double& distanceKm                 : OUT great circle distance to the POI
+ * @returnvalue int : number of the POI, -1 if the Route has no POI of the categories
+ */
+int CRouteTable::getNearestPoi(const CUnitVector& position,
+		const CPoiCategoryFilter& filter, double& distanceKm) const
+{
+	const double* pX = m_poiX.data();
+	const double* pY = m_poiY.data();
+	const double* pZ = m_poiZ.data();
+	unsigned int noPois = m_poiX.size();
+	double bestDot = -2.0;
+	int nearest = -1;
+
+	for (unsigned int i = 0; i < noPois; i++)
+	{
+		double dot = position.m_x * pX[i] + position.m_y * pY[i]
+				+ position.m_z * pZ[i];
+
+		if (dot > bestDot && filter.contains(m_poiCategory[i]))
+		{
+			bestDot = dot;
+			nearest = i;
+		}
+	}
+
+	if (nearest >= 0)
+		distanceKm = position.distanceTo(
+				CUnitVector(pX[nearest], pY[nearest], pZ[nearest]));
+
+	return nearest;
+}
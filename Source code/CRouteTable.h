@@ -0,0 +1,129 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CROUTETABLE.H
+ * Author          : George Sebastian
+ * Description     : CRouteTable is a value typed copy of the elements of a Route for the
+ *                   loops which run many times over the same Route (e.g. the nearest POI
+ *                   of every position update). Each element is a kind byte and a payload
+ *                   index : the number of the Waypoint or of the POI in the table. The
+ *                   positions are stored as unit vectors in separate arrays of doubles,
+ *                   the POIs additionally in arrays of their own with their categories.
+ *                   A search for the nearest POI runs over these arrays with dot products
+ *                   only : no pointers to the objects, no virtual functions, no
+ *                   trigonometry in the loop.
+ *                   CWaypoint and CPOI remain the interface to the user : the table keeps
+ *                   pointers to the objects in the databases and returns them for the
+ *                   results. The table has to be built again after the Route was changed.
+ ****************************************************************************/
+#ifndef CROUTETABLE_H
+#define CROUTETABLE_H
+
+#include <vector>
+#include <stdint.h>
+
+#include "CRoute.h"
+#include "CRouteView.h"
+#include "CUnitVector.h"
+#include "CPoiCategoryFilter.h"
+
+class CRouteTable
+{
+public:
+
+	/**
+	 * Constructor of class CRouteTable, the table is empty
+	 * @param no parameters
+	 * @return no value
+	 */
+	CRouteTable();
+
+	/**
+	 * Function copies the elements of a Route into the table
+	 * @param const CRoute& route : IN Route
+	 * @returnvalue void
+	 */
+	void build(const CRoute& route);
+
+	/**
+	 * Function returns the number of elements
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of Waypoints and POIs of the Route
+	 */
+	unsigned int size() const;
+
+	/**
+	 * Function returns the number of POIs
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of POIs of the Route
+	 */
+	unsigned int getNoPois() const;
+
+	/**
+	 * Function returns the kind of an element
+	 * @param unsigned int element : IN position in the Route
+	 * @returnvalue t_routeElementKind : ROUTE_WAYPOINT or ROUTE_POI
+	 */
+	t_routeElementKind getKind(unsigned int element) const;
+
+	/**
+	 * Function returns the position of an element
+	 * @param unsigned int element : IN position in the Route
+	 * @returnvalue CUnitVector : position
+	 */
+	CUnitVector getPosition(unsigned int element) const;
+
+	/**
+	 * Function returns the Waypoint or POI of an element
+	 * @param unsigned int element : IN position in the Route
+	 * @returnvalue const CWaypoint* : object in the database
+	 */
+	const CWaypoint* getWaypoint(unsigned int element) const;
+
+	/**
+	 * Function returns a POI of the table
+	 * @param unsigned int poi : IN number of the POI, 0 .. getNoPois() - 1 in the order of the Route
+	 * @returnvalue const CPOI* : POI in the POI Database
+	 */
+	const CPOI* getPoi(unsigned int poi) const;
+
+	/**
+	 * Function searches the nearest POI of the Route, the first of several POIs with the same distance is taken
+	 * @param const CUnitVector& position : IN position
+	 * @param double& distanceKm          : OUT great circle distance to the POI
+	 * @returnvalue int : number of the POI, -1 if the Route has no POI
+	 */
+	int getNearestPoi(const CUnitVector& position, double& distanceKm) const;
+
+	/**
+	 * Function searches the nearest POI of the Route of some categories, the first of several POIs with the
+	 * same distance is taken
+	 * @param const CUnitVector& position        : IN position
+	 * @param const CPoiCategoryFilter& filter   : IN categories of the POIs
+	 * @param double& distanceKm                 : OUT great circle distance to the POI
+	 * @returnvalue int : number of the POI, -1 if the Route has no POI of the categories
+	 */
+	int getNearestPoi(const CUnitVector& position,
+			const CPoiCategoryFilter& filter, double& distanceKm) const;
+
+private:
+
+	// elements of the Route
+	std::vector<uint8_t> m_kind;                // t_routeElementKind
+	std::vector<uint32_t> m_payload;            // number of the Waypoint or of the POI
+	std::vector<double> m_x;                    // position as unit vector
+	std::vector<double> m_y;
+	std::vector<double> m_z;
+
+	// payloads
+	std::vector<const CWaypoint*> m_pWaypoints;
+	std::vector<const CPOI*> m_pPois;
+	std::vector<double> m_poiX;                 // position of the POIs as unit vector
+	std::vector<double> m_poiY;
+	std::vector<double> m_poiZ;
+	std::vector<t_poiCategory> m_poiCategory;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CROUTETABLE_H */
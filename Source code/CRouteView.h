@@ -0,0 +1,120 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CROUTEVIEW.H
+ * Author          : George Sebastian
+ * Description     : CRouteView is a read only view on the elements of a Route.
+ *                   It only refers to the list inside of CRoute, so iterating through
+ *                   the Route does not copy or allocate anything. Each element knows
+ *                   whether it is a Waypoint or a POI, no dynamic_cast is needed.
+ *                   The view is valid as long as the Route is not changed.
+ ****************************************************************************/
+#ifndef CROUTEVIEW_H
+#define CROUTEVIEW_H
+
+#include <list>
+
+#include "CWaypoint.h"
+#include "CPOI.h"
+
+/*
+ * kind of an element of the Route
+ */
+typedef enum routeElementKind
+{
+	ROUTE_WAYPOINT, ROUTE_POI
+} t_routeElementKind;
+
+/*
+ * element of a Route : pointer to the WP/POI in the database and its kind
+ */
+struct t_routeElement
+{
+	const CWaypoint* pWaypoint;
+	t_routeElementKind kind;
+
+	/**
+	 * Function returns true if the element is a POI
+	 * @param no parameters
+	 * @returnvalue bool : true for POI, false for Waypoint
+	 */
+	bool isPoi() const
+	{
+		return kind == ROUTE_POI;
+	}
+
+	/**
+	 * Function returns the element as POI
+	 * @param no parameters
+	 * @returnvalue const CPOI* : pointer to the POI, NULL if the element is a Waypoint
+	 */
+	const CPOI* getPoi() const
+	{
+		return (kind == ROUTE_POI) ? static_cast<const CPOI*>(pWaypoint) : NULL;
+	}
+};
+
+class CRouteView
+{
+public:
+
+	typedef std::list<t_routeElement>::const_iterator const_iterator;
+
+	/**
+	 * Constructor of class CRouteView
+	 * @param const std::list<t_routeElement>& elements : IN elements of the Route
+	 * @return no value
+	 */
+	CRouteView(const std::list<t_routeElement>& elements) :
+			m_pElements(&elements)
+	{
+	}
+
+	/**
+	 * Function returns the iterator to the first element of the Route
+	 * @param no parameters
+	 * @returnvalue const_iterator : iterator to the first element
+	 */
+	const_iterator begin() const
+	{
+		return m_pElements->begin();
+	}
+
+	/**
+	 * Function returns the iterator behind the last element of the Route
+	 * @param no parameters
+	 * @returnvalue const_iterator : iterator behind the last element
+	 */
+	const_iterator end() const
+	{
+		return m_pElements->end();
+	}
+
+	/**
+	 * Function returns the number of elements of the Route
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of elements
+	 */
+	unsigned int size() const
+	{
+		return m_pElements->size();
+	}
+
+	/**
+	 * Function returns true if the Route has no elements
+	 * @param no parameters
+	 * @returnvalue bool : true for an empty Route
+	 */
+	bool empty() const
+	{
+		return m_pElements->empty();
+	}
+
+private:
+
+	const std::list<t_routeElement>* m_pElements;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CROUTEVIEW_H */
@@ -0,0 +1,223 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CSENSORPRODUCER.CPP
+ * Author          : George Sebastian
+ * Description     : CSensorProducer reads the fixes of a sensor (GPS Sensor, NMEA replay,
+ *                   ...) in its own thread and passes them to the navigation loop through
+ *                   a lock free ring buffer. Blocking I/O and parsing of the sensor never
+ *                   delay the Route and POI calculations of the navigation loop.
+ *                   Each fix is stamped when it arrives from the sensor, the latency until
+ *                   the navigation loop takes it from the buffer is counted in a histogram.
+ *                   Fixes which do not fit into the full buffer are counted as overruns.
+ ****************************************************************************/
+#include <iostream>
+using namespace std;
+
+#include "CSensorProducer.h"
+
+/**
+ * Constructor of class CSensorProducer
+ * @param CPositionSensor& sensor  : IN sensor to be read, must stay valid as long as the producer exists
+ * @param unsigned int capacity    : IN number of fixes in the ring buffer
+ * @param t_overrunPolicy policy   : IN behaviour if the buffer is full
+ * @return no value
+ */
+CSensorProducer::CSensorProducer(CPositionSensor& sensor,
+		unsigned int capacity, t_overrunPolicy policy) :
+		m_buffer(capacity)
+{
+	m_pSensor = &sensor;
+	m_policy = policy;
+	m_stopRequested = false;
+	m_endOfInput = false;
+	m_noFixes = 0;
+	m_noOverruns = 0;
+	m_noDroppedFixes = 0;
+	m_noSkippedFixes = 0;
+}
+
+/**
+ * Destructor of class CSensorProducer, stops the producer thread
+ * @param no parameters
+ * @return no value
+ */
+CSensorProducer::~CSensorProducer()
+{
+	stop();
+}
+
+/**
+ * Function starts the producer thread
+ * @param no parameters
+ * @returnvalue void
+ */
+void CSensorProducer::start()
+{
+	if (m_thread.joinable())
+		// already running
+		return;
+
+	m_stopRequested = false;
+	m_endOfInput = false;
+	m_thread = thread(&CSensorProducer::produce, this);
+}
+
+/**
+ * Function stops the producer thread. Waits until the sensor returns from the current read.
+ * @param no parameters
+ * @returnvalue void
+ */
+void CSensorProducer::stop()
+{
+	m_stopRequested = true;
+
+	if (m_thread.joinable())
+		m_thread.join();
+}
+
+/**
+ * Function takes the oldest fix from the buffer without waiting. Only called by the navigation loop.
+ * @param t_gpsFix& fix : OUT oldest fix
+ * @returnvalue true if a fix was available
+ */
+bool CSensorProducer::popFix(t_gpsFix& fix)
+{
+	t_timedFix timedFix;
+
+	if (!m_buffer.pop(timedFix))
+		return false;
+
+	m_latency.record(
+			chrono::duration_cast<chrono::nanoseconds>(
+					chrono::steady_clock::now() - timedFix.arrival).count());
+
+	fix = timedFix.fix;
+	return true;
+}
+
+/**
+ * Function takes the newest fix from the buffer without waiting, older fixes are skipped.
+ * Only called by the navigation loop.
+ * @param t_gpsFix& fix : OUT newest fix
+ * @returnvalue true if a fix was available
+ */
+bool CSensorProducer::popLatestFix(t_gpsFix& fix)
+{
+	t_timedFix timedFix;
+	bool found = false;
+
+	while (m_buffer.pop(timedFix))
+	{
+		if (found)
+			m_noSkippedFixes++;
+		found = true;
+	}
+
+	if (found)
+	{
+		m_latency.record(
+				chrono::duration_cast<chrono::nanoseconds>(
+						chrono::steady_clock::now() - timedFix.arrival).count());
+		fix = timedFix.fix;
+	}
+	return found;
+}
+
+/**
+ * Function returns true if the sensor has no more fixes and all fixes were taken from the buffer
+ * @param no parameters
+ * @returnvalue bool : true at the end of the input
+ */
+bool CSensorProducer::isFinished() const
+{
+	// end of input first : all fixes pushed before are visible in the buffer then
+	return m_endOfInput.load() && m_buffer.empty();
+}
+
+/**
+ * Function returns the number of fixes read from the sensor
+ * @param no parameters
+ * @returnvalue unsigned long : number of fixes
+ */
+unsigned long CSensorProducer::getNoFixes() const
+{
+	return m_noFixes.load(memory_order_relaxed);
+}
+
+/**
+ * Function returns how often the buffer was full when a fix arrived
+ * @param no parameters
+ * @returnvalue unsigned long : number of overruns
+ */
+unsigned long CSensorProducer::getNoOverruns() const
+{
+	return m_noOverruns.load(memory_order_relaxed);
+}
+
+/**
+ * Function returns the number of fixes dropped because the buffer was full (DROP_FIX)
+ * @param no parameters
+ * @returnvalue unsigned long : number of dropped fixes
+ */
+unsigned long CSensorProducer::getNoDroppedFixes() const
+{
+	return m_noDroppedFixes.load(memory_order_relaxed);
+}
+
+/**
+ * Function returns the number of fixes skipped by popLatestFix()
+ * @param no parameters
+ * @returnvalue unsigned long : number of skipped fixes
+ */
+unsigned long CSensorProducer::getNoSkippedFixes() const
+{
+	return m_noSkippedFixes;
+}
+
+/**
+ * Function returns the histogram of the latencies from the arrival of a fix until it was taken from the buffer
+ * @param no parameters
+ * @returnvalue const CLatencyHistogram& : latency histogram, only read by the navigation loop
+ */
+const CLatencyHistogram& CSensorProducer::getLatencyHistogram() const
+{
+	return m_latency;
+}
+
+/**
+ * Function of the producer thread : reads the sensor until the end of the input or stop()
+ * @param no parameters
+ * @returnvalue void
+ */
+void CSensorProducer::produce()
+{
+	t_timedFix timedFix;
+
+	while (!m_stopRequested.load(memory_order_relaxed)
+			&& m_pSensor->getNextFix(timedFix.fix))
+	{
+		timedFix.arrival = chrono::steady_clock::now();
+		m_noFixes.fetch_add(1, memory_order_relaxed);
+
+		if (m_buffer.push(timedFix))
+			continue;
+
+		// buffer is full, the navigation loop is behind
+		m_noOverruns.fetch_add(1, memory_order_relaxed);
+
+		if (m_policy == DROP_FIX)
+			m_noDroppedFixes.fetch_add(1, memory_order_relaxed);
+		else
+		{
+			while (!m_buffer.push(timedFix))
+			{
+				if (m_stopRequested.load(memory_order_relaxed))
+					break;
+				this_thread::yield();
+			}
+		}
+	}
+
+	m_endOfInput.store(true, memory_order_release);
+}
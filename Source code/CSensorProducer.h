@@ -0,0 +1,169 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CSENSORPRODUCER.H
+ * Author          : George Sebastian
+ * Description     : CSensorProducer reads the fixes of a sensor (GPS Sensor, NMEA replay,
+ *                   ...) in its own thread and passes them to the navigation loop through
+ *                   a lock free ring buffer. Blocking I/O and parsing of the sensor never
+ *                   delay the Route and POI calculations of the navigation loop.
+ *                   Each fix is stamped when it arrives from the sensor, the latency until
+ *                   the navigation loop takes it from the buffer is counted in a histogram.
+ *                   Fixes which do not fit into the full buffer are counted as overruns.
+ ****************************************************************************/
+#ifndef CSENSORPRODUCER_H
+#define CSENSORPRODUCER_H
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include "CPositionSensor.h"
+#include "CRingBuffer.h"
+#include "CLatencyHistogram.h"
+
+/*
+ * fix in the ring buffer with the time of its arrival from the sensor
+ */
+struct t_timedFix
+{
+	t_gpsFix fix;
+	std::chrono::steady_clock::time_point arrival;
+};
+
+class CSensorProducer
+{
+public:
+
+	/*
+	 * behaviour of the producer if the buffer is full
+	 */
+	enum t_overrunPolicy
+	{
+		DROP_FIX,           // the new fix is dropped, the sensor is never delayed (live sensors)
+		WAIT_FOR_SPACE      // the producer waits until the navigation loop has taken a fix (lossless replay)
+	};
+
+	/**
+	 * Constructor of class CSensorProducer
+	 * @param CPositionSensor& sensor  : IN sensor to be read, must stay valid as long as the producer exists
+	 * @param unsigned int capacity    : IN number of fixes in the ring buffer
+	 * @param t_overrunPolicy policy   : IN behaviour if the buffer is full
+	 * @return no value
+	 */
+	CSensorProducer(CPositionSensor& sensor, unsigned int capacity = 1024,
+			t_overrunPolicy policy = DROP_FIX);
+
+	/**
+	 * Destructor of class CSensorProducer, stops the producer thread
+	 * @param no parameters
+	 * @return no value
+	 */
+	~CSensorProducer();
+
+	/**
+	 * Function starts the producer thread
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void start();
+
+	/**
+	 * Function stops the producer thread. Waits until the sensor returns from the current read.
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void stop();
+
+	/**
+	 * Function takes the oldest fix from the buffer without waiting. Only called by the navigation loop.
+	 * @param t_gpsFix& fix : OUT oldest fix
+	 * @returnvalue true if a fix was available
+	 */
+	bool popFix(t_gpsFix& fix);
+
+	/**
+	 * Function takes the newest fix from the buffer without waiting, older fixes are skipped.
+	 * Only called by the navigation loop.
+	 * @param t_gpsFix& fix : OUT newest fix
+	 * @returnvalue true if a fix was available
+	 */
+	bool popLatestFix(t_gpsFix& fix);
+
+	/**
+	 * Function returns true if the sensor has no more fixes and all fixes were taken from the buffer
+	 * @param no parameters
+	 * @returnvalue bool : true at the end of the input
+	 */
+	bool isFinished() const;
+
+	/**
+	 * Function returns the number of fixes read from the sensor
+	 * @param no parameters
+	 * @returnvalue unsigned long : number of fixes
+	 */
+	unsigned long getNoFixes() const;
+
+	/**
+	 * Function returns how often the buffer was full when a fix arrived
+	 * @param no parameters
+	 * @returnvalue unsigned long : number of overruns
+	 */
+	unsigned long getNoOverruns() const;
+
+	/**
+	 * Function returns the number of fixes dropped because the buffer was full (DROP_FIX)
+	 * @param no parameters
+	 * @returnvalue unsigned long : number of dropped fixes
+	 */
+	unsigned long getNoDroppedFixes() const;
+
+	/**
+	 * Function returns the number of fixes skipped by popLatestFix()
+	 * @param no parameters
+	 * @returnvalue unsigned long : number of skipped fixes
+	 */
+	unsigned long getNoSkippedFixes() const;
+
+	/**
+	 * Function returns the histogram of the latencies from the arrival of a fix until it was taken from the buffer
+	 * @param no parameters
+	 * @returnvalue const CLatencyHistogram& : latency histogram, only read by the navigation loop
+	 */
+	const CLatencyHistogram& getLatencyHistogram() const;
+
+private:
+
+	/**
+	 * Copy constructor and assignment operator are not available, the producer owns a thread
+	 */
+	CSensorProducer(const CSensorProducer&);
+	CSensorProducer& operator=(const CSensorProducer&);
+
+	/**
+	 * Function of the producer thread : reads the sensor until the end of the input or stop()
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void produce();
+
+	CPositionSensor* m_pSensor;
+	CRingBuffer<t_timedFix> m_buffer;
+	t_overrunPolicy m_policy;
+	std::thread m_thread;
+	std::atomic<bool> m_stopRequested;
+	std::atomic<bool> m_endOfInput;
+
+	// written by the producer thread
+	std::atomic<unsigned long> m_noFixes;
+	std::atomic<unsigned long> m_noOverruns;
+	std::atomic<unsigned long> m_noDroppedFixes;
+
+	// written by the navigation loop
+	unsigned long m_noSkippedFixes;
+	CLatencyHistogram m_latency;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CSENSORPRODUCER_H */
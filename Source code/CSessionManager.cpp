@@ -0,0 +1,231 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CSESSIONMANAGER.CPP
+ * Author          : George Sebastian
+ * Description     : CSessionManager runs the navigation of a fleet : it holds many
+ *                   navigation sessions (one Route and the tracking state per vehicle).
+ *                   All Routes refer to the same WP and POI Databases, which are only read
+ *                   while positions are processed.
+ *                   Position updates are processed in batches on a work stealing thread
+ *                   pool. The updates of a batch are grouped by session (stable counting
+ *                   sort), each session is processed by one thread in the order of its
+ *                   updates, so the updates of a session are never reordered or processed
+ *                   in parallel and no locks are needed for the session state.
+ ****************************************************************************/
+#include <iostream>
+using namespace std;
+
+#include "CSessionManager.h"
+#include "CUnitVector.h"
+
+#define MIN_UPDATES_PER_TASK 64             // sessions are grouped into tasks of at least this many updates
+
+/**
+ * Constructor of class CSessionManager
+ * @param CWpDatabase& wpDatabase   : IN WP Database shared by all sessions, must not be changed while batches are processed
+ * @param CPoiDatabase& poiDatabase : IN POI Database shared by all sessions, must not be changed while batches are processed
+ * @param unsigned int noThreads    : IN number of threads processing a batch, 0 for the number of cores
+ * @return no value
+ */
+CSessionManager::CSessionManager(CWpDatabase& wpDatabase,
+		CPoiDatabase& poiDatabase, unsigned int noThreads) :
+		m_pool(noThreads), m_smoothing(0)
+{
+	m_pWpDatabase = &wpDatabase;
+	m_pPoiDatabase = &poiDatabase;
+}
+
+/**
+ * Destructor of class CSessionManager
+ * @param no parameters
+ * @return no value
+ */
+CSessionManager::~CSessionManager()
+{
+	for (unsigned int i = 0; i < m_sessions.size(); i++)
+		delete m_sessions[i];
+}
+
+/**
+ * Function creates a session with a Route through the given WPs and POIs of the shared Databases
+ * @param const std::vector<std::string>& stops : IN names of the WPs/POIs of the Route, WPs are looked up first
+ * @returnvalue unsigned int : number of the new session
+ */
+unsigned int CSessionManager::createSession(const vector<string>& stops)
+{
+	t_session* pSession = new t_session;
+
+	pSession->route.connectToWpDatabase(m_pWpDatabase);
+	pSession->route.connectToPoiDatabase(m_pPoiDatabase);
+
+	for (unsigned int i = 0; i < stops.size(); i++)
+	{
+		if (m_pWpDatabase->getPointerToWaypoint(stops[i]) != NULL)
+			pSession->route.addWaypoint(stops[i]);
+		else
+			// POI or unknown stop, addPoi() prints the error
+			pSession->route.addPoi(stops[i]);
+	}
+
+	pSession->matcher.setRoute(pSession->route);
+	pSession->table.build(pSession->route);
+
+	t_sessionState state = t_sessionState();
+	state.distanceNextPoiKm = -1.0;
+	state.pNextPoi = NULL;
+
+	m_sessions.push_back(pSession);
+	m_states.push_back(state);
+	m_smoothing.addVehicle();
+
+	return m_sessions.size() - 1;
+}
+
+/**
+ * Function processes a batch of position updates of any sessions. Updates of the same session are
+ * processed in the order of the batch. Returns when all updates are processed.
+ * @param const std::vector<t_positionUpdate>& updates : IN position updates
+ * @returnvalue void
+ */
+void CSessionManager::processBatch(const vector<t_positionUpdate>& updates)
+{
+	unsigned int noSessions = m_sessions.size();
+	unsigned int noUpdates = updates.size();
+
+	// counting sort of the updates by session, stable : the order within a session is kept
+	m_updateCount.assign(noSessions + 1, 0);
+	for (unsigned int i = 0; i < noUpdates; i++)
+	{
+		if (updates[i].session < noSessions)
+			m_updateCount[updates[i].session + 1]++;
+		else
+			cout << "WARNING : update for unknown session "
+					<< updates[i].session << " is ignored" << endl;
+	}
+
+	m_activeSessions.clear();
+	for (unsigned int session = 0; session < noSessions; session++)
+	{
+		if (m_updateCount[session + 1] > 0)
+			m_activeSessions.push_back(session);
+		m_updateCount[session + 1] += m_updateCount[session];
+	}
+
+	// m_updateCount[s] is the start of session s in m_orderedUpdates, moved forward while placing
+	m_orderedUpdates.resize(m_updateCount[noSessions]);
+	for (unsigned int i = 0; i < noUpdates; i++)
+	{
+		if (updates[i].session < noSessions)
+			m_orderedUpdates[m_updateCount[updates[i].session]++] = i;
+	}
+	// after placing, m_updateCount[s] is the end of session s and the start of the following sessions
+
+	// tasks of consecutive active sessions with at least MIN_UPDATES_PER_TASK updates
+	m_taskStart.clear();
+	unsigned int updatesInTask = MIN_UPDATES_PER_TASK;
+	unsigned int sessionStart = 0;
+	for (unsigned int a = 0; a < m_activeSessions.size(); a++)
+	{
+		if (updatesInTask >= MIN_UPDATES_PER_TASK)
+		{
+			m_taskStart.push_back(a);
+			updatesInTask = 0;
+		}
+		unsigned int sessionEnd = m_updateCount[m_activeSessions[a]];
+		updatesInTask += sessionEnd - sessionStart;
+		sessionStart = sessionEnd;
+	}
+	m_taskStart.push_back(m_activeSessions.size());
+
+	m_pool.parallelFor(m_taskStart.size() - 1,
+			[this, &updates](unsigned int task)
+			{
+				for (unsigned int a = m_taskStart[task]; a < m_taskStart[task + 1]; a++)
+				{
+					// all updates of a session in one task, in the order of the batch
+					unsigned int session = m_activeSessions[a];
+					unsigned int first = (session > 0) ? m_updateCount[session - 1] : 0;
+
+					for (unsigned int k = first; k < m_updateCount[session]; k++)
+						processUpdate(session, updates[m_orderedUpdates[k]].fix);
+				}
+			});
+}
+
+/**
+ * Function returns the tracking state of a session
+ * @param unsigned int session : IN number of the session
+ * @returnvalue const t_sessionState& : state after the last processed batch
+ */
+const t_sessionState& CSessionManager::getSessionState(
+		unsigned int session) const
+{
+	return m_states[session];
+}
+
+/**
+ * Function returns the Route of a session
+ * @param unsigned int session : IN number of the session
+ * @returnvalue const CRoute& : Route of the session
+ */
+const CRoute& CSessionManager::getRoute(unsigned int session) const
+{
+	return m_sessions[session]->route;
+}
+
+/**
+ * Function returns the number of sessions
+ * @param no parameters
+ * @returnvalue unsigned int : number of sessions
+ */
+unsigned int CSessionManager::getNoSessions() const
+{
+	return m_sessions.size();
+}
+
+/**
+ * Function returns the thread pool processing the batches
+ * @param no parameters
+ * @returnvalue const CWorkStealingPool& : thread pool
+ */
+const CWorkStealingPool& CSessionManager::getPool() const
+{
+	return m_pool;
+}
+
+/**
+ * Function processes one update of a session
+ * @param unsigned int session   : IN number of the session
+ * @param const t_gpsFix& fix    : IN raw position of the vehicle
+ * @returnvalue void
+ */
+void CSessionManager::processUpdate(unsigned int session, const t_gpsFix& fix)
+{
+	t_sessionState& state = m_states[session];
+	t_session& navigation = *m_sessions[session];
+
+	if (state.noUpdates > 0 && fix.timestamp < state.timestamp)
+	// the sensor delivered an old position
+	{
+		state.noOutOfOrder++;
+		return;
+	}
+
+	t_filteredFix filtered;
+	m_smoothing.filter(session, fix, filtered);
+
+	CUnitVector position = CUnitVector::fromLatLon(filtered.latitude,
+			filtered.longitude);
+	navigation.matcher.match(position, state.match);
+
+	// nearest POI from the arrays of the table, the first of several POIs with the same distance is taken
+	int nextPoi = navigation.table.getNearestPoi(position, state.distanceNextPoiKm);
+	if (nextPoi >= 0)
+		state.pNextPoi = navigation.table.getPoi(nextPoi);
+
+	state.noUpdates++;
+	state.timestamp = fix.timestamp;
+	state.latitude = filtered.latitude;
+	state.longitude = filtered.longitude;
+}
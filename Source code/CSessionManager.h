@@ -0,0 +1,160 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CSESSIONMANAGER.H
+ * Author          : George Sebastian
+ * Description     : CSessionManager runs the navigation of a fleet : it holds many
+ *                   navigation sessions (one Route and the tracking state per vehicle).
+ *                   All Routes refer to the same WP and POI Databases, which are only read
+ *                   while positions are processed.
+ *                   Position updates are processed in batches on a work stealing thread
+ *                   pool. The updates of a batch are grouped by session, each session is
+ *                   processed by one thread in the order of its updates, so the updates of
+ *                   a session are never reordered or processed in parallel.
+ ****************************************************************************/
+#ifndef CSESSIONMANAGER_H
+#define CSESSIONMANAGER_H
+
+#include <vector>
+#include <string>
+
+#include "CRoute.h"
+#include "CRouteMatcher.h"
+#include "CRouteTable.h"
+#include "CKalmanFilterBank.h"
+#include "CWorkStealingPool.h"
+#include "CWpDatabase.h"
+#include "CPoiDatabase.h"
+
+/*
+ * position update of a session
+ */
+struct t_positionUpdate
+{
+	unsigned int session;
+	t_gpsFix fix;
+};
+
+/*
+ * tracking state of a session after its last update
+ */
+struct t_sessionState
+{
+	unsigned long noUpdates;
+	unsigned long noOutOfOrder;        // updates older than the previous update of the session (ignored)
+	double timestamp;                  // timestamp of the last update
+	double latitude;                   // smoothed position of the last update
+	double longitude;
+	t_routeMatch match;                // position on the Route
+	double distanceNextPoiKm;          // distance to the nearest POI of the Route, -1 if the Route has no POI
+	const CPOI* pNextPoi;              // nearest POI in the POI Database, NULL if the Route has no POI
+};
+
+class CSessionManager
+{
+public:
+
+	/**
+	 * Constructor of class CSessionManager
+	 * @param CWpDatabase& wpDatabase   : IN WP Database shared by all sessions, must not be changed while batches are processed
+	 * @param CPoiDatabase& poiDatabase : IN POI Database shared by all sessions, must not be changed while batches are processed
+	 * @param unsigned int noThreads    : IN number of threads processing a batch, 0 for the number of cores
+	 * @return no value
+	 */
+	CSessionManager(CWpDatabase& wpDatabase, CPoiDatabase& poiDatabase,
+			unsigned int noThreads = 0);
+
+	/**
+	 * Destructor of class CSessionManager
+	 * @param no parameters
+	 * @return no value
+	 */
+	~CSessionManager();
+
+	/**
+	 * Function creates a session with a Route through the given WPs and POIs of the shared Databases
+	 * @param const std::vector<std::string>& stops : IN names of the WPs/POIs of the Route, WPs are looked up first
+	 * @returnvalue unsigned int : number of the new session
+	 */
+	unsigned int createSession(const std::vector<std::string>& stops);
+
+	/**
+	 * Function processes a batch of position updates of any sessions. Updates of the same session are
+	 * processed in the order of the batch. Returns when all updates are processed.
+	 * @param const std::vector<t_positionUpdate>& updates : IN position updates
+	 * @returnvalue void
+	 */
+	void processBatch(const std::vector<t_positionUpdate>& updates);
+
+	/**
+	 * Function returns the tracking state of a session
+	 * @param unsigned int session : IN number of the session
+	 * @returnvalue const t_sessionState& : state after the last processed batch
+	 */
+	const t_sessionState& getSessionState(unsigned int session) const;
+
+	/**
+	 * Function returns the Route of a session
+	 * @param unsigned int session : IN number of the session
+	 * @returnvalue const CRoute& : Route of the session
+	 */
+	const CRoute& getRoute(unsigned int session) const;
+
+	/**
+	 * Function returns the number of sessions
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of sessions
+	 */
+	unsigned int getNoSessions() const;
+
+	/**
+	 * Function returns the thread pool processing the batches
+	 * @param no parameters
+	 * @returnvalue const CWorkStealingPool& : thread pool
+	 */
+	const CWorkStealingPool& getPool() const;
+
+private:
+
+	/*
+	 * Route and matcher of a session
+	 */
+	struct t_session
+	{
+		CRoute route;
+		CRouteMatcher matcher;
+		CRouteTable table;                 // POIs of the Route for the nearest POI of each update
+	};
+
+	/**
+	 * Copy constructor and assignment operator are not available, the sessions refer to the databases
+	 */
+	CSessionManager(const CSessionManager&);
+	CSessionManager& operator=(const CSessionManager&);
+
+	/**
+	 * Function processes one update of a session
+	 * @param unsigned int session   : IN number of the session
+	 * @param const t_gpsFix& fix    : IN raw position of the vehicle
+	 * @returnvalue void
+	 */
+	void processUpdate(unsigned int session, const t_gpsFix& fix);
+
+	CWpDatabase* m_pWpDatabase;
+	CPoiDatabase* m_pPoiDatabase;
+	CWorkStealingPool m_pool;
+
+	std::vector<t_session*> m_sessions;
+	std::vector<t_sessionState> m_states;
+	CKalmanFilterBank m_smoothing;         // one filter per session, sessions only touch their own filter
+
+	// grouping of a batch by session (kept to avoid allocations per batch)
+	std::vector<unsigned int> m_updateCount;     // per session : updates in the batch, then start in m_orderedUpdates
+	std::vector<unsigned int> m_orderedUpdates;  // indices of the updates sorted by session, stable
+	std::vector<unsigned int> m_activeSessions;  // sessions with updates in the batch
+	std::vector<unsigned int> m_taskStart;       // first active session of each task
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CSESSIONMANAGER_H */
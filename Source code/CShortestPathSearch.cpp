@@ -0,0 +1,401 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CSHORTESTPATHSEARCH.CPP
+ * Author          : George Sebastian
+ * Description     : CShortestPathSearch finds the shortest path between two nodes of a
+ *                   CRoadGraph. The binary heap has no decrease key operation : a node is
+ *                   pushed again with its smaller distance and the outdated entry is
+ *                   skipped when it is popped. The searches stop as soon as the result is
+ *                   known :
+ *                   - Dijkstra and A* when the destination is settled
+ *                   - bidirectional searches when the smallest keys of both heaps together
+ *                     reach the shortest path found so far
+ *                   A* heuristic : the chord between the unit vectors of the nodes is never
+ *                   longer than their great circle distance (CWaypoint::calculateDistance)
+ *                   and costs a square root instead of trigonometry.
+ *                   Bidirectional A* uses the average potential (h_to - h_from) / 2 forward
+ *                   and its negative backward, which keeps both searches consistent.
+ *                   The landmark bounds of ALT are rounded to metres and not exactly
+ *                   consistent; a node reached again on a shorter path is pushed again, so
+ *                   the search stays correct.
+ ****************************************************************************/
+#include <math.h>
+#include <algorithm>
+using namespace std;
+
+#include "CShortestPathSearch.h"
+
+#define HEURISTIC_FACTOR 0.999999    // lower bound reduced slightly, rounding must not make it larger than an edge cost
+
+/**
+ * Constructor of class CShortestPathSearch
+ * @param const CRoadGraph& graph : IN graph to be searched, must not be changed while the search object is used
+ * @return no value
+ */
+CShortestPathSearch::CShortestPathSearch(const CRoadGraph& graph) :
+		m_graph(graph)
+{
+	m_pLandmarks = NULL;
+	m_useLandmarks = false;
+	m_queryStamp = 0;
+	m_meetingNode = 0;
+	m_bidirectional = false;
+	m_noSettledNodes = 0;
+	m_noRelaxedEdges = 0;
+}
+
+/**
+ * Function sets the landmark table used by ALT, without a table ALT searches like A*
+ * @param const CLandmarkTable* pLandmarks : IN table built for the graph of the search, NULL for none
+ * @returnvalue void
+ */
+void CShortestPathSearch::setLandmarks(const CLandmarkTable* pLandmarks)
+{
+	m_pLandmarks = pLandmarks;
+}
+
+/**
+ * Function searches the shortest path between two nodes
+ * @param unsigned int from           : IN start node
+ * @param unsigned int to             : IN destination node
+ * @param std::vector<unsigned int>& path : OUT nodes of the path from start to destination
+ * @param double& costKm              : OUT cost of the path
+ * @param t_algorithm algorithm       : IN search algorithm
+ * @returnvalue true if the destination can be reached from the start
+ */
+bool CShortestPathSearch::shortestPath(unsigned int from, unsigned int to,
+		vector<unsigned int>& path, double& costKm, t_algorithm algorithm)
+{
+	path.clear();
+
+	if (!m_graph.isReady() || from >= m_graph.getNoNodes()
+			|| to >= m_graph.getNoNodes())
+		return false;
+
+	startQuery();
+	m_useLandmarks = (algorithm == ALT && m_pLandmarks != NULL);
+	m_bidirectional = (algorithm == BIDIRECTIONAL_DIJKSTRA
+			|| algorithm == BIDIRECTIONAL_ASTAR);
+
+	bool found;
+	if (m_bidirectional)
+		found = searchBidirectional(from, to, algorithm == BIDIRECTIONAL_ASTAR,
+				costKm);
+	else
+		found = searchForward(from, to, algorithm == ASTAR || algorithm == ALT,
+				costKm);
+
+	if (found)
+		extractPath(from, to, path);
+
+	return found;
+}
+
+/**
+ * Function searches the shortest path between two Waypoints and replaces the Route by it
+ * @param const std::string& from : IN name of the start Waypoint
+ * @param const std::string& to   : IN name of the destination Waypoint
+ * @param CRoute& route           : OUT Route along the path, has to be connected to the WP Database of the graph
+ * @param double& costKm          : OUT cost of the path
+ * @param t_algorithm algorithm   : IN search algorithm
+ * @returnvalue true if both Waypoints are nodes and the destination can be reached
+ */
+bool CShortestPathSearch::shortestRoute(const string& from, const string& to,
+		CRoute& route, double& costKm, t_algorithm algorithm)
+{
+	unsigned int fromNode, toNode;
+
+	if (!m_graph.getNode(from, fromNode) || !m_graph.getNode(to, toNode)
+			|| !shortestPath(fromNode, toNode, m_path, costKm, algorithm))
+		return false;
+
+	route.rebuildFromIndices(vector<unsigned int>());    // empty Route
+
+	for (unsigned int i = 0; i < m_path.size(); i++)
+		route.addWaypoint(m_graph.getWaypoint(m_path[i])->getName());
+
+	return true;
+}
+
+/**
+ * Function returns the number of nodes settled by the last query, in both directions (for benchmarks)
+ * @param no parameters
+ * @returnvalue unsigned int : number of settled nodes
+ */
+unsigned int CShortestPathSearch::getNoSettledNodes() const
+{
+	return m_noSettledNodes;
+}
+
+/**
+ * Function returns the number of edges relaxed by the last query, in both directions (for benchmarks)
+ * @param no parameters
+ * @returnvalue unsigned int : number of relaxed edges
+ */
+unsigned int CShortestPathSearch::getNoRelaxedEdges() const
+{
+	return m_noRelaxedEdges;
+}
+
+/**
+ * Function starts a new query : arrays are resized if the graph grew, the query stamp is incremented
+ * @param no parameters
+ * @returnvalue void
+ */
+void CShortestPathSearch::startQuery()
+{
+	unsigned int noNodes = m_graph.getNoNodes();
+
+	m_queryStamp++;
+
+	for (unsigned int direction = 0; direction < 2; direction++)
+	{
+		if (m_distance[direction].size() < noNodes)
+		{
+			m_distance[direction].resize(noNodes);
+			m_parent[direction].resize(noNodes);
+			m_stamp[direction].resize(noNodes, 0);
+		}
+
+		if (m_queryStamp == 0)
+			// stamp wrapped around, stamps of old queries could match again
+			fill(m_stamp[direction].begin(), m_stamp[direction].end(), 0);
+
+		m_heap[direction].clear();
+	}
+
+	if (m_queryStamp == 0)
+		m_queryStamp = 1;
+
+	m_noSettledNodes = 0;
+	m_noRelaxedEdges = 0;
+}
+
+/**
+ * Function searches from the start only (Dijkstra, A*)
+ * @param unsigned int from   : IN start node
+ * @param unsigned int to     : IN destination node
+ * @param bool useHeuristic   : IN A* with heuristic(), the lower bound of the distance to the destination
+ * @param double& costKm      : OUT cost of the path
+ * @returnvalue true if the destination was reached
+ */
+bool CShortestPathSearch::searchForward(unsigned int from, unsigned int to,
+		bool useHeuristic, double& costKm)
+{
+	const unsigned int* firstEdge = &m_graph.m_firstEdge[0];
+	const unsigned int* edgeTarget = m_graph.m_edgeTarget.empty() ? NULL : &m_graph.m_edgeTarget[0];
+	const double* edgeCost = m_graph.m_edgeCost.empty() ? NULL : &m_graph.m_edgeCost[0];
+	vector<t_heapEntry>& heap = m_heap[0];
+
+	relax(0, from, 0.0, useHeuristic ? heuristic(from, to) : 0.0, from);
+
+	while (!heap.empty())
+	{
+		t_heapEntry top = heap.front();
+		pop_heap(heap.begin(), heap.end());
+		heap.pop_back();
+
+		if (top.distance > m_distance[0][top.node])
+			// outdated entry, the node was settled with a smaller distance
+			continue;
+
+		m_noSettledNodes++;
+
+		if (top.node == to)
+		{
+			costKm = top.distance;
+			return true;
+		}
+
+		for (unsigned int e = firstEdge[top.node]; e < firstEdge[top.node + 1]; e++)
+		{
+			unsigned int target = edgeTarget[e];
+
+			m_noRelaxedEdges++;
+			relax(0, target, top.distance + edgeCost[e],
+					useHeuristic ? heuristic(target, to) : 0.0, top.node);
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Function searches from the start and from the destination until the searches meet
+ * @param unsigned int from   : IN start node
+ * @param unsigned int to     : IN destination node
+ * @param bool useHeuristic   : IN both searches directed with the average potential
+ * @param double& costKm      : OUT cost of the path
+ * @returnvalue true if the searches met
+ */
+bool CShortestPathSearch::searchBidirectional(unsigned int from,
+		unsigned int to, bool useHeuristic, double& costKm)
+{
+	const unsigned int* firstEdge[2] =
+	{ &m_graph.m_firstEdge[0], &m_graph.m_firstReverseEdge[0] };
+	const unsigned int* edgeNode[2] =
+	{ m_graph.m_edgeTarget.empty() ? NULL : &m_graph.m_edgeTarget[0],
+			m_graph.m_reverseEdgeSource.empty() ? NULL : &m_graph.m_reverseEdgeSource[0] };
+	const double* edgeCost[2] =
+	{ m_graph.m_edgeCost.empty() ? NULL : &m_graph.m_edgeCost[0],
+			m_graph.m_reverseEdgeCost.empty() ? NULL : &m_graph.m_reverseEdgeCost[0] };
+
+	double bestKm = -1.0;           // shortest path found so far, -1 : none
+
+	if (from == to)
+	{
+		bestKm = 0.0;
+		m_meetingNode = from;
+	}
+
+	// forward potential of the start and the destination, backward potential is the negative
+	double potentialFrom = useHeuristic ? 0.5 * lowerBound(from, to) : 0.0;
+	relax(0, from, 0.0, potentialFrom, from);
+	relax(1, to, 0.0, potentialFrom, to);
+
+	while (!m_heap[0].empty() && !m_heap[1].empty())
+	{
+		if (bestKm >= 0.0
+				&& m_heap[0].front().key + m_heap[1].front().key >= bestKm)
+			// no path through an unsettled node can be shorter
+			break;
+
+		unsigned int direction =
+				(m_heap[0].front().key <= m_heap[1].front().key) ? 0 : 1;
+		vector<t_heapEntry>& heap = m_heap[direction];
+		unsigned int other = 1 - direction;
+
+		t_heapEntry top = heap.front();
+		pop_heap(heap.begin(), heap.end());
+		heap.pop_back();
+
+		if (top.distance > m_distance[direction][top.node])
+			continue;
+
+		m_noSettledNodes++;
+
+		for (unsigned int e = firstEdge[direction][top.node];
+				e < firstEdge[direction][top.node + 1]; e++)
+		{
+			unsigned int node = edgeNode[direction][e];
+			double distance = top.distance + edgeCost[direction][e];
+			double potential = 0.0;
+
+			if (useHeuristic)
+			{
+				potential = 0.5 * (lowerBound(node, to) - lowerBound(node, from));
+				if (direction == 1)
+					potential = -potential;
+			}
+
+			m_noRelaxedEdges++;
+
+			if (relax(direction, node, distance, potential, top.node)
+					&& m_stamp[other][node] == m_queryStamp)
+			// node reached by both searches : path from start to destination through the node
+			{
+				double pathKm = distance + m_distance[other][node];
+
+				if (bestKm < 0.0 || pathKm < bestKm)
+				{
+					bestKm = pathKm;
+					m_meetingNode = node;
+				}
+			}
+		}
+	}
+
+	costKm = bestKm;
+	return bestKm >= 0.0;
+}
+
+/**
+ * Function sets the distance of a node if it is smaller than the known one and pushes it onto the heap
+ * @param unsigned int direction : IN 0 forward, 1 backward
+ * @param unsigned int node      : IN node
+ * @param double distance        : IN distance from the start (forward) or to the destination (backward)
+ * @param double potential       : IN potential of the node, added to the distance as key of the heap
+ * @param unsigned int parent    : IN previous node on the path
+ * @returnvalue true if the distance of the node was improved
+ */
+bool CShortestPathSearch::relax(unsigned int direction, unsigned int node,
+		double distance, double potential, unsigned int parent)
+{
+	if (m_stamp[direction][node] == m_queryStamp
+			&& m_distance[direction][node] <= distance)
+		// already reached on a path which is not longer
+		return false;
+
+	m_stamp[direction][node] = m_queryStamp;
+	m_distance[direction][node] = distance;
+	m_parent[direction][node] = parent;
+
+	t_heapEntry entry;
+	entry.key = distance + potential;
+	entry.distance = distance;
+	entry.node = node;
+	m_heap[direction].push_back(entry);
+	push_heap(m_heap[direction].begin(), m_heap[direction].end());
+	return true;
+}
+
+/**
+ * Function returns a lower bound of the cost between two nodes : chord of the unit vectors, slightly reduced for rounding
+ * @param unsigned int a : IN first node
+ * @param unsigned int b : IN second node
+ * @returnvalue double : lower bound in km
+ */
+double CShortestPathSearch::lowerBound(unsigned int a, unsigned int b) const
+{
+	const CUnitVector& pa = m_graph.m_positions[a];
+	const CUnitVector& pb = m_graph.m_positions[b];
+	double dx = pa.m_x - pb.m_x, dy = pa.m_y - pb.m_y, dz = pa.m_z - pb.m_z;
+
+	return sqrt(dx * dx + dy * dy + dz * dz) * CUnitVector::EARTH_RADIUS
+			* HEURISTIC_FACTOR;
+}
+
+/**
+ * Function returns the heuristic of the forward A* : great circle bound, with landmarks the larger of both bounds
+ * @param unsigned int node : IN node
+ * @param unsigned int to   : IN destination node
+ * @returnvalue double : lower bound of the distance from the node to the destination in km
+ */
+double CShortestPathSearch::heuristic(unsigned int node, unsigned int to) const
+{
+	double bound = lowerBound(node, to);
+
+	if (m_useLandmarks)
+		bound = max(bound, m_pLandmarks->lowerBound(node, to));
+
+	return bound;
+}
+
+/**
+ * Function reads the path from the parents of the nodes
+ * @param unsigned int from               : IN start node
+ * @param unsigned int to                 : IN destination node
+ * @param std::vector<unsigned int>& path : OUT nodes from start to destination
+ * @returnvalue void
+ */
+void CShortestPathSearch::extractPath(unsigned int from, unsigned int to,
+		vector<unsigned int>& path) const
+{
+	unsigned int meeting = m_bidirectional ? m_meetingNode : to;
+
+	path.clear();
+
+	// start .. meeting node from the parents of the forward search
+	for (unsigned int node = meeting; node != from; node = m_parent[0][node])
+		path.push_back(node);
+	path.push_back(from);
+	reverse(path.begin(), path.end());
+
+	// meeting node .. destination from the parents of the backward search
+	for (unsigned int node = meeting; node != to && m_bidirectional;)
+	{
+		node = m_parent[1][node];
+		path.push_back(node);
+	}
+}
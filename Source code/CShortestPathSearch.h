@@ -0,0 +1,202 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CSHORTESTPATHSEARCH.H
+ * Author          : George Sebastian
+ * Description     : CShortestPathSearch finds the shortest path between two nodes of a
+ *                   CRoadGraph and returns it as Route. Algorithms :
+ *                   - Dijkstra
+ *                   - A* : nodes closer to the destination (great circle distance) first
+ *                   - bidirectional Dijkstra : from the start and from the destination
+ *                     backwards until the searches meet
+ *                   - bidirectional A* : both searches directed with the average of the
+ *                     distances to start and destination
+ *                   - ALT : A* with the lower bounds of a CLandmarkTable (triangle inequality
+ *                     with the distances from and to landmarks), at least the great circle
+ *                   The heuristics are admissible as long as no edge costs less than the
+ *                   great circle distance between its nodes (lengths of roads in km).
+ *                   The object keeps its arrays (distance, parent, binary heap for each
+ *                   direction) between the queries : it is created once per thread and
+ *                   reused, a query neither allocates nor clears arrays of the size of the
+ *                   graph. Nodes touched by an older query are recognised by a query stamp.
+ ****************************************************************************/
+#ifndef CSHORTESTPATHSEARCH_H
+#define CSHORTESTPATHSEARCH_H
+
+#include <vector>
+#include <string>
+
+#include "CRoadGraph.h"
+#include "CRoute.h"
+#include "CLandmarkTable.h"
+
+class CShortestPathSearch
+{
+public:
+
+	/*
+	 * search algorithm
+	 */
+	enum t_algorithm
+	{
+		DIJKSTRA, ASTAR, BIDIRECTIONAL_DIJKSTRA, BIDIRECTIONAL_ASTAR, ALT
+	};
+
+	/**
+	 * Constructor of class CShortestPathSearch
+	 * @param const CRoadGraph& graph : IN graph to be searched, must not be changed while the search object is used
+	 * @return no value
+	 */
+	CShortestPathSearch(const CRoadGraph& graph);
+
+	/**
+	 * Function sets the landmark table used by ALT, without a table ALT searches like A*
+	 * @param const CLandmarkTable* pLandmarks : IN table built for the graph of the search, NULL for none
+	 * @returnvalue void
+	 */
+	void setLandmarks(const CLandmarkTable* pLandmarks);
+
+	/**
+	 * Function searches the shortest path between two nodes
+	 * @param unsigned int from           : IN start node
+	 * @param unsigned int to             : IN destination node
+	 * @param std::vector<unsigned int>& path : OUT nodes of the path from start to destination
+	 * @param double& costKm              : OUT cost of the path
+	 * @param t_algorithm algorithm       : IN search algorithm
+	 * @returnvalue true if the destination can be reached from the start
+	 */
+	bool shortestPath(unsigned int from, unsigned int to,
+			std::vector<unsigned int>& path, double& costKm,
+			t_algorithm algorithm = DIJKSTRA);
+
+	/**
+	 * Function searches the shortest path between two Waypoints and replaces the Route by it
+	 * @param const std::string& from : IN name of the start Waypoint
+	 * @param const std::string& to   : IN name of the destination Waypoint
+	 * @param CRoute& route           : OUT Route along the path, has to be connected to the WP Database of the graph
+	 * @param double& costKm          : OUT cost of the path
+	 * @param t_algorithm algorithm   : IN search algorithm
+	 * @returnvalue true if both Waypoints are nodes and the destination can be reached
+	 */
+	bool shortestRoute(const std::string& from, const std::string& to,
+			CRoute& route, double& costKm, t_algorithm algorithm = DIJKSTRA);
+
+	/**
+	 * Function returns the number of nodes settled by the last query, in both directions (for benchmarks)
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of settled nodes
+	 */
+	unsigned int getNoSettledNodes() const;
+
+	/**
+	 * Function returns the number of edges relaxed by the last query, in both directions (for benchmarks)
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of relaxed edges
+	 */
+	unsigned int getNoRelaxedEdges() const;
+
+private:
+
+	/*
+	 * entry of the binary heap, entries of nodes with a smaller distance found later are skipped when popped
+	 */
+	struct t_heapEntry
+	{
+		double key;             // distance plus potential of the node
+		double distance;
+		unsigned int node;
+
+		bool operator<(const t_heapEntry& other) const
+		{
+			return key > other.key;     // std heap functions build a max heap, smallest key on top
+		}
+	};
+
+	/**
+	 * Function starts a new query : arrays are resized if the graph grew, the query stamp is incremented
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void startQuery();
+
+	/**
+	 * Function searches from the start only (Dijkstra, A*)
+	 * @param unsigned int from   : IN start node
+	 * @param unsigned int to     : IN destination node
+	 * @param bool useHeuristic   : IN A* with heuristic(), the lower bound of the distance to the destination
+	 * @param double& costKm      : OUT cost of the path
+	 * @returnvalue true if the destination was reached
+	 */
+	bool searchForward(unsigned int from, unsigned int to, bool useHeuristic,
+			double& costKm);
+
+	/**
+	 * Function searches from the start and from the destination until the searches meet
+	 * @param unsigned int from   : IN start node
+	 * @param unsigned int to     : IN destination node
+	 * @param bool useHeuristic   : IN both searches directed with the average potential
+	 * @param double& costKm      : OUT cost of the path
+	 * @returnvalue true if the searches met
+	 */
+	bool searchBidirectional(unsigned int from, unsigned int to,
+			bool useHeuristic, double& costKm);
+
+	/**
+	 * Function sets the distance of a node if it is smaller than the known one and pushes it onto the heap
+	 * @param unsigned int direction : IN 0 forward, 1 backward
+	 * @param unsigned int node      : IN node
+	 * @param double distance        : IN distance from the start (forward) or to the destination (backward)
+	 * @param double potential       : IN potential of the node, added to the distance as key of the heap
+	 * @param unsigned int parent    : IN previous node on the path
+	 * @returnvalue true if the distance of the node was improved
+	 */
+	bool relax(unsigned int direction, unsigned int node, double distance,
+			double potential, unsigned int parent);
+
+	/**
+	 * Function returns a lower bound of the cost between two nodes : chord of the unit vectors, slightly reduced for rounding
+	 * @param unsigned int a : IN first node
+	 * @param unsigned int b : IN second node
+	 * @returnvalue double : lower bound in km
+	 */
+	double lowerBound(unsigned int a, unsigned int b) const;
+
+	/**
+	 * Function returns the heuristic of the forward A* : great circle bound, with landmarks the larger of both bounds
+	 * @param unsigned int node : IN node
+	 * @param unsigned int to   : IN destination node
+	 * @returnvalue double : lower bound of the distance from the node to the destination in km
+	 */
+	double heuristic(unsigned int node, unsigned int to) const;
+
+	/**
+	 * Function reads the path from the parents of the nodes
+	 * @param unsigned int from               : IN start node
+	 * @param unsigned int to                 : IN destination node
+	 * @param std::vector<unsigned int>& path : OUT nodes from start to destination
+	 * @returnvalue void
+	 */
+	void extractPath(unsigned int from, unsigned int to,
+			std::vector<unsigned int>& path) const;
+
+	const CRoadGraph& m_graph;
+	const CLandmarkTable* m_pLandmarks;
+	bool m_useLandmarks;                    // last query was ALT with a landmark table
+
+	// search state of the forward [0] and backward [1] search
+	std::vector<double> m_distance[2];
+	std::vector<unsigned int> m_parent[2];
+	std::vector<unsigned int> m_stamp[2];   // query which set the distance of the node
+	std::vector<t_heapEntry> m_heap[2];
+	unsigned int m_queryStamp;
+	unsigned int m_meetingNode;             // bidirectional : node on the shortest path reached by both searches
+	bool m_bidirectional;                   // last query was bidirectional
+
+	std::vector<unsigned int> m_path;       // buffer of shortestRoute()
+	unsigned int m_noSettledNodes;
+	unsigned int m_noRelaxedEdges;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CSHORTESTPATHSEARCH_H */
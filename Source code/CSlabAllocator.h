@@ -0,0 +1,109 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CSLABALLOCATOR.H
+ * Author          : George Sebastian
+ * Description     : CSlabAllocator is an allocator for the containers of the STL which
+ *                   takes the memory from a CSlabArena, e.g. the nodes of a std::map.
+ *                   Copies (also for other element types) use the same arena, two
+ *                   allocators are equal if they use the same arena.
+ *                   T -> Type of the elements
+ ****************************************************************************/
+#ifndef CSLABALLOCATOR_H
+#define CSLABALLOCATOR_H
+
+#include <cstddef>
+
+#include "CSlabArena.h"
+
+template<class T>
+class CSlabAllocator
+{
+public:
+
+	typedef T value_type;
+
+	/**
+	 * Constructor of class CSlabAllocator
+	 * @param CSlabArena* pArena : IN arena of the memory, has to live longer than the container
+	 * @return no value
+	 */
+	CSlabAllocator(CSlabArena* pArena) :
+			m_pArena(pArena)
+	{
+	}
+
+	/**
+	 * Constructor of class CSlabAllocator for the allocator of another type, used by the containers
+	 * @param const CSlabAllocator<U>& other : IN allocator
+	 * @return no value
+	 */
+	template<class U>
+	CSlabAllocator(const CSlabAllocator<U>& other) :
+			m_pArena(other.getArena())
+	{
+	}
+
+	/**
+	 * Function returns memory for elements
+	 * @param size_t n : IN number of elements
+	 * @returnvalue T* : memory for the elements
+	 */
+	T* allocate(size_t n)
+	{
+		return static_cast<T*>(m_pArena->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	/**
+	 * Function takes back memory of elements
+	 * @param T* p     : IN memory returned by allocate()
+	 * @param size_t n : IN number of elements
+	 * @returnvalue void
+	 */
+	void deallocate(T* p, size_t n)
+	{
+		m_pArena->deallocate(p, n * sizeof(T), alignof(T));
+	}
+
+	/**
+	 * Function returns the arena of the allocator
+	 * @param no parameters
+	 * @returnvalue CSlabArena* : arena
+	 */
+	CSlabArena* getArena() const
+	{
+		return m_pArena;
+	}
+
+private:
+
+	CSlabArena* m_pArena;
+};
+
+/**
+ * Operator compares two allocators
+ * @param const CSlabAllocator<T>& left  : IN allocator
+ * @param const CSlabAllocator<U>& right : IN allocator
+ * @returnvalue true if both use the same arena
+ */
+template<class T, class U>
+bool operator==(const CSlabAllocator<T>& left, const CSlabAllocator<U>& right)
+{
+	return left.getArena() == right.getArena();
+}
+
+/**
+ * Operator compares two allocators
+ * @param const CSlabAllocator<T>& left  : IN allocator
+ * @param const CSlabAllocator<U>& right : IN allocator
+ * @returnvalue true if they use different arenas
+ */
+template<class T, class U>
+bool operator!=(const CSlabAllocator<T>& left, const CSlabAllocator<U>& right)
+{
+	return left.getArena() != right.getArena();
+}
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CSLABALLOCATOR_H */
@@ -0,0 +1,153 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CSLABARENA.CPP
+ * Author          : George Sebastian
+ * Description     : CSlabArena hands out blocks from slabs of SLAB_BYTES. Block sizes are
+ *                   rounded up to their alignment and to the size of a pointer, so a freed
+ *                   block can hold the link of its free list.
+ ****************************************************************************/
+using namespace std;
+
+#include "CSlabArena.h"
+
+#define SLAB_BYTES 262144                // bytes per slab
+#define LARGE_BLOCK_BYTES 65536          // larger blocks get a slab of their own
+
+/**
+ * Constructor of class CSlabArena, no slab is allocated before the first block
+ * @param no parameters
+ * @return no value
+ */
+CSlabArena::CSlabArena()
+{
+	m_used = SLAB_BYTES;                   // no slab yet, the first block starts one
+	m_bytes = 0;
+}
+
+/**
+ * Destructor of class CSlabArena, deletes all slabs
+ * @param no parameters
+ * @return no value
+ */
+CSlabArena::~CSlabArena()
+{
+	release();
+}
+
+/**
+ * Function returns a block of memory
+ * @param size_t bytes     : IN size of the block
+ * @param size_t alignment : IN alignment of the block, a power of 2 up to the alignment of new
+ * @returnvalue void* : block
+ */
+void* CSlabArena::allocate(size_t bytes, size_t alignment)
+{
+	if (alignment < sizeof(void*))
+		alignment = sizeof(void*);
+	bytes = (bytes + alignment - 1) & ~(alignment - 1);
+
+	for (unsigned int i = 0; i < m_freeLists.size(); i++)
+	{
+		if (m_freeLists[i].bytes == bytes && m_freeLists[i].alignment == alignment
+				&& m_freeLists[i].pFirst != NULL)
+		{
+			void* pBlock = m_freeLists[i].pFirst;
+			m_freeLists[i].pFirst = *(void**) pBlock;
+			return pBlock;
+		}
+	}
+
+	if (bytes > LARGE_BLOCK_BYTES)
+	// large block : slab of its own, inserted before the current slab which stays the last one
+	{
+		char* pSlab = new char[bytes];
+		m_slabs.insert(m_slabs.empty() ? m_slabs.end() : m_slabs.end() - 1,
+				pSlab);
+		m_bytes += bytes;
+		return pSlab;
+	}
+
+	size_t offset = (m_used + alignment - 1) & ~(alignment - 1);
+
+	if (offset + bytes > SLAB_BYTES)
+	{
+		m_slabs.push_back(new char[SLAB_BYTES]);
+		m_bytes += SLAB_BYTES;
+		offset = 0;
+	}
+
+	m_used = offset + bytes;
+	return m_slabs.back() + offset;
+}
+
+/**
+ * Function takes back a block, it is handed out again by allocate() for a block of the same size and alignment
+ * @param void* pBlock     : IN block returned by allocate()
+ * @param size_t bytes     : IN size passed to allocate()
+ * @param size_t alignment : IN alignment passed to allocate()
+ * @returnvalue void
+ */
+void CSlabArena::deallocate(void* pBlock, size_t bytes, size_t alignment)
+{
+	if (pBlock == NULL)
+		return;
+
+	// same rounding as allocate()
+	if (alignment < sizeof(void*))
+		alignment = sizeof(void*);
+	bytes = (bytes + alignment - 1) & ~(alignment - 1);
+
+	unsigned int i = 0;
+	while (i < m_freeLists.size()
+			&& (m_freeLists[i].bytes != bytes || m_freeLists[i].alignment != alignment))
+		i++;
+
+	if (i == m_freeLists.size())
+	{
+		t_freeList freeList;
+		freeList.bytes = bytes;
+		freeList.alignment = alignment;
+		freeList.pFirst = NULL;
+		m_freeLists.push_back(freeList);
+	}
+
+	*(void**) pBlock = m_freeLists[i].pFirst;
+	m_freeLists[i].pFirst = pBlock;
+}
+
+/**
+ * Function deletes all slabs, the blocks handed out before must not be used any more
+ * @param no parameters
+ * @returnvalue void
+ */
+void CSlabArena::release()
+{
+	for (unsigned int i = 0; i < m_slabs.size(); i++)
+		delete[] m_slabs[i];
+
+	m_slabs.clear();
+	m_freeLists.clear();
+	m_used = SLAB_BYTES;
+	m_bytes = 0;
+}
+
+/**
+ * Function returns the number of slabs
+ * @param no parameters
+ * @returnvalue unsigned int : number of slabs
+ */
+unsigned int CSlabArena::getNoSlabs() const
+{
+	return m_slabs.size();
+}
+
+/**
+ * Function returns the memory of all slabs
+ * @param no parameters
+ * @returnvalue size_t : bytes
+ */
+size_t CSlabArena::getBytes() const
+{
+	return m_bytes;
+}
@@ -0,0 +1,111 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CSLABARENA.H
+ * Author          : George Sebastian
+ * Description     : CSlabArena hands out memory from large slabs by moving a pointer.
+ *                   Freed blocks are kept in a free list per block size and alignment and
+ *                   handed out again, the slabs themselves are only returned by release(), which
+ *                   deletes all of them at once : the cost depends on the number of
+ *                   slabs, not on the number of blocks.
+ *                   Blocks handed out one after another lie next to each other in a
+ *                   slab. An arena is used by one object (e.g. one CDatabase) and does
+ *                   not lock.
+ ****************************************************************************/
+#ifndef CSLABARENA_H
+#define CSLABARENA_H
+
+#include <vector>
+#include <cstddef>
+
+class CSlabArena
+{
+public:
+
+	/**
+	 * Constructor of class CSlabArena, no slab is allocated before the first block
+	 * @param no parameters
+	 * @return no value
+	 */
+	CSlabArena();
+
+	/**
+	 * Destructor of class CSlabArena, deletes all slabs
+	 * @param no parameters
+	 * @return no value
+	 */
+	~CSlabArena();
+
+	/**
+	 * Function returns a block of memory
+	 * @param size_t bytes     : IN size of the block
+	 * @param size_t alignment : IN alignment of the block, a power of 2 up to the alignment of new
+	 * @returnvalue void* : block
+	 */
+	void* allocate(size_t bytes, size_t alignment);
+
+	/**
+	 * Function takes back a block, it is handed out again by allocate() for a block of the same size and alignment
+	 * @param void* pBlock     : IN block returned by allocate()
+	 * @param size_t bytes     : IN size passed to allocate()
+	 * @param size_t alignment : IN alignment passed to allocate()
+	 * @returnvalue void
+	 */
+	void deallocate(void* pBlock, size_t bytes, size_t alignment);
+
+	/**
+	 * Function deletes all slabs, the blocks handed out before must not be used any more
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void release();
+
+	/**
+	 * Function returns the number of slabs
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of slabs
+	 */
+	unsigned int getNoSlabs() const;
+
+	/**
+	 * Function returns the memory of all slabs
+	 * @param no parameters
+	 * @returnvalue size_t : bytes
+	 */
+	size_t getBytes() const;
+
+private:
+
+	/**
+	 * Copy constructor of class CSlabArena, not available : the blocks belong to one arena
+	 * @param const CSlabArena& other : IN arena
+	 * @return no value
+	 */
+	CSlabArena(const CSlabArena& other);
+
+	/**
+	 * Assignment operator of class CSlabArena, not available : the blocks belong to one arena
+	 * @param const CSlabArena& other : IN arena
+	 * @returnvalue CSlabArena&
+	 */
+	CSlabArena& operator=(const CSlabArena& other);
+
+	/*
+	 * freed blocks of one size and alignment
+	 */
+	struct t_freeList
+	{
+		size_t bytes;
+		size_t alignment;
+		void* pFirst;                       // the first bytes of a free block point to the next one
+	};
+
+	std::vector<char*> m_slabs;             // the current slab is the last one
+	size_t m_used;                          // bytes used in the current slab
+	size_t m_bytes;                         // bytes of all slabs
+	std::vector<t_freeList> m_freeLists;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CSLABARENA_H */
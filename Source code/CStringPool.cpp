@@ -0,0 +1,430 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CSTRINGPOOL.CPP
+ * Author          : George Sebastian
+ * Description     : CStringPool interns strings into an append only arena. The entries of
+ *                   the IDs are in blocks of ENTRIES_PER_BLOCK; the vector of the block
+ *                   pointers is reserved for all 2^26 indexes when the pool is created, so
+ *                   adding a block never moves the pointers get() reads. The hash table
+ *                   has a power of 2 slots and is kept at most half full.
+ *                   The pools are registered in a table indexed by their number; the
+ *                   blocks of a pool of a Database are taken from its CSlabArena, only the
+ *                   hash table is on the heap.
+ ****************************************************************************/
+#include <string.h>
+#include <stdexcept>
+using namespace std;
+
+#include "CStringPool.h"
+
+#define ARENA_BLOCK_BYTES 65536          // characters per arena block, longer strings get a block of their own
+#define ENTRIES_PER_BLOCK 65536          // entries per entry block
+#define MIN_SLOTS 1024                   // slots of the empty hash table
+#define INDEX_BITS 26                    // lower bits of an ID : index of the string in its pool
+#define INDEX_MASK ((1u << INDEX_BITS) - 1)
+#define MAX_STRINGS (1u << INDEX_BITS)   // strings per pool
+#define MAX_POOLS (1u << (32 - INDEX_BITS))  // numbers of pools, 0 : shared pool
+
+static CStringPool* registeredPools[MAX_POOLS];   // pool of each number, NULL : number is free
+static mutex registeredPoolsMutex;
+
+/**
+ * Constructor of class CStringPool for the pool of a Database
+ * @param CSlabArena& arena : IN arena of the Database, holds the characters and the entries
+ * @return no value
+ */
+CStringPool::CStringPool(CSlabArena& arena)
+{
+	m_pArena = &arena;
+	m_number = 0;                           // no free number : the strings go to the shared pool
+	m_arenaUsed = ARENA_BLOCK_BYTES;
+	m_arenaBytes = 0;
+	m_noStrings = 0;
+	m_entryBlocks.reserve(MAX_STRINGS / ENTRIES_PER_BLOCK);
+	m_slots.assign(MIN_SLOTS, 0);
+
+	lock_guard<mutex> lock(registeredPoolsMutex);
+
+	for (uint32_t number = 1; number < MAX_POOLS && m_number == 0; number++)
+	{
+		if (registeredPools[number] == NULL)
+		{
+			registeredPools[number] = this;
+			m_number = number;
+		}
+	}
+}
+
+/**
+ * Function returns the ID of a string in this pool, the string is added if it is not yet in it
+ * @param const char* text    : IN characters of the string (need not be terminated)
+ * @param unsigned int length : IN number of characters
+ * @returnvalue uint32_t : ID of the string
+ */
+uint32_t CStringPool::add(const char* text, unsigned int length)
+{
+	if (m_pArena != NULL && (m_number == 0 || m_noStrings == MAX_STRINGS))
+		// pool of a Database without number or full
+		return intern(text, length);
+
+	uint32_t textHash = hash(text, length);
+	unique_lock<mutex> lock(m_mutex, defer_lock);
+	if (m_pArena == NULL)
+		// only the shared pool is used by several threads
+		lock.lock();
+
+	unsigned int slot = findSlot(text, length, textHash);
+	if (m_slots[slot] != 0)
+		// already in the pool
+		return (m_number << INDEX_BITS) | (m_slots[slot] - 1);
+
+	uint32_t index = m_noStrings;
+	if (index == MAX_STRINGS)
+		throw length_error("CStringPool : too many strings");
+	if (index % ENTRIES_PER_BLOCK == 0)
+		m_entryBlocks.push_back(
+				(t_entry*) newBlock(ENTRIES_PER_BLOCK * sizeof(t_entry)));
+
+	t_entry& newEntry = m_entryBlocks[index / ENTRIES_PER_BLOCK][index % ENTRIES_PER_BLOCK];
+	newEntry.text = store(text, length);
+	newEntry.length = length;
+	newEntry.hash = textHash;
+
+	m_noStrings++;
+	m_slots[slot] = index + 1;
+
+	if (2 * (size_t) m_noStrings > m_slots.size())
+		grow();
+
+	return (m_number << INDEX_BITS) | index;
+}
+
+/**
+ * Function returns the ID of a string in this pool, the string is added if it is not yet in it
+ * @param const std::string& text : IN string
+ * @returnvalue uint32_t : ID of the string
+ */
+uint32_t CStringPool::add(const string& text)
+{
+	return add(text.data(), text.size());
+}
+
+/**
+ * Function checks whether an ID belongs to this pool
+ * @param uint32_t id : IN ID
+ * @returnvalue true if the string of the ID is in this pool
+ */
+bool CStringPool::owns(uint32_t id) const
+{
+	return (id >> INDEX_BITS) == m_number;
+}
+
+/**
+ * Function forgets all strings of the pool of a Database, called after release() of its arena
+ * @param no parameters
+ * @returnvalue void
+ */
+void CStringPool::reset()
+{
+	if (m_pArena == NULL)
+		// the strings of the shared pool stay valid as long as the program runs
+		return;
+
+	// the blocks were in the slabs of the arena
+	m_arenaBlocks.clear();
+	m_arenaUsed = ARENA_BLOCK_BYTES;
+	m_arenaBytes = 0;
+	m_entryBlocks.clear();
+	m_noStrings = 0;
+	vector<uint32_t>(MIN_SLOTS, 0).swap(m_slots);
+}
+
+/**
+ * Function returns the ID of a string in the shared pool, the string is added if it is not yet in it
+ * @param const char* text      : IN characters of the string (need not be terminated)
+ * @param unsigned int length   : IN number of characters
+ * @returnvalue uint32_t : ID of the string
+ */
+uint32_t CStringPool::intern(const char* text, unsigned int length)
+{
+	return getSharedPool().add(text, length);
+}
+
+/**
+ * Function returns the ID of a string in the shared pool, the string is added if it is not yet in it
+ * @param const std::string& text : IN string
+ * @returnvalue uint32_t : ID of the string
+ */
+uint32_t CStringPool::intern(const string& text)
+{
+	return getSharedPool().add(text.data(), text.size());
+}
+
+/**
+ * Function searches a string in the shared pool without adding it
+ * @param const char* text    : IN characters of the string
+ * @param unsigned int length : IN number of characters
+ * @param uint32_t& id        : OUT ID of the string
+ * @returnvalue true if the string is in the pool
+ */
+bool CStringPool::find(const char* text, unsigned int length, uint32_t& id)
+{
+	CStringPool& pool = getSharedPool();
+	uint32_t textHash = hash(text, length);
+	lock_guard<mutex> lock(pool.m_mutex);
+
+	uint32_t slotValue = pool.m_slots[pool.findSlot(text, length, textHash)];
+	if (slotValue == 0)
+		return false;
+
+	id = slotValue - 1;
+	return true;
+}
+
+/**
+ * Function returns the characters of a string
+ * @param uint32_t id : IN ID returned by intern() or add()
+ * @returnvalue const char* : characters in the arena, terminated by '\0'
+ */
+const char* CStringPool::get(uint32_t id)
+{
+	return entry(id).text;
+}
+
+/**
+ * Function returns the length of a string
+ * @param uint32_t id : IN ID returned by intern() or add()
+ * @returnvalue unsigned int : number of characters
+ */
+unsigned int CStringPool::getLength(uint32_t id)
+{
+	return entry(id).length;
+}
+
+/**
+ * Function returns a copy of a string
+ * @param uint32_t id : IN ID returned by intern() or add()
+ * @returnvalue std::string : string
+ */
+string CStringPool::getString(uint32_t id)
+{
+	const t_entry& stringEntry = entry(id);
+	return string(stringEntry.text, stringEntry.length);
+}
+
+/**
+ * Function returns the number of distinct strings of the shared pool
+ * @param no parameters
+ * @returnvalue unsigned int : number of strings in the pool
+ */
+unsigned int CStringPool::getNoStrings()
+{
+	CStringPool& pool = getSharedPool();
+	lock_guard<mutex> lock(pool.m_mutex);
+
+	return pool.m_noStrings;
+}
+
+/**
+ * Function returns the memory used by the shared pool : arena, entries and hash table
+ * @param no parameters
+ * @returnvalue size_t : bytes
+ */
+size_t CStringPool::getMemoryBytes()
+{
+	CStringPool& pool = getSharedPool();
+	lock_guard<mutex> lock(pool.m_mutex);
+
+	return pool.m_arenaBytes
+			+ pool.m_entryBlocks.size() * ENTRIES_PER_BLOCK * sizeof(t_entry)
+			+ pool.m_entryBlocks.capacity() * sizeof(t_entry*)
+			+ pool.m_slots.size() * sizeof(uint32_t);
+}
+
+/**
+ * Constructor of class CStringPool for the shared pool
+ * @param no parameters
+ * @return no value
+ */
+CStringPool::CStringPool()
+{
+	m_pArena = NULL;
+	m_number = 0;
+	m_arenaUsed = ARENA_BLOCK_BYTES;        // no block yet, the first string starts one
+	m_arenaBytes = 0;
+	m_noStrings = 0;
+	m_entryBlocks.reserve(MAX_STRINGS / ENTRIES_PER_BLOCK);
+	m_slots.assign(MIN_SLOTS, 0);
+
+	lock_guard<mutex> lock(registeredPoolsMutex);
+	registeredPools[0] = this;
+}
+
+/**
+ * Destructor of class CStringPool, frees the blocks of the shared pool, the number of the pool can be used again
+ * @param no parameters
+ * @return no value
+ */
+CStringPool::~CStringPool()
+{
+	if (m_pArena == NULL)
+	// shared pool : own blocks
+	{
+		for (unsigned int i = 0; i < m_arenaBlocks.size(); i++)
+			delete[] m_arenaBlocks[i];
+		for (unsigned int i = 0; i < m_entryBlocks.size(); i++)
+			delete[] (char*) m_entryBlocks[i];
+	}
+	else if (m_number != 0)
+	// pool of a Database : the blocks are deleted with the slabs of the arena
+	{
+		lock_guard<mutex> lock(registeredPoolsMutex);
+		registeredPools[m_number] = NULL;
+	}
+}
+
+/**
+ * Function returns the shared pool of the program, created on the first use
+ * @param no parameters
+ * @returnvalue CStringPool& : pool
+ */
+CStringPool& CStringPool::getSharedPool()
+{
+	static CStringPool pool;
+	return pool;
+}
+
+/**
+ * Function returns the FNV-1a hash of a string
+ * @param const char* text    : IN characters
+ * @param unsigned int length : IN number of characters
+ * @returnvalue uint32_t : hash
+ */
+uint32_t CStringPool::hash(const char* text, unsigned int length)
+{
+	uint32_t textHash = 2166136261u;
+
+	for (unsigned int i = 0; i < length; i++)
+	{
+		textHash ^= (unsigned char) text[i];
+		textHash *= 16777619u;
+	}
+	return textHash;
+}
+
+/**
+ * Function returns the entry of an ID
+ * @param uint32_t id : IN ID of any pool
+ * @returnvalue const t_entry& : entry
+ */
+const CStringPool::t_entry& CStringPool::entry(uint32_t id)
+{
+	return registeredPools[id >> INDEX_BITS]->localEntry(id & INDEX_MASK);
+}
+
+/**
+ * Function returns the entry of a string of this pool
+ * @param uint32_t index : IN index of the string in the pool
+ * @returnvalue const t_entry& : entry
+ */
+const CStringPool::t_entry& CStringPool::localEntry(uint32_t index) const
+{
+	return m_entryBlocks[index / ENTRIES_PER_BLOCK][index % ENTRIES_PER_BLOCK];
+}
+
+/**
+ * Function searches the slot of a string in the hash table, the mutex has to be locked
+ * @param const char* text    : IN characters
+ * @param unsigned int length : IN number of characters
+ * @param uint32_t textHash   : IN hash of the string
+ * @returnvalue unsigned int : slot holding the string or the empty slot where it belongs
+ */
+unsigned int CStringPool::findSlot(const char* text, unsigned int length,
+		uint32_t textHash) const
+{
+	unsigned int mask = m_slots.size() - 1;
+	unsigned int slot = textHash & mask;
+
+	while (m_slots[slot] != 0)
+	{
+		const t_entry& slotEntry = localEntry(m_slots[slot] - 1);
+
+		if (slotEntry.hash == textHash && slotEntry.length == length
+				&& memcmp(slotEntry.text, text, length) == 0)
+			break;
+
+		slot = (slot + 1) & mask;
+	}
+	return slot;
+}
+
+/**
+ * Function returns a new block, from the arena of the Database or from the heap for the shared pool
+ * @param size_t bytes : IN size of the block
+ * @returnvalue char* : block
+ */
+char* CStringPool::newBlock(size_t bytes)
+{
+	if (m_pArena != NULL)
+		return (char*) m_pArena->allocate(bytes, sizeof(void*));
+
+	return new char[bytes];
+}
+
+/**
+ * Function copies characters into the arena, a new block is started when the current one is full
+ * @param const char* text    : IN characters
+ * @param unsigned int length : IN number of characters
+ * @returnvalue const char* : copy in the arena, terminated by '\0'
+ */
+const char* CStringPool::store(const char* text, unsigned int length)
+{
+	char* copy;
+
+	if (length + 1 > ARENA_BLOCK_BYTES)
+	// long string : block of its own, inserted before the current block which stays the last one
+	{
+		copy = newBlock(length + 1);
+		m_arenaBlocks.insert(
+				m_arenaBlocks.empty() ? m_arenaBlocks.end() : m_arenaBlocks.end() - 1,
+				copy);
+		m_arenaBytes += length + 1;
+	}
+	else
+	{
+		if (m_arenaUsed + length + 1 > ARENA_BLOCK_BYTES)
+		{
+			m_arenaBlocks.push_back(newBlock(ARENA_BLOCK_BYTES));
+			m_arenaUsed = 0;
+			m_arenaBytes += ARENA_BLOCK_BYTES;
+		}
+		copy = m_arenaBlocks.back() + m_arenaUsed;
+		m_arenaUsed += length + 1;
+	}
+
+	memcpy(copy, text, length);
+	copy[length] = '\0';
+	return copy;
+}
+
+/**
+ * Function rebuilds the hash table with twice the number of slots, the mutex has to be locked
+ * @param no parameters
+ * @returnvalue void
+ */
+void CStringPool::grow()
+{
+	unsigned int mask = 2 * m_slots.size() - 1;
+
+	m_slots.assign(2 * m_slots.size(), 0);
+
+	for (uint32_t index = 0; index < m_noStrings; index++)
+	{
+		unsigned int slot = localEntry(index).hash & mask;
+
+		while (m_slots[slot] != 0)
+			slot = (slot + 1) & mask;
+		m_slots[slot] = index + 1;
+	}
+}
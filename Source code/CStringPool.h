@@ -0,0 +1,257 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CSTRINGPOOL.H
+ * Author          : George Sebastian
+ * Description     : CStringPool interns strings : every distinct string is stored once in
+ *                   an append only arena and identified by a 32 bit ID. Names of Waypoints
+ *                   and POIs and descriptions of POIs are kept as IDs, so a description
+ *                   repeated by a million POIs is stored once, and copying a Waypoint or
+ *                   POI (e.g. by getDbContainer()) copies no characters.
+ *                   The shared pool of the program is used by the static functions. Its
+ *                   blocks are never moved or freed, the characters of its IDs stay valid
+ *                   as long as the program runs.
+ *                   A Database has a pool of its own whose characters and entries are in
+ *                   the CSlabArena of the Database : they are freed with the slabs, reset()
+ *                   forgets them. The IDs of such a pool are valid until reset() or the
+ *                   destruction of the pool.
+ *                   ID : number of the pool (upper 6 bits, 0 : shared pool) and index of
+ *                   the string in the pool (lower 26 bits), get() finds the pool by its
+ *                   number. At most 63 pools of Databases exist at the same time, further
+ *                   ones (and full ones) add their strings to the shared pool.
+ *                   The strings are terminated by '\0'.
+ *                   Lookup : open addressing hash table of the IDs, the hash of each string
+ *                   is stored with it and compared before the characters. Strings are
+ *                   looked up by pointer and length, no std::string has to be built.
+ *                   intern() and find() are thread safe. get() does not lock : the entries
+ *                   are stored in blocks which are never moved either. A pool of a Database
+ *                   is used by the thread of the Database and does not lock.
+ ****************************************************************************/
+#ifndef CSTRINGPOOL_H
+#define CSTRINGPOOL_H
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <stdint.h>
+
+#include "CSlabArena.h"
+
+class CStringPool
+{
+public:
+
+	/**
+	 * Constructor of class CStringPool for the pool of a Database
+	 * @param CSlabArena& arena : IN arena of the Database, holds the characters and the entries
+	 * @return no value
+	 */
+	explicit CStringPool(CSlabArena& arena);
+
+	/**
+	 * Destructor of class CStringPool, frees the blocks of the shared pool, the number of the pool can be used again
+	 * @param no parameters
+	 * @return no value
+	 */
+	~CStringPool();
+
+	/**
+	 * Function returns the ID of a string in this pool, the string is added if it is not yet in it
+	 * @param const char* text    : IN characters of the string (need not be terminated)
+	 * @param unsigned int length : IN number of characters
+	 * @returnvalue uint32_t : ID of the string
+	 */
+	uint32_t add(const char* text, unsigned int length);
+
+	/**
+	 * Function returns the ID of a string in this pool, the string is added if it is not yet in it
+	 * @param const std::string& text : IN string
+	 * @returnvalue uint32_t : ID of the string
+	 */
+	uint32_t add(const std::string& text);
+
+	/**
+	 * Function checks whether an ID belongs to this pool
+	 * @param uint32_t id : IN ID
+	 * @returnvalue true if the string of the ID is in this pool
+	 */
+	bool owns(uint32_t id) const;
+
+	/**
+	 * Function forgets all strings of the pool of a Database, called after release() of its arena
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void reset();
+
+	/**
+	 * Function returns the shared pool of the program, created on the first use
+	 * @param no parameters
+	 * @returnvalue CStringPool& : pool
+	 */
+	static CStringPool& getSharedPool();
+
+	/**
+	 * Function returns the ID of a string in the shared pool, the string is added if it is not yet in it
+	 * @param const char* text      : IN characters of the string (need not be terminated)
+	 * @param unsigned int length   : IN number of characters
+	 * @returnvalue uint32_t : ID of the string
+	 */
+	static uint32_t intern(const char* text, unsigned int length);
+
+	/**
+	 * Function returns the ID of a string in the shared pool, the string is added if it is not yet in it
+	 * @param const std::string& text : IN string
+	 * @returnvalue uint32_t : ID of the string
+	 */
+	static uint32_t intern(const std::string& text);
+
+	/**
+	 * Function searches a string in the shared pool without adding it
+	 * @param const char* text    : IN characters of the string
+	 * @param unsigned int length : IN number of characters
+	 * @param uint32_t& id        : OUT ID of the string
+	 * @returnvalue true if the string is in the pool
+	 */
+	static bool find(const char* text, unsigned int length, uint32_t& id);
+
+	/**
+	 * Function returns the characters of a string
+	 * @param uint32_t id : IN ID returned by intern() or add()
+	 * @returnvalue const char* : characters in the arena, terminated by '\0'
+	 */
+	static const char* get(uint32_t id);
+
+	/**
+	 * Function returns the length of a string
+	 * @param uint32_t id : IN ID returned by intern() or add()
+	 * @returnvalue unsigned int : number of characters
+	 */
+	static unsigned int getLength(uint32_t id);
+
+	/**
+	 * Function returns a copy of a string
+	 * @param uint32_t id : IN ID returned by intern() or add()
+	 * @returnvalue std::string : string
+	 */
+	static std::string getString(uint32_t id);
+
+	/**
+	 * Function returns the number of distinct strings of the shared pool
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of strings in the pool
+	 */
+	static unsigned int getNoStrings();
+
+	/**
+	 * Function returns the memory used by the shared pool : arena, entries and hash table
+	 * @param no parameters
+	 * @returnvalue size_t : bytes
+	 */
+	static size_t getMemoryBytes();
+
+private:
+
+	/*
+	 * string in the arena
+	 */
+	struct t_entry
+	{
+		const char* text;
+		uint32_t length;
+		uint32_t hash;
+	};
+
+	/**
+	 * Constructor of class CStringPool for the shared pool
+	 * @param no parameters
+	 * @return no value
+	 */
+	CStringPool();
+
+	/**
+	 * Copy constructor of class CStringPool, not available : the IDs belong to one pool
+	 * @param const CStringPool& other : IN pool
+	 * @return no value
+	 */
+	CStringPool(const CStringPool& other);
+
+	/**
+	 * Assignment operator of class CStringPool, not available : the IDs belong to one pool
+	 * @param const CStringPool& other : IN pool
+	 * @returnvalue CStringPool&
+	 */
+	CStringPool& operator=(const CStringPool& other);
+
+	/**
+	 * Function returns the FNV-1a hash of a string
+	 * @param const char* text    : IN characters
+	 * @param unsigned int length : IN number of characters
+	 * @returnvalue uint32_t : hash
+	 */
+	static uint32_t hash(const char* text, unsigned int length);
+
+	/**
+	 * Function returns the entry of an ID
+	 * @param uint32_t id : IN ID of any pool
+	 * @returnvalue const t_entry& : entry
+	 */
+	static const t_entry& entry(uint32_t id);
+
+	/**
+	 * Function returns the entry of a string of this pool
+	 * @param uint32_t index : IN index of the string in the pool
+	 * @returnvalue const t_entry& : entry
+	 */
+	const t_entry& localEntry(uint32_t index) const;
+
+	/**
+	 * Function searches the slot of a string in the hash table, the mutex has to be locked
+	 * @param const char* text    : IN characters
+	 * @param unsigned int length : IN number of characters
+	 * @param uint32_t textHash   : IN hash of the string
+	 * @returnvalue unsigned int : slot holding the string or the empty slot where it belongs
+	 */
+	unsigned int findSlot(const char* text, unsigned int length,
+			uint32_t textHash) const;
+
+	/**
+	 * Function returns a new block, from the arena of the Database or from the heap for the shared pool
+	 * @param size_t bytes : IN size of the block
+	 * @returnvalue char* : block
+	 */
+	char* newBlock(size_t bytes);
+
+	/**
+	 * Function copies characters into the arena, a new block is started when the current one is full
+	 * @param const char* text    : IN characters
+	 * @param unsigned int length : IN number of characters
+	 * @returnvalue const char* : copy in the arena, terminated by '\0'
+	 */
+	const char* store(const char* text, unsigned int length);
+
+	/**
+	 * Function rebuilds the hash table with twice the number of slots, the mutex has to be locked
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void grow();
+
+	CSlabArena* m_pArena;                   // arena of the Database, NULL : shared pool
+	uint32_t m_number;                      // number of the pool in the IDs, 0 : shared pool
+
+	std::mutex m_mutex;                     // add() and find() of the shared pool
+
+	std::vector<char*> m_arenaBlocks;
+	size_t m_arenaUsed;                     // bytes used in the last block
+	size_t m_arenaBytes;                    // bytes of all blocks
+
+	std::vector<t_entry*> m_entryBlocks;    // capacity reserved for all IDs, never reallocated
+	unsigned int m_noStrings;
+
+	std::vector<uint32_t> m_slots;          // index + 1, 0 : empty slot
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CSTRINGPOOL_H */
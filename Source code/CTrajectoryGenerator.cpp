@@ -0,0 +1,416 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CTRAJECTORYGENERATOR.CPP
+ * Author          : George Sebastian
+ * Description     : CTrajectoryGenerator is a synthetic position sensor for load tests.
+ *                   It generates the fixes of one or many vehicles driving along a Route
+ *                   (or in a random walk) with a given speed, GPS noise and fix rate.
+ *                   The vehicles are served round robin, all vehicles get one fix per
+ *                   period (1 / rate). The same seed always gives the same fixes.
+ *                   Each vehicle has its own xorshift random number generator, a fix
+ *                   costs a few multiplications and no allocation.
+ ****************************************************************************/
+#include <math.h>
+#include <thread>
+#include <algorithm>
+using namespace std;
+
+#include "CTrajectoryGenerator.h"
+#include "CUnitVector.h"
+
+#define DEG_TO_RAD 0.017453292519943295
+#define TWO_PI 6.283185307179586
+
+/**
+ * Constructor of class CTrajectoryGenerator
+ * @param unsigned long long seed : IN seed of the random numbers, same seed gives the same fixes
+ * @return no value
+ */
+CTrajectoryGenerator::CTrajectoryGenerator(unsigned long long seed)
+{
+	m_seed = seed;
+	m_followRoute = false;
+	m_startLatitude = 49.8728;              // Darmstadt
+	m_startLongitude = 8.6512;
+	m_turnDegreePerSecond = 10.0;
+	m_noVehicles = 1;
+	m_speedKmh = 50.0;
+	m_noiseMetres = 0.0;
+	m_fixesPerSecond = 1.0;
+	m_pacing = AS_FAST_AS_POSSIBLE;
+	m_maxFixes = 0;
+
+	restart();
+}
+
+/**
+ * Function lets the vehicles drive along a Route. Each vehicle starts at a different position
+ * of the Route and starts again at the beginning after the end of the Route.
+ * @param const CRoute& route : IN Route with at least 2 elements
+ * @returnvalue true if the Route has at least 2 elements
+ */
+bool CTrajectoryGenerator::setRoute(const CRoute& route)
+{
+	CRouteView view = route.getRouteView();
+
+	if (view.size() < 2)
+		return false;
+
+	m_routeLatitudes.clear();
+	m_routeLongitudes.clear();
+	m_routeKm.clear();
+
+	const CWaypoint* pPrevious = NULL;
+	double routeKm = 0.0;
+
+	for (CRouteView::const_iterator itr = view.begin(); itr != view.end();
+			++itr)
+	{
+		if (pPrevious != NULL)
+			routeKm += pPrevious->calculateDistance(*itr->pWaypoint);
+
+		m_routeLatitudes.push_back(itr->pWaypoint->getLatitude());
+		m_routeLongitudes.push_back(itr->pWaypoint->getLongitude());
+		m_routeKm.push_back(routeKm);
+		pPrevious = itr->pWaypoint;
+	}
+
+	m_followRoute = true;
+	restart();
+	return true;
+}
+
+/**
+ * Function lets the vehicles drive in a random walk starting near a position
+ * @param const CWaypoint& start        : IN start position
+ * @param double turnDegreePerSecond    : IN standard deviation of the change of the heading per second
+ * @returnvalue void
+ */
+void CTrajectoryGenerator::setRandomWalk(const CWaypoint& start,
+		double turnDegreePerSecond)
+{
+	m_startLatitude = start.getLatitude();
+	m_startLongitude = start.getLongitude();
+	m_turnDegreePerSecond = turnDegreePerSecond;
+	m_followRoute = false;
+	restart();
+}
+
+/**
+ * Function sets the number of vehicles and restarts the generation
+ * @param unsigned int noVehicles : IN number of independent vehicles (at least 1)
+ * @returnvalue void
+ */
+void CTrajectoryGenerator::setNoVehicles(unsigned int noVehicles)
+{
+	m_noVehicles = (noVehicles > 0) ? noVehicles : 1;
+	restart();
+}
+
+/**
+ * Function sets the mean speed of the vehicles, each vehicle drives up to 10% slower or faster
+ * @param double speedKmh : IN speed in km/h
+ * @returnvalue void
+ */
+void CTrajectoryGenerator::setSpeed(double speedKmh)
+{
+	m_speedKmh = (speedKmh > 0.0) ? speedKmh : 0.0;
+	restart();
+}
+
+/**
+ * Function sets the GPS noise added to each fix
+ * @param double noiseMetres : IN standard deviation of the noise in metres (north and east)
+ * @returnvalue void
+ */
+void CTrajectoryGenerator::setNoise(double noiseMetres)
+{
+	m_noiseMetres = (noiseMetres > 0.0) ? noiseMetres : 0.0;
+	restart();
+}
+
+/**
+ * Function sets the rate of the fixes of each vehicle
+ * @param double fixesPerSecond : IN fixes per second and vehicle
+ * @param t_pacing pacing       : IN generate as fast as possible or at the rate in real time
+ * @returnvalue void
+ */
+void CTrajectoryGenerator::setRate(double fixesPerSecond, t_pacing pacing)
+{
+	if (fixesPerSecond > 0.0)
+		m_fixesPerSecond = fixesPerSecond;
+	m_pacing = pacing;
+	restart();
+}
+
+/**
+ * Function sets the total number of fixes, getNextFix() returns false afterwards
+ * @param unsigned long long maxFixes : IN number of fixes of all vehicles, 0 for no limit
+ * @returnvalue void
+ */
+void CTrajectoryGenerator::setMaxFixes(unsigned long long maxFixes)
+{
+	m_maxFixes = maxFixes;
+	restart();
+}
+
+/**
+ * Function restarts the generation : same seed, start positions and time as after the configuration
+ * @param no parameters
+ * @returnvalue void
+ */
+void CTrajectoryGenerator::restart()
+{
+	m_randomState.resize(m_noVehicles);
+	m_stepKm.resize(m_noVehicles);
+	m_positionKm.resize(m_noVehicles);
+	m_segment.resize(m_noVehicles);
+	m_latitude.resize(m_noVehicles);
+	m_longitude.resize(m_noVehicles);
+	m_heading.resize(m_noVehicles);
+
+	for (unsigned int vehicle = 0; vehicle < m_noVehicles; vehicle++)
+	{
+		// splitmix64 of seed and vehicle : independent, never zero streams for the vehicles
+		unsigned long long state = m_seed + (vehicle + 1) * 0x9E3779B97F4A7C15ULL;
+		state = (state ^ (state >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		state = (state ^ (state >> 27)) * 0x94D049BB133111EBULL;
+		state ^= state >> 31;
+		m_randomState[vehicle] = (state != 0) ? state : 1;
+
+		double speedFactor = 0.9 + 0.2 * nextUniform(m_randomState[vehicle]);
+		m_stepKm[vehicle] = m_speedKmh * speedFactor / 3600.0 / m_fixesPerSecond;
+
+		if (m_followRoute)
+		// vehicles spread equally over the Route
+		{
+			m_positionKm[vehicle] = m_routeKm.back() * vehicle / m_noVehicles;
+			m_segment[vehicle] = upper_bound(m_routeKm.begin(),
+					m_routeKm.end() - 1, m_positionKm[vehicle])
+					- m_routeKm.begin() - 1;
+		}
+		else
+		// vehicles start within about 1 km of the start position in random directions
+		{
+			m_latitude[vehicle] = m_startLatitude
+					+ (nextUniform(m_randomState[vehicle]) - 0.5) / CUnitVector::KM_PER_DEGREE;
+			m_longitude[vehicle] = m_startLongitude
+					+ (nextUniform(m_randomState[vehicle]) - 0.5)
+							/ (CUnitVector::KM_PER_DEGREE * cos(m_startLatitude * DEG_TO_RAD));
+			m_heading[vehicle] = TWO_PI * nextUniform(m_randomState[vehicle]);
+		}
+	}
+
+	m_noFixes = 0;
+	m_nextVehicle = 0;
+	m_period = 0;
+	m_startTime = chrono::steady_clock::now();
+}
+
+/**
+ * Function generates the next fix (vehicles round robin)
+ * @param t_gpsFix& fix : OUT next fix
+ * @returnvalue true if a fix was generated, false if the maximum number of fixes is reached
+ */
+bool CTrajectoryGenerator::getNextFix(t_gpsFix& fix)
+{
+	unsigned int vehicle;
+	return getNextFix(fix, vehicle);
+}
+
+/**
+ * Function generates the next fix and returns the vehicle it belongs to
+ * @param t_gpsFix& fix         : OUT next fix
+ * @param unsigned int& vehicle : OUT number of the vehicle, 0 .. number of vehicles - 1
+ * @returnvalue true if a fix was generated, false if the maximum number of fixes is reached
+ */
+bool CTrajectoryGenerator::getNextFix(t_gpsFix& fix, unsigned int& vehicle)
+{
+	if (m_maxFixes != 0 && m_noFixes >= m_maxFixes)
+		return false;
+
+	if (m_nextVehicle == 0 && m_pacing == REAL_TIME)
+		waitForPeriod();
+
+	vehicle = m_nextVehicle;
+	moveVehicle(vehicle, fix.latitude, fix.longitude);
+
+	if (m_noiseMetres > 0.0)
+	{
+		double noiseNorth, noiseEast;
+		nextGaussian(m_randomState[vehicle], noiseNorth, noiseEast);
+
+		double noiseDegree = m_noiseMetres / 1000.0 / CUnitVector::KM_PER_DEGREE;
+		fix.latitude += noiseNorth * noiseDegree;
+		fix.longitude += noiseEast * noiseDegree
+				/ cos(fix.latitude * DEG_TO_RAD);
+	}
+
+	fix.timestamp = m_period / m_fixesPerSecond;
+
+	m_noFixes++;
+	if (++m_nextVehicle == m_noVehicles)
+	// all vehicles got their fix of this period
+	{
+		m_nextVehicle = 0;
+		m_period++;
+	}
+	return true;
+}
+
+/**
+ * Function to get the current position of the user, i.e. the next generated fix
+ * @param no parameters
+ * @returnvalue CWaypoint : next position, "default city" if the maximum number of fixes is reached
+ */
+CWaypoint CTrajectoryGenerator::getCurrentPosition()
+{
+	t_gpsFix fix;
+
+	if (getNextFix(fix))
+		return CWaypoint("Current position", fix.latitude, fix.longitude);
+	else
+		return CWaypoint();
+}
+
+/**
+ * Function returns the number of fixes generated since the last restart
+ * @param no parameters
+ * @returnvalue unsigned long long : number of fixes
+ */
+unsigned long long CTrajectoryGenerator::getNoFixes() const
+{
+	return m_noFixes;
+}
+
+/**
+ * Function returns the next random number of a vehicle (xorshift64*)
+ * @param unsigned long long& state : IN/OUT state of the random number generator of the vehicle
+ * @returnvalue unsigned long long : random number
+ */
+unsigned long long CTrajectoryGenerator::nextRandom(unsigned long long& state)
+{
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	return state * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * Function returns a random number uniformly distributed in [0, 1)
+ * @param unsigned long long& state : IN/OUT state of the random number generator of the vehicle
+ * @returnvalue double : random number
+ */
+double CTrajectoryGenerator::nextUniform(unsigned long long& state)
+{
+	// upper 53 bits fill the mantissa
+	return (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Function returns 2 independent normally distributed random numbers (Box-Muller)
+ * @param unsigned long long& state : IN/OUT state of the random number generator of the vehicle
+ * @param double& first             : OUT first random number
+ * @param double& second            : OUT second random number
+ * @returnvalue void
+ */
+void CTrajectoryGenerator::nextGaussian(unsigned long long& state,
+		double& first, double& second)
+{
+	double radius = sqrt(-2.0 * log(1.0 - nextUniform(state))); // 1 - u avoids log(0)
+	double angle = TWO_PI * nextUniform(state);
+
+	first = radius * cos(angle);
+	second = radius * sin(angle);
+}
+
+/**
+ * Function moves a vehicle by one period and returns its exact position
+ * @param unsigned int vehicle : IN number of the vehicle
+ * @param double& latitude     : OUT latitude without noise
+ * @param double& longitude    : OUT longitude without noise
+ * @returnvalue void
+ */
+void CTrajectoryGenerator::moveVehicle(unsigned int vehicle,
+		double& latitude, double& longitude)
+{
+	if (m_followRoute)
+	{
+		double routeKm = m_routeKm.back();
+		double positionKm = m_positionKm[vehicle] + m_stepKm[vehicle];
+		unsigned int segment = m_segment[vehicle];
+
+		if (positionKm >= routeKm)
+		// end of the Route reached, starting again at the beginning
+		{
+			positionKm = (routeKm > 0.0) ? fmod(positionKm, routeKm) : 0.0;
+			segment = 0;
+		}
+
+		unsigned int lastSegment = m_routeKm.size() - 2;
+		while (segment < lastSegment && m_routeKm[segment + 1] <= positionKm)
+			segment++;
+
+		double segmentKm = m_routeKm[segment + 1] - m_routeKm[segment];
+		double fraction =
+				(segmentKm > 0.0) ?
+						(positionKm - m_routeKm[segment]) / segmentKm : 0.0;
+
+		latitude = m_routeLatitudes[segment]
+				+ fraction
+						* (m_routeLatitudes[segment + 1]
+								- m_routeLatitudes[segment]);
+		longitude = m_routeLongitudes[segment]
+				+ fraction
+						* (m_routeLongitudes[segment + 1]
+								- m_routeLongitudes[segment]);
+
+		m_positionKm[vehicle] = positionKm;
+		m_segment[vehicle] = segment;
+	}
+	else
+	{
+		double turn, unused;
+		nextGaussian(m_randomState[vehicle], turn, unused);
+
+		// heading changes like a random walk : standard deviation grows with the square root of the time
+		double heading = m_heading[vehicle]
+				+ turn * m_turnDegreePerSecond * DEG_TO_RAD
+						/ sqrt(m_fixesPerSecond);
+		double stepKm = m_stepKm[vehicle];
+
+		latitude = m_latitude[vehicle] + stepKm * cos(heading) / CUnitVector::KM_PER_DEGREE;
+		longitude = m_longitude[vehicle]
+				+ stepKm * sin(heading)
+						/ (CUnitVector::KM_PER_DEGREE * cos(latitude * DEG_TO_RAD));
+
+		if (latitude > 89.0 || latitude < -89.0)
+		// turning back before the pole
+		{
+			latitude = m_latitude[vehicle];
+			heading += TWO_PI / 2;
+		}
+		if (longitude > 180.0)
+			longitude -= 360.0;
+		else if (longitude < -180.0)
+			longitude += 360.0;
+
+		m_latitude[vehicle] = latitude;
+		m_longitude[vehicle] = longitude;
+		m_heading[vehicle] = heading;
+	}
+}
+
+/**
+ * Function waits until the current period is due in REAL_TIME pacing
+ * @param no parameters
+ * @returnvalue void
+ */
+void CTrajectoryGenerator::waitForPeriod()
+{
+	chrono::steady_clock::time_point due = m_startTime
+			+ chrono::microseconds(
+					(long long) (m_period / m_fixesPerSecond * 1e6));
+	this_thread::sleep_until(due);
+}
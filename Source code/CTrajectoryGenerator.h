@@ -0,0 +1,210 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CTRAJECTORYGENERATOR.H
+ * Author          : George Sebastian
+ * Description     : CTrajectoryGenerator is a synthetic position sensor for load tests.
+ *                   It generates the fixes of one or many vehicles driving along a Route
+ *                   (or in a random walk) with a given speed, GPS noise and fix rate.
+ *                   The vehicles are served round robin, all vehicles get one fix per
+ *                   period (1 / rate). The same seed always gives the same fixes.
+ *                   Like all position sensors it can replace the GPS Sensor, so the whole
+ *                   navigation pipeline can be tested without hardware.
+ ****************************************************************************/
+#ifndef CTRAJECTORYGENERATOR_H
+#define CTRAJECTORYGENERATOR_H
+
+#include <vector>
+#include <chrono>
+
+#include "CPositionSensor.h"
+#include "CRoute.h"
+
+class CTrajectoryGenerator: public CPositionSensor
+{
+public:
+
+	/*
+	 * pacing of the generated fixes
+	 */
+	enum t_pacing
+	{
+		AS_FAST_AS_POSSIBLE, REAL_TIME
+	};
+
+	/**
+	 * Constructor of class CTrajectoryGenerator
+	 * @param unsigned long long seed : IN seed of the random numbers, same seed gives the same fixes
+	 * @return no value
+	 */
+	CTrajectoryGenerator(unsigned long long seed = 1);
+
+	/**
+	 * Function lets the vehicles drive along a Route. Each vehicle starts at a different position
+	 * of the Route and starts again at the beginning after the end of the Route.
+	 * @param const CRoute& route : IN Route with at least 2 elements
+	 * @returnvalue true if the Route has at least 2 elements
+	 */
+	bool setRoute(const CRoute& route);
+
+	/**
+	 * Function lets the vehicles drive in a random walk starting near a position
+	 * @param const CWaypoint& start        : IN start position
+	 * @param double turnDegreePerSecond    : IN standard deviation of the change of the heading per second
+	 * @returnvalue void
+	 */
+	void setRandomWalk(const CWaypoint& start, double turnDegreePerSecond = 10.0);
+
+	/**
+	 * Function sets the number of vehicles and restarts the generation
+	 * @param unsigned int noVehicles : IN number of independent vehicles (at least 1)
+	 * @returnvalue void
+	 */
+	void setNoVehicles(unsigned int noVehicles);
+
+	/**
+	 * Function sets the mean speed of the vehicles, each vehicle drives up to 10% slower or faster
+	 * @param double speedKmh : IN speed in km/h
+	 * @returnvalue void
+	 */
+	void setSpeed(double speedKmh);
+
+	/**
+	 * Function sets the GPS noise added to each fix
+	 * @param double noiseMetres : IN standard deviation of the noise in metres (north and east)
+	 * @returnvalue void
+	 */
+	void setNoise(double noiseMetres);
+
+	/**
+	 * Function sets the rate of the fixes of each vehicle
+	 * @param double fixesPerSecond : IN fixes per second and vehicle
+	 * @param t_pacing pacing       : IN generate as fast as possible or at the rate in real time
+	 * @returnvalue void
+	 */
+	void setRate(double fixesPerSecond, t_pacing pacing = AS_FAST_AS_POSSIBLE);
+
+	/**
+	 * Function sets the total number of fixes, getNextFix() returns false afterwards
+	 * @param unsigned long long maxFixes : IN number of fixes of all vehicles, 0 for no limit
+	 * @returnvalue void
+	 */
+	void setMaxFixes(unsigned long long maxFixes);
+
+	/**
+	 * Function restarts the generation : same seed, start positions and time as after the configuration
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void restart();
+
+	/**
+	 * Function generates the next fix (vehicles round robin)
+	 * @param t_gpsFix& fix : OUT next fix
+	 * @returnvalue true if a fix was generated, false if the maximum number of fixes is reached
+	 */
+	virtual bool getNextFix(t_gpsFix& fix);
+
+	/**
+	 * Function generates the next fix and returns the vehicle it belongs to
+	 * @param t_gpsFix& fix         : OUT next fix
+	 * @param unsigned int& vehicle : OUT number of the vehicle, 0 .. number of vehicles - 1
+	 * @returnvalue true if a fix was generated, false if the maximum number of fixes is reached
+	 */
+	bool getNextFix(t_gpsFix& fix, unsigned int& vehicle);
+
+	/**
+	 * Function to get the current position of the user, i.e. the next generated fix
+	 * @param no parameters
+	 * @returnvalue CWaypoint : next position, "default city" if the maximum number of fixes is reached
+	 */
+	virtual CWaypoint getCurrentPosition();
+
+	/**
+	 * Function returns the number of fixes generated since the last restart
+	 * @param no parameters
+	 * @returnvalue unsigned long long : number of fixes
+	 */
+	unsigned long long getNoFixes() const;
+
+private:
+
+	/**
+	 * Function returns the next random number of a vehicle (xorshift64*)
+	 * @param unsigned long long& state : IN/OUT state of the random number generator of the vehicle
+	 * @returnvalue unsigned long long : random number
+	 */
+	static unsigned long long nextRandom(unsigned long long& state);
+
+	/**
+	 * Function returns a random number uniformly distributed in [0, 1)
+	 * @param unsigned long long& state : IN/OUT state of the random number generator of the vehicle
+	 * @returnvalue double : random number
+	 */
+	static double nextUniform(unsigned long long& state);
+
+	/**
+	 * Function returns 2 independent normally distributed random numbers (Box-Muller)
+	 * @param unsigned long long& state : IN/OUT state of the random number generator of the vehicle
+	 * @param double& first             : OUT first random number
+	 * @param double& second            : OUT second random number
+	 * @returnvalue void
+	 */
+	static void nextGaussian(unsigned long long& state, double& first,
+			double& second);
+
+	/**
+	 * Function moves a vehicle by one period and returns its exact position
+	 * @param unsigned int vehicle : IN number of the vehicle
+	 * @param double& latitude     : OUT latitude without noise
+	 * @param double& longitude    : OUT longitude without noise
+	 * @returnvalue void
+	 */
+	void moveVehicle(unsigned int vehicle, double& latitude, double& longitude);
+
+	/**
+	 * Function waits until the current period is due in REAL_TIME pacing
+	 * @param no parameters
+	 * @returnvalue void
+	 */
+	void waitForPeriod();
+
+	unsigned long long m_seed;
+
+	// Route : points and distance in km from the start of the Route to each point
+	bool m_followRoute;
+	std::vector<double> m_routeLatitudes;
+	std::vector<double> m_routeLongitudes;
+	std::vector<double> m_routeKm;
+
+	// random walk
+	double m_startLatitude;
+	double m_startLongitude;
+	double m_turnDegreePerSecond;
+
+	// configuration
+	unsigned int m_noVehicles;
+	double m_speedKmh;
+	double m_noiseMetres;
+	double m_fixesPerSecond;
+	t_pacing m_pacing;
+	unsigned long long m_maxFixes;
+
+	// state of the vehicles (one array per attribute)
+	std::vector<unsigned long long> m_randomState;
+	std::vector<double> m_stepKm;           // distance driven per period
+	std::vector<double> m_positionKm;       // Route : distance from the start of the Route
+	std::vector<unsigned int> m_segment;    // Route : current segment
+	std::vector<double> m_latitude;         // random walk : current position
+	std::vector<double> m_longitude;
+	std::vector<double> m_heading;          // random walk : heading in radian, 0 = north
+
+	unsigned long long m_noFixes;
+	unsigned int m_nextVehicle;
+	unsigned long long m_period;            // number of completed rounds over all vehicles
+	std::chrono::steady_clock::time_point m_startTime;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CTRAJECTORYGENERATOR_H */
@@ -0,0 +1,132 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CUNITVECTOR.CPP
+ * Author          : George Sebastian
+ * Description     : CUnitVector represents a geodetic position as unit vector (x,y,z)
+ *                   on the sphere. Distances, cross track distances and projections
+ *                   onto great circle segments reduce to dot and cross products and
+ *                   need far less trigonometry than calculations on latitude/longitude.
+ ****************************************************************************/
+#include <math.h>
+using namespace std;
+
+#include "CUnitVector.h"
+#include "CWaypoint.h"
+
+#define PI 3.14159265358979323846
+
+const double CUnitVector::EARTH_RADIUS = 6371.0088;          // mean radius of the WGS84 ellipsoid (IUGG)
+const double CUnitVector::KM_PER_DEGREE = CUnitVector::EARTH_RADIUS * PI / 180;
+
+/**
+ * Function returns the unit vector of a position given by latitude and longitude in degree
+ * @param double latitude  : IN latitude in degree
+ * @param double longitude : IN longitude in degree
+ * @returnvalue CUnitVector : unit vector of the position
+ */
+CUnitVector CUnitVector::fromLatLon(double latitude, double longitude)
+{
+	double lat = latitude * PI / 180, lon = longitude * PI / 180;
+	double cosLat = cos(lat);
+
+	return CUnitVector(cosLat * cos(lon), cosLat * sin(lon), sin(lat));
+}
+
+/**
+ * Function returns the unit vector of the position of a Waypoint
+ * @param const CWaypoint& wp : IN Waypoint
+ * @returnvalue CUnitVector : unit vector of the Waypoint
+ */
+CUnitVector CUnitVector::fromWaypoint(const CWaypoint& wp)
+{
+	CUnitVector position;
+
+	// no trigonometry if it is stored in the Waypoint (WAYPOINT_UNIT_VECTOR)
+	wp.getUnitVector(position.m_x, position.m_y, position.m_z);
+	return position;
+}
+
+/**
+ * Function converts the vector back to latitude and longitude in degree
+ * @param double& latitude  : OUT latitude in degree
+ * @param double& longitude : OUT longitude in degree
+ * @returnvalue void
+ */
+void CUnitVector::toLatLon(double& latitude, double& longitude) const
+{
+	latitude = atan2(m_z, sqrt(m_x * m_x + m_y * m_y)) * 180 / PI;
+	longitude = atan2(m_y, m_x) * 180 / PI;
+}
+
+/**
+ * Function returns the length of the vector
+ * @param no parameters
+ * @returnvalue double : euclidean length
+ */
+double CUnitVector::length() const
+{
+	return sqrt(dot(*this));
+}
+
+/**
+ * Function returns the vector scaled to length 1. The null vector is returned unchanged.
+ * @param no parameters
+ * @returnvalue CUnitVector : normalised vector
+ */
+CUnitVector CUnitVector::normalized() const
+{
+	double len = length();
+
+	if (len == 0.0)
+		return *this;
+
+	return CUnitVector(m_x / len, m_y / len, m_z / len);
+}
+
+/**
+ * Function returns the angle between two unit vectors in radian. Precise also for very small angles.
+ * @param const CUnitVector& v : IN other vector
+ * @returnvalue double : angle in radian
+ */
+double CUnitVector::angleTo(const CUnitVector& v) const
+{
+	// atan2 of sine and cosine does not lose precision for small angles like acos() does
+	return atan2(cross(v).length(), dot(v));
+}
+
+/**
+ * Function returns the great circle distance in km from this position to the great circle segment from a to b.
+ * If the projection of the position lies outside of the segment, the distance to the nearer end point is returned.
+ * @param const CUnitVector& a : IN start of the segment
+ * @param const CUnitVector& b : IN end of the segment
+ * @returnvalue double : distance in km
+ */
+double CUnitVector::distanceToSegment(const CUnitVector& a,
+		const CUnitVector& b) const
+{
+	CUnitVector normal = a.cross(b);
+	double normalLength = normal.length();
+
+	if (normalLength > 0.0)
+	{
+		normal = CUnitVector(normal.m_x / normalLength,
+				normal.m_y / normalLength, normal.m_z / normalLength);
+
+		if (a.cross(*this).dot(normal) >= 0.0
+				&& cross(b).dot(normal) >= 0.0)
+		// projection onto the great circle lies between a and b, cross track distance
+		{
+			double sinCrossTrack = dot(normal);
+			if (sinCrossTrack > 1.0)
+				sinCrossTrack = 1.0;
+			else if (sinCrossTrack < -1.0)
+				sinCrossTrack = -1.0;
+
+			return EARTH_RADIUS * fabs(asin(sinCrossTrack));
+		}
+	}
+
+	double distanceA = distanceTo(a), distanceB = distanceTo(b); // outside of the segment or a == b
+	return (distanceA < distanceB) ? distanceA : distanceB;
+}
@@ -0,0 +1,134 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CUNITVECTOR.H
+ * Author          : George Sebastian
+ * Description     : CUnitVector represents a geodetic position as unit vector (x,y,z)
+ *                   on the sphere. Distances, cross track distances and projections
+ *                   onto great circle segments reduce to dot and cross products and
+ *                   need far less trigonometry than calculations on latitude/longitude.
+ ****************************************************************************/
+#ifndef CUNITVECTOR_H
+#define CUNITVECTOR_H
+
+class CWaypoint;
+
+class CUnitVector
+{
+public:
+
+	/*
+	 * Mean radius of the earth in km, used by CWaypoint::calculateDistance(). On the sphere,
+	 * distances differ from the geodesic on the WGS84 ellipsoid by up to about 0.6%
+	 */
+	static const double EARTH_RADIUS;
+
+	/*
+	 * km per degree of latitude (and of longitude on the equator), derived from EARTH_RADIUS
+	 */
+	static const double KM_PER_DEGREE;
+
+	double m_x;
+	double m_y;
+	double m_z;
+
+	/**
+	 * Constructor of class CUnitVector
+	 * @param double x : IN x component
+	 * @param double y : IN y component
+	 * @param double z : IN z component
+	 * @return no value
+	 */
+	CUnitVector(double x = 1.0, double y = 0.0, double z = 0.0) :
+			m_x(x), m_y(y), m_z(z)
+	{
+	}
+
+	/**
+	 * Function returns the unit vector of a position given by latitude and longitude in degree
+	 * @param double latitude  : IN latitude in degree
+	 * @param double longitude : IN longitude in degree
+	 * @returnvalue CUnitVector : unit vector of the position
+	 */
+	static CUnitVector fromLatLon(double latitude, double longitude);
+
+	/**
+	 * Function returns the unit vector of the position of a Waypoint
+	 * @param const CWaypoint& wp : IN Waypoint
+	 * @returnvalue CUnitVector : unit vector of the Waypoint
+	 */
+	static CUnitVector fromWaypoint(const CWaypoint& wp);
+
+	/**
+	 * Function converts the vector back to latitude and longitude in degree
+	 * @param double& latitude  : OUT latitude in degree
+	 * @param double& longitude : OUT longitude in degree
+	 * @returnvalue void
+	 */
+	void toLatLon(double& latitude, double& longitude) const;
+
+	/**
+	 * Function returns the dot product of two vectors
+	 * @param const CUnitVector& v : IN other vector
+	 * @returnvalue double : dot product
+	 */
+	double dot(const CUnitVector& v) const
+	{
+		return m_x * v.m_x + m_y * v.m_y + m_z * v.m_z;
+	}
+
+	/**
+	 * Function returns the cross product of two vectors (not normalised)
+	 * @param const CUnitVector& v : IN other vector
+	 * @returnvalue CUnitVector : cross product this x v
+	 */
+	CUnitVector cross(const CUnitVector& v) const
+	{
+		return CUnitVector(m_y * v.m_z - m_z * v.m_y, m_z * v.m_x - m_x * v.m_z,
+				m_x * v.m_y - m_y * v.m_x);
+	}
+
+	/**
+	 * Function returns the length of the vector
+	 * @param no parameters
+	 * @returnvalue double : euclidean length
+	 */
+	double length() const;
+
+	/**
+	 * Function returns the vector scaled to length 1. The null vector is returned unchanged.
+	 * @param no parameters
+	 * @returnvalue CUnitVector : normalised vector
+	 */
+	CUnitVector normalized() const;
+
+	/**
+	 * Function returns the angle between two unit vectors in radian. Precise also for very small angles.
+	 * @param const CUnitVector& v : IN other vector
+	 * @returnvalue double : angle in radian
+	 */
+	double angleTo(const CUnitVector& v) const;
+
+	/**
+	 * Function returns the great circle distance in km between two unit vectors
+	 * @param const CUnitVector& v : IN other vector
+	 * @returnvalue double : distance in km
+	 */
+	double distanceTo(const CUnitVector& v) const
+	{
+		return EARTH_RADIUS * angleTo(v);
+	}
+
+	/**
+	 * Function returns the great circle distance in km from this position to the great circle segment from a to b.
+	 * If the projection of the position lies outside of the segment, the distance to the nearer end point is returned.
+	 * @param const CUnitVector& a : IN start of the segment
+	 * @param const CUnitVector& b : IN end of the segment
+	 * @returnvalue double : distance in km
+	 */
+	double distanceToSegment(const CUnitVector& a, const CUnitVector& b) const;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CUNITVECTOR_H */
@@ -5,6 +5,11 @@
  * Author          : George Sebastian
  * Description     : CWaypoint Class stores a geodetic position and provides some simple operations
  *                   for geodetic data
+ *                   With COMPACT_COORDINATES the attributes hold 1e-7 degree, the getters
+ *                   decode them and all calculations use the decoded values.
+ *                   calculateDistance() uses the angle between the unit vectors (atan2 of
+ *                   the sine and cosine, precise for small and large distances) and the
+ *                   earth radius of CUnitVector.
  ****************************************************************************/
 #include <iostream>
 #include <math.h>
@@ -12,11 +17,12 @@
 using namespace std;
 
 #include "CWaypoint.h"
+#include "CStringPool.h"
+#include "CUnitVector.h"
 
-#define RADIUS 6378.17       // Value of Radius of Earth
-#define PI 3.14159           // Value of Pi
 #define DEGREE 1
 #define MMSS 2
+#define PI 3.14159265358979323846
 //#define SHOWADDRESS   // define SHOWADDRESS only if address needs to be printed inside default constructor
 
 /**
@@ -25,27 +31,54 @@ using namespace std;
  * @param string name      : IN name of the Waypoint
  * @param double latitude  : IN latitude of the Waypoint
  * @param double longitude : IN longitude of the Waypoint
+ * @param CStringPool* pPool : IN pool of the name, NULL : shared pool
  * @returnvalue void
  */
-void CWaypoint::set(string name, double latitude, double longitude)
+void CWaypoint::set(string name, double latitude, double longitude,
+		CStringPool* pPool)
 {
+	CStringPool& pool = (pPool != NULL) ? *pPool : CStringPool::getSharedPool();
+
 	// checking the validity of parameter values and writing the correct values to the attributes.
 	if (latitude >= -90 && latitude <= 90 && longitude >= -180
 			&& longitude <= 180)
 	{
-		m_name = name;
-		m_latitude = latitude;
-		m_longitude = longitude;
+		m_nameId = pool.add(name);
+		setPosition(latitude, longitude);
 	}
 	//In case of invalid parameter values, writing '0' to the attributes
 	else
 	{
-		m_latitude = 0;
-		m_longitude = 0;
-		m_name = "default city";
+		setPosition(0, 0);
+		m_nameId = pool.add("default city");
 	}
 }
 
+/**
+ * Function writes the coordinates (and the unit vector) of a valid position to the attributes
+ * @param double latitude  : IN latitude in degree, -90 .. 90
+ * @param double longitude : IN longitude in degree, -180 .. 180
+ * @returnvalue void
+ */
+void CWaypoint::setPosition(double latitude, double longitude)
+{
+#if COMPACT_COORDINATES
+	m_latitude = encodeCoordinate(latitude);
+	m_longitude = encodeCoordinate(longitude);
+#else
+	m_latitude = latitude;
+	m_longitude = longitude;
+#endif
+
+#if WAYPOINT_UNIT_VECTOR
+	// from the stored (rounded) coordinates, the same vector as CUnitVector::fromLatLon(getLatitude(), getLongitude())
+	CUnitVector position = CUnitVector::fromLatLon(getLatitude(), getLongitude());
+	m_unitX = position.m_x;
+	m_unitY = position.m_y;
+	m_unitZ = position.m_z;
+#endif
+}
+
 /**
  * Function returns the name of the Waypoint
  * @param no parameters
@@ -53,7 +86,39 @@ void CWaypoint::set(string name, double latitude, double longitude)
  */
 string CWaypoint::getName()const
 {
-	return m_name;
+	return CStringPool::getString(m_nameId);
+}
+
+/**
+ * Function returns the name of the Waypoint without copying it
+ * @param no parameters
+ * @returnvalue const char* : the name of the Waypoint in CStringPool, terminated by '\0'
+ */
+const char* CWaypoint::getNameChars() const
+{
+	return CStringPool::get(m_nameId);
+}
+
+/**
+ * Function returns the ID of the name of the Waypoint, equal names have equal IDs
+ * @param no parameters
+ * @returnvalue uint32_t : ID of the name in CStringPool
+ */
+uint32_t CWaypoint::getNameId() const
+{
+	return m_nameId;
+}
+
+/**
+ * Function moves the strings of the Waypoint into a pool, strings already in the pool are not copied
+ * @param CStringPool& pool : IN pool, e.g. the one of the Database the Waypoint is added to
+ * @returnvalue void
+ */
+void CWaypoint::internStrings(CStringPool& pool)
+{
+	if (!pool.owns(m_nameId))
+		m_nameId = pool.add(CStringPool::get(m_nameId),
+				CStringPool::getLength(m_nameId));
 }
 
 /**
@@ -63,7 +128,11 @@ string CWaypoint::getName()const
  */
 double CWaypoint::getLatitude()const
 {
+#if COMPACT_COORDINATES
+	return decodeCoordinate(m_latitude);
+#else
 	return m_latitude;
+#endif
 }
 
 /**
@@ -73,7 +142,60 @@ double CWaypoint::getLatitude()const
  */
 double CWaypoint::getLongitude()const
 {
+#if COMPACT_COORDINATES
+	return decodeCoordinate(m_longitude);
+#else
 	return m_longitude;
+#endif
+}
+
+/**
+ * Function returns the latitude of the Waypoint in the fixed point encoding
+ * @param no parameters
+ * @returnvalue int32_t : the latitude of the Waypoint in 1e-7 degree
+ */
+int32_t CWaypoint::getLatitudeE7() const
+{
+#if COMPACT_COORDINATES
+	return m_latitude;
+#else
+	return encodeCoordinate(m_latitude);
+#endif
+}
+
+/**
+ * Function returns the longitude of the Waypoint in the fixed point encoding
+ * @param no parameters
+ * @returnvalue int32_t : the longitude of the Waypoint in 1e-7 degree
+ */
+int32_t CWaypoint::getLongitudeE7() const
+{
+#if COMPACT_COORDINATES
+	return m_longitude;
+#else
+	return encodeCoordinate(m_longitude);
+#endif
+}
+
+/**
+ * Function converts a coordinate in degree to the fixed point encoding, rounded to the nearest unit
+ * @param double degree : IN coordinate in degree, -180 .. 180
+ * @returnvalue int32_t : coordinate in 1e-7 degree
+ */
+int32_t CWaypoint::encodeCoordinate(double degree)
+{
+	// 180 degree are 1.8e9 units, int32_t holds up to 2.147e9
+	return (int32_t) floor(degree * COORDINATE_UNITS_PER_DEGREE + 0.5);
+}
+
+/**
+ * Function converts a coordinate in the fixed point encoding to degree
+ * @param int32_t units : IN coordinate in 1e-7 degree
+ * @returnvalue double : coordinate in degree
+ */
+double CWaypoint::decodeCoordinate(int32_t units)
+{
+	return units / COORDINATE_UNITS_PER_DEGREE;
 }
 
 /**
@@ -91,7 +213,7 @@ void CWaypoint::getAllDataByReference(string& name, double & latitude,
 	cout<<"Address and values of parameters of member function : name "<<name<<" "<<&name<<", latitude "<<latitude<<" "<<&latitude<<", longitude "<<longitude<<" "<<&longitude<<endl;
 #endif
 
-	name = getName();
+	name.assign(CStringPool::get(m_nameId), CStringPool::getLength(m_nameId));    // reuses the buffer of name
 	latitude = getLatitude();
 	longitude = getLongitude();
 }
@@ -108,7 +230,7 @@ void CWaypoint::transformLongitude2degmmss(int & deg, int & mm, double & ss)
 	double integerPart, fractionPart;
 	// modf() to extract integer and fraction part
 	// 60 minutes or 3600 seconds = 1 degree
-	fractionPart = modf(m_longitude, &integerPart);
+	fractionPart = modf(getLongitude(), &integerPart);
 	deg = (int) integerPart;
 	mm = (int) (fractionPart * 60);
 
@@ -128,7 +250,7 @@ void CWaypoint::transformLatitude2degmmss(int & deg, int & mm, double & ss)
 	double integerPart, fractionPart;
 	// modf() to extract integer and fraction part
 	// 60 minutes or 3600 seconds = 1 degree
-	fractionPart = modf(m_latitude, &integerPart);
+	fractionPart = modf(getLatitude(), &integerPart);
 	deg = (int) integerPart;
 	mm = (int) (fractionPart * 60);
 
@@ -136,22 +258,74 @@ void CWaypoint::transformLatitude2degmmss(int & deg, int & mm, double & ss)
 	ss = fractionPart * 60;
 }
 
+/**
+ * Function returns the position of the Waypoint as unit vector
+ * @param double& x : OUT x coordinate (latitude 0, longitude 0)
+ * @param double& y : OUT y coordinate (latitude 0, longitude 90)
+ * @param double& z : OUT z coordinate (north pole)
+ * @returnvalue void
+ */
+void CWaypoint::getUnitVector(double& x, double& y, double& z) const
+{
+#if WAYPOINT_UNIT_VECTOR
+	x = m_unitX;
+	y = m_unitY;
+	z = m_unitZ;
+#else
+	CUnitVector position = CUnitVector::fromLatLon(getLatitude(), getLongitude());
+	x = position.m_x;
+	y = position.m_y;
+	z = position.m_z;
+#endif
+}
+
 /**
  * Function calculates the distance between two Waypoints using the formula and returns the distance
  * @param const CWaypoint& wp : IN one of the Waypoint object passed via reference (Other Waypoint object is the object invoking this member function)
  * @return double : the calculated distance between the two Waypoints
  */
-double CWaypoint::calculateDistance(const CWaypoint& wp)
+double CWaypoint::calculateDistance(const CWaypoint& wp) const
+{
+#if WAYPOINT_UNIT_VECTOR
+	CUnitVector position, wpPosition;
+
+	getUnitVector(position.m_x, position.m_y, position.m_z);
+	wp.getUnitVector(wpPosition.m_x, wpPosition.m_y, wpPosition.m_z);
+
+	// atan2 of sine and cosine of the angle, acos() of the cosine alone loses precision for short distances
+	return position.distanceTo(wpPosition);
+#else
+	// the same angle from the coordinates : 6 sin/cos instead of 8 for both unit vectors
+	double latitude = getLatitude() * PI / 180, wpLatitude = wp.getLatitude() * PI / 180;
+	double deltaLongitude = (wp.getLongitude() - getLongitude()) * PI / 180;
+	double sinLatitude = sin(latitude), cosLatitude = cos(latitude);
+	double sinWpLatitude = sin(wpLatitude), cosWpLatitude = cos(wpLatitude);
+	double sinDelta = sin(deltaLongitude), cosDelta = cos(deltaLongitude);
+
+	double crossEast = cosWpLatitude * sinDelta;
+	double crossNorth = cosLatitude * sinWpLatitude - sinLatitude * cosWpLatitude * cosDelta;
+	double cosAngle = sinLatitude * sinWpLatitude + cosLatitude * cosWpLatitude * cosDelta;
+
+	// atan2 of sine and cosine of the angle, acos() of the cosine alone loses precision for short distances
+	return CUnitVector::EARTH_RADIUS
+			* atan2(sqrt(crossEast * crossEast + crossNorth * crossNorth), cosAngle);
+#endif
+}
+
+/**
+ * Function calculates the squared length of the chord between two Waypoints through the earth (unit sphere).
+ * It grows with the distance, Waypoints can be ranked by distance without trigonometry.
+ * @param const CWaypoint& wp : IN other Waypoint
+ * @returnvalue double : squared chord, 0 .. 4
+ */
+double CWaypoint::calculateChordSquared(const CWaypoint& wp) const
 {
-	return (RADIUS
-			* acos(
-					sin(this->m_latitude * PI / 180)
-							* sin(wp.m_latitude * PI / 180)
-							+ cos(this->m_latitude * PI / 180)
-									* cos(wp.m_latitude * PI / 180)
-									* cos(
-											(wp.m_longitude - this->m_longitude)
-													* PI / 180)));
+	double x, y, z, wpX, wpY, wpZ;
+
+	getUnitVector(x, y, z);
+	wp.getUnitVector(wpX, wpY, wpZ);
+
+	return (x - wpX) * (x - wpX) + (y - wpY) * (y - wpY) + (z - wpZ) * (z - wpZ);
 }
 
 /**
@@ -159,11 +333,11 @@ double CWaypoint::calculateDistance(const CWaypoint& wp)
  * @param int format : IN format in which latitude and longitude needs to be printed. '0' - decimal format, '1' - deg mm ss format
  * @returnvalue void
  */
-void CWaypoint::print(int format)
+void CWaypoint::print(int format) const
 {   // latitude and longitude printed in decimal format
 	if (format == DEGREE)
-		cout << m_name << " on latitude = " << m_latitude << " and longitude = "
-				<< m_longitude << endl;
+		cout << getNameChars() << " on latitude = " << getLatitude() << " and longitude = "
+				<< getLongitude() << endl;
 	// latitude and longitude printed in deg mm ss format
 	else
 	{
@@ -205,24 +379,27 @@ ostream& operator<<(ostream& out, const CWaypoint& Wp)
  * @param string name      : IN name of the Waypoint
  * @param double latitude  : IN latitude of the Waypoint
  * @param double longitude : IN longitude of the Waypoint
+ * @param CStringPool* pPool : IN pool of the name, NULL : shared pool
  * @returnvalue no value
  */
-CWaypoint::CWaypoint(string name, double latitude, double longitude)
+CWaypoint::CWaypoint(string name, double latitude, double longitude,
+		CStringPool* pPool)
 {
-	set(name, latitude, longitude);
+	set(name, latitude, longitude, pPool);
 
 #ifdef SHOWADDRESS
 
 	cout<<"Address of object "<<this<<endl;
-	cout<<"Attribute values are : "<<m_name<<" latitude "<<m_latitude<<" and longitude "<<m_longitude<<endl;
-	cout<<"Address of attributes are : "<<&m_name<<" "<<&m_latitude<<" "<<&m_longitude<<endl;
+	cout<<"Attribute values are : "<<getNameChars()<<" latitude "<<getLatitude()<<" and longitude "<<getLongitude()<<endl;
+	cout<<"Address of attributes are : "<<&m_nameId<<" "<<&m_latitude<<" "<<&m_longitude<<endl;
 #endif
 
 	/*
 	 *  Address is allocated to attributes in the same order in which they are defined inside the Class
 	 *  Address of object = Address of 1st attribute
-	 *  Size of double = 8 Bytes
-	 *  Size of string = 32 Bytes  // sizeof() operator
+	 *  Size of a coordinate = 4 Bytes (COMPACT_COORDINATES) or 8 Bytes (double)
+	 *  Size of the unit vector = 3 * 8 Bytes (WAYPOINT_UNIT_VECTOR)
+	 *  Size of the name ID = 4 Bytes  // sizeof() operator, the characters are in CStringPool
 	 */
 }
 
@@ -5,18 +5,56 @@
  * Author          : George Sebastian
  * Description     : CWaypoint Class stores a geodetic position and provides some simple operations
  *                   for geodetic data
+ *                   The name is stored as ID of CStringPool, equal names share one copy.
+ *                   It is in the shared pool, or in the pool of a Database for the
+ *                   Waypoints of the Database (see internStrings()).
+ *                   With COMPACT_COORDINATES the coordinates are stored as 32 bit integers
+ *                   in 1e-7 degree (about 1.1 cm on the equator) instead of doubles, they
+ *                   are converted to double only by the getters and the calculations.
+ *                   With WAYPOINT_UNIT_VECTOR the position is also stored as unit vector
+ *                   (x,y,z), computed once by set() : calculateDistance() needs no sin/cos
+ *                   of the coordinates, and calculateChordSquared() ranks distances with
+ *                   no trigonometry at all. It is off by default because it doubles the size
+ *                   of a Waypoint (48 instead of 24 bytes); CRouteTable, CRoadGraph and
+ *                   CDistanceMatrix keep the unit vectors of their Waypoints in their own
+ *                   arrays instead.
  ****************************************************************************/
 #ifndef CWAYPOINT_H
 #define CWAYPOINT_H
 
 #include <string>
+#include <stdint.h>
+
+class CStringPool;
+
+#define COMPACT_COORDINATES 1           // 1 : coordinates stored as int32 in 1e-7 degree, 0 : as double
+#define COORDINATE_UNITS_PER_DEGREE 10000000.0
+#define WAYPOINT_UNIT_VECTOR 0          // 1 : unit vector stored with the coordinates, 0 : computed by each calculation
 
 class CWaypoint
 {
 protected:
-	std::string m_name;
+	uint32_t m_nameId;                  // name in CStringPool
+#if COMPACT_COORDINATES
+	int32_t m_latitude;                 // 1e-7 degree
+	int32_t m_longitude;                // 1e-7 degree
+#else
 	double m_latitude;
 	double m_longitude;
+#endif
+#if WAYPOINT_UNIT_VECTOR
+	double m_unitX;                     // position as unit vector, see CUnitVector
+	double m_unitY;
+	double m_unitZ;
+#endif
+
+	/**
+	 * Function writes the coordinates (and the unit vector) of a valid position to the attributes
+	 * @param double latitude  : IN latitude in degree, -90 .. 90
+	 * @param double longitude : IN longitude in degree, -180 .. 180
+	 * @returnvalue void
+	 */
+	void setPosition(double latitude, double longitude);
 public:
 
 	/**
@@ -33,10 +71,11 @@ public:
 	 * @param string name      : IN name of the Waypoint
 	 * @param double latitude  : IN latitude of the Waypoint
 	 * @param double longitude : IN longitude of the Waypoint
+	 * @param CStringPool* pPool : IN pool of the name, NULL : shared pool
 	 * @returnvalue no value
 	 */
 	CWaypoint(std::string name = "default city", double latitude = 0.0,
-			double longitude = 0.0);
+			double longitude = 0.0, CStringPool* pPool = NULL);
 
 	/**
 	 * Function checks the validity of parameter values and writes the correct values to the attributes.
@@ -45,9 +84,11 @@ public:
 	 * @param string name      : IN name of the Waypoint
 	 * @param double latitude  : IN latitude of the Waypoint
 	 * @param double longitude : IN longitude of the Waypoint
+	 * @param CStringPool* pPool : IN pool of the name, NULL : shared pool
 	 * @returnvalue void
 	 */
-	void set(std::string name, double latitude, double longitude);
+	void set(std::string name, double latitude, double longitude,
+			CStringPool* pPool = NULL);
 
 	/**
 	 * Function returns the name of the Waypoint
@@ -56,6 +97,27 @@ public:
 	 */
 	std::string getName() const;
 
+	/**
+	 * Function returns the name of the Waypoint without copying it
+	 * @param no parameters
+	 * @returnvalue const char* : the name of the Waypoint in CStringPool, terminated by '\0'
+	 */
+	const char* getNameChars() const;
+
+	/**
+	 * Function returns the ID of the name of the Waypoint, equal names have equal IDs
+	 * @param no parameters
+	 * @returnvalue uint32_t : ID of the name in CStringPool
+	 */
+	uint32_t getNameId() const;
+
+	/**
+	 * Function moves the strings of the Waypoint into a pool, strings already in the pool are not copied
+	 * @param CStringPool& pool : IN pool, e.g. the one of the Database the Waypoint is added to
+	 * @returnvalue void
+	 */
+	virtual void internStrings(CStringPool& pool);
+
 	/**
 	 * Function returns the latitude of the Waypoint
 	 * @param no parameters
@@ -70,6 +132,34 @@ public:
 	 */
 	double getLongitude()const;
 
+	/**
+	 * Function returns the latitude of the Waypoint in the fixed point encoding
+	 * @param no parameters
+	 * @returnvalue int32_t : the latitude of the Waypoint in 1e-7 degree
+	 */
+	int32_t getLatitudeE7() const;
+
+	/**
+	 * Function returns the longitude of the Waypoint in the fixed point encoding
+	 * @param no parameters
+	 * @returnvalue int32_t : the longitude of the Waypoint in 1e-7 degree
+	 */
+	int32_t getLongitudeE7() const;
+
+	/**
+	 * Function converts a coordinate in degree to the fixed point encoding, rounded to the nearest unit
+	 * @param double degree : IN coordinate in degree, -180 .. 180
+	 * @returnvalue int32_t : coordinate in 1e-7 degree
+	 */
+	static int32_t encodeCoordinate(double degree);
+
+	/**
+	 * Function converts a coordinate in the fixed point encoding to degree
+	 * @param int32_t units : IN coordinate in 1e-7 degree
+	 * @returnvalue double : coordinate in degree
+	 */
+	static double decodeCoordinate(int32_t units);
+
 	/**
 	 * Function to get the values of all the attributes by reference
 	 * @param string& name       : OUT name of the Waypoint
@@ -80,19 +170,36 @@ public:
 	void getAllDataByReference(std::string& name, double & latitude,
 			double & longitude)const;
 
+	/**
+	 * Function returns the position of the Waypoint as unit vector
+	 * @param double& x : OUT x coordinate (latitude 0, longitude 0)
+	 * @param double& y : OUT y coordinate (latitude 0, longitude 90)
+	 * @param double& z : OUT z coordinate (north pole)
+	 * @returnvalue void
+	 */
+	void getUnitVector(double& x, double& y, double& z) const;
+
 	/**
 	 * Function calculates the distance between two Waypoints using the formula and returns the distance
 	 * @param const CWaypoint& wp : IN one of the Waypoint object passed via reference (Other Waypoint object is the object invoking this member function)
 	 * @returnvalue double : the calculated distance between the two Waypoints
 	 */
-	double calculateDistance(const CWaypoint& wp);
+	double calculateDistance(const CWaypoint& wp) const;
+
+	/**
+	 * Function calculates the squared length of the chord between two Waypoints through the earth (unit sphere).
+	 * It grows with the distance, Waypoints can be ranked by distance without trigonometry.
+	 * @param const CWaypoint& wp : IN other Waypoint
+	 * @returnvalue double : squared chord, 0 .. 4
+	 */
+	double calculateChordSquared(const CWaypoint& wp) const;
 
 	/**
 	 * Virtual Function prints the latitude and longitude of the Waypoint in decimal or deg mm ss format depending on the value of format being passed
 	 * @param int format : IN format in which latitude and longitude needs to be printed. '0' - decimal format, '1' - deg mm ss format
 	 * @returnvalue void
 	 */
-	virtual void print(int format);
+	virtual void print(int format) const;
 
 	/**
 	 * Virtual Destructor for CWaypoint class
@@ -0,0 +1,206 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CWORKSTEALINGPOOL.CPP
+ * Author          : George Sebastian
+ * Description     : CWorkStealingPool runs the tasks of a batch on a fixed set of worker
+ *                   threads. The tasks are distributed over one queue per worker; a worker
+ *                   takes tasks from the back of its own queue and, when it runs out of
+ *                   work, steals from the front of the queues of the other workers. So
+ *                   unevenly expensive tasks still keep all cores busy.
+ *                   The calling thread works on the batch as well and returns when all
+ *                   tasks of the batch are finished.
+ ****************************************************************************/
+#include <iostream>
+using namespace std;
+
+#include "CWorkStealingPool.h"
+
+/**
+ * Constructor of class CWorkStealingPool, starts the worker threads
+ * @param unsigned int noThreads : IN number of threads working on a batch including the calling thread, 0 for the number of cores
+ * @return no value
+ */
+CWorkStealingPool::CWorkStealingPool(unsigned int noThreads)
+{
+	if (noThreads == 0)
+		noThreads = thread::hardware_concurrency();
+	if (noThreads == 0)
+		// number of cores is unknown
+		noThreads = 1;
+
+	m_batchNumber = 0;
+	m_shutdown = false;
+	m_pTask = NULL;
+	m_noOpenTasks = 0;
+	m_noSteals = 0;
+
+	for (unsigned int i = 0; i < noThreads; i++)
+		m_queues.push_back(new t_taskQueue);
+
+	for (unsigned int worker = 0; worker < noThreads - 1; worker++)
+		m_threads.push_back(thread(&CWorkStealingPool::workerLoop, this, worker));
+}
+
+/**
+ * Destructor of class CWorkStealingPool, stops the worker threads
+ * @param no parameters
+ * @return no value
+ */
+CWorkStealingPool::~CWorkStealingPool()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_shutdown = true;
+	}
+	m_batchStarted.notify_all();
+
+	for (unsigned int i = 0; i < m_threads.size(); i++)
+		m_threads[i].join();
+
+	for (unsigned int i = 0; i < m_queues.size(); i++)
+		delete m_queues[i];
+}
+
+/**
+ * Function runs task(0) .. task(noTasks - 1) on the pool and waits until all tasks are finished.
+ * Tasks may run in any order and in parallel.
+ * @param unsigned int noTasks                          : IN number of tasks
+ * @param const std::function<void(unsigned int)>& task : IN function called with the number of the task
+ * @returnvalue void
+ */
+void CWorkStealingPool::parallelFor(unsigned int noTasks,
+		const function<void(unsigned int)>& task)
+{
+	if (noTasks == 0)
+		return;
+
+	unsigned int noQueues = m_queues.size();
+	m_pTask = &task;
+	m_noOpenTasks = noTasks;
+
+	// contiguous blocks of tasks per queue, neighbouring tasks often share data
+	for (unsigned int queue = 0; queue < noQueues; queue++)
+	{
+		unsigned int first = (unsigned long long) noTasks * queue / noQueues;
+		unsigned int last = (unsigned long long) noTasks * (queue + 1) / noQueues;
+
+		lock_guard<mutex> lock(m_queues[queue]->mutex);
+		for (unsigned int i = first; i < last; i++)
+			m_queues[queue]->tasks.push_back(i);
+	}
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_batchNumber++;
+	}
+	m_batchStarted.notify_all();
+
+	workOnBatch(noQueues - 1);
+
+	unique_lock<mutex> lock(m_mutex);
+	while (m_noOpenTasks.load() != 0)
+		m_batchFinished.wait(lock);
+
+	m_pTask = NULL;
+}
+
+/**
+ * Function returns the number of threads working on a batch, including the calling thread
+ * @param no parameters
+ * @returnvalue unsigned int : number of threads
+ */
+unsigned int CWorkStealingPool::getNoThreads() const
+{
+	return m_queues.size();
+}
+
+/**
+ * Function returns the number of tasks taken from the queue of another thread
+ * @param no parameters
+ * @returnvalue unsigned long : number of stolen tasks
+ */
+unsigned long CWorkStealingPool::getNoSteals() const
+{
+	return m_noSteals.load();
+}
+
+/**
+ * Function of the worker threads : waits for a batch and works on it
+ * @param unsigned int worker : IN number of the worker, index of its queue
+ * @returnvalue void
+ */
+void CWorkStealingPool::workerLoop(unsigned int worker)
+{
+	unsigned long lastBatch = 0;
+
+	while (true)
+	{
+		{
+			unique_lock<mutex> lock(m_mutex);
+			while (!m_shutdown && m_batchNumber == lastBatch)
+				m_batchStarted.wait(lock);
+
+			if (m_shutdown)
+				return;
+			lastBatch = m_batchNumber;
+		}
+
+		workOnBatch(worker);
+	}
+}
+
+/**
+ * Function runs tasks from the own queue or stolen from other queues until no task is left
+ * @param unsigned int worker : IN number of the thread, index of its queue
+ * @returnvalue void
+ */
+void CWorkStealingPool::workOnBatch(unsigned int worker)
+{
+	unsigned int noQueues = m_queues.size();
+
+	while (m_noOpenTasks.load() != 0)
+	{
+		unsigned int task = 0;
+		bool found = false;
+
+		{
+			// own queue from the back
+			lock_guard<mutex> lock(m_queues[worker]->mutex);
+			if (!m_queues[worker]->tasks.empty())
+			{
+				task = m_queues[worker]->tasks.back();
+				m_queues[worker]->tasks.pop_back();
+				found = true;
+			}
+		}
+
+		for (unsigned int offset = 1; !found && offset < noQueues; offset++)
+		// stealing from the front of the other queues, the victims work on the other end
+		{
+			t_taskQueue* pVictim = m_queues[(worker + offset) % noQueues];
+			lock_guard<mutex> lock(pVictim->mutex);
+
+			if (!pVictim->tasks.empty())
+			{
+				task = pVictim->tasks.front();
+				pVictim->tasks.pop_front();
+				found = true;
+				m_noSteals.fetch_add(1, memory_order_relaxed);
+			}
+		}
+
+		if (!found)
+			// remaining tasks are running on other threads
+			return;
+
+		(*m_pTask)(task);
+
+		if (m_noOpenTasks.fetch_sub(1) == 1)
+		// last task of the batch
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_batchFinished.notify_all();
+		}
+	}
+}
@@ -0,0 +1,114 @@
+/***************************************************************************
+ *============= Copyright by Darmstadt University of Applied Sciences =======
+ ****************************************************************************
+ * Filename        : CWORKSTEALINGPOOL.H
+ * Author          : George Sebastian
+ * Description     : CWorkStealingPool runs the tasks of a batch on a fixed set of worker
+ *                   threads. The tasks are distributed over one queue per worker; a worker
+ *                   takes tasks from the back of its own queue and, when it runs out of
+ *                   work, steals from the front of the queues of the other workers. So
+ *                   unevenly expensive tasks still keep all cores busy.
+ *                   The calling thread works on the batch as well and returns when all
+ *                   tasks of the batch are finished.
+ ****************************************************************************/
+#ifndef CWORKSTEALINGPOOL_H
+#define CWORKSTEALINGPOOL_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+class CWorkStealingPool
+{
+public:
+
+	/**
+	 * Constructor of class CWorkStealingPool, starts the worker threads
+	 * @param unsigned int noThreads : IN number of threads working on a batch including the calling thread, 0 for the number of cores
+	 * @return no value
+	 */
+	CWorkStealingPool(unsigned int noThreads = 0);
+
+	/**
+	 * Destructor of class CWorkStealingPool, stops the worker threads
+	 * @param no parameters
+	 * @return no value
+	 */
+	~CWorkStealingPool();
+
+	/**
+	 * Function runs task(0) .. task(noTasks - 1) on the pool and waits until all tasks are finished.
+	 * Tasks may run in any order and in parallel.
+	 * @param unsigned int noTasks                          : IN number of tasks
+	 * @param const std::function<void(unsigned int)>& task : IN function called with the number of the task
+	 * @returnvalue void
+	 */
+	void parallelFor(unsigned int noTasks,
+			const std::function<void(unsigned int)>& task);
+
+	/**
+	 * Function returns the number of threads working on a batch, including the calling thread
+	 * @param no parameters
+	 * @returnvalue unsigned int : number of threads
+	 */
+	unsigned int getNoThreads() const;
+
+	/**
+	 * Function returns the number of tasks taken from the queue of another thread
+	 * @param no parameters
+	 * @returnvalue unsigned long : number of stolen tasks
+	 */
+	unsigned long getNoSteals() const;
+
+private:
+
+	/*
+	 * task queue of one thread
+	 */
+	struct t_taskQueue
+	{
+		std::mutex mutex;
+		std::deque<unsigned int> tasks;
+	};
+
+	/**
+	 * Copy constructor and assignment operator are not available, the pool owns threads
+	 */
+	CWorkStealingPool(const CWorkStealingPool&);
+	CWorkStealingPool& operator=(const CWorkStealingPool&);
+
+	/**
+	 * Function of the worker threads : waits for a batch and works on it
+	 * @param unsigned int worker : IN number of the worker, index of its queue
+	 * @returnvalue void
+	 */
+	void workerLoop(unsigned int worker);
+
+	/**
+	 * Function runs tasks from the own queue or stolen from other queues until no task is left
+	 * @param unsigned int worker : IN number of the thread, index of its queue
+	 * @returnvalue void
+	 */
+	void workOnBatch(unsigned int worker);
+
+	std::vector<std::thread> m_threads;
+	std::vector<t_taskQueue*> m_queues;     // queue m_queues.size() - 1 belongs to the calling thread
+
+	std::mutex m_mutex;
+	std::condition_variable m_batchStarted;
+	std::condition_variable m_batchFinished;
+	unsigned long m_batchNumber;           // incremented for each batch, wakes up the workers
+	bool m_shutdown;
+
+	const std::function<void(unsigned int)>* m_pTask;
+	std::atomic<unsigned int> m_noOpenTasks;
+	std::atomic<unsigned long> m_noSteals;
+};
+/********************
+ **  CLASS END
+ *********************/
+#endif /* CWORKSTEALINGPOOL_H */